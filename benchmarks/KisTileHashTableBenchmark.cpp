@@ -0,0 +1,171 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTileHashTableBenchmark.h"
+
+#include <QThreadPool>
+#include <QRunnable>
+#include <QRandomGenerator>
+
+#include "tiles3/kis_tile_hash_table.h"
+#include "tiles3/kis_tile_hash_table2.h"
+#include "tiles3/kis_memento_manager.h"
+#include "tiles3/kis_tile_data_store.h"
+
+/**
+ * The tiles of a 4096x4096 image
+ */
+const int NUM_COLS = 64;
+const int NUM_ROWS = 64;
+
+const int NUM_CYCLES = 200000;
+const int NUM_ITERATIONS = 50;
+
+template <class HashTable>
+class KisHashTableAccessJob : public QRunnable
+{
+public:
+    KisHashTableAccessJob(HashTable *table, quint32 seed)
+        : m_table(table), m_rng(seed)
+    {
+    }
+
+    void run() override {
+        for (int i = 0; i < NUM_CYCLES; i++) {
+            const qint32 col = m_rng.bounded(NUM_COLS);
+            const qint32 row = m_rng.bounded(NUM_ROWS);
+
+            bool flag = false;
+
+            /**
+             * The updater threads mostly read the tiles, sometimes
+             * create new ones and rarely delete them
+             */
+            switch (i % 8) {
+            case 0:
+                m_table->getTileLazy(col, row, flag);
+                break;
+            case 1:
+                m_table->getExistingTile(col, row);
+                break;
+            case 7:
+                if (!(i % 1024)) {
+                    m_table->deleteTile(col, row);
+                    break;
+                }
+                Q_FALLTHROUGH();
+            default:
+                m_table->getReadOnlyTileLazy(col, row, flag);
+                break;
+            }
+        }
+    }
+
+private:
+    HashTable *m_table;
+    QRandomGenerator m_rng;
+};
+
+template <class HashTable, class Iterator>
+class KisHashTableIterationJob : public QRunnable
+{
+public:
+    KisHashTableIterationJob(HashTable *table)
+        : m_table(table)
+    {
+    }
+
+    void run() override {
+        for (int i = 0; i < NUM_ITERATIONS; i++) {
+            Iterator iter(m_table);
+            int numTiles = 0;
+
+            while (!iter.isDone()) {
+                numTiles += bool(iter.tile());
+                iter.next();
+            }
+
+            Q_UNUSED(numTiles);
+        }
+    }
+
+private:
+    HashTable *m_table;
+};
+
+template <class HashTable, class Iterator>
+void runContentionBenchmark(int numThreads, int numIteratingThreads)
+{
+    KisMementoManager mementoManager;
+
+    quint8 defaultPixel[4] = {0, 0, 0, 0};
+    KisTileData *defaultTileData =
+        KisTileDataStore::instance()->createDefaultTileData(4, defaultPixel);
+
+    HashTable table(&mementoManager);
+    table.setDefaultTileData(defaultTileData);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(numThreads + numIteratingThreads);
+
+    QBENCHMARK_ONCE {
+        for (int i = 0; i < numThreads; i++) {
+            pool.start(new KisHashTableAccessJob<HashTable>(&table, i + 1));
+        }
+
+        for (int i = 0; i < numIteratingThreads; i++) {
+            pool.start(new KisHashTableIterationJob<HashTable, Iterator>(&table));
+        }
+
+        pool.waitForDone();
+    }
+
+    table.clear();
+    table.setDefaultTileData(0);
+}
+
+void KisTileHashTableBenchmark::populateData()
+{
+    QTest::addColumn<int>("numThreads");
+    QTest::addColumn<int>("numIteratingThreads");
+
+    const int maxThreads = qMax(4, QThread::idealThreadCount());
+
+    for (int numThreads = 1; numThreads <= maxThreads; numThreads *= 2) {
+        QTest::addRow("%d threads", numThreads) << numThreads << 0;
+        QTest::addRow("%d threads, iterating", numThreads) << numThreads << 1;
+    }
+}
+
+void KisTileHashTableBenchmark::benchmarkLockFreeTable_data()
+{
+    populateData();
+}
+
+void KisTileHashTableBenchmark::benchmarkLockFreeTable()
+{
+    QFETCH(int, numThreads);
+    QFETCH(int, numIteratingThreads);
+
+    runContentionBenchmark<KisTileHashTableTraits2<KisTile>,
+                           KisTileHashTableIteratorTraits2<KisTile>>(numThreads, numIteratingThreads);
+}
+
+void KisTileHashTableBenchmark::benchmarkLegacyTable_data()
+{
+    populateData();
+}
+
+void KisTileHashTableBenchmark::benchmarkLegacyTable()
+{
+    QFETCH(int, numThreads);
+    QFETCH(int, numIteratingThreads);
+
+    runContentionBenchmark<KisTileHashTableTraits<KisTile>,
+                           KisTileHashTableIteratorTraits<KisTile, QReadLocker>>(numThreads, numIteratingThreads);
+}
+
+SIMPLE_TEST_MAIN(KisTileHashTableBenchmark)
@@ -0,0 +1,31 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTILEHASHTABLEBENCHMARK_H
+#define KISTILEHASHTABLEBENCHMARK_H
+
+#include <simpletest.h>
+
+/**
+ * Compares the contention of the lock-free tile hash table with the
+ * legacy blocking one when many updater-like threads access the same
+ * table and some of them iterate over it.
+ */
+class KisTileHashTableBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkLockFreeTable_data();
+    void benchmarkLockFreeTable();
+
+    void benchmarkLegacyTable_data();
+    void benchmarkLegacyTable();
+
+private:
+    void populateData();
+};
+
+#endif // KISTILEHASHTABLEBENCHMARK_H
@@ -10,6 +10,10 @@
 #define TEST_IMAGE_WIDTH 4096
 #define TEST_IMAGE_HEIGHT 4096
 
+// 16k wide strip of a float canvas, 256 MiB in RGBA F32
+#define LARGE_FLOAT_IMAGE_WIDTH 16384
+#define LARGE_FLOAT_IMAGE_HEIGHT 1024
+
 #define NO_TILE_EXACT_BOUNDARY_WIDTH 1021
 #define NO_TILE_EXACT_BOUNDARY_HEIGHT 1084
 
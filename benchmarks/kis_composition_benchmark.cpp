@@ -14,6 +14,9 @@
 #include <KoOptimizedCompositeOpOver128.h>
 #include <KoOptimizedCompositeOpCopy128.h>
 #include <KoOptimizedCompositeOpAlphaDarken32.h>
+#include <KoOptimizedCompositeOpGenericSC.h>
+#include <KoOptimizedCompositeOpBehind128.h>
+#include <KoOptimizedCompositeOpErase128.h>
 #endif
 
 #include "kis_composition_benchmark.h"
@@ -28,6 +31,12 @@
 #include <KoCompositeOpAlphaDarken.h>
 #include <KoCompositeOpOver.h>
 #include <KoCompositeOpCopy2.h>
+#include <KoCompositeOpBehind.h>
+#include <KoCompositeOpErase.h>
+#include <KoCompositeOpGeneric.h>
+#include <KoCompositeOpRegistry.h>
+#include <KoCompositeOpFunctions.h>
+#include <KoColorSpaceBlendingPolicy.h>
 #include <KoOptimizedCompositeOpFactory.h>
 #include <KoAlphaDarkenParamsWrapper.h>
 
@@ -360,7 +369,7 @@ bool compareTwoOpsPixels(QVector<Tile> &tiles, channel_type prec) {
 }
 
 template<template<typename> class Compare = PixelEqualDirect>
-bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp *op2)
+bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp *op2, const QBitArray &channelFlags = QBitArray())
 {
     Q_ASSERT(op1->colorSpace()->pixelSize() == op2->colorSpace()->pixelSize());
     const quint32 pixelSize = op1->colorSpace()->pixelSize();
@@ -376,7 +385,7 @@ bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp
     // This is a hack as in the old version we get a rounding of opacity to this value
     params.opacity       = float(Arithmetic::scale<quint8>(0.5*1.0f))/255.0;
     params.flow          = 0.3*1.0f;
-    params.channelFlags  = QBitArray();
+    params.channelFlags  = channelFlags;
 
     params.dstRowStart   = tiles[0].dst;
     params.srcRowStart   = tiles[0].src;
@@ -407,6 +416,98 @@ bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp
     return compareResult;
 }
 
+QStringList genericSCOpIds()
+{
+    return {COMPOSITE_MULT, COMPOSITE_SCREEN, COMPOSITE_OVERLAY,
+            COMPOSITE_DARKEN, COMPOSITE_LIGHTEN, COMPOSITE_ADD,
+            COMPOSITE_LINEAR_DODGE, COMPOSITE_SUBTRACT, COMPOSITE_DIFF};
+}
+
+/**
+ * Creates the op registered by KoCompositeOps.h for the colorspaces
+ * without the optimized version of the blend mode
+ */
+template<class Traits>
+KoCompositeOp* createGenericSCOp(const KoColorSpace *cs, const QString &id)
+{
+    using Arg = typename Traits::channels_type;
+    using Policy = KoAdditiveBlendingPolicy<Traits>;
+
+    if (id == COMPOSITE_MULT) {
+        return new KoCompositeOpGenericSC<Traits, &cfMultiply<Arg>, Policy>(cs, id, KoCompositeOp::categoryArithmetic());
+    } else if (id == COMPOSITE_SCREEN) {
+        return new KoCompositeOpGenericSC<Traits, &cfScreen<Arg>, Policy>(cs, id, KoCompositeOp::categoryLight());
+    } else if (id == COMPOSITE_OVERLAY) {
+        return new KoCompositeOpGenericSCFunctor<Traits, CFOverlay<Arg>, Policy>(cs, id, KoCompositeOp::categoryMix());
+    } else if (id == COMPOSITE_DARKEN) {
+        return new KoCompositeOpGenericSC<Traits, &cfDarkenOnly<Arg>, Policy>(cs, id, KoCompositeOp::categoryDark());
+    } else if (id == COMPOSITE_LIGHTEN) {
+        return new KoCompositeOpGenericSC<Traits, &cfLightenOnly<Arg>, Policy>(cs, id, KoCompositeOp::categoryLight());
+    } else if (id == COMPOSITE_ADD) {
+        return new KoCompositeOpGenericSC<Traits, &cfAddition<Arg>, Policy>(cs, id, KoCompositeOp::categoryArithmetic());
+    } else if (id == COMPOSITE_LINEAR_DODGE) {
+        return new KoCompositeOpGenericSC<Traits, &cfAddition<Arg>, Policy>(cs, id, KoCompositeOp::categoryLight());
+    } else if (id == COMPOSITE_SUBTRACT) {
+        return new KoCompositeOpGenericSC<Traits, &cfSubtract<Arg>, Policy>(cs, id, KoCompositeOp::categoryArithmetic());
+    } else if (id == COMPOSITE_DIFF) {
+        return new KoCompositeOpGenericSC<Traits, &cfDifference<Arg>, Policy>(cs, id, KoCompositeOp::categoryNegative());
+    }
+
+    qFatal("Composite op %s is not implemented", qPrintable(id));
+    return 0;
+}
+
+QString channelFlagsToString(const QBitArray &channelFlags)
+{
+    if (channelFlags.isEmpty()) return "all";
+
+    QString result;
+    for (int i = 0; i < channelFlags.size(); i++) {
+        result += channelFlags.testBit(i) ? "1" : "0";
+    }
+    return result;
+}
+
+typedef KoCompositeOp* (*GenericSCOpFactory)(const KoColorSpace *cs, const QString &id, const QString &category);
+
+/**
+ * Compares the optimized separable blend modes against the generic
+ * ones, including the alpha locked and the partial channel flags cases
+ */
+template<class Traits>
+void compareGenericSCOps(const KoColorSpace *cs, GenericSCOpFactory createOptimizedOp)
+{
+    QBitArray alphaLocked(4, true);
+    alphaLocked.clearBit(3);
+
+    QBitArray partialFlags(4, true);
+    partialFlags.clearBit(0);
+
+    QBitArray partialFlagsAlphaLocked = partialFlags;
+    partialFlagsAlphaLocked.clearBit(3);
+
+    const QVector<QBitArray> channelFlagsVariants =
+        {QBitArray(), alphaLocked, partialFlags, partialFlagsAlphaLocked};
+
+    Q_FOREACH (const QString &id, genericSCOpIds()) {
+        QScopedPointer<KoCompositeOp> opAct(createOptimizedOp(cs, id, QString()));
+        if (!opAct) {
+            QSKIP("No optimized version of the op is available");
+        }
+
+        QScopedPointer<KoCompositeOp> opExp(createGenericSCOp<Traits>(cs, id));
+
+        Q_FOREACH (const QBitArray &channelFlags, channelFlagsVariants) {
+            Q_FOREACH (bool haveMask, {true, false}) {
+                QVERIFY2(compareTwoOps(haveMask, opAct.data(), opExp.data(), channelFlags),
+                         qPrintable(QString("op: %1 channel flags: %2 mask: %3")
+                                    .arg(id, channelFlagsToString(channelFlags))
+                                    .arg(haveMask)));
+            }
+        }
+    }
+}
+
 QString getTestName(bool haveMask,
                     const int srcAlignmentShift,
                     const int dstAlignmentShift,
@@ -614,6 +715,21 @@ void checkRounding(qreal opacity, qreal flow, qreal averageOpacity = -1, quint32
     freeTiles(tiles, 0, 0);
 }
 
+template<typename channels_type>
+void checkRoundingGenericSC(quint32 pixelSize)
+{
+    using namespace KoOptimizedBlendFunctions;
+
+    checkRounding<GenericSCCompositor<channels_type, Multiply, false, true> >(0.5, 1.0, -1, pixelSize);
+    checkRounding<GenericSCCompositor<channels_type, Screen, false, true> >(0.5, 1.0, -1, pixelSize);
+    checkRounding<GenericSCCompositor<channels_type, Overlay, false, true> >(0.5, 1.0, -1, pixelSize);
+    checkRounding<GenericSCCompositor<channels_type, Darken, false, true> >(0.5, 1.0, -1, pixelSize);
+    checkRounding<GenericSCCompositor<channels_type, Lighten, false, true> >(0.5, 1.0, -1, pixelSize);
+    checkRounding<GenericSCCompositor<channels_type, Addition, false, true> >(0.5, 1.0, -1, pixelSize);
+    checkRounding<GenericSCCompositor<channels_type, Subtract, false, true> >(0.5, 1.0, -1, pixelSize);
+    checkRounding<GenericSCCompositor<channels_type, Difference, false, true> >(0.5, 1.0, -1, pixelSize);
+}
+
 #endif
 
 
@@ -734,6 +850,20 @@ void KisCompositionBenchmark::checkRoundingOverRgbaF32()
     checkRounding<OverCompositor128<float, false, true> >(0.5, 1.0, -1, 16);
 #endif
 }
+
+void KisCompositionBenchmark::checkRoundingBehindRgbaU16()
+{
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE) && XSIMD_UNIVERSAL_BUILD_PASS
+    checkRounding<BehindCompositor128<quint16, false, true> >(0.5, 1.0, -1, 8);
+#endif
+}
+
+void KisCompositionBenchmark::checkRoundingEraseRgbaU16()
+{
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE) && XSIMD_UNIVERSAL_BUILD_PASS
+    checkRounding<EraseCompositor128<quint16> >(0.5, 1.0, -1, 8);
+#endif
+}
 #include <cfenv>
 void KisCompositionBenchmark::checkRoundingCopyRgbaU16()
 {
@@ -749,6 +879,27 @@ void KisCompositionBenchmark::checkRoundingCopyRgbaF32()
 #endif
 }
 
+void KisCompositionBenchmark::checkRoundingGenericSCRgbaU8()
+{
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE) && XSIMD_UNIVERSAL_BUILD_PASS
+    checkRoundingGenericSC<quint8>(4);
+#endif
+}
+
+void KisCompositionBenchmark::checkRoundingGenericSCRgbaU16()
+{
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE) && XSIMD_UNIVERSAL_BUILD_PASS
+    checkRoundingGenericSC<quint16>(8);
+#endif
+}
+
+void KisCompositionBenchmark::checkRoundingGenericSCRgbaF32()
+{
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE) && XSIMD_UNIVERSAL_BUILD_PASS
+    checkRoundingGenericSC<float>(16);
+#endif
+}
+
 void KisCompositionBenchmark::compareAlphaDarkenOps()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -833,6 +984,37 @@ void KisCompositionBenchmark::compareRgbU16OverOps()
     delete opAct;
 }
 
+void KisCompositionBenchmark::compareRgbU16BehindOps()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    KoCompositeOp *opAct = KoOptimizedCompositeOpFactory::createBehindOpU64(cs);
+    KoCompositeOp *opExp = new KoCompositeOpBehind<KoBgrU16Traits, KoAdditiveBlendingPolicy<KoBgrU16Traits>>(cs);
+
+    QBitArray alphaLocked(4, true);
+    alphaLocked.clearBit(3);
+
+    QVERIFY(compareTwoOps(false, opAct, opExp));
+    QVERIFY(compareTwoOps(true, opAct, opExp));
+    QVERIFY(compareTwoOps(false, opAct, opExp, alphaLocked));
+    QVERIFY(compareTwoOps(true, opAct, opExp, alphaLocked));
+
+    delete opExp;
+    delete opAct;
+}
+
+void KisCompositionBenchmark::compareRgbU16EraseOps()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    KoCompositeOp *opAct = KoOptimizedCompositeOpFactory::createEraseOpU64(cs);
+    KoCompositeOp *opExp = new KoCompositeOpErase<KoBgrU16Traits>(cs);
+
+    QVERIFY(compareTwoOps(false, opAct, opExp));
+    QVERIFY(compareTwoOps(true, opAct, opExp));
+
+    delete opExp;
+    delete opAct;
+}
+
 void KisCompositionBenchmark::compareRgbF32OverOps()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
@@ -885,6 +1067,24 @@ void KisCompositionBenchmark::compareRgbF32CopyOps()
     delete opAct;
 }
 
+void KisCompositionBenchmark::compareRgbU8GenericSCOps()
+{
+    compareGenericSCOps<KoBgrU8Traits>(KoColorSpaceRegistry::instance()->rgb8(),
+                                       &KoOptimizedCompositeOpFactory::createGenericSCOp32);
+}
+
+void KisCompositionBenchmark::compareRgbU16GenericSCOps()
+{
+    compareGenericSCOps<KoBgrU16Traits>(KoColorSpaceRegistry::instance()->rgb16(),
+                                        &KoOptimizedCompositeOpFactory::createGenericSCOpU64);
+}
+
+void KisCompositionBenchmark::compareRgbF32GenericSCOps()
+{
+    compareGenericSCOps<KoRgbF32Traits>(KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", ""),
+                                        &KoOptimizedCompositeOpFactory::createGenericSCOp128);
+}
+
 void KisCompositionBenchmark::testRgb8CompositeAlphaDarkenLegacy()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -949,6 +1149,38 @@ void KisCompositionBenchmark::testRgb16CompositeOverOptimized()
     delete op;
 }
 
+void KisCompositionBenchmark::testRgb16CompositeBehindLegacy()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    KoCompositeOp *op = new KoCompositeOpBehind<KoBgrU16Traits, KoAdditiveBlendingPolicy<KoBgrU16Traits>>(cs);
+    benchmarkCompositeOp(op, "Legacy");
+    delete op;
+}
+
+void KisCompositionBenchmark::testRgb16CompositeBehindOptimized()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    KoCompositeOp *op = KoOptimizedCompositeOpFactory::createBehindOpU64(cs);
+    benchmarkCompositeOp(op, "Optimized");
+    delete op;
+}
+
+void KisCompositionBenchmark::testRgb16CompositeEraseLegacy()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    KoCompositeOp *op = new KoCompositeOpErase<KoBgrU16Traits>(cs);
+    benchmarkCompositeOp(op, "Legacy");
+    delete op;
+}
+
+void KisCompositionBenchmark::testRgb16CompositeEraseOptimized()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    KoCompositeOp *op = KoOptimizedCompositeOpFactory::createEraseOpU64(cs);
+    benchmarkCompositeOp(op, "Optimized");
+    delete op;
+}
+
 
 void KisCompositionBenchmark::testRgb16CompositeCopyLegacy()
 {
@@ -29,10 +29,16 @@ private Q_SLOTS:
     void checkRoundingOver();
     void checkRoundingOverRgbaU16();
     void checkRoundingOverRgbaF32();
+    void checkRoundingBehindRgbaU16();
+    void checkRoundingEraseRgbaU16();
 
     void checkRoundingCopyRgbaU16();
     void checkRoundingCopyRgbaF32();
 
+    void checkRoundingGenericSCRgbaU8();
+    void checkRoundingGenericSCRgbaU16();
+    void checkRoundingGenericSCRgbaF32();
+
     void compareAlphaDarkenOps();
     void compareAlphaDarkenOpsNoMask();
     void compareRgbU16AlphaDarkenOps();
@@ -41,12 +47,18 @@ private Q_SLOTS:
     void compareOverOps();
     void compareOverOpsNoMask();
     void compareRgbU16OverOps();
+    void compareRgbU16BehindOps();
+    void compareRgbU16EraseOps();
     void compareRgbF32OverOps();
 
     void compareRgbU8CopyOps();
     void compareRgbU16CopyOps();
     void compareRgbF32CopyOps();
 
+    void compareRgbU8GenericSCOps();
+    void compareRgbU16GenericSCOps();
+    void compareRgbF32GenericSCOps();
+
     void testRgb8CompositeAlphaDarkenLegacy();
     void testRgb8CompositeAlphaDarkenOptimized();
 
@@ -59,6 +71,12 @@ private Q_SLOTS:
     void testRgb16CompositeOverLegacy();
     void testRgb16CompositeOverOptimized();
 
+    void testRgb16CompositeBehindLegacy();
+    void testRgb16CompositeBehindOptimized();
+
+    void testRgb16CompositeEraseLegacy();
+    void testRgb16CompositeEraseOptimized();
+
     void testRgb16CompositeCopyLegacy();
     void testRgb16CompositeCopyOptimized();
 
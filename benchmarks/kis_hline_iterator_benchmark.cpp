@@ -12,6 +12,7 @@
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoColor.h>
+#include <KoColorModelStandardIds.h>
 
 #include <simpletest.h>
 
@@ -133,6 +134,41 @@ void KisHLineIteratorBenchmark::benchmarkReadWriteBytes2()
 }
 
 
+void KisHLineIteratorBenchmark::benchmarkLargeFloatCanvas()
+{
+    /**
+     * On huge float canvases the per-tile overhead and the hash table
+     * lookups take a noticeable part of a filter pass. Compare the
+     * results of the builds with different KRITA_TILE_SIZE.
+     */
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(),
+                                                     Float32BitsColorDepthID.id());
+
+    if (!cs) {
+        QSKIP("The F32 color space is not available without the color space plugins");
+    }
+
+    const QRect rc(0, 0, LARGE_FLOAT_IMAGE_WIDTH, LARGE_FLOAT_IMAGE_HEIGHT);
+
+    KisPaintDevice device(cs);
+    device.fill(rc, KoColor(QColor(250, 120, 0), cs));
+
+    QBENCHMARK {
+        KisHLineIteratorSP it = device.createHLineIteratorNG(rc.x(), rc.y(), rc.width());
+
+        for (int j = 0; j < rc.height(); j++) {
+            do {
+                float *pixel = reinterpret_cast<float*>(it->rawData());
+                pixel[0] *= 0.5f;
+                pixel[1] *= 0.5f;
+                pixel[2] *= 0.5f;
+            } while (it->nextPixel());
+            it->nextRow();
+        }
+    }
+}
+
 void KisHLineIteratorBenchmark::benchmarkNoMemCpy()
 {
     KisHLineIteratorSP it = m_device->createHLineIteratorNG(0, 0, TEST_IMAGE_WIDTH);
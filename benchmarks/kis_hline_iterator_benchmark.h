@@ -40,6 +40,9 @@ private Q_SLOTS:
     
     void benchmarkReadWriteBytes2();
     
+    // a bulk pass over a huge float canvas, see KRITA_TILE_SIZE
+    void benchmarkLargeFloatCanvas();
+
     void benchmarkNoMemCpy();
     void benchmarkConstNoMemCpy();
     // copy from one device to another
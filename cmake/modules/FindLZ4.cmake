@@ -0,0 +1,80 @@
+# SPDX-FileCopyrightText: 2026 Krita Developers
+# SPDX-License-Identifier: BSD-3-Clause
+
+#[=======================================================================[.rst:
+FindLZ4
+-------
+
+Find the LZ4 compression library headers and libraries.
+
+Imported Targets
+^^^^^^^^^^^^^^^^
+
+``LZ4::lz4``
+  The LZ4 library, if found.
+
+Result Variables
+^^^^^^^^^^^^^^^^
+
+This will define the following variables in your project:
+
+``LZ4_FOUND``
+  true if (the requested version of) LZ4 is available.
+``LZ4_VERSION``
+  the version of LZ4.
+``LZ4_LIBRARIES``
+  the libraries to link against to use LZ4.
+``LZ4_INCLUDE_DIRS``
+  where to find the LZ4 headers.
+
+#]=======================================================================]
+
+find_package(PkgConfig QUIET)
+pkg_check_modules(PC_LZ4 QUIET liblz4)
+
+find_path(LZ4_INCLUDE_DIR
+    NAMES lz4.h
+    HINTS ${PC_LZ4_INCLUDEDIR} ${PC_LZ4_INCLUDE_DIRS}
+)
+
+find_library(LZ4_LIBRARY
+    NAMES lz4 liblz4
+    HINTS ${PC_LZ4_LIBDIR} ${PC_LZ4_LIBRARY_DIRS}
+)
+
+if (PC_LZ4_VERSION)
+    set(LZ4_VERSION ${PC_LZ4_VERSION})
+elseif (LZ4_INCLUDE_DIR AND EXISTS "${LZ4_INCLUDE_DIR}/lz4.h")
+    file(STRINGS "${LZ4_INCLUDE_DIR}/lz4.h" _lz4_version_lines
+        REGEX "#define[ \t]+LZ4_VERSION_(MAJOR|MINOR|RELEASE)")
+    string(REGEX REPLACE ".*LZ4_VERSION_MAJOR[ \t]+([0-9]+).*" "\\1" _lz4_major "${_lz4_version_lines}")
+    string(REGEX REPLACE ".*LZ4_VERSION_MINOR[ \t]+([0-9]+).*" "\\1" _lz4_minor "${_lz4_version_lines}")
+    string(REGEX REPLACE ".*LZ4_VERSION_RELEASE[ \t]+([0-9]+).*" "\\1" _lz4_release "${_lz4_version_lines}")
+    set(LZ4_VERSION "${_lz4_major}.${_lz4_minor}.${_lz4_release}")
+    unset(_lz4_version_lines)
+    unset(_lz4_major)
+    unset(_lz4_minor)
+    unset(_lz4_release)
+endif ()
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(LZ4
+    FOUND_VAR LZ4_FOUND
+    REQUIRED_VARS LZ4_LIBRARY LZ4_INCLUDE_DIR
+    VERSION_VAR LZ4_VERSION
+)
+
+if (LZ4_FOUND)
+    set(LZ4_LIBRARIES ${LZ4_LIBRARY})
+    set(LZ4_INCLUDE_DIRS ${LZ4_INCLUDE_DIR})
+
+    if (NOT TARGET LZ4::lz4)
+        add_library(LZ4::lz4 UNKNOWN IMPORTED)
+        set_target_properties(LZ4::lz4 PROPERTIES
+            IMPORTED_LOCATION "${LZ4_LIBRARY}"
+            INTERFACE_INCLUDE_DIRECTORIES "${LZ4_INCLUDE_DIR}"
+        )
+    endif ()
+endif ()
+
+mark_as_advanced(LZ4_INCLUDE_DIR LZ4_LIBRARY)
@@ -0,0 +1,80 @@
+# SPDX-FileCopyrightText: 2026 Krita Developers
+# SPDX-License-Identifier: BSD-3-Clause
+
+#[=======================================================================[.rst:
+FindZSTD
+--------
+
+Find the ZSTD compression library headers and libraries.
+
+Imported Targets
+^^^^^^^^^^^^^^^^
+
+``ZSTD::zstd``
+  The ZSTD library, if found.
+
+Result Variables
+^^^^^^^^^^^^^^^^
+
+This will define the following variables in your project:
+
+``ZSTD_FOUND``
+  true if (the requested version of) ZSTD is available.
+``ZSTD_VERSION``
+  the version of ZSTD.
+``ZSTD_LIBRARIES``
+  the libraries to link against to use ZSTD.
+``ZSTD_INCLUDE_DIRS``
+  where to find the ZSTD headers.
+
+#]=======================================================================]
+
+find_package(PkgConfig QUIET)
+pkg_check_modules(PC_ZSTD QUIET libzstd)
+
+find_path(ZSTD_INCLUDE_DIR
+    NAMES zstd.h
+    HINTS ${PC_ZSTD_INCLUDEDIR} ${PC_ZSTD_INCLUDE_DIRS}
+)
+
+find_library(ZSTD_LIBRARY
+    NAMES zstd libzstd
+    HINTS ${PC_ZSTD_LIBDIR} ${PC_ZSTD_LIBRARY_DIRS}
+)
+
+if (PC_ZSTD_VERSION)
+    set(ZSTD_VERSION ${PC_ZSTD_VERSION})
+elseif (ZSTD_INCLUDE_DIR AND EXISTS "${ZSTD_INCLUDE_DIR}/zstd.h")
+    file(STRINGS "${ZSTD_INCLUDE_DIR}/zstd.h" _zstd_version_lines
+        REGEX "#define[ \t]+ZSTD_VERSION_(MAJOR|MINOR|RELEASE)")
+    string(REGEX REPLACE ".*ZSTD_VERSION_MAJOR[ \t]+([0-9]+).*" "\\1" _zstd_major "${_zstd_version_lines}")
+    string(REGEX REPLACE ".*ZSTD_VERSION_MINOR[ \t]+([0-9]+).*" "\\1" _zstd_minor "${_zstd_version_lines}")
+    string(REGEX REPLACE ".*ZSTD_VERSION_RELEASE[ \t]+([0-9]+).*" "\\1" _zstd_release "${_zstd_version_lines}")
+    set(ZSTD_VERSION "${_zstd_major}.${_zstd_minor}.${_zstd_release}")
+    unset(_zstd_version_lines)
+    unset(_zstd_major)
+    unset(_zstd_minor)
+    unset(_zstd_release)
+endif ()
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(ZSTD
+    FOUND_VAR ZSTD_FOUND
+    REQUIRED_VARS ZSTD_LIBRARY ZSTD_INCLUDE_DIR
+    VERSION_VAR ZSTD_VERSION
+)
+
+if (ZSTD_FOUND)
+    set(ZSTD_LIBRARIES ${ZSTD_LIBRARY})
+    set(ZSTD_INCLUDE_DIRS ${ZSTD_INCLUDE_DIR})
+
+    if (NOT TARGET ZSTD::zstd)
+        add_library(ZSTD::zstd UNKNOWN IMPORTED)
+        set_target_properties(ZSTD::zstd PROPERTIES
+            IMPORTED_LOCATION "${ZSTD_LIBRARY}"
+            INTERFACE_INCLUDE_DIRECTORIES "${ZSTD_INCLUDE_DIR}"
+        )
+    endif ()
+endif ()
+
+mark_as_advanced(ZSTD_INCLUDE_DIR ZSTD_LIBRARY)
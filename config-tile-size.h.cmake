@@ -0,0 +1,4 @@
+/* config-tile-size.h.  Generated by cmake from config-tile-size.h.cmake */
+
+/* The size of the side of the image tiles in pixels */
+#define KRITA_TILE_SIZE @KRITA_TILE_SIZE@
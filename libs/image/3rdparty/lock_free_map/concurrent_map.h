@@ -294,9 +294,13 @@ public:
         return iter.eraseValue();
     }
 
-    // The easiest way to implement an Iterator is to prevent all Redirects.
-    // The currrent Iterator does that by forbidding concurrent inserts.
-    // To make it work with concurrent inserts, we'd need a way to block TableMigrations.
+    // The Iterator doesn't follow Redirects. If it meets one, then a TableMigration
+    // is in progress and some cells have already been moved to the new table. In such
+    // a case the Iterator skips the cell and reports it via wasRedirected(), so the
+    // caller can restart the iteration when the migration is finished.
+    //
+    // The caller should hold raw pointer access in QSBR for the whole iteration,
+    // otherwise the table may be reclaimed under its feet.
     class Iterator
     {
     private:
@@ -304,14 +308,15 @@ public:
         quint64 m_idx;
         Key m_hash;
         Value m_value;
+        bool m_redirected = false;
 
     public:
         Iterator() = default;
         Iterator(ConcurrentMap& map)
         {
-            // Since we've forbidden concurrent inserts (for now), nonatomic would suffice here, but let's plan ahead:
             m_table = map.m_root.load(Consume);
             m_idx = -1;
+            m_redirected = false;
             next();
         }
 
@@ -319,6 +324,7 @@ public:
         {
             m_table = map.m_root.load(Consume);
             m_idx = -1;
+            m_redirected = false;
             next();
         }
 
@@ -332,7 +338,12 @@ public:
 
                 if (m_hash != KeyTraits::NullHash) {
                     // Cell has been reserved.
-                    m_value = cell->value.load(Relaxed);
+                    m_value = cell->value.load(Acquire);
+                    if (m_value == Value(ValueTraits::Redirect)) {
+                        // The cell has been migrated to a new table.
+                        m_redirected = true;
+                        continue;
+                    }
                     if (m_value != Value(ValueTraits::NullValue))
                         return; // Yield this cell.
                 }
@@ -352,10 +363,15 @@ public:
 
         Key getKey() const
         {
-            // Since we've forbidden concurrent inserts (for now), nonatomic would suffice here, but let's plan ahead:
             return KeyTraits::dehash(m_hash);
         }
 
+        // Returns true if some cells were skipped, because the table is being migrated
+        bool wasRedirected() const
+        {
+            return m_redirected;
+        }
+
         Value getValue() const
         {
             return m_value;
@@ -0,0 +1,152 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisGroupCompositionCache.h"
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+
+#include "kis_node.h"
+#include "kis_paint_device.h"
+
+
+namespace {
+
+bool regionContains(const QRegion &region, const QRect &rc)
+{
+    return !rc.isEmpty() && (QRegion(rc) - region).isEmpty();
+}
+
+}
+
+KisGroupCompositionCache::KisGroupCompositionCache()
+{
+}
+
+KisGroupCompositionCache::~KisGroupCompositionCache()
+{
+}
+
+KisGroupCompositionCache::Ticket KisGroupCompositionCache::acquire(KisNodeSP activeChild, int graphSequenceNumber, KisPaintDeviceSP original)
+{
+    QMutexLocker l(&m_lock);
+
+    const bool needsReset =
+        m_activeChild != activeChild.data() ||
+        m_graphSequenceNumber != graphSequenceNumber ||
+        !m_belowDevice ||
+        !(*m_belowDevice->colorSpace() == *original->colorSpace()) ||
+        m_belowDevice->x() != original->x() ||
+        m_belowDevice->y() != original->y() ||
+        !(m_belowDevice->defaultPixel() == original->defaultPixel());
+
+    if (needsReset) {
+        resetImpl();
+
+        m_activeChild = activeChild.data();
+        m_graphSequenceNumber = graphSequenceNumber;
+
+        m_belowDevice = new KisPaintDevice(original->colorSpace());
+        m_belowDevice->prepareClone(original);
+
+        m_aboveDevice = new KisPaintDevice(original->colorSpace());
+        m_aboveDevice->prepareClone(original);
+        m_aboveDevice->setDefaultPixel(KoColor::createTransparent(original->colorSpace()));
+    }
+
+    Ticket ticket;
+    ticket.belowDevice = m_belowDevice;
+    ticket.aboveDevice = m_aboveDevice;
+    ticket.generation = m_generation;
+
+    return ticket;
+}
+
+bool KisGroupCompositionCache::belowContains(const Ticket &ticket, const QRect &rc) const
+{
+    QMutexLocker l(&m_lock);
+    const bool result = ticket.generation == m_generation && regionContains(m_belowRegion, rc);
+    m_numBelowHits += result;
+    return result;
+}
+
+bool KisGroupCompositionCache::aboveContains(const Ticket &ticket, const QRect &rc) const
+{
+    QMutexLocker l(&m_lock);
+    const bool result = ticket.generation == m_generation && regionContains(m_aboveRegion, rc);
+    m_numAboveHits += result;
+    return result;
+}
+
+void KisGroupCompositionCache::commitBelow(const Ticket &ticket, const QRect &rc)
+{
+    QMutexLocker l(&m_lock);
+    if (ticket.generation != m_generation) return;
+
+    m_belowRegion += rc;
+}
+
+void KisGroupCompositionCache::commitAbove(const Ticket &ticket, const QRect &rc)
+{
+    QMutexLocker l(&m_lock);
+    if (ticket.generation != m_generation) return;
+
+    m_aboveRegion += rc;
+}
+
+void KisGroupCompositionCache::invalidate(const QRect &rc)
+{
+    QMutexLocker l(&m_lock);
+
+    m_belowRegion -= rc;
+    m_aboveRegion -= rc;
+}
+
+void KisGroupCompositionCache::reset()
+{
+    QMutexLocker l(&m_lock);
+
+    if (!m_activeChild && !m_belowDevice) return;
+
+    resetImpl();
+    m_activeChild = nullptr;
+    m_graphSequenceNumber = -1;
+}
+
+void KisGroupCompositionCache::resetImpl()
+{
+    m_generation++;
+
+    m_belowRegion = QRegion();
+    m_aboveRegion = QRegion();
+
+    m_belowDevice = nullptr;
+    m_aboveDevice = nullptr;
+}
+
+QRegion KisGroupCompositionCache::testingBelowRegion() const
+{
+    QMutexLocker l(&m_lock);
+    return m_belowRegion;
+}
+
+QRegion KisGroupCompositionCache::testingAboveRegion() const
+{
+    QMutexLocker l(&m_lock);
+    return m_aboveRegion;
+}
+
+int KisGroupCompositionCache::testingNumBelowHits() const
+{
+    QMutexLocker l(&m_lock);
+    return m_numBelowHits;
+}
+
+int KisGroupCompositionCache::testingNumAboveHits() const
+{
+    QMutexLocker l(&m_lock);
+    return m_numAboveHits;
+}
@@ -0,0 +1,133 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISGROUPCOMPOSITIONCACHE_H
+#define KISGROUPCOMPOSITIONCACHE_H
+
+#include <QMutex>
+#include <QRegion>
+
+#include "kis_types.h"
+#include "kritaimage_export.h"
+
+
+/**
+ * Keeps the partial composition of the children of a group layer
+ * around the child that is being changed at the moment (the "active"
+ * child). When the user paints on a layer in a group with hundreds of
+ * children, every update of the group recomposites all of them, even
+ * though only one child has actually changed. With this cache
+ * KisAsyncMerger composites only three planes instead:
+ *
+ * 1) the "below" plane: the composition of all the children below
+ *    the active one (including the default color of the group);
+ *
+ * 2) the active child itself;
+ *
+ * 3) the "above" plane: the children above the active one composited
+ *    onto a transparent device. Normal blending is associative, so
+ *    this plane can be used only when all the children above are
+ *    plain layers with COMPOSITE_OVER, no layer styles, no channel
+ *    flags and nothing depending on the lower nodes. The result may
+ *    differ from the direct composition by a rounding error.
+ *
+ * The cache is bound to the active child and to the graph sequence
+ * number of the image. As soon as a walker updates the group because
+ * of some other child, or the structure of the image changes, all the
+ * cached data is dropped. The updates that don't have a single active
+ * child (e.g. full refreshes) drop the cached data in their rects only.
+ *
+ * The cache is filled and read by concurrent merge jobs. The jobs never
+ * access the same area of the group at the same time, so only the
+ * bookkeeping needs to be guarded. When the cache is reset, the old
+ * devices are not touched anymore, the jobs that still use them write
+ * into the stale devices and their results are discarded.
+ */
+class KRITAIMAGE_EXPORT KisGroupCompositionCache
+{
+public:
+    /**
+     * The state of the cache as seen by a single merge job
+     */
+    struct Ticket {
+        KisPaintDeviceSP belowDevice;
+        KisPaintDeviceSP aboveDevice;
+        int generation = -1;
+
+        bool isValid() const {
+            return generation >= 0;
+        }
+    };
+
+public:
+    KisGroupCompositionCache();
+    ~KisGroupCompositionCache();
+
+    /**
+     * Binds the cache to \p activeChild and returns the devices the job
+     * should use. If the cache was bound to some other child, or the graph,
+     * the color space or the geometry of \p original have changed since,
+     * the cached data is dropped.
+     */
+    Ticket acquire(KisNodeSP activeChild, int graphSequenceNumber, KisPaintDeviceSP original);
+
+    bool belowContains(const Ticket &ticket, const QRect &rc) const;
+    bool aboveContains(const Ticket &ticket, const QRect &rc) const;
+
+    /**
+     * Marks \p rc of the corresponding device as filled by the job.
+     * Does nothing if the cache has been reset after the ticket was
+     * acquired.
+     */
+    void commitBelow(const Ticket &ticket, const QRect &rc);
+    void commitAbove(const Ticket &ticket, const QRect &rc);
+
+    /**
+     * Drops the cached data in \p rc
+     */
+    void invalidate(const QRect &rc);
+
+    /**
+     * Drops all the cached data and frees the devices
+     */
+    void reset();
+
+    /**
+     * The size of the valid areas of the cache, for testing purposes
+     */
+    QRegion testingBelowRegion() const;
+    QRegion testingAboveRegion() const;
+
+    /**
+     * The number of lookups that found the cached planes valid,
+     * for testing purposes
+     */
+    int testingNumBelowHits() const;
+    int testingNumAboveHits() const;
+
+private:
+    void resetImpl();
+
+private:
+    Q_DISABLE_COPY(KisGroupCompositionCache)
+
+    mutable QMutex m_lock;
+
+    const KisNode *m_activeChild = nullptr;
+    int m_graphSequenceNumber = -1;
+    int m_generation = 0;
+
+    KisPaintDeviceSP m_belowDevice;
+    KisPaintDeviceSP m_aboveDevice;
+
+    QRegion m_belowRegion;
+    QRegion m_aboveRegion;
+
+    mutable int m_numBelowHits = 0;
+    mutable int m_numAboveHits = 0;
+};
+
+#endif // KISGROUPCOMPOSITIONCACHE_H
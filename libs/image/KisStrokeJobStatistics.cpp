@@ -0,0 +1,140 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisStrokeJobStatistics.h"
+
+#include <QDebug>
+
+
+namespace {
+
+/**
+ * The weight of the newest sample in the running average is 1/8,
+ * so the average follows the changes of the brush in a few dabs
+ */
+const int AVERAGE_DURATION_SMOOTHING = 8;
+
+template <int N>
+QVector<qint64> loadHistogram(const std::atomic<qint64> (&buckets)[N])
+{
+    QVector<qint64> result(N);
+
+    for (int i = 0; i < N; i++) {
+        result[i] = buckets[i].load(std::memory_order_relaxed);
+    }
+
+    return result;
+}
+
+}
+
+KisStrokeJobStatistics::KisStrokeJobStatistics()
+{
+    for (int i = 0; i < NumDurationBuckets; i++) {
+        m_durationBuckets[i] = 0;
+    }
+
+    for (int i = 0; i < NumBatchSizeBuckets; i++) {
+        m_batchSizeBuckets[i] = 0;
+    }
+}
+
+void KisStrokeJobStatistics::addJobDuration(qint64 nsecs)
+{
+    nsecs = qMax(qint64(0), nsecs);
+
+    qint64 usecs = nsecs / 1000;
+    int bucket = 0;
+
+    while (usecs > 1 && bucket < NumDurationBuckets - 1) {
+        usecs >>= 1;
+        bucket++;
+    }
+
+    m_durationBuckets[bucket].fetch_add(1, std::memory_order_relaxed);
+
+    qint64 average = m_averageJobDuration.load(std::memory_order_relaxed);
+    qint64 newAverage = 0;
+
+    do {
+        newAverage = average < 0 ?
+            nsecs : average + (nsecs - average) / AVERAGE_DURATION_SMOOTHING;
+    } while (!m_averageJobDuration.compare_exchange_weak(average, newAverage,
+                                                         std::memory_order_relaxed));
+}
+
+void KisStrokeJobStatistics::addBatch(int size)
+{
+    const int bucket = qBound(0, size - 1, NumBatchSizeBuckets - 1);
+    m_batchSizeBuckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+qint64 KisStrokeJobStatistics::averageJobDuration() const
+{
+    return m_averageJobDuration.load(std::memory_order_relaxed);
+}
+
+qint64 KisStrokeJobStatistics::numJobs() const
+{
+    qint64 result = 0;
+
+    for (int i = 0; i < NumDurationBuckets; i++) {
+        result += m_durationBuckets[i].load(std::memory_order_relaxed);
+    }
+
+    return result;
+}
+
+qint64 KisStrokeJobStatistics::numBatches() const
+{
+    qint64 result = 0;
+
+    for (int i = 0; i < NumBatchSizeBuckets; i++) {
+        result += m_batchSizeBuckets[i].load(std::memory_order_relaxed);
+    }
+
+    return result;
+}
+
+QVector<qint64> KisStrokeJobStatistics::durationHistogram() const
+{
+    return loadHistogram(m_durationBuckets);
+}
+
+QVector<qint64> KisStrokeJobStatistics::batchSizeHistogram() const
+{
+    return loadHistogram(m_batchSizeBuckets);
+}
+
+QDebug operator<<(QDebug dbg, const KisStrokeJobStatistics &stats)
+{
+    QDebugStateSaver saver(dbg);
+    dbg.nospace();
+
+    dbg << "KisStrokeJobStatistics(jobs: " << stats.numJobs()
+        << ", batches: " << stats.numBatches()
+        << ", avg: " << stats.averageJobDuration() / 1000 << "us";
+
+    const QVector<qint64> durations = stats.durationHistogram();
+
+    dbg << ", durations:";
+    for (int i = 0; i < durations.size(); i++) {
+        if (!durations[i]) continue;
+        dbg << " " << (i ? (1 << i) : 0) << "us: " << durations[i];
+    }
+
+    const QVector<qint64> batchSizes = stats.batchSizeHistogram();
+
+    dbg << ", batch sizes:";
+    for (int i = 0; i < batchSizes.size(); i++) {
+        if (!batchSizes[i]) continue;
+        dbg << " " << i + 1 << ": " << batchSizes[i];
+    }
+
+    dbg << ")";
+
+    return dbg;
+}
@@ -0,0 +1,74 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSTROKEJOBSTATISTICS_H
+#define KISSTROKEJOBSTATISTICS_H
+
+#include <atomic>
+
+#include <QtGlobal>
+#include <QVector>
+
+#include "kritaimage_export.h"
+
+class QDebug;
+
+
+/**
+ * Collects the execution times of the jobs of a single stroke and the
+ * sizes of the batches the jobs were executed in (see
+ * KisStroke::popJobBatch()). The execution times are reported by the
+ * worker threads, so all the counters are atomic.
+ *
+ * The running average of the execution time is used as the "size" of
+ * the next job when the strokes queue decides how many jobs it should
+ * batch together.
+ */
+class KRITAIMAGE_EXPORT KisStrokeJobStatistics
+{
+public:
+    /**
+     * Bucket \c i of the duration histogram counts the jobs that took
+     * [2^i, 2^(i+1)) microseconds, the first bucket also counts the
+     * jobs shorter than a microsecond, the last one all the longer jobs.
+     */
+    static const int NumDurationBuckets = 16;
+
+    /**
+     * Bucket \c i of the batch size histogram counts the batches of
+     * size i + 1, the last one also counts all the bigger batches.
+     */
+    static const int NumBatchSizeBuckets = 32;
+
+public:
+    KisStrokeJobStatistics();
+
+    void addJobDuration(qint64 nsecs);
+    void addBatch(int size);
+
+    /**
+     * The exponential moving average of the execution time of the
+     * jobs in nanoseconds or -1 if no job has finished yet
+     */
+    qint64 averageJobDuration() const;
+
+    qint64 numJobs() const;
+    qint64 numBatches() const;
+
+    QVector<qint64> durationHistogram() const;
+    QVector<qint64> batchSizeHistogram() const;
+
+private:
+    Q_DISABLE_COPY(KisStrokeJobStatistics)
+
+    std::atomic<qint64> m_averageJobDuration {-1};
+    std::atomic<qint64> m_durationBuckets[NumDurationBuckets];
+    std::atomic<qint64> m_batchSizeBuckets[NumBatchSizeBuckets];
+};
+
+KRITAIMAGE_EXPORT QDebug operator<<(QDebug dbg, const KisStrokeJobStatistics &stats);
+
+#endif // KISSTROKEJOBSTATISTICS_H
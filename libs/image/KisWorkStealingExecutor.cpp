@@ -0,0 +1,305 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisWorkStealingExecutor.h"
+
+#include <atomic>
+#include <deque>
+
+#include <QMutex>
+#include <QRunnable>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+
+struct KisWorkStealingExecutor::Private
+{
+    int maxThreadCount = 1;
+
+    QMutex workersLock;
+    std::atomic<bool> workersStarted {false};
+    QVector<Worker*> workers;
+    std::atomic<int> nextWorker {0};
+
+    /**
+     * The sleeping workers check numQueuedJobs after registering
+     * themselves in numSleepingWorkers and the producer checks
+     * numSleepingWorkers after incrementing numQueuedJobs. Both
+     * the operations are sequentially consistent, so at least
+     * one of the sides sees the change of the other one and
+     * the wakeup is never lost.
+     */
+    std::atomic<int> numQueuedJobs {0};
+    std::atomic<int> numSleepingWorkers {0};
+    QMutex sleepLock;
+    QWaitCondition wakeCondition;
+    bool stopFlag = false;
+
+    std::atomic<int> numPendingJobs {0};
+    QMutex doneLock;
+    QWaitCondition doneCondition;
+
+    std::atomic<qint64> numStartedJobs {0};
+
+    static thread_local Worker *currentWorker;
+
+    void startWorkers();
+    void stopWorkers();
+
+    bool steal(Worker *thief, QRunnable *&job);
+    void runJob(QRunnable *job);
+};
+
+thread_local KisWorkStealingExecutor::Worker *KisWorkStealingExecutor::Private::currentWorker = nullptr;
+
+
+struct KisWorkStealingExecutor::Worker : public QThread
+{
+    Worker(KisWorkStealingExecutor::Private *_d, int _index)
+        : d(_d),
+          index(_index)
+    {
+        setObjectName(QString("KisWorkStealingExecutor worker %1").arg(index));
+    }
+
+    void run() override {
+        Private::currentWorker = this;
+
+        while (true) {
+            QRunnable *job = 0;
+
+            if (popBack(job)) {
+                numLocalJobs++;
+            } else if (d->steal(this, job)) {
+                numStolenJobs++;
+            }
+
+            if (job) {
+                d->numQueuedJobs--;
+                d->runJob(job);
+                continue;
+            }
+
+            QMutexLocker l(&d->sleepLock);
+
+            if (d->stopFlag) break;
+
+            d->numSleepingWorkers++;
+            if (!d->numQueuedJobs) {
+                d->wakeCondition.wait(&d->sleepLock);
+            }
+            d->numSleepingWorkers--;
+        }
+
+        Private::currentWorker = nullptr;
+    }
+
+    void push(QRunnable *job) {
+        QMutexLocker l(&lock);
+        jobs.push_back(job);
+
+        if (int(jobs.size()) > maxQueueDepth) {
+            maxQueueDepth = jobs.size();
+        }
+    }
+
+    bool popBack(QRunnable *&job) {
+        QMutexLocker l(&lock);
+        if (jobs.empty()) return false;
+
+        job = jobs.back();
+        jobs.pop_back();
+        return true;
+    }
+
+    bool popFront(QRunnable *&job) {
+        QMutexLocker l(&lock);
+        if (jobs.empty()) return false;
+
+        job = jobs.front();
+        jobs.pop_front();
+        return true;
+    }
+
+    Private * const d;
+    const int index;
+
+    QMutex lock;
+    std::deque<QRunnable*> jobs;
+    std::atomic<int> maxQueueDepth {0};
+
+    std::atomic<qint64> numLocalJobs {0};
+    std::atomic<qint64> numStolenJobs {0};
+};
+
+
+void KisWorkStealingExecutor::Private::startWorkers()
+{
+    QMutexLocker l(&workersLock);
+    if (workersStarted) return;
+
+    for (int i = 0; i < maxThreadCount; i++) {
+        Worker *worker = new Worker(this, i);
+        workers.append(worker);
+    }
+
+    Q_FOREACH (Worker *worker, workers) {
+        worker->start();
+    }
+
+    workersStarted = true;
+}
+
+void KisWorkStealingExecutor::Private::stopWorkers()
+{
+    QMutexLocker l(&workersLock);
+    if (!workersStarted) return;
+
+    {
+        QMutexLocker sleepLocker(&sleepLock);
+        stopFlag = true;
+        wakeCondition.wakeAll();
+    }
+
+    Q_FOREACH (Worker *worker, workers) {
+        worker->wait();
+        delete worker;
+    }
+
+    workers.clear();
+    stopFlag = false;
+    workersStarted = false;
+}
+
+bool KisWorkStealingExecutor::Private::steal(Worker *thief, QRunnable *&job)
+{
+    const int numWorkers = workers.size();
+
+    for (int i = 1; i < numWorkers; i++) {
+        Worker *victim = workers[(thief->index + i) % numWorkers];
+        if (victim->popFront(job)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void KisWorkStealingExecutor::Private::runJob(QRunnable *job)
+{
+    const bool autoDelete = job->autoDelete();
+
+    job->run();
+
+    if (autoDelete) {
+        delete job;
+    }
+
+    if (numPendingJobs.fetch_sub(1) == 1) {
+        QMutexLocker l(&doneLock);
+        doneCondition.wakeAll();
+    }
+}
+
+
+KisWorkStealingExecutor::KisWorkStealingExecutor(int threadCount)
+    : m_d(new Private)
+{
+    setMaxThreadCount(threadCount);
+}
+
+KisWorkStealingExecutor::~KisWorkStealingExecutor()
+{
+    waitForDone();
+    m_d->stopWorkers();
+}
+
+void KisWorkStealingExecutor::setMaxThreadCount(int value)
+{
+    /**
+     * The jobs might still be finishing their loops,
+     * even though they have already reported being done
+     */
+    waitForDone();
+
+    m_d->stopWorkers();
+    m_d->maxThreadCount = qMax(1, value);
+}
+
+int KisWorkStealingExecutor::maxThreadCount() const
+{
+    return m_d->maxThreadCount;
+}
+
+void KisWorkStealingExecutor::start(QRunnable *runnable)
+{
+    /**
+     * The workers are started lazily, since many updater
+     * contexts (e.g. in unit tests) never run anything
+     */
+    if (!m_d->workersStarted) {
+        m_d->startWorkers();
+    }
+
+    m_d->numPendingJobs++;
+    m_d->numStartedJobs++;
+
+    Worker *worker = Private::currentWorker;
+
+    if (!worker || worker->d != m_d.data()) {
+        const int index = m_d->nextWorker.fetch_add(1, std::memory_order_relaxed);
+        worker = m_d->workers[(index & 0x7fffffff) % m_d->workers.size()];
+    }
+
+    worker->push(runnable);
+    m_d->numQueuedJobs++;
+
+    if (m_d->numSleepingWorkers > 0) {
+        QMutexLocker l(&m_d->sleepLock);
+        m_d->wakeCondition.wakeOne();
+    }
+}
+
+void KisWorkStealingExecutor::waitForDone()
+{
+    QMutexLocker l(&m_d->doneLock);
+
+    while (m_d->numPendingJobs > 0) {
+        m_d->doneCondition.wait(&m_d->doneLock);
+    }
+}
+
+KisWorkStealingExecutor::Statistics KisWorkStealingExecutor::statistics() const
+{
+    Statistics stats;
+
+    QMutexLocker l(&m_d->workersLock);
+
+    stats.numStartedJobs = m_d->numStartedJobs;
+    stats.queueDepth = m_d->numQueuedJobs;
+
+    Q_FOREACH (Worker *worker, m_d->workers) {
+        stats.numLocalJobs += worker->numLocalJobs;
+        stats.numStolenJobs += worker->numStolenJobs;
+        stats.maxQueueDepth = qMax(stats.maxQueueDepth, worker->maxQueueDepth.load());
+    }
+
+    return stats;
+}
+
+void KisWorkStealingExecutor::resetStatistics()
+{
+    QMutexLocker l(&m_d->workersLock);
+
+    m_d->numStartedJobs = 0;
+
+    Q_FOREACH (Worker *worker, m_d->workers) {
+        worker->numLocalJobs = 0;
+        worker->numStolenJobs = 0;
+        worker->maxQueueDepth = 0;
+    }
+}
@@ -0,0 +1,91 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISWORKSTEALINGEXECUTOR_H
+#define KISWORKSTEALINGEXECUTOR_H
+
+#include <QtGlobal>
+#include <QScopedPointer>
+
+#include "kritaimage_export.h"
+
+class QRunnable;
+
+
+/**
+ * A thread pool for the jobs of KisUpdaterContext. Unlike QThreadPool,
+ * which keeps all the jobs in a single queue guarded by a global lock,
+ * every worker thread owns a separate deque of jobs:
+ *
+ * 1) A job started from a worker thread (e.g. when a finished update
+ *    job asks the scheduler for more work) is pushed into the deque of
+ *    this very worker, which is not touched by anyone else usually.
+ *
+ * 2) A job started from any other thread is put into the deques in
+ *    a round-robin manner.
+ *
+ * 3) The worker takes the jobs from the back of its own deque (the
+ *    most recent job, with the hottest caches) and, when it is empty,
+ *    steals the oldest job from the front of the deque of some other
+ *    worker.
+ *
+ * The idle workers sleep on a wait condition, which is signalled only
+ * when there is at least one sleeping worker, so the producer doesn't
+ * touch any global lock while all the workers are busy.
+ *
+ * The executor respects QRunnable::autoDelete() the same way QThreadPool
+ * does.
+ */
+class KRITAIMAGE_EXPORT KisWorkStealingExecutor
+{
+public:
+    struct Statistics {
+        /// The total number of jobs started in the executor
+        qint64 numStartedJobs = 0;
+
+        /// The number of jobs executed by the worker that owned them
+        qint64 numLocalJobs = 0;
+
+        /// The number of jobs stolen from the deques of other workers
+        qint64 numStolenJobs = 0;
+
+        /// The number of jobs waiting in all the deques at the moment
+        int queueDepth = 0;
+
+        /// The highest number of jobs ever seen waiting in a single deque
+        int maxQueueDepth = 0;
+    };
+
+public:
+    KisWorkStealingExecutor(int threadCount);
+    ~KisWorkStealingExecutor();
+
+    /**
+     * Changes the number of the worker threads. Waits for all the
+     * started jobs to finish first, so it must not be called from
+     * inside a job.
+     */
+    void setMaxThreadCount(int value);
+    int maxThreadCount() const;
+
+    void start(QRunnable *runnable);
+
+    /**
+     * Blocks until all the started jobs are finished
+     */
+    void waitForDone();
+
+    Statistics statistics() const;
+    void resetStatistics();
+
+private:
+    struct Worker;
+    friend struct Worker;
+
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISWORKSTEALINGEXECUTOR_H
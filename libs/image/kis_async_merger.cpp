@@ -27,6 +27,7 @@
 #include "kis_clone_layer.h"
 #include "kis_processing_information.h"
 #include "kis_busy_progress_indicator.h"
+#include "kis_update_time_monitor.h"
 
 
 #include "kis_merge_walker.h"
@@ -110,6 +111,7 @@ public:
             layer->busyProgressIndicator()->update();
 
             // We do not create a transaction here, as srcDevice != dstDevice
+            KisUpdateTimeMonitor::TraceSpan span("filter", layer, filterRect);
             filter->process(m_projection, dstDevice, 0, filterRect, filterConfig.data(), 0);
         }
 
@@ -175,6 +177,10 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 
     const bool useTempProjections = walker.needRectVaries();
 
+    // don't touch the refcounts of the nodes, when not tracing
+    KisUpdateTimeMonitor *timeMonitor = KisUpdateTimeMonitor::instance();
+    const bool isTracingEnabled = timeMonitor && timeMonitor->isTracingEnabled();
+
     while(!leafStack.isEmpty()) {
         KisMergeWalker::JobItem item = leafStack.pop();
         KisProjectionLeafSP currentLeaf = item.m_leaf;
@@ -192,6 +198,10 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 
         QRect applyRect = item.m_applyRect;
 
+        KisUpdateTimeMonitor::TraceSpan span("composite",
+                                             isTracingEnabled ? currentLeaf->node().data() : nullptr,
+                                             applyRect);
+
         if (currentLeaf->isRoot()) {
             currentLeaf->projectionPlane()->recalculate(applyRect, walker.startNode(), item.m_renderFlags);
             continue;
@@ -212,6 +222,10 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 
         if (!m_currentProjection) {
             setupProjection(currentLeaf, applyRect, useTempProjections);
+
+            if (m_currentProjection) {
+                setupCompositionCache(walker, item);
+            }
         }
 
         KisUpdateOriginalVisitor originalVisitor(applyRect,
@@ -244,7 +258,7 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
             /* nothing to do */
         }
 
-        compositeWithProjection(currentLeaf, applyRect);
+        compositeWithCompositionCache(currentLeaf, applyRect);
 
         if(item.m_position & KisMergeWalker::N_TOPMOST) {
             writeProjection(currentLeaf, useTempProjections, applyRect);
@@ -273,6 +287,211 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 void KisAsyncMerger::resetProjection() {
     m_currentProjection = 0;
     m_finalProjection = 0;
+    m_cacheState = CompositionCacheState();
+}
+
+void KisAsyncMerger::setUseGroupCompositionCache(bool value)
+{
+    m_useGroupCompositionCache = value;
+}
+
+namespace {
+
+/**
+ * The above-plane of the composition cache is valid only when
+ * the layers can be pre-composited without the lower ones
+ */
+bool canBePrecomposited(KisProjectionLeafSP leaf)
+{
+    if (leaf->dependsOnLowerNodes()) return false;
+    if (leaf->layerStyle()) return false;
+
+    const QBitArray channelFlags = leaf->channelFlags();
+    if (!channelFlags.isEmpty() && channelFlags.count(true) != channelFlags.size()) return false;
+
+    KisLayer *layer = qobject_cast<KisLayer*>(leaf->node().data());
+    if (!layer || layer->compositeOpId() != COMPOSITE_OVER) return false;
+
+    KisGroupLayer *group = qobject_cast<KisGroupLayer*>(layer);
+    if (group && group->passThroughMode()) return false;
+
+    return true;
+}
+
+}
+
+void KisAsyncMerger::setupCompositionCache(KisBaseRectsWalker &walker, const KisBaseRectsWalker::JobItem &firstItem)
+{
+    m_cacheState = CompositionCacheState();
+
+    /**
+     * LodN planes are short-living, don't cache them
+     */
+    if (walker.levelOfDetail() > 0) return;
+
+    KisProjectionLeafSP parentLeaf = firstItem.m_leaf->parent();
+    KisGroupLayer *group = parentLeaf ? qobject_cast<KisGroupLayer*>(parentLeaf->node().data()) : 0;
+    if (!group) return;
+
+    KisGroupCompositionCache *cache = group->compositionCache();
+
+    if (!m_useGroupCompositionCache || group->passThroughMode()) {
+        cache->reset();
+        return;
+    }
+
+    /**
+     * The first child of the group has already been popped from
+     * the stack, the rest of the children are on its top
+     */
+    const KisMergeWalker::LeafStack &leafStack = walker.leafStack();
+
+    QVector<const KisMergeWalker::JobItem*> items;
+    items.append(&firstItem);
+
+    if (!(firstItem.m_position & KisMergeWalker::N_TOPMOST)) {
+        for (int i = leafStack.size() - 1; i >= 0; i--) {
+            items.append(&leafStack[i]);
+            if (leafStack[i].m_position & KisMergeWalker::N_TOPMOST) break;
+        }
+    }
+
+    /**
+     * The cache can be used only when there is exactly one changed
+     * child, everything below it is N_BELOW_FILTHY and everything
+     * above it is N_ABOVE_FILTHY. Any other update (e.g. a full
+     * refresh) may change any child, so it invalidates the cache.
+     */
+    int filthyIndex = -1;
+    bool isRegular = true;
+    QRect levelRect;
+
+    for (int i = 0; i < items.size(); i++) {
+        const KisMergeWalker::NodePosition position = items[i]->m_position;
+        levelRect |= items[i]->m_applyRect;
+
+        if (position & KisMergeWalker::N_EXTRA) {
+            isRegular = false;
+        } else if (position & (KisMergeWalker::N_FILTHY | KisMergeWalker::N_FILTHY_PROJECTION)) {
+            isRegular &= filthyIndex < 0;
+            filthyIndex = i;
+        } else if (position & KisMergeWalker::N_BELOW_FILTHY) {
+            isRegular &= filthyIndex < 0;
+        } else if (position & KisMergeWalker::N_ABOVE_FILTHY) {
+            isRegular &= filthyIndex >= 0;
+        } else {
+            isRegular = false;
+        }
+    }
+
+    if (!isRegular || filthyIndex < 0) {
+        cache->invalidate(levelRect);
+        return;
+    }
+
+    CompositionCacheState &state = m_cacheState;
+
+    state.cache = cache;
+    state.ticket = cache->acquire(items[filthyIndex]->m_leaf->node(),
+                                  group->graphSequenceNumber(),
+                                  m_finalProjection);
+
+    state.numBelowLeaves = filthyIndex;
+    state.numAboveLeaves = items.size() - filthyIndex - 1;
+
+    if (state.numBelowLeaves > 0) {
+        bool rectsMatch = true;
+        state.belowRect = items.first()->m_applyRect;
+
+        for (int i = 1; i < filthyIndex; i++) {
+            rectsMatch &= items[i]->m_applyRect == state.belowRect;
+        }
+
+        if (rectsMatch) {
+            state.useBelow = cache->belowContains(state.ticket, state.belowRect);
+            state.storeBelow = !state.useBelow;
+        }
+    }
+
+    if (state.numAboveLeaves > 0) {
+        bool canUseAbove = true;
+        state.aboveRect = items[filthyIndex + 1]->m_applyRect;
+
+        for (int i = filthyIndex + 1; i < items.size(); i++) {
+            canUseAbove &=
+                items[i]->m_applyRect == state.aboveRect &&
+                canBePrecomposited(items[i]->m_leaf);
+        }
+
+        if (canUseAbove) {
+            state.useAbove = cache->aboveContains(state.ticket, state.aboveRect);
+            state.storeAbove = !state.useAbove;
+        }
+    }
+}
+
+void KisAsyncMerger::compositeWithCompositionCache(KisProjectionLeafSP leaf, const QRect &rect)
+{
+    CompositionCacheState &state = m_cacheState;
+
+    if (!state.cache || !m_currentProjection) {
+        compositeWithProjection(leaf, rect);
+        return;
+    }
+
+    const int index = state.currentIndex++;
+
+    if (index < state.numBelowLeaves) {
+        if (state.useBelow) {
+            if (index == 0) {
+                KisPainter::copyAreaOptimized(state.belowRect.topLeft(),
+                                              state.ticket.belowDevice,
+                                              m_currentProjection,
+                                              state.belowRect);
+                DEBUG_NODE_ACTION("Using cached composition", "N_BELOW_FILTHY", leaf->parent(), state.belowRect);
+            }
+        } else {
+            compositeWithProjection(leaf, rect);
+
+            if (state.storeBelow && index == state.numBelowLeaves - 1) {
+                KisPainter::copyAreaOptimized(state.belowRect.topLeft(),
+                                              m_currentProjection,
+                                              state.ticket.belowDevice,
+                                              state.belowRect);
+                state.cache->commitBelow(state.ticket, state.belowRect);
+            }
+        }
+    } else if (index == state.numBelowLeaves) {
+        compositeWithProjection(leaf, rect);
+    } else {
+        const int aboveIndex = index - state.numBelowLeaves - 1;
+
+        if (state.useAbove) {
+            if (aboveIndex == 0) {
+                KisPainter gc(m_currentProjection);
+                gc.setCompositeOpId(COMPOSITE_OVER);
+                gc.bitBlt(state.aboveRect.topLeft(), state.ticket.aboveDevice, state.aboveRect);
+                DEBUG_NODE_ACTION("Using cached composition", "N_ABOVE_FILTHY", leaf->parent(), state.aboveRect);
+            }
+        } else {
+            compositeWithProjection(leaf, rect);
+
+            if (state.storeAbove) {
+                if (aboveIndex == 0) {
+                    state.ticket.aboveDevice->clear(state.aboveRect);
+                }
+
+                if (leaf->visible()) {
+                    KisPainter gc(state.ticket.aboveDevice);
+                    leaf->projectionPlane()->apply(&gc, rect);
+                }
+
+                if (aboveIndex == state.numAboveLeaves - 1) {
+                    state.cache->commitAbove(state.ticket, state.aboveRect);
+                }
+            }
+        }
+    }
 }
 
 void KisAsyncMerger::setupProjection(KisProjectionLeafSP currentLeaf, const QRect& rect, bool useTempProjection) {
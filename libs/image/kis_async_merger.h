@@ -9,15 +9,48 @@
 #include "kritaimage_export.h"
 #include "kis_types.h"
 #include "KisRenderPassFlags.h"
+#include "KisGroupCompositionCache.h"
+#include "kis_base_rects_walker.h"
 
 class QRect;
-class KisBaseRectsWalker;
 
 class KRITAIMAGE_EXPORT KisAsyncMerger
 {
 public:
     void startMerge(KisBaseRectsWalker &walker, bool notifyClones = true);
 
+    /**
+     * Make the merger use and fill the composition caches of the
+     * group layers, \see KisGroupCompositionCache. When disabled,
+     * the merger drops the caches of the groups it updates.
+     */
+    void setUseGroupCompositionCache(bool value);
+
+private:
+    /**
+     * The way the children of the group being composited at the
+     * moment use the composition cache of the group
+     */
+    struct CompositionCacheState {
+        KisGroupCompositionCache *cache = nullptr;
+        KisGroupCompositionCache::Ticket ticket;
+
+        int numBelowLeaves = 0;
+        int numAboveLeaves = 0;
+        int currentIndex = 0;
+
+        QRect belowRect;
+        bool useBelow = false;
+        bool storeBelow = false;
+
+        QRect aboveRect;
+        bool useAbove = false;
+        bool storeAbove = false;
+    };
+
+    void setupCompositionCache(KisBaseRectsWalker &walker, const KisBaseRectsWalker::JobItem &firstItem);
+    void compositeWithCompositionCache(KisProjectionLeafSP leaf, const QRect &rect);
+
 private:
     inline void resetProjection();
     inline void setupProjection(KisProjectionLeafSP currentLeaf, const QRect& rect, bool useTempProjection);
@@ -50,6 +83,9 @@ private:
      * setupProjection()
      */
     KisPaintDeviceSP m_cachedPaintDevice;
+
+    bool m_useGroupCompositionCache = false;
+    CompositionCacheState m_cacheState;
 };
 
 
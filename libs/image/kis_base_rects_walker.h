@@ -192,6 +192,19 @@ public:
         return m_cropRect;
     }
 
+    /**
+     * The moment the walker has been put into the update queue,
+     * measured by the clock of the queue. Used for deciding how
+     * long the walker may be deferred.
+     */
+    inline void setEnqueueTime(qint64 value) {
+        m_enqueueTime = value;
+    }
+
+    inline qint64 enqueueTime() const {
+        return m_enqueueTime;
+    }
+
     // return a reference for efficiency reasons
     inline LeafStack& leafStack() {
         return m_mergeTask;
@@ -537,6 +550,8 @@ private:
     int m_levelOfDetail {0};
 
     bool m_clonesDontInvalidateFrames {false};
+
+    qint64 m_enqueueTime {0};
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(KisBaseRectsWalker::SubtreeVisitFlags);
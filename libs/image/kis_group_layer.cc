@@ -27,6 +27,7 @@
 #include "kis_layer_properties_icons.h"
 #include <kis_projection_leaf.h>
 #include <kis_abstract_projection_plane.h>
+#include "KisGroupCompositionCache.h"
 
 
 struct Q_DECL_HIDDEN KisGroupLayer::Private
@@ -44,6 +45,7 @@ public:
     qint32 x;
     qint32 y;
     bool passThroughMode;
+    mutable KisGroupCompositionCache compositionCache;
 
     std::tuple<KisPaintDeviceSP, bool> originalImpl() const;
 };
@@ -209,6 +211,8 @@ void KisGroupLayer::resetCache(const KoColorSpace *colorSpace)
 
         m_d->paintDevice->clear();
     }
+
+    m_d->compositionCache.reset();
 }
 
 KisLayer* KisGroupLayer::onlyMeaningfulChild() const
@@ -322,6 +326,11 @@ bool KisGroupLayer::passThroughMode() const
     return m_d->passThroughMode;
 }
 
+KisGroupCompositionCache* KisGroupLayer::compositionCache() const
+{
+    return &m_d->compositionCache;
+}
+
 void KisGroupLayer::setPassThroughMode(bool value)
 {
     if (m_d->passThroughMode == value) return;
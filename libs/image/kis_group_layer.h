@@ -11,6 +11,7 @@
 #include "kis_types.h"
 
 class KoColorSpace;
+class KisGroupCompositionCache;
 
 /**
  * A KisLayer that bundles child layers into a single layer.
@@ -97,6 +98,12 @@ public:
     bool passThroughMode() const;
     void setPassThroughMode(bool value);
 
+    /**
+     * The cache of the partial composition of the children,
+     * used by KisAsyncMerger, \see KisGroupCompositionCache
+     */
+    KisGroupCompositionCache* compositionCache() const;
+
     QRect extent() const override;
     QRect exactBounds() const override;
 
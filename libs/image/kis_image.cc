@@ -280,6 +280,8 @@ public:
     QPointF axesCenter;
     bool allowMasksOnRootNode = false;
 
+    QHash<const QObject*, QRect> canvasViewportRects;
+
     void requestProjectionUpdateImpl(KisNode *node,
                                      const QVector<QRect> &rects,
                                      const QRect &cropRect,
@@ -407,9 +409,9 @@ KisImage *KisImage::clone(bool exactCopy)
     return new KisImage(*this, 0, exactCopy);
 }
 
-void KisImage::copyFromImage(const KisImage &rhs)
+void KisImage::copyFromImage(const KisImage &rhs, bool exactCopy)
 {
-    copyFromImageImpl(rhs, REPLACE);
+    copyFromImageImpl(rhs, REPLACE | (exactCopy ? EXACT_COPY : 0));
 }
 
 void KisImage::copyFromImageImpl(const KisImage &rhs, int policy)
@@ -561,6 +563,14 @@ KisImage::KisImage(const KisImage& rhs, KisUndoStore *undoStore, bool exactCopy)
 {
     // make sure KisImage belongs to the GUI thread
     moveToThread(qApp->thread());
+
+    /**
+     * The copied animation interface is not a child of the image, so
+     * it should be moved separately, otherwise it would stay in the
+     * thread the image has been cloned in (e.g. a stroke worker thread
+     * without an event loop) and lose all its queued signals
+     */
+    m_d->animationInterface->moveToThread(qApp->thread());
     connect(this, SIGNAL(sigInternalStopIsolatedModeRequested()), SLOT(stopIsolatedMode()));
 
     copyFromImageImpl(rhs, CONSTRUCT | (exactCopy ? EXACT_COPY : 0));
@@ -2557,6 +2567,22 @@ KisLodPreferences KisImage::lodPreferences() const
     return m_d->scheduler.lodPreferences();
 }
 
+void KisImage::setCanvasViewportRect(const QObject *canvas, const QRect &rect)
+{
+    if (rect.isEmpty()) {
+        m_d->canvasViewportRects.remove(canvas);
+    } else {
+        m_d->canvasViewportRects.insert(canvas, rect);
+    }
+
+    QVector<QRect> rects;
+    Q_FOREACH (const QRect &rc, m_d->canvasViewportRects) {
+        rects.append(rc);
+    }
+
+    m_d->scheduler.setViewportRects(rects);
+}
+
 void KisImage::nodeCollapsedChanged(KisNode * node)
 {
     Q_UNUSED(node);
@@ -117,7 +117,11 @@ public:
      */
     KisImage *clone(bool exactCopy = false);
 
-    void copyFromImage(const KisImage &rhs);
+    /**
+     * Replaces the layers of the image with copies of the layers
+     * of \p rhs. See clone() for the meaning of \p exactCopy.
+     */
+    void copyFromImage(const KisImage &rhs, bool exactCopy = false);
 
 private:
 
@@ -785,6 +789,16 @@ public:
      */
     KisLodPreferences lodPreferences() const;
 
+    /**
+     * Sets the rect of the image (in image pixels) currently shown by
+     * \p canvas. The projection updates of the visible areas are
+     * processed before the off-screen ones. Pass an empty rect when
+     * the canvas is gone.
+     *
+     * Should be called from the GUI thread only.
+     */
+    void setCanvasViewportRect(const QObject *canvas, const QRect &rect);
+
     KisImageAnimationInterface *animationInterface() const;
 
     /**
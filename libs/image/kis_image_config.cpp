@@ -22,6 +22,7 @@
 #include <QDir>
 
 #include "kis_global.h"
+#include "tiles3/swap/KisMemoryPressureMonitor.h"
 #include <cmath>
 #include <QTemporaryFile>
 
@@ -109,6 +110,50 @@ void KisImageConfig::setUpdatePatchWidth(int value)
     m_config.writeEntry("updatePatchWidth", value);
 }
 
+bool KisImageConfig::splitUpdatesIntoWorkUnits(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("splitUpdatesIntoWorkUnits", false) : false;
+}
+
+void KisImageConfig::setSplitUpdatesIntoWorkUnits(bool value)
+{
+    m_config.writeEntry("splitUpdatesIntoWorkUnits", value);
+}
+
+bool KisImageConfig::prioritizeVisibleUpdates(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("prioritizeVisibleUpdates", true) : true;
+}
+
+void KisImageConfig::setPrioritizeVisibleUpdates(bool value)
+{
+    m_config.writeEntry("prioritizeVisibleUpdates", value);
+}
+
+int KisImageConfig::offscreenUpdatesDeadline(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("offscreenUpdatesDeadline", 1000) : 1000;
+}
+
+void KisImageConfig::setOffscreenUpdatesDeadline(int value)
+{
+    m_config.writeEntry("offscreenUpdatesDeadline", value);
+}
+
+bool KisImageConfig::cacheGroupComposition(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("cacheGroupComposition", false) : false;
+}
+
+void KisImageConfig::setCacheGroupComposition(bool value)
+{
+    m_config.writeEntry("cacheGroupComposition", value);
+}
+
 qreal KisImageConfig::maxCollectAlpha() const
 {
     return m_config.readEntry("maxCollectAlpha", 2.5);
@@ -137,6 +182,28 @@ void KisImageConfig::setSchedulerBalancingRatio(qreal value)
     m_config.writeEntry("schedulerBalancingRatio", value);
 }
 
+int KisImageConfig::maxStrokeJobBatchSize(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("maxStrokeJobBatchSize", 8) : 8;
+}
+
+void KisImageConfig::setMaxStrokeJobBatchSize(int value)
+{
+    m_config.writeEntry("maxStrokeJobBatchSize", value);
+}
+
+int KisImageConfig::strokeJobBatchTargetTime(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("strokeJobBatchTargetTime", 1000) : 1000; // in usec
+}
+
+void KisImageConfig::setStrokeJobBatchTargetTime(int value)
+{
+    m_config.writeEntry("strokeJobBatchTargetTime", value);
+}
+
 int KisImageConfig::maxSwapSize(bool requestDefault) const
 {
     return !requestDefault ?
@@ -168,6 +235,94 @@ void KisImageConfig::setSwapWindowSize(int value)
     m_config.writeEntry("swapWindowSize", value);
 }
 
+QString KisImageConfig::swapCompressionAlgorithm(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("swapCompressionAlgorithm", "LZF") : "LZF";
+}
+
+void KisImageConfig::setSwapCompressionAlgorithm(const QString &value)
+{
+    m_config.writeEntry("swapCompressionAlgorithm", value);
+}
+
+bool KisImageConfig::enableSwapPrefetch(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("enableSwapPrefetch", true) : true;
+}
+
+void KisImageConfig::setEnableSwapPrefetch(bool value)
+{
+    m_config.writeEntry("enableSwapPrefetch", value);
+}
+
+bool KisImageConfig::enableSwapHolePunching(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("enableSwapHolePunching", true) : true;
+}
+
+void KisImageConfig::setEnableSwapHolePunching(bool value)
+{
+    m_config.writeEntry("enableSwapHolePunching", value);
+}
+
+bool KisImageConfig::enableTileDeduplication(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("enableTileDeduplication", true) : true;
+}
+
+void KisImageConfig::setEnableTileDeduplication(bool value)
+{
+    m_config.writeEntry("enableTileDeduplication", value);
+}
+
+bool KisImageConfig::prerenderFilterLodPlanes(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("prerenderFilterLodPlanes", true) : true;
+}
+
+void KisImageConfig::setPrerenderFilterLodPlanes(bool value)
+{
+    m_config.writeEntry("prerenderFilterLodPlanes", value);
+}
+
+bool KisImageConfig::useHugePagesForTileData(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("useHugePagesForTileData", true) : true;
+}
+
+void KisImageConfig::setUseHugePagesForTileData(bool value)
+{
+    m_config.writeEntry("useHugePagesForTileData", value);
+}
+
+bool KisImageConfig::trackSystemMemoryPressure(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("trackSystemMemoryPressure", true) : true;
+}
+
+void KisImageConfig::setTrackSystemMemoryPressure(bool value)
+{
+    m_config.writeEntry("trackSystemMemoryPressure", value);
+}
+
+bool KisImageConfig::useMementoDeltaCompression(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("useMementoDeltaCompression", false) : false;
+}
+
+void KisImageConfig::setUseMementoDeltaCompression(bool value)
+{
+    m_config.writeEntry("useMementoDeltaCompression", value);
+}
+
 int KisImageConfig::tilesHardLimit() const
 {
     qreal hp = qreal(memoryHardLimitPercent()) / 100.0;
@@ -487,6 +642,15 @@ int KisImageConfig::totalRAM()
         warnKrita << "Cannot get the size of your RAM. Using 1 GiB by default.";
     }
 
+    /**
+     * When running inside a container or a systemd slice, the memory
+     * we can actually use is limited by the cgroup, not by the RAM
+     */
+    const qint64 cgroupLimit = KisMemoryPressureMonitor::cgroupMemoryLimit();
+    if (cgroupLimit > 0) {
+        totalMemory = qMin(qint64(totalMemory), cgroupLimit >> 20);
+    }
+
     return totalMemory;
 }
 
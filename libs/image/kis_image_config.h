@@ -31,12 +31,50 @@ public:
     int updatePatchWidth() const;
     void setUpdatePatchWidth(int value);
 
+    /**
+     * @return true if the update queue should split the updates into
+     * tile-aligned work units when there are idle updater threads
+     */
+    bool splitUpdatesIntoWorkUnits(bool requestDefault = false) const;
+    void setSplitUpdatesIntoWorkUnits(bool value);
+
+    /**
+     * @return true if the updates visible on the canvas should be
+     * processed before the off-screen ones
+     */
+    bool prioritizeVisibleUpdates(bool requestDefault = false) const;
+    void setPrioritizeVisibleUpdates(bool value);
+
+    /**
+     * @return the maximum time in milliseconds an off-screen update
+     * may be deferred in favour of the visible ones
+     */
+    int offscreenUpdatesDeadline(bool requestDefault = false) const;
+    void setOffscreenUpdatesDeadline(int value);
+
+    /**
+     * @return true if the group layers should cache the composition
+     * of the children below and above the one being changed
+     */
+    bool cacheGroupComposition(bool requestDefault = false) const;
+    void setCacheGroupComposition(bool value);
+
     qreal maxCollectAlpha() const;
     qreal maxMergeAlpha() const;
     qreal maxMergeCollectAlpha() const;
     qreal schedulerBalancingRatio() const;
     void setSchedulerBalancingRatio(qreal value);
 
+    /**
+     * The limits for executing the consecutive small jobs of a stroke
+     * in a single executor task, see KisStroke::popJobBatch(). The
+     * target time of a batch is in microseconds.
+     */
+    int maxStrokeJobBatchSize(bool requestDefault = false) const;
+    void setMaxStrokeJobBatchSize(int value);
+    int strokeJobBatchTargetTime(bool requestDefault = false) const;
+    void setStrokeJobBatchTargetTime(int value);
+
     int maxSwapSize(bool requestDefault = false) const;
     void setMaxSwapSize(int value);
 
@@ -46,6 +84,66 @@ public:
     int swapWindowSize() const;
     void setSwapWindowSize(int value);
 
+    /**
+     * @return the name of the compression backend used for the tiles
+     * in the swap file, one of KisTileCompressorFactory::availableCompressions()
+     */
+    QString swapCompressionAlgorithm(bool requestDefault = false) const;
+    void setSwapCompressionAlgorithm(const QString &value);
+
+    /**
+     * @return true if the update scheduler should ask the swapper to load
+     * the swapped-out tiles of the pending updates in background
+     */
+    bool enableSwapPrefetch(bool requestDefault = false) const;
+    void setEnableSwapPrefetch(bool value);
+
+    /**
+     * @return true if the space of the freed chunks of the swap file
+     * should be returned to the file system (punched out of the file).
+     * Ignored on the platforms that don't support sparse files.
+     */
+    bool enableSwapHolePunching(bool requestDefault = false) const;
+    void setEnableSwapHolePunching(bool value);
+
+    /**
+     * @return true if identical tiles of the layers and raster frames
+     * should be merged into shared tile data while the image is idle
+     */
+    bool enableTileDeduplication(bool requestDefault = false) const;
+    void setEnableTileDeduplication(bool value);
+
+    /**
+     * @return true if the Lod planes of the filter-based nodes should be
+     * pre-rendered for the neighbouring levels of detail while the image
+     * is idle
+     */
+    bool prerenderFilterLodPlanes(bool requestDefault = false) const;
+    void setPrerenderFilterLodPlanes(bool value);
+
+    /**
+     * @return true if the pools of the tile data should ask the system
+     * to back them with huge pages. The value is read only once per session.
+     */
+    bool useHugePagesForTileData(bool requestDefault = false) const;
+    void setUseHugePagesForTileData(bool value);
+
+    /**
+     * @return true if the swapper should watch the memory pressure
+     * signals of the system (cgroup limits and Linux PSI) and start
+     * swapping out tiles before the memory limits are reached
+     */
+    bool trackSystemMemoryPressure(bool requestDefault = false) const;
+    void setTrackSystemMemoryPressure(bool value);
+
+    /**
+     * @return true if the undo history of paint devices should keep
+     * the old tile data as compressed deltas. The value is read only
+     * once per session.
+     */
+    bool useMementoDeltaCompression(bool requestDefault = false) const;
+    void setUseMementoDeltaCompression(bool value);
+
     int tilesHardLimit() const; // MiB
     int tilesSoftLimit() const; // MiB
     int poolLimit() const; // MiB
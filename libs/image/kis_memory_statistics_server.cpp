@@ -144,6 +144,7 @@ KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image) const
     stats.poolSize = tileStats.poolSize;
 
     stats.swapSize = tileStats.swapSize;
+    stats.deduplicatedSize = tileStats.deduplicatedSize;
 
     KisImageConfig cfg(true);
 
@@ -33,6 +33,7 @@ public:
               poolSize(0),
 
               swapSize(0),
+              deduplicatedSize(0),
 
               totalMemoryLimit(0),
               tilesHardLimit(0),
@@ -53,6 +54,12 @@ public:
 
         qint64 swapSize;
 
+        /**
+         * The amount of memory released during the session by
+         * merging identical tiles, see KisTileDataDeduplicator
+         */
+        qint64 deduplicatedSize;
+
         qint64 totalMemoryLimit;
         qint64 tilesHardLimit;
         qint64 tilesSoftLimit;
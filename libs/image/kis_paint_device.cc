@@ -13,6 +13,8 @@
 #include <QImage>
 #include <QList>
 #include <QHash>
+#include <QMap>
+#include <QRegion>
 #include <QIODevice>
 #include <qmath.h>
 #include <KisRegion.h>
@@ -53,6 +55,7 @@
 #include "kis_paint_device_cache.h"
 #include "kis_paint_device_data.h"
 #include "kis_paint_device_frames_interface.h"
+#include "tiles3/kis_tile_data_store.h"
 
 #include "kis_transform_worker.h"
 #include "kis_filter_strategy.h"
@@ -154,6 +157,13 @@ public:
     {
 
         m_lodData.reset();
+        m_lodDataStamp = LodPlaneStamp();
+        m_lodPyramid.clear();
+
+        {
+            QMutexLocker l(&m_lod0JournalLock);
+            m_lod0Journal.reset();
+        }
         m_externalFrameData.reset();
 
         if (!m_frames.isEmpty()) {
@@ -415,9 +425,76 @@ public:
     void uploadFrameData(DataSP srcData, DataSP dstData);
 
     struct LodDataStructImpl;
+
+    /**
+     * The state of the Lod0 data, a Lod plane has been generated from.
+     * The plane stays valid while the sequence number of the cache of
+     * the source is not changed, i.e. until the Lod0 data is modified.
+     *
+     * The source is identified by its unique id, not by the pointer,
+     * since a new data object may be allocated at the same address.
+     */
+    struct LodPlaneStamp {
+        quint64 sourceDataId = 0;
+        int sequenceNumber = -1;
+    };
+
+    struct LodPyramidLevel {
+        DataSP data;
+        LodPlaneStamp stamp;
+
+        /// the value of m_lodPyramidClock when the level was last used
+        quint64 lastUsed = 0;
+    };
+
+    /**
+     * The number of inactive levels kept in the pyramid. When it
+     * is exceeded, the least recently used level is dropped.
+     */
+    static const int maxLodPyramidLevels = 3;
+
+    /**
+     * The changes of Lod0 data reported by the transactions. The journal
+     * is continuous, i.e. every change starts at the sequence number the
+     * previous one has finished at. If some change is made outside the
+     * transactions, the journal is restarted.
+     */
+    struct Lod0ChangeJournal {
+        static const int maxSize = 256;
+
+        quint64 dataId = 0;
+        int sequenceNumber = -1;
+
+        /// the sequence number before the change and the changed rect
+        QVector<std::pair<int, QRect>> changes;
+
+        quint64 openDataId = 0;
+        int numOpenChanges = 0;
+        bool hasOverlappingChanges = false;
+
+        void reset() {
+            dataId = 0;
+            sequenceNumber = -1;
+            changes.clear();
+        }
+    };
+
+    LodPlaneStamp lodPlaneStamp(Data *srcData) const;
+    bool isLodPlaneCompatible(const Data *plane, Data *srcData) const;
+    bool isLodPlaneValid(const Data *plane, const LodPlaneStamp &stamp, Data *srcData) const;
+    bool fetchLodPlaneChanges(const LodPlaneStamp &stamp, Data *srcData, QRegion *changes) const;
+
+    void insertLodPyramidLevelLocked(int lod, LodPyramidLevel level);
+    void touchLodPyramidLevel(int lod);
+
+    int beginLod0Change(KisDataManagerSP dataManager);
+    void endLod0Change(int cookie, const QRect &changedRect, bool changeIsKnown);
+
     LodDataStruct* createLodDataStruct(int lod);
     void updateLodDataStruct(LodDataStruct *dst, const QRect &srcRect);
     void uploadLodDataStruct(LodDataStruct *dst);
+    void stashLodDataStruct(LodDataStruct *dst);
+    bool hasUpToDateLodPlane(int lod) const;
     KisRegion regionForLodSyncing() const;
 
     void updateLodDataManager(KisDataManager *srcDataManager,
@@ -450,6 +527,13 @@ public:
             lodData += estimateDataSize(m_lodData.data());
         }
 
+        {
+            QMutexLocker l(&m_dataSwitchLock);
+            Q_FOREACH (const LodPyramidLevel &level, m_lodPyramid) {
+                lodData += estimateDataSize(level.data.data());
+            }
+        }
+
         if (m_externalFrameData) {
             temporaryData += estimateDataSize(m_externalFrameData.data());
         }
@@ -593,6 +677,25 @@ private:
 private:
     DataSP m_data;
     mutable QScopedPointer<Data> m_lodData;
+    LodPlaneStamp m_lodDataStamp;
+
+    /**
+     * The Lod planes generated for the levels of detail that are not
+     * active at the moment. When the user zooms back to one of these
+     * levels, the plane is reused as it is. The planes are also used as
+     * the sources for generating coarser levels, which is much cheaper
+     * than downsampling the Lod0 data.
+     *
+     * The pyramid is bounded by maxLodPyramidLevels and is dropped
+     * completely when the tiles take more memory than the swapper's
+     * soft limit.
+     */
+    QMap<int, LodPyramidLevel> m_lodPyramid;
+    quint64 m_lodPyramidClock = 0;
+
+    mutable QMutex m_lod0JournalLock;
+    Lod0ChangeJournal m_lod0Journal;
+
     mutable QScopedPointer<Data> m_externalFrameData;
     mutable QMutex m_dataSwitchLock;
 
@@ -676,6 +779,27 @@ struct KisPaintDevice::Private::StrategyPolicy {
 struct KisPaintDevice::Private::LodDataStructImpl : public KisPaintDevice::LodDataStruct {
     LodDataStructImpl(Data *_lodData) : lodData(_lodData) {}
     QScopedPointer<Data> lodData;
+    LodPlaneStamp stamp;
+
+    /**
+     * A valid plane of a finer (or the same) level of detail the data
+     * is generated from. Null means the data is generated from Lod0.
+     */
+    Data *sourcePlane = nullptr;
+    DataSP sourcePlaneHolder;
+
+    /**
+     * The plane of the requested level of detail is valid already,
+     * no generation is needed
+     */
+    bool isUpToDate = false;
+
+    /**
+     * The data is a copy of an outdated plane of the requested level,
+     * only the changed rects (aligned to the level) are regenerated
+     */
+    bool isIncremental = false;
+    QVector<QRect> changedRects;
 };
 
 KisRegion KisPaintDevice::Private::regionForLodSyncing() const
@@ -684,6 +808,163 @@ KisRegion KisPaintDevice::Private::regionForLodSyncing() const
     return srcData->dataManager()->region().translated(srcData->x(), srcData->y());
 }
 
+KisPaintDevice::Private::LodPlaneStamp KisPaintDevice::Private::lodPlaneStamp(Data *srcData) const
+{
+    LodPlaneStamp stamp;
+    stamp.sourceDataId = srcData->uniqueId();
+    stamp.sequenceNumber = srcData->cache()->sequenceNumber();
+    return stamp;
+}
+
+bool KisPaintDevice::Private::isLodPlaneCompatible(const Data *plane, Data *srcData) const
+{
+    const int lod = plane->levelOfDetail();
+
+    /**
+     * We compare color spaces as pure pointers, because they must be
+     * exactly the same, since they come from the common source.
+     */
+    return lod > 0 &&
+        plane->colorSpace() == srcData->colorSpace() &&
+        plane->x() == KisLodTransform::coordToLodCoord(srcData->x(), lod) &&
+        plane->y() == KisLodTransform::coordToLodCoord(srcData->y(), lod);
+}
+
+bool KisPaintDevice::Private::isLodPlaneValid(const Data *plane, const LodPlaneStamp &stamp, Data *srcData) const
+{
+    return isLodPlaneCompatible(plane, srcData) &&
+        stamp.sourceDataId == srcData->uniqueId() &&
+        stamp.sequenceNumber == srcData->cache()->sequenceNumber();
+}
+
+bool KisPaintDevice::Private::fetchLodPlaneChanges(const LodPlaneStamp &stamp, Data *srcData, QRegion *changes) const
+{
+    if (stamp.sourceDataId != srcData->uniqueId()) return false;
+
+    const int sequenceNumber = srcData->cache()->sequenceNumber();
+    if (stamp.sequenceNumber == sequenceNumber) return true;
+
+    QMutexLocker l(&m_lod0JournalLock);
+
+    const Lod0ChangeJournal &journal = m_lod0Journal;
+
+    if (journal.dataId != srcData->uniqueId() ||
+        journal.sequenceNumber != sequenceNumber ||
+        journal.numOpenChanges > 0) {
+
+        return false;
+    }
+
+    bool found = false;
+
+    for (auto it = journal.changes.begin(); it != journal.changes.end(); ++it) {
+        found |= it->first == stamp.sequenceNumber;
+
+        if (found) {
+            *changes += it->second;
+        }
+    }
+
+    return found;
+}
+
+void KisPaintDevice::Private::insertLodPyramidLevelLocked(int lod, LodPyramidLevel level)
+{
+    /**
+     * The pyramid is just a cache, so don't keep it when the tiles
+     * already take more memory than the user allowed to keep before
+     * starting to swap out the undo data
+     */
+    if (KisTileDataStore::instance()->isAboveSoftLimit()) {
+        m_lodPyramid.clear();
+        return;
+    }
+
+    level.lastUsed = ++m_lodPyramidClock;
+    m_lodPyramid.insert(lod, level);
+
+    while (m_lodPyramid.size() > maxLodPyramidLevels) {
+        auto leastRecentlyUsed = m_lodPyramid.begin();
+
+        for (auto it = m_lodPyramid.begin(); it != m_lodPyramid.end(); ++it) {
+            if (it->lastUsed < leastRecentlyUsed->lastUsed) {
+                leastRecentlyUsed = it;
+            }
+        }
+
+        m_lodPyramid.erase(leastRecentlyUsed);
+    }
+}
+
+void KisPaintDevice::Private::touchLodPyramidLevel(int lod)
+{
+    QMutexLocker l(&m_dataSwitchLock);
+
+    auto it = m_lodPyramid.find(lod);
+    if (it != m_lodPyramid.end()) {
+        it->lastUsed = ++m_lodPyramidClock;
+    }
+}
+
+int KisPaintDevice::Private::beginLod0Change(KisDataManagerSP dataManager)
+{
+    Data *data = currentNonLodData();
+    if (data->dataManager() != dataManager) return -1;
+
+    QMutexLocker l(&m_lod0JournalLock);
+
+    if (m_lod0Journal.numOpenChanges++ > 0) {
+        m_lod0Journal.hasOverlappingChanges = true;
+    }
+
+    m_lod0Journal.openDataId = data->uniqueId();
+
+    return data->cache()->sequenceNumber();
+}
+
+void KisPaintDevice::Private::endLod0Change(int cookie, const QRect &changedRect, bool changeIsKnown)
+{
+    if (cookie < 0) return;
+
+    Data *data = currentNonLodData();
+
+    QMutexLocker l(&m_lod0JournalLock);
+
+    Lod0ChangeJournal &journal = m_lod0Journal;
+
+    KIS_SAFE_ASSERT_RECOVER_NOOP(journal.numOpenChanges > 0);
+    journal.numOpenChanges = qMax(0, journal.numOpenChanges - 1);
+
+    /**
+     * If two changes overlapped in time, the rect of any of them
+     * doesn't cover all the changes made in between
+     */
+    if (!changeIsKnown ||
+        journal.hasOverlappingChanges ||
+        journal.openDataId != data->uniqueId()) {
+
+        journal.reset();
+
+        if (!journal.numOpenChanges) {
+            journal.hasOverlappingChanges = false;
+        }
+
+        return;
+    }
+
+    if (journal.dataId != data->uniqueId() || journal.sequenceNumber != cookie) {
+        journal.reset();
+        journal.dataId = data->uniqueId();
+    }
+
+    if (journal.changes.size() >= Lod0ChangeJournal::maxSize) {
+        journal.changes.removeFirst();
+    }
+
+    journal.changes.append(std::make_pair(cookie, changedRect));
+    journal.sequenceNumber = data->cache()->sequenceNumber();
+}
+
 KisPaintDevice::LodDataStruct* KisPaintDevice::Private::createLodDataStruct(int newLod)
 {
     KIS_SAFE_ASSERT_RECOVER_NOOP(newLod > 0);
@@ -691,7 +972,8 @@ KisPaintDevice::LodDataStruct* KisPaintDevice::Private::createLodDataStruct(int
     Data *srcData = currentNonLodData();
 
     Data *lodData = new Data(q, srcData, false);
-    LodDataStruct *lodStruct = new LodDataStructImpl(lodData);
+    LodDataStructImpl *lodStruct = new LodDataStructImpl(lodData);
+    lodStruct->stamp = lodPlaneStamp(srcData);
 
     int expectedX = KisLodTransform::coordToLodCoord(srcData->x(), newLod);
     int expectedY = KisLodTransform::coordToLodCoord(srcData->y(), newLod);
@@ -717,6 +999,140 @@ KisPaintDevice::LodDataStruct* KisPaintDevice::Private::createLodDataStruct(int
 
     lodData->cache()->invalidate();
 
+    /**
+     * Projection devices are updated at the current level of detail
+     * only, so their active Lod plane may diverge from Lod0 without
+     * changing it. Regenerate them from scratch, unless the level has
+     * been pre-rendered from the very same Lod0 data (see
+     * stashLodDataStruct()).
+     */
+    if (isProjectionDevice) {
+        QMutexLocker l(&m_dataSwitchLock);
+
+        for (auto it = m_lodPyramid.begin(); it != m_lodPyramid.end();) {
+            if (!isLodPlaneValid(it->data.data(), it->stamp, srcData)) {
+                it = m_lodPyramid.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        auto it = m_lodPyramid.find(newLod);
+        if (it != m_lodPyramid.end()) {
+            lodStruct->sourcePlane = it->data.data();
+            lodStruct->sourcePlaneHolder = it->data;
+            lodStruct->isUpToDate = true;
+            it->lastUsed = ++m_lodPyramidClock;
+        }
+
+        return lodStruct;
+    }
+
+    {
+        QMutexLocker l(&m_dataSwitchLock);
+
+        for (auto it = m_lodPyramid.begin(); it != m_lodPyramid.end();) {
+            QRegion changes;
+
+            if (!isLodPlaneCompatible(it->data.data(), srcData) ||
+                !fetchLodPlaneChanges(it->stamp, srcData, &changes)) {
+
+                it = m_lodPyramid.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    /**
+     * If we have a plane of the requested level and know what has been
+     * changed in Lod0 since it was generated, regenerate the changed
+     * areas only
+     */
+    Data *samePlane = nullptr;
+    LodPlaneStamp samePlaneStamp;
+    DataSP samePlaneHolder;
+
+    if (m_lodData &&
+        m_lodData->levelOfDetail() == newLod &&
+        isLodPlaneCompatible(m_lodData.data(), srcData)) {
+
+        samePlane = m_lodData.data();
+        samePlaneStamp = m_lodDataStamp;
+
+    } else if (m_lodPyramid.contains(newLod)) {
+        const LodPyramidLevel &level = m_lodPyramid[newLod];
+
+        samePlane = level.data.data();
+        samePlaneStamp = level.stamp;
+        samePlaneHolder = level.data;
+
+        touchLodPyramidLevel(newLod);
+    }
+
+    QRegion changes;
+
+    if (samePlane && fetchLodPlaneChanges(samePlaneStamp, srcData, &changes)) {
+        if (changes.isEmpty()) {
+            lodStruct->sourcePlane = samePlane;
+            lodStruct->sourcePlaneHolder = samePlaneHolder;
+            lodStruct->isUpToDate = true;
+            return lodStruct;
+        }
+
+        lodData->dataManager()->bitBltRough(samePlane->dataManager(), samePlane->dataManager()->extent());
+
+        /**
+         * The changed areas are cleared first, because the
+         * sync jobs visit only the areas Lod0 has data in
+         */
+        for (auto it = changes.begin(); it != changes.end(); ++it) {
+            const QRect alignedRect = KisLodTransform::alignedRect(*it, newLod);
+            const QRect lodRect =
+                KisLodTransform::scaledRect(alignedRect, newLod)
+                    .translated(-lodData->x(), -lodData->y());
+
+            lodData->dataManager()->clear(lodRect.x(), lodRect.y(),
+                                          lodRect.width(), lodRect.height(),
+                                          lodData->dataManager()->defaultPixel());
+
+            lodStruct->changedRects.append(alignedRect);
+        }
+
+        lodStruct->isIncremental = true;
+        return lodStruct;
+    }
+
+    /**
+     * Find the finest valid plane that is not finer than the requested
+     * one. Each level of the pyramid is four times smaller than the
+     * previous one, so the closer the source is, the cheaper it is.
+     */
+    if (m_lodData &&
+        m_lodData->levelOfDetail() <= newLod &&
+        isLodPlaneValid(m_lodData.data(), m_lodDataStamp, srcData)) {
+
+        lodStruct->sourcePlane = m_lodData.data();
+    }
+
+    auto it = m_lodPyramid.upperBound(newLod);
+    if (it != m_lodPyramid.begin()) {
+        --it;
+
+        if (!lodStruct->sourcePlane ||
+            lodStruct->sourcePlane->levelOfDetail() < it.key()) {
+
+            lodStruct->sourcePlane = it->data.data();
+            lodStruct->sourcePlaneHolder = it->data;
+
+            touchLodPyramidLevel(it.key());
+        }
+    }
+
+    lodStruct->isUpToDate =
+        lodStruct->sourcePlane &&
+        lodStruct->sourcePlane->levelOfDetail() == newLod;
+
     return lodStruct;
 }
 
@@ -809,15 +1225,47 @@ void KisPaintDevice::Private::updateLodDataStruct(LodDataStruct *_dst, const QRe
     LodDataStructImpl *dst = dynamic_cast<LodDataStructImpl*>(_dst);
     KIS_SAFE_ASSERT_RECOVER_RETURN(dst);
 
-    Data *lodData = dst->lodData.data();
-    Data *srcData = currentNonLodData();
+    if (dst->isUpToDate) return;
 
+    Data *lodData = dst->lodData.data();
     const int lod = lodData->levelOfDetail();
 
-    updateLodDataManager(srcData->dataManager().data(), lodData->dataManager().data(),
-                         QPoint(srcData->x(), srcData->y()),
-                         QPoint(lodData->x(), lodData->y()),
-                         originalRect, lod);
+    if (dst->isIncremental) {
+        Data *srcData = currentNonLodData();
+
+        Q_FOREACH (const QRect &changedRect, dst->changedRects) {
+            const QRect rc = changedRect & originalRect;
+            if (rc.isEmpty()) continue;
+
+            updateLodDataManager(srcData->dataManager().data(), lodData->dataManager().data(),
+                                 QPoint(srcData->x(), srcData->y()),
+                                 QPoint(lodData->x(), lodData->y()),
+                                 rc, lod);
+        }
+    } else if (dst->sourcePlane) {
+        Data *srcPlane = dst->sourcePlane;
+        const int srcLod = srcPlane->levelOfDetail();
+
+        /**
+         * The rect is aligned to the requested level of detail, so it is
+         * mapped into the coordinates of the source level without any
+         * rounding
+         */
+        const QRect srcRect =
+            KisLodTransform::scaledRect(KisLodTransform::alignedRect(originalRect, lod), srcLod);
+
+        updateLodDataManager(srcPlane->dataManager().data(), lodData->dataManager().data(),
+                             QPoint(srcPlane->x(), srcPlane->y()),
+                             QPoint(lodData->x(), lodData->y()),
+                             srcRect, lod - srcLod);
+    } else {
+        Data *srcData = currentNonLodData();
+
+        updateLodDataManager(srcData->dataManager().data(), lodData->dataManager().data(),
+                             QPoint(srcData->x(), srcData->y()),
+                             QPoint(lodData->x(), lodData->y()),
+                             originalRect, lod);
+    }
 }
 
 void KisPaintDevice::Private::generateLodCloneDevice(KisPaintDeviceSP dst, const QRect &originalRect, int lod)
@@ -839,10 +1287,79 @@ void KisPaintDevice::Private::uploadLodDataStruct(LodDataStruct *_dst)
     KIS_SAFE_ASSERT_RECOVER_RETURN(
         dst->lodData->levelOfDetail() == defaultBounds->currentLevelOfDetail());
 
+    const int newLod = dst->lodData->levelOfDetail();
+
+    if (dst->isUpToDate && dst->sourcePlane == m_lodData.data()) {
+        // the active plane is still valid
+        return;
+    }
+
+    /**
+     * Keep the currently active plane in the pyramid, the user may
+     * zoom back into its level soon. The copy shares the tiles with
+     * the active plane, so it is cheap.
+     */
+    QRegion activePlaneChanges;
+
+    if (!isProjectionDevice &&
+        m_lodData &&
+        m_lodData->levelOfDetail() != newLod &&
+        isLodPlaneCompatible(m_lodData.data(), currentNonLodData()) &&
+        fetchLodPlaneChanges(m_lodDataStamp, currentNonLodData(), &activePlaneChanges)) {
+
+        LodPyramidLevel level;
+        level.data = toQShared(new Data(q, m_lodData.data(), true));
+        level.stamp = m_lodDataStamp;
+
+        QMutexLocker l(&m_dataSwitchLock);
+        insertLodPyramidLevelLocked(m_lodData->levelOfDetail(), level);
+    }
+
+    Data *srcPlane = dst->isUpToDate ? dst->sourcePlane : dst->lodData.data();
+
     ensureLodDataPresent();
 
-    m_lodData->prepareClone(dst->lodData.data());
-    m_lodData->dataManager()->bitBltRough(dst->lodData->dataManager(), dst->lodData->dataManager()->extent());
+    m_lodData->prepareClone(srcPlane);
+    m_lodData->dataManager()->bitBltRough(srcPlane->dataManager(), srcPlane->dataManager()->extent());
+    m_lodDataStamp = dst->stamp;
+
+    {
+        // the level is active now, no need to keep a separate copy of it
+        QMutexLocker l(&m_dataSwitchLock);
+        m_lodPyramid.remove(newLod);
+    }
+}
+
+void KisPaintDevice::Private::stashLodDataStruct(LodDataStruct *_dst)
+{
+    LodDataStructImpl *dst = dynamic_cast<LodDataStructImpl*>(_dst);
+    KIS_SAFE_ASSERT_RECOVER_RETURN(dst);
+
+    // the plane is already present in the pyramid or active
+    if (dst->isUpToDate) return;
+
+    // Lod0 has been changed while the plane was being generated
+    if (!isLodPlaneValid(dst->lodData.data(), dst->stamp, currentNonLodData())) return;
+
+    const int lod = dst->lodData->levelOfDetail();
+
+    LodPyramidLevel level;
+    level.data = toQShared(dst->lodData.take());
+    level.stamp = dst->stamp;
+
+    QMutexLocker l(&m_dataSwitchLock);
+    insertLodPyramidLevelLocked(lod, level);
+}
+
+bool KisPaintDevice::Private::hasUpToDateLodPlane(int lod) const
+{
+    Data *srcData = currentNonLodData();
+
+    QMutexLocker l(&m_dataSwitchLock);
+
+    auto it = m_lodPyramid.find(lod);
+    return it != m_lodPyramid.end() &&
+        isLodPlaneValid(it->data.data(), it->stamp, srcData);
 }
 
 void KisPaintDevice::Private::transferFromData(Data *data, KisPaintDeviceSP targetDevice)
@@ -2164,11 +2681,36 @@ void KisPaintDevice::uploadLodDataStruct(LodDataStruct *dst)
     m_d->uploadLodDataStruct(dst);
 }
 
+void KisPaintDevice::stashLodDataStruct(LodDataStruct *dst)
+{
+    m_d->stashLodDataStruct(dst);
+}
+
+bool KisPaintDevice::hasUpToDateLodPlane(int lod) const
+{
+    return m_d->hasUpToDateLodPlane(lod);
+}
+
 void KisPaintDevice::generateLodCloneDevice(KisPaintDeviceSP dst, const QRect &originalRect, int lod)
 {
     m_d->generateLodCloneDevice(dst, originalRect, lod);
 }
 
+int KisPaintDevice::beginLod0Change(KisDataManagerSP dataManager)
+{
+    return m_d->beginLod0Change(dataManager);
+}
+
+void KisPaintDevice::endLod0Change(int cookie, const QRect &changedRect)
+{
+    m_d->endLod0Change(cookie, changedRect, true);
+}
+
+void KisPaintDevice::abortLod0Change(int cookie)
+{
+    m_d->endLod0Change(cookie, QRect(), false);
+}
+
 void KisPaintDevice::setSupportsWraparoundMode(bool value)
 {
     m_d->supportsWrapAroundMode = value;
@@ -922,8 +922,52 @@ public:
     void updateLodDataStruct(LodDataStruct *dst, const QRect &srcRect);
     void uploadLodDataStruct(LodDataStruct *dst);
 
+    /**
+     * Keeps the plane generated by \p dst in the Lod pyramid of the
+     * device instead of activating it. It is used for pre-rendering the
+     * levels of detail the user is likely to switch to. The plane is
+     * picked up by createLodDataStruct() while the Lod0 data stays
+     * unchanged (or, for non-projection devices, its changes are known).
+     *
+     * If Lod0 data has been changed since createLodDataStruct(), e.g. by
+     * an update running concurrently with the generation, the plane may
+     * be inconsistent, so it is just dropped.
+     */
+    void stashLodDataStruct(LodDataStruct *dst);
+
+    /**
+     * \return true if the Lod pyramid of the device keeps a plane of
+     * level \p lod generated from the current Lod0 data, i.e. the Lod0
+     * data has not been changed since the plane was stashed and the
+     * level needs no pre-rendering
+     */
+    bool hasUpToDateLodPlane(int lod) const;
+
     void generateLodCloneDevice(KisPaintDeviceSP dst, const QRect &originalRect, int lod);
 
+    /**
+     * Tracking of the changes of Lod0 data. A transaction calls
+     * beginLod0Change() before modifying the device and endLod0Change()
+     * with the changed rect after that, so the Lod planes could be
+     * updated in the changed areas only. Any change made outside such
+     * a pair makes the device regenerate its Lod planes from scratch.
+     *
+     * \return a cookie for endLod0Change(), or -1 if \p dataManager
+     *         does not belong to the current Lod0 data of the device
+     */
+    int beginLod0Change(KisDataManagerSP dataManager);
+
+    /**
+     * Finishes the change started with beginLod0Change()
+     */
+    void endLod0Change(int cookie, const QRect &changedRect);
+
+    /**
+     * Finishes the change started with beginLod0Change(), when
+     * the changed area is unknown
+     */
+    void abortLod0Change(int cookie);
+
     void setSupportsWraparoundMode(bool value);
     bool supportsWraproundMode() const;
 
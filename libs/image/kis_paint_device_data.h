@@ -8,6 +8,8 @@
 #ifndef __KIS_PAINT_DEVICE_DATA_H
 #define __KIS_PAINT_DEVICE_DATA_H
 
+#include <atomic>
+
 #include "KisInterstrokeData.h"
 #include "KisSequentialIteratorProgress.h"
 #include "KoAlwaysInline.h"
@@ -50,7 +52,8 @@ public:
           m_x(0), m_y(0),
           m_colorSpace(0),
           m_levelOfDetail(0),
-          m_cacheInvalidator(this)
+          m_cacheInvalidator(this),
+          m_uniqueId(generateUniqueId())
         {
         }
 
@@ -63,7 +66,8 @@ public:
           m_y(rhs->m_y),
           m_colorSpace(rhs->m_colorSpace),
           m_levelOfDetail(rhs->m_levelOfDetail),
-          m_cacheInvalidator(this)
+          m_cacheInvalidator(this),
+          m_uniqueId(generateUniqueId())
         {
             m_cache.setupCache();
             // WARNING: interstroke data is **not** copied while cloning, that is expected behavior!
@@ -327,6 +331,15 @@ public:
         m_levelOfDetail = value;
     }
 
+    /**
+     * The id of the data object, unique during the whole session.
+     * Unlike the address of the object, it is never reused, so it
+     * can be used to check if the data has been replaced.
+     */
+    ALWAYS_INLINE quint64 uniqueId() const {
+        return m_uniqueId;
+    }
+
     ALWAYS_INLINE KisIteratorCompleteListener* cacheInvalidator() {
         return &m_cacheInvalidator;
     }
@@ -362,6 +375,11 @@ public:
 
 
 private:
+    static quint64 generateUniqueId() {
+        static std::atomic<quint64> lastId(0);
+        return ++lastId;
+    }
+
     struct CacheInvalidator : public KisIteratorCompleteListener {
         CacheInvalidator(KisPaintDeviceData *_q) : q(_q) {}
 
@@ -382,6 +400,7 @@ private:
     const KoColorSpace* m_colorSpace;
     qint32 m_levelOfDetail;
     CacheInvalidator m_cacheInvalidator;
+    const quint64 m_uniqueId;
     KisInterstrokeDataSP m_interstrokeData;
 };
 
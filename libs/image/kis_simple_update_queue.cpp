@@ -8,10 +8,17 @@
 
 #include <QMutexLocker>
 #include <QVector>
+#include <cmath>
 
 #include "kis_image_config.h"
 #include "kis_full_refresh_walker.h"
 #include "kis_spontaneous_job.h"
+#include "kis_projection_leaf.h"
+#include "kis_paint_device.h"
+#include "kis_datamanager.h"
+#include "kis_lod_transform.h"
+#include "kis_update_time_monitor.h"
+#include "tiles3/kis_tile_data_interface.h"
 
 
 //#define ENABLE_DEBUG_JOIN
@@ -44,6 +51,7 @@
 KisSimpleUpdateQueue::KisSimpleUpdateQueue()
     : m_overrideLevelOfDetail(-1)
 {
+    m_clock.start();
     updateSettings();
 }
 
@@ -68,6 +76,10 @@ void KisSimpleUpdateQueue::updateSettings()
     m_maxCollectAlpha = config.maxCollectAlpha();
     m_maxMergeAlpha = config.maxMergeAlpha();
     m_maxMergeCollectAlpha = config.maxMergeCollectAlpha();
+    m_prefetchSwappedData = config.enableSwapPrefetch();
+    m_splitIntoWorkUnits = config.splitUpdatesIntoWorkUnits();
+    m_prioritizeVisibleUpdates = config.prioritizeVisibleUpdates();
+    m_offscreenUpdatesDeadline = config.offscreenUpdatesDeadline();
 }
 
 int KisSimpleUpdateQueue::overrideLevelOfDetail() const
@@ -75,6 +87,12 @@ int KisSimpleUpdateQueue::overrideLevelOfDetail() const
     return m_overrideLevelOfDetail;
 }
 
+void KisSimpleUpdateQueue::setViewportRects(const QVector<QRect> &rects)
+{
+    QMutexLocker locker(&m_lock);
+    m_viewportRects = rects;
+}
+
 void KisSimpleUpdateQueue::processQueue(KisUpdaterContext &updaterContext)
 {
     updaterContext.lock();
@@ -95,24 +113,36 @@ bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
 
     int currentLevelOfDetail = updaterContext.currentLevelOfDetail();
 
-    while(iter.hasNext()) {
-        item = iter.next();
+    const qint64 currentTime = m_clock.elapsed();
 
-        if ((currentLevelOfDetail < 0 || currentLevelOfDetail == item->levelOfDetail()) &&
-            !item->checksumValid()) {
+    /**
+     * On the first pass only the walkers visible on the canvas
+     * (and the ones that have waited for too long) are considered.
+     * The rest of the walkers are started on the second pass, that
+     * is, only when none of the visible walkers can be started right
+     * now. Otherwise a visible walker, blocked by a running job,
+     * would leave the spare threads idle.
+     */
+    for (int pass = 0; pass < 2 && !jobAdded; pass++) {
+        iter.toFront();
 
-            m_overrideLevelOfDetail = item->levelOfDetail();
-            item->recalculate(item->requestedRect());
-            m_overrideLevelOfDetail = -1;
-        }
+        while(iter.hasNext()) {
+            item = iter.next();
 
-        if ((currentLevelOfDetail < 0 || currentLevelOfDetail == item->levelOfDetail()) &&
-            updaterContext.isJobAllowed(item)) {
+            if (currentLevelOfDetail >= 0 && currentLevelOfDetail != item->levelOfDetail()) continue;
 
-            updaterContext.addMergeJob(item);
-            iter.remove();
-            jobAdded = true;
-            break;
+            if (!item->checksumValid()) {
+                m_overrideLevelOfDetail = item->levelOfDetail();
+                item->recalculate(item->requestedRect());
+                m_overrideLevelOfDetail = -1;
+            }
+
+            if (isHighPriorityJob(item, currentTime) != (pass == 0)) continue;
+
+            if (tryStartJob(updaterContext, iter, item)) {
+                jobAdded = true;
+                break;
+            }
         }
     }
 
@@ -146,6 +176,50 @@ bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
     return jobAdded;
 }
 
+bool KisSimpleUpdateQueue::tryStartJob(KisUpdaterContext &updaterContext, KisMutableWalkersListIterator &iter, KisBaseRectsWalkerSP item)
+{
+    if (!updaterContext.isJobAllowed(item)) return false;
+
+    QVector<KisBaseRectsWalkerSP> restUnits;
+
+    if (m_splitIntoWorkUnits) {
+        /**
+         * Split only for the threads that will not
+         * get any other walker from the queue
+         */
+        const int numIdleThreads =
+            updaterContext.numSpareThreads() - (m_updatesList.size() - 1);
+
+        restUnits = splitIntoWorkUnits(item, numIdleThreads);
+    }
+
+    updaterContext.addMergeJob(item);
+    iter.remove();
+
+    // the rest of the units go first in the queue
+    Q_FOREACH (KisBaseRectsWalkerSP unit, restUnits) {
+        unit->setEnqueueTime(item->enqueueTime());
+        iter.insert(unit);
+    }
+
+    return true;
+}
+
+bool KisSimpleUpdateQueue::isHighPriorityJob(KisBaseRectsWalkerSP walker, qint64 currentTime) const
+{
+    if (!m_prioritizeVisibleUpdates || m_viewportRects.isEmpty()) return true;
+    if (currentTime - walker->enqueueTime() >= m_offscreenUpdatesDeadline) return true;
+
+    const QRect changeRect =
+        KisLodTransformBase::upscaledRect(walker->changeRect(), walker->levelOfDetail());
+
+    Q_FOREACH (const QRect &rc, m_viewportRects) {
+        if (rc.intersects(changeRect)) return true;
+    }
+
+    return false;
+}
+
 void KisSimpleUpdateQueue::addUpdateJob(KisNodeSP node, const QVector<QRect> &rects, const QRect &cropRect, int levelOfDetail, KisProjectionUpdateFlags flags)
 {
     KisBaseRectsWalker::UpdateType type =
@@ -191,53 +265,213 @@ void KisSimpleUpdateQueue::addJob(KisNodeSP node, const QVector<QRect> &rects,
     Q_FOREACH (const QRect &rc, rects) {
         if (rc.isEmpty()) continue;
 
-        KisBaseRectsWalkerSP walker;
-
         if(trySplitJob(node, rc, cropRect, levelOfDetail, type, dontInvalidateFrames)) continue;
         if(tryMergeJob(node, rc, cropRect, levelOfDetail, type, dontInvalidateFrames)) continue;
 
-        if (type == KisBaseRectsWalker::UPDATE) {
-            KisMergeWalker::Flags flags = KisMergeWalker::DEFAULT;
-            if (dontInvalidateFrames) {
-                flags |= KisMergeWalker::CLONES_DONT_INVALIDATE_FRAMES;
-            }
+        KisBaseRectsWalkerSP walker = createWalker(cropRect, type, dontInvalidateFrames);
+        KIS_SAFE_ASSERT_RECOVER(walker) { continue; }
 
-            walker = new KisMergeWalker(cropRect, flags);
+        {
+            KisUpdateTimeMonitor::TraceSpan span("collect", node.data(), rc);
+            walker->collectRects(node, rc);
         }
-        else if (type == KisBaseRectsWalker::FULL_REFRESH)  {
-            KisFullRefreshWalker::Flags flags = KisFullRefreshWalker::None;
-            if (dontInvalidateFrames) {
-                flags |= KisFullRefreshWalker::ClonesDontInvalidateFrames;
-            }
 
-            walker = new KisFullRefreshWalker(cropRect, flags);
+        prefetchSwappedData(walker);
+        walkers.append(walker);
+    }
+
+    if (!walkers.isEmpty()) {
+        m_lock.lock();
+
+        const qint64 currentTime = m_clock.elapsed();
+        Q_FOREACH (KisBaseRectsWalkerSP walker, walkers) {
+            walker->setEnqueueTime(currentTime);
         }
-        else if (type == KisBaseRectsWalker::UPDATE_NO_FILTHY) {
-            KisMergeWalker::Flags flags = KisMergeWalker::NO_FILTHY;
-            if (dontInvalidateFrames) {
-                flags |= KisMergeWalker::CLONES_DONT_INVALIDATE_FRAMES;
-            }
 
-            walker = new KisMergeWalker(cropRect, flags);
+        m_updatesList.append(walkers);
+        m_lock.unlock();
+    }
+}
+
+KisBaseRectsWalkerSP KisSimpleUpdateQueue::createWalker(const QRect &cropRect,
+                                                        KisBaseRectsWalker::UpdateType type,
+                                                        bool dontInvalidateFrames)
+{
+    KisBaseRectsWalkerSP walker;
+
+    if (type == KisBaseRectsWalker::UPDATE) {
+        KisMergeWalker::Flags flags = KisMergeWalker::DEFAULT;
+        if (dontInvalidateFrames) {
+            flags |= KisMergeWalker::CLONES_DONT_INVALIDATE_FRAMES;
         }
-        else if (type == KisBaseRectsWalker::FULL_REFRESH_NO_FILTHY)  {
-            KisFullRefreshWalker::Flags flags = KisFullRefreshWalker::NoFilthyMode;
-            if (dontInvalidateFrames) {
-                flags |= KisFullRefreshWalker::ClonesDontInvalidateFrames;
-            }
 
-            walker = new KisFullRefreshWalker(cropRect, KisFullRefreshWalker::NoFilthyMode);
+        walker = new KisMergeWalker(cropRect, flags);
+    }
+    else if (type == KisBaseRectsWalker::FULL_REFRESH)  {
+        KisFullRefreshWalker::Flags flags = KisFullRefreshWalker::None;
+        if (dontInvalidateFrames) {
+            flags |= KisFullRefreshWalker::ClonesDontInvalidateFrames;
         }
-        /* else if(type == KisBaseRectsWalker::UNSUPPORTED) fatalKrita; */
 
-        walker->collectRects(node, rc);
-        walkers.append(walker);
+        walker = new KisFullRefreshWalker(cropRect, flags);
     }
+    else if (type == KisBaseRectsWalker::UPDATE_NO_FILTHY) {
+        KisMergeWalker::Flags flags = KisMergeWalker::NO_FILTHY;
+        if (dontInvalidateFrames) {
+            flags |= KisMergeWalker::CLONES_DONT_INVALIDATE_FRAMES;
+        }
 
-    if (!walkers.isEmpty()) {
-        m_lock.lock();
-        m_updatesList.append(walkers);
-        m_lock.unlock();
+        walker = new KisMergeWalker(cropRect, flags);
+    }
+    else if (type == KisBaseRectsWalker::FULL_REFRESH_NO_FILTHY)  {
+        KisFullRefreshWalker::Flags flags = KisFullRefreshWalker::NoFilthyMode;
+        if (dontInvalidateFrames) {
+            flags |= KisFullRefreshWalker::ClonesDontInvalidateFrames;
+        }
+
+        walker = new KisFullRefreshWalker(cropRect, KisFullRefreshWalker::NoFilthyMode);
+    }
+    /* else if(type == KisBaseRectsWalker::UNSUPPORTED) fatalKrita; */
+
+    return walker;
+}
+
+QVector<KisBaseRectsWalkerSP> KisSimpleUpdateQueue::splitIntoWorkUnits(KisBaseRectsWalkerSP walker, int maxUnits)
+{
+    QVector<KisBaseRectsWalkerSP> result;
+
+    if (maxUnits < 2) return result;
+
+    const QRect rc = walker->requestedRect();
+
+    /**
+     * If some layer in the stack needs pixels from around the
+     * update (e.g. a blur filter or a layer style), the access rects
+     * of the neighbouring units would intersect, so the context will
+     * not let them run in parallel anyway.
+     */
+    const QRect maxAccessRect =
+        rc.adjusted(-KisTileData::WIDTH / 2, -KisTileData::HEIGHT / 2,
+                    KisTileData::WIDTH / 2, KisTileData::HEIGHT / 2);
+
+    if (!maxAccessRect.contains(walker->accessRect())) return result;
+
+    /**
+     * Every unit has some constant overhead per layer,
+     * so don't make them smaller than 2x2 tiles
+     */
+    const QVector<QRect> units =
+        splitIntoTileAlignedUnits(rc, maxUnits, 2 * qMax(KisTileData::WIDTH, KisTileData::HEIGHT));
+
+    if (units.size() < 2) return result;
+
+    KisNodeSP startNode = walker->startNode();
+
+    m_overrideLevelOfDetail = walker->levelOfDetail();
+
+    walker->collectRects(startNode, units.first());
+
+    for (int i = 1; i < units.size(); i++) {
+        KisBaseRectsWalkerSP unit =
+            createWalker(walker->cropRect(), walker->type(), walker->clonesDontInvalidateFrames());
+        KIS_SAFE_ASSERT_RECOVER(unit) { continue; }
+
+        unit->collectRects(startNode, units[i]);
+        result.append(unit);
+    }
+
+    m_overrideLevelOfDetail = -1;
+
+    return result;
+}
+
+QVector<QRect> KisSimpleUpdateQueue::splitIntoTileAlignedUnits(const QRect &rc, int maxUnits, int minUnitSize)
+{
+    auto alignedSplitPosition = [] (int start, int size, int tileSize) {
+        const int middle = start + size / 2;
+        return int(std::floor(qreal(middle) / tileSize + 0.5)) * tileSize;
+    };
+
+    auto trySplit = [&] (const QRect &unit, bool horizontally, QRect *first, QRect *second) {
+        const int tileSize = horizontally ? KisTileData::WIDTH : KisTileData::HEIGHT;
+        const int start = horizontally ? unit.x() : unit.y();
+        const int size = horizontally ? unit.width() : unit.height();
+        const int split = alignedSplitPosition(start, size, tileSize);
+
+        if (split - start < minUnitSize || start + size - split < minUnitSize) {
+            return false;
+        }
+
+        if (horizontally) {
+            *first = QRect(unit.x(), unit.y(), split - unit.x(), unit.height());
+            *second = QRect(split, unit.y(), unit.x() + unit.width() - split, unit.height());
+        } else {
+            *first = QRect(unit.x(), unit.y(), unit.width(), split - unit.y());
+            *second = QRect(unit.x(), split, unit.width(), unit.y() + unit.height() - split);
+        }
+
+        return true;
+    };
+
+    QVector<QRect> units;
+    units << rc;
+
+    /**
+     * Split the biggest unit in halves along its longer side
+     * until we have enough units or nothing can be split anymore
+     */
+    QVector<bool> splittable;
+    splittable << true;
+
+    while (units.size() < maxUnits) {
+        int biggestIndex = -1;
+        qint64 biggestArea = 0;
+
+        for (int i = 0; i < units.size(); i++) {
+            const qint64 area = qint64(units[i].width()) * units[i].height();
+            if (splittable[i] && area > biggestArea) {
+                biggestIndex = i;
+                biggestArea = area;
+            }
+        }
+
+        if (biggestIndex < 0) break;
+
+        const QRect unit = units[biggestIndex];
+        const bool horizontally = unit.width() >= unit.height();
+
+        QRect first;
+        QRect second;
+
+        if (trySplit(unit, horizontally, &first, &second) ||
+            trySplit(unit, !horizontally, &first, &second)) {
+
+            units[biggestIndex] = first;
+            units.insert(biggestIndex + 1, second);
+            splittable.insert(biggestIndex + 1, true);
+        } else {
+            splittable[biggestIndex] = false;
+        }
+    }
+
+    return units;
+}
+
+void KisSimpleUpdateQueue::prefetchSwappedData(KisBaseRectsWalkerSP walker)
+{
+    /**
+     * The walker is not in the queue yet, so by the time the updater
+     * threads reach it, the swapper has some time to load its data.
+     * LOD planes are never swapped out for long, so skip them.
+     */
+    if (!m_prefetchSwappedData || walker->levelOfDetail() > 0) return;
+
+    Q_FOREACH (const KisBaseRectsWalker::JobItem &item, walker->leafStack()) {
+        KisPaintDeviceSP device = item.m_leaf->projection();
+        if (!device) continue;
+
+        device->dataManager()->prefetchSwappedTiles(
+            item.m_applyRect.translated(-device->x(), -device->y()));
     }
 }
 
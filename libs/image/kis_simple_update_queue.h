@@ -8,6 +8,7 @@
 #define __KIS_SIMPLE_UPDATE_QUEUE_H
 
 #include <QMutex>
+#include <QElapsedTimer>
 #include "kis_updater_context.h"
 #include <KisProjectionUpdateFlags.h>
 
@@ -49,10 +50,32 @@ public:
 
     int overrideLevelOfDetail() const;
 
+    /**
+     * Sets the rects of the image (in LOD0 coordinates) currently
+     * shown on the canvases. The walkers that change these areas
+     * are started before the others, the off-screen walkers are
+     * deferred until there is no visible work left or until they
+     * have waited longer than the offscreenUpdatesDeadline.
+     *
+     * An empty vector disables the prioritization.
+     */
+    void setViewportRects(const QVector<QRect> &rects);
+
+    /**
+     * Splits \p rc into at most \p maxUnits non-overlapping
+     * rects whose inner boundaries are aligned to the tile grid.
+     * Every unit is at least \p minUnitSize pixels along the
+     * dimension it was split by.
+     */
+    static QVector<QRect> splitIntoTileAlignedUnits(const QRect &rc, int maxUnits, int minUnitSize);
+
 protected:
     void addJob(KisNodeSP node, const QVector<QRect> &rects, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type, bool dontInvalidateFrames);
 
     bool processOneJob(KisUpdaterContext &updaterContext);
+    bool tryStartJob(KisUpdaterContext &updaterContext, KisMutableWalkersListIterator &iter, KisBaseRectsWalkerSP item);
+
+    bool isHighPriorityJob(KisBaseRectsWalkerSP walker, qint64 currentTime) const;
 
     bool trySplitJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type, bool dontInvalidateFrames);
     bool tryMergeJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type, bool dontInvalidateFrames);
@@ -61,6 +84,11 @@ protected:
                      const qreal maxAlpha);
     bool joinRects(QRect& baseRect, const QRect& newRect, qreal maxAlpha);
 
+    void prefetchSwappedData(KisBaseRectsWalkerSP walker);
+
+    KisBaseRectsWalkerSP createWalker(const QRect &cropRect, KisBaseRectsWalker::UpdateType type, bool dontInvalidateFrames);
+    QVector<KisBaseRectsWalkerSP> splitIntoWorkUnits(KisBaseRectsWalkerSP walker, int maxUnits);
+
 protected:
 
     mutable QMutex m_lock;
@@ -96,6 +124,30 @@ protected:
      */
     qreal m_maxMergeCollectAlpha;
 
+    /**
+     * Ask the tile store to swap-in the tiles the queued
+     * walkers are going to touch in background
+     */
+    bool m_prefetchSwappedData;
+
+    /**
+     * When there are idle threads in the updater context, split the
+     * walker being started into several tile-aligned work units, so
+     * that the idle threads could merge them in parallel
+     */
+    bool m_splitIntoWorkUnits;
+
+    /**
+     * The walkers visible on the canvas go first, the
+     * off-screen ones wait for at most m_offscreenUpdatesDeadline
+     * milliseconds
+     */
+    bool m_prioritizeVisibleUpdates;
+    int m_offscreenUpdatesDeadline;
+
+    QVector<QRect> m_viewportRects;
+    QElapsedTimer m_clock;
+
     int m_overrideLevelOfDetail;
 };
 
@@ -7,10 +7,12 @@
 #include "kis_stroke.h"
 
 #include "kis_stroke_strategy.h"
+#include "KisStrokeJobStatistics.h"
 
 
 KisStroke::KisStroke(KisStrokeStrategy *strokeStrategy, Type type, int levelOfDetail)
     : m_strokeStrategy(strokeStrategy),
+      m_jobStatistics(new KisStrokeJobStatistics()),
       m_strokeInitialized(false),
       m_strokeEnded(false),
       m_strokeSuspended(false),
@@ -54,6 +56,8 @@ void KisStroke::suspendStroke(KisStrokeSP recipient)
         return;
     }
 
+    reclaimBatchedJobs();
+
     KIS_ASSERT_RECOVER_NOOP(m_suspendStrategy && m_resumeStrategy);
 
     prepend(m_resumeStrategy.data(),
@@ -81,6 +85,13 @@ void KisStroke::addMutatedJobs(const QVector<KisStrokeJobData *> list)
         return;
     }
 
+    /**
+     * The mutated jobs should be executed before any other job of
+     * the stroke, including the ones that are still waiting in the
+     * currently running batch
+     */
+    reclaimBatchedJobs();
+
     // Find first non-alien (non-suspend/non-resume) job
     //
     // Please note that this algorithm will stop working at the day we start
@@ -92,7 +103,7 @@ void KisStroke::addMutatedJobs(const QVector<KisStrokeJobData *> list)
                            std::mem_fn(&KisStrokeJob::isOwnJob));
 
     Q_FOREACH (KisStrokeJobData *data, list) {
-        it = m_jobsQueue.insert(it, new KisStrokeJob(m_dabStrategy.data(), data, worksOnLevelOfDetail(), true));
+        it = m_jobsQueue.insert(it, createJob(m_dabStrategy.data(), data, true));
         ++it;
     }
 }
@@ -109,6 +120,85 @@ KisStrokeJob* KisStroke::popOneJob()
     return job;
 }
 
+KisStrokeJob* KisStroke::popJobBatch(int maxBatchSize, qint64 targetBatchTime)
+{
+    KisStrokeJob *job = popOneJob();
+    if (!job) return job;
+
+    int batchSize = 1;
+    const qint64 averageJobDuration = m_jobStatistics->averageJobDuration();
+
+    if (m_strokeStrategy->supportsJobBatching() &&
+        maxBatchSize > 1 &&
+        averageJobDuration >= 0 &&
+        canBeBatched(job, job)) {
+
+        const int maxJobs =
+            int(qMin(qint64(maxBatchSize),
+                     targetBatchTime / qMax(averageJobDuration, qint64(1))));
+
+        QSharedPointer<KisStrokeJobBatch> batch;
+
+        while (batchSize < maxJobs &&
+               !m_jobsQueue.isEmpty() &&
+               canBeBatched(m_jobsQueue.head(), job)) {
+
+            if (!batch) {
+                batch.reset(new KisStrokeJobBatch());
+            }
+
+            batch->append(m_jobsQueue.dequeue());
+            batchSize++;
+        }
+
+        if (batch) {
+            job->setBatch(batch);
+            m_currentBatch = batch;
+        }
+    }
+
+    return job;
+}
+
+const KisStrokeJobStatistics* KisStroke::jobStatistics() const
+{
+    return m_jobStatistics.data();
+}
+
+KisStrokeJobStatistics* KisStroke::jobStatistics()
+{
+    return m_jobStatistics.data();
+}
+
+bool KisStroke::canBeBatched(KisStrokeJob *job, KisStrokeJob *batchHead)
+{
+    const KisStrokeJobData::Sequentiality sequentiality = job->sequentiality();
+
+    return (sequentiality == KisStrokeJobData::SEQUENTIAL ||
+            sequentiality == KisStrokeJobData::UNIQUELY_CONCURRENT) &&
+        sequentiality == batchHead->sequentiality() &&
+        job->isOwnJob() &&
+        !job->isExclusive() &&
+        job->levelOfDetail() == batchHead->levelOfDetail() &&
+        job->isCancellable() == batchHead->isCancellable();
+}
+
+void KisStroke::reclaimBatchedJobs()
+{
+    if (!m_currentBatch) return;
+
+    QQueue<KisStrokeJob*> jobs = m_currentBatch->takeRemaining();
+    m_currentBatch.reset();
+
+    auto it = std::find_if(m_jobsQueue.begin(), m_jobsQueue.end(),
+                           std::mem_fn(&KisStrokeJob::isOwnJob));
+
+    Q_FOREACH (KisStrokeJob *job, jobs) {
+        it = m_jobsQueue.insert(it, job);
+        ++it;
+    }
+}
+
 KUndo2MagicString KisStroke::name() const
 {
     return m_strokeStrategy->name();
@@ -159,6 +249,8 @@ void KisStroke::cancelStroke()
     // case 6
     if (m_isCancelled) return;
 
+    reclaimBatchedJobs();
+
     const bool effectivelyInitialized =
         m_strokeInitialized || m_strokeStrategy->needsExplicitCancel();
 
@@ -295,7 +387,7 @@ void KisStroke::enqueue(KisStrokeJobStrategy *strategy,
         return;
     }
 
-    m_jobsQueue.enqueue(new KisStrokeJob(strategy, data, worksOnLevelOfDetail(), true));
+    m_jobsQueue.enqueue(createJob(strategy, data, true));
 }
 
 void KisStroke::prepend(KisStrokeJobStrategy *strategy,
@@ -312,7 +404,16 @@ void KisStroke::prepend(KisStrokeJobStrategy *strategy,
     // LOG_MERGE_FIXME:
     Q_UNUSED(levelOfDetail);
 
-    m_jobsQueue.prepend(new KisStrokeJob(strategy, data, worksOnLevelOfDetail(), isOwnJob));
+    m_jobsQueue.prepend(createJob(strategy, data, isOwnJob));
+}
+
+KisStrokeJob* KisStroke::createJob(KisStrokeJobStrategy *strategy,
+                                   KisStrokeJobData *data,
+                                   bool isOwnJob)
+{
+    KisStrokeJob *job = new KisStrokeJob(strategy, data, worksOnLevelOfDetail(), isOwnJob);
+    job->setStatistics(m_jobStatistics.data());
+    return job;
 }
 
 KisStrokeJob* KisStroke::dequeue()
@@ -9,12 +9,14 @@
 
 #include <QQueue>
 #include <QScopedPointer>
+#include <QSharedPointer>
 
 #include <kis_types.h>
 #include "kritaimage_export.h"
 #include "kis_stroke_job.h"
 
 class KisStrokeStrategy;
+class KisStrokeJobStatistics;
 class KUndo2MagicString;
 
 
@@ -43,6 +45,27 @@ public:
     qint32 numJobs() const;
     KisStrokeJob* popOneJob();
 
+    /**
+     * Pops the next job and, if the strategy supports job batching,
+     * attaches to it the following jobs of the same kind, so that all
+     * of them were executed by a single executor task. Only the own
+     * SEQUENTIAL or UNIQUELY_CONCURRENT jobs with the same level of
+     * detail are batched.
+     *
+     * The size of the batch is chosen by the running average of the
+     * execution time of the jobs: the batch should take about
+     * \p targetBatchTime nanoseconds, but contain not more than
+     * \p maxBatchSize jobs. Until the first job is finished, the jobs
+     * are not batched at all.
+     */
+    KisStrokeJob* popJobBatch(int maxBatchSize, qint64 targetBatchTime);
+
+    /**
+     * The execution times and batch sizes of the jobs of the stroke
+     */
+    const KisStrokeJobStatistics* jobStatistics() const;
+    KisStrokeJobStatistics* jobStatistics();
+
     void endStroke();
     void cancelStroke();
 
@@ -84,6 +107,19 @@ private:
 
     KisStrokeJob* dequeue();
 
+    KisStrokeJob* createJob(KisStrokeJobStrategy *strategy,
+                            KisStrokeJobData *data,
+                            bool isOwnJob);
+
+    /**
+     * Returns the jobs of the currently running batch that have not
+     * been started yet into the queue, right before the own jobs of
+     * the stroke
+     */
+    void reclaimBatchedJobs();
+
+    static bool canBeBatched(KisStrokeJob *job, KisStrokeJob *batchHead);
+
     void clearQueueOnCancel();
     bool sanityCheckAllJobsAreCancellable() const;
 
@@ -106,6 +142,8 @@ private:
     QScopedPointer<KisStrokeJobStrategy> m_resumeStrategy;
 
     QQueue<KisStrokeJob*> m_jobsQueue;
+    QScopedPointer<KisStrokeJobStatistics> m_jobStatistics;
+    QSharedPointer<KisStrokeJobBatch> m_currentBatch;
     bool m_strokeInitialized;
     bool m_strokeEnded;
     bool m_strokeSuspended;
@@ -0,0 +1,79 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_stroke_job.h"
+
+#include <QElapsedTimer>
+
+#include "KisStrokeJobStatistics.h"
+
+
+KisStrokeJob::~KisStrokeJob()
+{
+    delete m_dabData;
+}
+
+void KisStrokeJob::run()
+{
+    KisStrokeJob *job = this;
+    int numExecutedJobs = 0;
+
+    while (job) {
+        if (job->m_statistics) {
+            QElapsedTimer timer;
+            timer.start();
+
+            job->m_dabStrategy->run(job->m_dabData);
+
+            job->m_statistics->addJobDuration(timer.nsecsElapsed());
+        } else {
+            job->m_dabStrategy->run(job->m_dabData);
+        }
+
+        numExecutedJobs++;
+
+        if (job != this) {
+            delete job;
+        }
+
+        job = m_batch ? m_batch->takeNext() : nullptr;
+    }
+
+    /**
+     * The jobs taken back by the stroke are executed in some other
+     * batch, so count only the jobs that have actually been executed
+     */
+    if (m_statistics) {
+        m_statistics->addBatch(numExecutedJobs);
+    }
+}
+
+
+KisStrokeJobBatch::~KisStrokeJobBatch()
+{
+    qDeleteAll(m_jobs);
+}
+
+void KisStrokeJobBatch::append(KisStrokeJob *job)
+{
+    QMutexLocker l(&m_lock);
+    m_jobs.enqueue(job);
+}
+
+KisStrokeJob* KisStrokeJobBatch::takeNext()
+{
+    QMutexLocker l(&m_lock);
+    return !m_jobs.isEmpty() ? m_jobs.dequeue() : nullptr;
+}
+
+QQueue<KisStrokeJob*> KisStrokeJobBatch::takeRemaining()
+{
+    QMutexLocker l(&m_lock);
+
+    QQueue<KisStrokeJob*> result;
+    std::swap(result, m_jobs);
+    return result;
+}
@@ -7,9 +7,16 @@
 #ifndef __KIS_STROKE_JOB_H
 #define __KIS_STROKE_JOB_H
 
+#include <QMutex>
+#include <QQueue>
+#include <QSharedPointer>
+
 #include "kis_runnable_with_debug_name.h"
 #include "kis_stroke_job_strategy.h"
 
+class KisStrokeJobStatistics;
+class KisStrokeJobBatch;
+
 class KRITAIMAGE_EXPORT KisStrokeJob : public KisRunnableWithDebugName
 {
 public:
@@ -24,13 +31,13 @@ public:
     {
     }
 
-    ~KisStrokeJob() override {
-        delete m_dabData;
-    }
+    ~KisStrokeJob() override;
 
-    void run() override {
-        m_dabStrategy->run(m_dabData);
-    }
+    /**
+     * Runs the job itself and then all the jobs of the attached
+     * batch, unless they have been taken back by the stroke
+     */
+    void run() override;
 
     KisStrokeJobData::Sequentiality sequentiality() const {
         return m_dabData ? m_dabData->sequentiality() : KisStrokeJobData::SEQUENTIAL;
@@ -69,6 +76,18 @@ public:
         return m_dabStrategy->debugId();
     }
 
+    /**
+     * The statistics object the execution time of the job is reported to,
+     * owned by the stroke
+     */
+    void setStatistics(KisStrokeJobStatistics *statistics) {
+        m_statistics = statistics;
+    }
+
+    void setBatch(QSharedPointer<KisStrokeJobBatch> batch) {
+        m_batch = batch;
+    }
+
 private:
     // for testing use only, do not use in real code
     friend QString getJobName(KisStrokeJob *job);
@@ -92,6 +111,40 @@ private:
 
     int m_levelOfDetail;
     bool m_isOwnJob;
+
+    KisStrokeJobStatistics *m_statistics = nullptr;
+    QSharedPointer<KisStrokeJobBatch> m_batch;
+};
+
+/**
+ * The jobs that follow a KisStrokeJob in the queue of the stroke and are
+ * executed by the same executor task right after it (see
+ * KisStroke::popJobBatch()). The batch is shared between the job and the
+ * stroke, so that the stroke could take the jobs that have not been
+ * started yet back into its queue, e.g. when the running job adds
+ * mutated jobs or the stroke is cancelled.
+ */
+class KRITAIMAGE_EXPORT KisStrokeJobBatch
+{
+public:
+    ~KisStrokeJobBatch();
+
+    void append(KisStrokeJob *job);
+
+    /**
+     * Takes the next job for execution or returns null if
+     * the batch is exhausted
+     */
+    KisStrokeJob* takeNext();
+
+    /**
+     * Takes all the jobs that have not been started yet
+     */
+    QQueue<KisStrokeJob*> takeRemaining();
+
+private:
+    QMutex m_lock;
+    QQueue<KisStrokeJob*> m_jobs;
 };
 
 #endif /* __KIS_STROKE_JOB_H */
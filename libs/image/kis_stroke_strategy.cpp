@@ -19,6 +19,7 @@ KisStrokeStrategy::KisStrokeStrategy(const QLatin1String &id, const KUndo2MagicS
       m_asynchronouslyCancellable(true),
       m_needsExplicitCancel(false),
       m_forceLodModeIfPossible(false),
+      m_supportsJobBatching(false),
       m_balancingRatioOverride(-1.0),
       m_id(id),
       m_name(name),
@@ -35,6 +36,7 @@ KisStrokeStrategy::KisStrokeStrategy(const KisStrokeStrategy &rhs)
       m_asynchronouslyCancellable(rhs.m_asynchronouslyCancellable),
       m_needsExplicitCancel(rhs.m_needsExplicitCancel),
       m_forceLodModeIfPossible(rhs.m_forceLodModeIfPossible),
+      m_supportsJobBatching(rhs.m_supportsJobBatching),
       m_balancingRatioOverride(rhs.m_balancingRatioOverride),
       m_id(rhs.m_id),
       m_name(rhs.m_name),
@@ -239,6 +241,16 @@ void KisStrokeStrategy::setNeedsExplicitCancel(bool value)
     m_needsExplicitCancel = value;
 }
 
+bool KisStrokeStrategy::supportsJobBatching() const
+{
+    return m_supportsJobBatching;
+}
+
+void KisStrokeStrategy::setSupportsJobBatching(bool value)
+{
+    m_supportsJobBatching = value;
+}
+
 qreal KisStrokeStrategy::balancingRatioOverride() const
 {
     return m_balancingRatioOverride;
@@ -112,6 +112,19 @@ public:
 
     bool needsExplicitCancel() const;
 
+    /**
+     * Returns true if the consecutive SEQUENTIAL or UNIQUELY_CONCURRENT
+     * jobs of the stroke can be executed by a single executor task (see
+     * KisStroke::popJobBatch()). The jobs are still executed in the
+     * same order and one by one, so the only visible difference is that
+     * the update jobs are not interleaved with them. If a job of the
+     * batch adds mutated jobs, the rest of the batch is returned into
+     * the queue right after them.
+     *
+     * Default is 'false'.
+     */
+    bool supportsJobBatching() const;
+
 
     /**
      * \see setBalancingRatioOverride() for details
@@ -171,6 +184,7 @@ protected:
     void setCanForgetAboutMe(bool value);
     void setAsynchronouslyCancellable(bool value);
     void setNeedsExplicitCancel(bool value);
+    void setSupportsJobBatching(bool value);
 
     /**
      * Set override for the desired scheduler balancing ratio:
@@ -202,6 +216,7 @@ private:
     bool m_asynchronouslyCancellable;
     bool m_needsExplicitCancel;
     bool m_forceLodModeIfPossible;
+    bool m_supportsJobBatching;
     qreal m_balancingRatioOverride;
 
     QLatin1String m_id;
@@ -10,6 +10,7 @@
 #include <QMutex>
 #include <QMutexLocker>
 #include "kis_stroke.h"
+#include "KisStrokeJobStatistics.h"
 #include "kis_updater_context.h"
 #include "kis_stroke_job_strategy.h"
 #include "kis_stroke_strategy.h"
@@ -94,6 +95,9 @@ struct Q_DECL_HIDDEN KisStrokesQueue::Private {
     KisPostExecutionUndoAdapter lodNPostExecutionUndoAdapter;
     KisLodPreferences lodPreferences;
 
+    int maxStrokeJobBatchSize = 1;
+    qint64 strokeJobBatchTargetTime = 0; // in nanoseconds
+
     void cancelForgettableStrokes();
     void startLod0ToNStroke(int levelOfDetail, bool forgettable);
 
@@ -615,6 +619,14 @@ qreal KisStrokesQueue::balancingRatioOverride() const
     return m_d->balancingRatioOverride;
 }
 
+void KisStrokesQueue::setStrokeJobBatchingLimits(int maxBatchSize, int targetBatchTime)
+{
+    QMutexLocker locker(&m_d->mutex);
+
+    m_d->maxStrokeJobBatchSize = maxBatchSize;
+    m_d->strokeJobBatchTargetTime = qint64(targetBatchTime) * 1000;
+}
+
 KisLodPreferences KisStrokesQueue::lodPreferences() const
 {
     QMutexLocker locker(&m_d->mutex);
@@ -696,6 +708,7 @@ void KisStrokesQueue::debugDumpAllStrokes()
     qDebug() <<"===";
     Q_FOREACH (KisStrokeSP stroke, m_d->strokesQueue) {
         qDebug() << ppVar(stroke->name()) << ppVar(stroke->type()) << ppVar(stroke->numJobs()) << ppVar(stroke->isInitialized()) << ppVar(stroke->isCancelled());
+        qDebug() << "    " << *stroke->jobStatistics();
     }
     qDebug() <<"===";
 }
@@ -758,7 +771,8 @@ bool KisStrokesQueue::processOneJob(KisUpdaterContext &updaterContext,
        checkSequentialProperty(snapshot, externalJobsPending)) {
 
         KisStrokeSP stroke = m_d->strokesQueue.head();
-        updaterContext.addStrokeJob(stroke->popOneJob());
+        updaterContext.addStrokeJob(stroke->popJobBatch(m_d->maxStrokeJobBatchSize,
+                                                        m_d->strokeJobBatchTargetTime));
         result = true;
     }
 
@@ -848,6 +862,8 @@ bool KisStrokesQueue::checkStrokeState(bool hasStrokeJobsRunning,
             m_d->postSyncLod0GUIPlaneRequestForResume();
         }
 
+        dbgImage << "Stroke finished:" << stroke->id() << *stroke->jobStatistics();
+
         m_d->strokesQueue.dequeue(); // deleted by shared pointer
         m_d->needsExclusiveAccess = false;
         m_d->wrapAroundModeSupported = false;
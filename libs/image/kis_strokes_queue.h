@@ -53,6 +53,15 @@ public:
     bool wrapAroundModeSupported() const;
     qreal balancingRatioOverride() const;
 
+    /**
+     * Sets the limits for batching the consecutive small jobs of the
+     * strokes that support it (see KisStroke::popJobBatch()). The
+     * batch should take about \p targetBatchTime microseconds and
+     * contain not more than \p maxBatchSize jobs. The value of
+     * \p maxBatchSize less than 2 disables batching.
+     */
+    void setStrokeJobBatchingLimits(int maxBatchSize, int targetBatchTime);
+
     KisLodPreferences lodPreferences() const override;
     void setLodPreferences(const KisLodPreferences &value);
     void explicitRegenerateLevelOfDetail();
@@ -59,9 +59,16 @@ public:
     QScopedPointer<OptionalInterstrokeInfo> interstrokeInfo;
     bool suppressUpdates = false;
 
+    /**
+     * The cookie of the change of Lod0 data of the device that
+     * is tracked for incremental updates of its Lod planes
+     */
+    int lod0ChangeCookie = -1;
+
     void possiblySwitchCurrentTime();
     KisDataManagerSP dataManager();
     void moveDevice(const QPoint newOffset);
+    QRect changedRect() const;
 };
 
 KisTransactionData::KisTransactionData(const KUndo2MagicString& name, KisPaintDeviceSP device, bool resetSelectionOutlineCache, KisTransactionWrapperFactory *interstrokeDataFactory, KUndo2Command* parent, bool suppressUpdates)
@@ -110,10 +117,16 @@ void KisTransactionData::init(KisPaintDeviceSP device)
         m_d->device->framesInterface()->frameDataManager(m_d->transactionFrameId) :
         m_d->device->dataManager();
     m_d->memento = m_d->savedDataManager->getMemento();
+
+    m_d->lod0ChangeCookie = m_d->device->beginLod0Change(m_d->savedDataManager);
 }
 
 KisTransactionData::~KisTransactionData()
 {
+    if (!m_d->transactionFinished) {
+        m_d->device->abortLod0Change(m_d->lod0ChangeCookie);
+    }
+
     Q_ASSERT(m_d->memento);
     m_d->savedDataManager->purgeHistory(m_d->memento);
 
@@ -142,6 +155,9 @@ void KisTransactionData::endTransaction()
         m_d->newOffset = QPoint(m_d->device->x(), m_d->device->y());
         m_d->defaultPixelChanged = m_d->oldDefaultPixel != m_d->device->defaultPixel();
 
+        m_d->device->endLod0Change(m_d->lod0ChangeCookie, m_d->changedRect());
+        m_d->lod0ChangeCookie = -1;
+
         if (m_d->interstrokeInfo) {
             m_d->interstrokeInfo->endTransactionCommand.reset(m_d->interstrokeInfo->factory->createEndTransactionCommand());
             if (m_d->interstrokeInfo->endTransactionCommand) {
@@ -160,27 +176,32 @@ void KisTransactionData::startUpdates()
         m_d->transactionFrameId ==
         m_d->device->framesInterface()->currentFrameId()) {
 
-        QRect rc;
-        QRect mementoExtent = m_d->memento->extent();
+        m_d->device->setDirty(m_d->changedRect());
+    } else {
+        m_d->device->framesInterface()->invalidateFrameCache(m_d->transactionFrameId);
+    }
+}
 
-        if (m_d->newOffset == m_d->oldOffset) {
-            rc = mementoExtent.translated(m_d->device->x(), m_d->device->y());
-        } else {
-            QRect totalExtent =
-                m_d->savedDataManager->extent() | mementoExtent;
+QRect KisTransactionData::Private::changedRect() const
+{
+    QRect rc;
+    QRect mementoExtent = memento->extent();
 
-            rc = totalExtent.translated(m_d->oldOffset) |
-                totalExtent.translated(m_d->newOffset);
-        }
+    if (newOffset == oldOffset) {
+        rc = mementoExtent.translated(device->x(), device->y());
+    } else {
+        QRect totalExtent =
+            savedDataManager->extent() | mementoExtent;
 
-        if (m_d->defaultPixelChanged) {
-            rc |= m_d->device->defaultBounds()->bounds();
-        }
+        rc = totalExtent.translated(oldOffset) |
+            totalExtent.translated(newOffset);
+    }
 
-        m_d->device->setDirty(rc);
-    } else {
-        m_d->device->framesInterface()->invalidateFrameCache(m_d->transactionFrameId);
+    if (defaultPixelChanged) {
+        rc |= device->defaultBounds()->bounds();
     }
+
+    return rc;
 }
 
 void KisTransactionData::possiblyNotifySelectionChanged()
@@ -265,6 +286,13 @@ void KisTransactionData::redo()
 
     DEBUG_ACTION("Redo()");
 
+    /**
+     * Flattening of the selection changes the pixels outside
+     * the memento, so such changes are not tracked
+     */
+    const int lod0ChangeCookie = !m_d->flattenUndoCommand ?
+        m_d->device->beginLod0Change(m_d->savedDataManager) : -1;
+
     if (m_d->interstrokeInfo && m_d->interstrokeInfo->beginTransactionCommand) {
         m_d->interstrokeInfo->beginTransactionCommand->redo();
     }
@@ -282,6 +310,9 @@ void KisTransactionData::redo()
 
     m_d->possiblySwitchCurrentTime();
     startUpdates();
+
+    m_d->device->endLod0Change(lod0ChangeCookie, m_d->changedRect());
+
     possiblyNotifySelectionChanged();
 }
 
@@ -289,6 +320,9 @@ void KisTransactionData::undo()
 {
     DEBUG_ACTION("Undo()");
 
+    const int lod0ChangeCookie = !m_d->flattenUndoCommand ?
+        m_d->device->beginLod0Change(m_d->savedDataManager) : -1;
+
     if (m_d->interstrokeInfo && m_d->interstrokeInfo->endTransactionCommand) {
         m_d->interstrokeInfo->endTransactionCommand->undo();
     }
@@ -309,6 +343,9 @@ void KisTransactionData::undo()
 
     m_d->possiblySwitchCurrentTime();
     startUpdates();
+
+    m_d->device->endLod0Change(lod0ChangeCookie, m_d->changedRect());
+
     possiblyNotifySelectionChanged();
 }
 
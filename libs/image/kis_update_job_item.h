@@ -17,6 +17,7 @@
 #include "kis_base_rects_walker.h"
 #include "kis_async_merger.h"
 #include "kis_updater_context.h"
+#include "kis_update_time_monitor.h"
 #include <KoAlwaysInline.h>
 
 //#define DEBUG_JOBS_SEQUENCE
@@ -59,8 +60,8 @@ private:
         if (!isRunning()) return;
 
         /**
-         * Here we break the idea of QThreadPool a bit. Ideally, we should split the
-         * jobs into distinct QRunnable objects and pass all of them to QThreadPool.
+         * Here we break the idea of a thread pool a bit. Ideally, we should split the
+         * jobs into distinct QRunnable objects and pass all of them to the executor.
          * That is a nice idea, but it doesn't work well when the jobs are small enough
          * and the number of available cores is high (>4 cores). It this case the
          * threads just tend to execute the job very quickly and go to sleep, which is
@@ -97,6 +98,11 @@ private:
                     }
 #endif
 
+                    KisUpdateTimeMonitor::TraceSpan span(
+                        m_atomicType == Type::STROKE ? "stroke" : "spontaneous",
+                        KisUpdateTimeMonitor::instance()->isTracingEnabled() ?
+                            m_runnableJob->debugName() : QString());
+
                     m_runnableJob->run();
                 }
             }
@@ -132,7 +138,15 @@ public:
 
 #endif
 
-        m_merger.startMerge(*m_walker);
+        m_merger.setUseGroupCompositionCache(m_updaterContext->useGroupCompositionCache());
+
+        {
+            KisUpdateTimeMonitor::TraceSpan span("merge",
+                KisUpdateTimeMonitor::instance()->isTracingEnabled() ?
+                    m_walker->startNode().data() : nullptr,
+                m_walker->requestedRect());
+            m_merger.startMerge(*m_walker);
+        }
 
         QRect changeRect = m_walker->changeRect();
         m_updaterContext->continueUpdate(changeRect);
@@ -229,6 +229,11 @@ KisLodPreferences KisUpdateScheduler::lodPreferences() const
     return m_d->strokesQueue.lodPreferences();
 }
 
+void KisUpdateScheduler::setViewportRects(const QVector<QRect> &rects)
+{
+    m_d->updatesQueue.setViewportRects(rects);
+}
+
 void KisUpdateScheduler::explicitRegenerateLevelOfDetail()
 {
     m_d->strokesQueue.explicitRegenerateLevelOfDetail();
@@ -283,6 +288,9 @@ void KisUpdateScheduler::updateSettings()
     m_d->updatesQueue.updateSettings();
     KisImageConfig config(true);
     m_d->defaultBalancingRatio = config.schedulerBalancingRatio();
+    m_d->updaterContext.setUseGroupCompositionCache(config.cacheGroupComposition());
+    m_d->strokesQueue.setStrokeJobBatchingLimits(config.maxStrokeJobBatchSize(),
+                                                 config.strokeJobBatchTargetTime());
     setThreadsLimit(config.maxNumberOfThreads());
 }
 
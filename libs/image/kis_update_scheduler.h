@@ -156,6 +156,14 @@ public:
      */
     KisLodPreferences lodPreferences() const;
 
+    /**
+     * Sets the rects of the image currently visible on the canvases,
+     * the updates of these areas are processed first.
+     *
+     * \see KisSimpleUpdateQueue::setViewportRects()
+     */
+    void setViewportRects(const QVector<QRect> &rects);
+
     /**
      * Explicitly start regeneration of LoD planes of all the devices
      * in the image. This call should be performed when the user is idle,
@@ -18,18 +18,75 @@
 #include <QDir>
 
 #include <QElapsedTimer>
+#include <QThread>
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
 
 #include <QFileInfo>
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include <kis_debug.h>
 #include <KisPortingUtils.h>
 #include "kis_image_config.h"
+#include "kis_node.h"
 
 
 #include <brushengine/kis_paintop_preset.h>
 
 Q_GLOBAL_STATIC(KisUpdateTimeMonitor, s_instance)
 
+namespace {
+
+/**
+ * Every thread collects its events in its own buffer and writes them
+ * into the trace file in chunks of this size, so the threads don't
+ * fight for a lock on every span, and the memory usage doesn't grow
+ * with the length of the trace.
+ */
+const int TRACE_CHUNK_SIZE = 4096;
+
+/**
+ * An event takes about 150 bytes in the file, so the trace file
+ * is limited to about 150 MiB. When the limit is reached, the
+ * new events are dropped, the old ones are kept.
+ */
+const int MAX_TRACE_EVENTS = 1000000;
+
+struct TraceEvent
+{
+    const char *category;
+    QString name;
+    qint64 startTime;
+    qint64 endTime;
+    QRect rect;
+};
+
+struct ThreadTraceBuffer
+{
+    /**
+     * The lock is taken by the owner thread only, unless the
+     * tracing is being started or stopped
+     */
+    QMutex mutex;
+    QVector<TraceEvent> events;
+
+    int threadId = -1;
+    QString threadName;
+
+    /**
+     * Guarded by the trace file lock
+     */
+    bool threadNameWritten = false;
+};
+
+thread_local ThreadTraceBuffer *t_traceBuffer = nullptr;
+
+}
+
 
 struct StrokeTicket
 {
@@ -93,8 +150,110 @@ struct Q_DECL_HIDDEN KisUpdateTimeMonitor::Private
     KisPaintOpPresetSP preset;
 
     bool loggingEnabled;
+
+    std::atomic<bool> tracingEnabled {false};
+    std::atomic<int> numTraceEvents {0};
+    std::atomic<int> numDroppedTraceEvents {0};
+    QElapsedTimer traceClock;
+
+    /**
+     * The buffers are never deleted while the monitor is alive,
+     * so the threads may keep raw pointers to them
+     */
+    QMutex traceBuffersMutex;
+    std::vector<std::unique_ptr<ThreadTraceBuffer>> traceBuffers;
+
+    QMutex traceFileMutex;
+    QFile traceFile;
+    bool traceFileHasEvents = false;
+    bool traceQuitHandlerConnected = false;
+
+    ThreadTraceBuffer* currentThreadTraceBuffer();
+    void writeTraceChunk(ThreadTraceBuffer *buffer, const QVector<TraceEvent> &events);
 };
 
+ThreadTraceBuffer* KisUpdateTimeMonitor::Private::currentThreadTraceBuffer()
+{
+    if (!t_traceBuffer) {
+        QMutexLocker locker(&traceBuffersMutex);
+
+        std::unique_ptr<ThreadTraceBuffer> buffer(new ThreadTraceBuffer());
+        buffer->threadId = int(traceBuffers.size());
+        buffer->threadName = QThread::currentThread()->objectName();
+
+        if (buffer->threadName.isEmpty()) {
+            buffer->threadName = qApp && QThread::currentThread() == qApp->thread() ?
+                QString("GUI thread") : QString("Thread %1").arg(buffer->threadId);
+        }
+
+        t_traceBuffer = buffer.get();
+        traceBuffers.push_back(std::move(buffer));
+    }
+
+    return t_traceBuffer;
+}
+
+void KisUpdateTimeMonitor::Private::writeTraceChunk(ThreadTraceBuffer *buffer, const QVector<TraceEvent> &events)
+{
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    QByteArray data;
+
+    Q_FOREACH (const TraceEvent &traceEvent, events) {
+        QJsonObject event;
+        event["ph"] = "X";
+        event["cat"] = QString::fromLatin1(traceEvent.category);
+        event["name"] = traceEvent.name;
+        event["pid"] = pid;
+        event["tid"] = buffer->threadId;
+        event["ts"] = qreal(traceEvent.startTime) / 1000.0;
+        event["dur"] = qreal(traceEvent.endTime - traceEvent.startTime) / 1000.0;
+
+        if (!traceEvent.rect.isEmpty()) {
+            const QRect &rc = traceEvent.rect;
+            event["args"] = QJsonObject({{"x", rc.x()},
+                                         {"y", rc.y()},
+                                         {"width", rc.width()},
+                                         {"height", rc.height()},
+                                         {"area", qint64(rc.width()) * rc.height()}});
+        }
+
+        if (!data.isEmpty()) {
+            data += ",\n";
+        }
+        data += QJsonDocument(event).toJson(QJsonDocument::Compact);
+    }
+
+    QMutexLocker locker(&traceFileMutex);
+
+    // the tracing has been stopped while we were serializing the chunk
+    if (!traceFile.isOpen() || data.isEmpty()) return;
+
+    // the name of the thread should go before its first event
+    if (!buffer->threadNameWritten) {
+        QJsonObject event;
+        event["ph"] = "M";
+        event["name"] = "thread_name";
+        event["pid"] = pid;
+        event["tid"] = buffer->threadId;
+        event["args"] = QJsonObject({{"name", buffer->threadName}});
+
+        if (traceFileHasEvents) {
+            traceFile.write(",\n");
+        }
+        traceFile.write(QJsonDocument(event).toJson(QJsonDocument::Compact));
+
+        buffer->threadNameWritten = true;
+        traceFileHasEvents = true;
+    }
+
+    if (traceFileHasEvents) {
+        traceFile.write(",\n");
+    }
+    traceFile.write(data);
+    traceFileHasEvents = true;
+}
+
 KisUpdateTimeMonitor::KisUpdateTimeMonitor()
     : m_d(new Private)
 {
@@ -105,10 +264,16 @@ KisUpdateTimeMonitor::KisUpdateTimeMonitor()
         }
         dir.mkdir("log");
     }
+
+    const QString traceFileName = qEnvironmentVariable("KRITA_UPDATE_TRACE");
+    if (!traceFileName.isEmpty()) {
+        startTracing(traceFileName);
+    }
 }
 
 KisUpdateTimeMonitor::~KisUpdateTimeMonitor()
 {
+    stopTracing();
     delete m_d;
 }
 
@@ -245,3 +410,175 @@ void KisUpdateTimeMonitor::reportUpdateFinished(const QRect &rect)
     }
     m_d->numUpdates++;
 }
+
+void KisUpdateTimeMonitor::startTracing(const QString &fileName)
+{
+    stopTracing();
+
+    QMutexLocker buffersLocker(&m_d->traceBuffersMutex);
+
+    for (auto &buffer : m_d->traceBuffers) {
+        QMutexLocker bufferLocker(&buffer->mutex);
+        buffer->events.clear();
+    }
+
+    {
+        QMutexLocker locker(&m_d->traceFileMutex);
+
+        for (auto &buffer : m_d->traceBuffers) {
+            buffer->threadNameWritten = false;
+        }
+
+        m_d->traceFile.setFileName(fileName);
+        if (!m_d->traceFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            warnKrita << "KisUpdateTimeMonitor: failed to open trace file" << fileName;
+            return;
+        }
+
+        m_d->traceFile.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+        m_d->traceFileHasEvents = false;
+    }
+
+    buffersLocker.unlock();
+
+    m_d->numTraceEvents = 0;
+    m_d->numDroppedTraceEvents = 0;
+
+    if (!m_d->traceClock.isValid()) {
+        m_d->traceClock.start();
+    }
+
+    /**
+     * The global static is destroyed too late to rely on,
+     * so finish the file when the application quits
+     */
+    if (qApp && !m_d->traceQuitHandlerConnected) {
+        QObject::connect(qApp, &QCoreApplication::aboutToQuit, qApp, [this] () {
+            stopTracing();
+        });
+        m_d->traceQuitHandlerConnected = true;
+    }
+
+    m_d->tracingEnabled = true;
+}
+
+void KisUpdateTimeMonitor::stopTracing()
+{
+    if (!m_d->tracingEnabled.exchange(false)) return;
+
+    QVector<ThreadTraceBuffer*> buffers;
+
+    {
+        QMutexLocker locker(&m_d->traceBuffersMutex);
+
+        for (auto &buffer : m_d->traceBuffers) {
+            buffers.append(buffer.get());
+        }
+    }
+
+    Q_FOREACH (ThreadTraceBuffer *buffer, buffers) {
+        QVector<TraceEvent> events;
+
+        {
+            QMutexLocker locker(&buffer->mutex);
+            events.swap(buffer->events);
+        }
+
+        m_d->writeTraceChunk(buffer, events);
+    }
+
+    QMutexLocker locker(&m_d->traceFileMutex);
+
+    if (!m_d->traceFile.isOpen()) return;
+
+    m_d->traceFile.write("\n]");
+
+    const int numDroppedEvents = m_d->numDroppedTraceEvents;
+    if (numDroppedEvents) {
+        m_d->traceFile.write(QString(",\"otherData\":{\"droppedEvents\":%1}").arg(numDroppedEvents).toLatin1());
+    }
+
+    m_d->traceFile.write("}\n");
+    m_d->traceFile.close();
+}
+
+bool KisUpdateTimeMonitor::isTracingEnabled() const
+{
+    return m_d->tracingEnabled.load(std::memory_order_relaxed);
+}
+
+qint64 KisUpdateTimeMonitor::traceTimestamp() const
+{
+    return m_d->traceClock.nsecsElapsed();
+}
+
+void KisUpdateTimeMonitor::reportTraceSpan(const char *category, const QString &name,
+                                           qint64 startTime, qint64 endTime,
+                                           const QRect &rect)
+{
+    if (!m_d->tracingEnabled) return;
+
+    if (m_d->numTraceEvents.fetch_add(1, std::memory_order_relaxed) >= MAX_TRACE_EVENTS) {
+        m_d->numDroppedTraceEvents.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    ThreadTraceBuffer *buffer = m_d->currentThreadTraceBuffer();
+    QVector<TraceEvent> chunk;
+
+    {
+        QMutexLocker locker(&buffer->mutex);
+
+        buffer->events.append({category, name, startTime, endTime, rect});
+
+        if (buffer->events.size() >= TRACE_CHUNK_SIZE) {
+            chunk.swap(buffer->events);
+        }
+    }
+
+    if (!chunk.isEmpty()) {
+        m_d->writeTraceChunk(buffer, chunk);
+    }
+}
+
+KisUpdateTimeMonitor::TraceSpan::TraceSpan(const char *category, const QString &name, const QRect &rect)
+    : m_category(category)
+{
+    KisUpdateTimeMonitor *monitor = KisUpdateTimeMonitor::instance();
+
+    if (monitor && monitor->isTracingEnabled()) {
+        m_name = name;
+        m_rect = rect;
+        m_startTime = monitor->traceTimestamp();
+    }
+}
+
+KisUpdateTimeMonitor::TraceSpan::TraceSpan(const char *category, const KisNode *node, const QRect &rect)
+    : m_category(category)
+{
+    KisUpdateTimeMonitor *monitor = KisUpdateTimeMonitor::instance();
+
+    if (monitor && monitor->isTracingEnabled()) {
+        m_name = node ? node->name() : QString();
+        m_rect = rect;
+        m_startTime = monitor->traceTimestamp();
+    }
+}
+
+KisUpdateTimeMonitor::TraceSpan::~TraceSpan()
+{
+    if (m_startTime < 0) return;
+
+    KisUpdateTimeMonitor *monitor = KisUpdateTimeMonitor::instance();
+
+    if (monitor) {
+        monitor->reportTraceSpan(m_category, m_name,
+                                 m_startTime, monitor->traceTimestamp(),
+                                 m_rect);
+    }
+}
+
+void KisUpdateTimeMonitor::TraceSpan::setRect(const QRect &rect)
+{
+    m_rect = rect;
+}
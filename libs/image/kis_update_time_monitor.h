@@ -12,8 +12,9 @@
 
 
 #include <QVector>
+#include <QRect>
+#include <QString>
 class QPointF;
-class QRect;
 
 
 class KRITAIMAGE_EXPORT KisUpdateTimeMonitor
@@ -34,6 +35,61 @@ public:
     void reportJobFinished(void *key, const QVector<QRect> &rects);
     void reportUpdateFinished(const QRect &rect);
 
+public:
+    /**
+     * Tracing of the individual stages of the image updates. When
+     * enabled, every TraceSpan is recorded with its thread and rect
+     * and streamed into \p fileName in Chrome trace event format,
+     * which can be opened in chrome://tracing or https://ui.perfetto.dev.
+     * The file is finished by stopTracing() or when the application
+     * quits.
+     *
+     * Tracing is started automatically if KRITA_UPDATE_TRACE environment
+     * variable contains the name of the file (or with --trace-updates
+     * command line option of Krita)
+     */
+    void startTracing(const QString &fileName);
+    void stopTracing();
+    bool isTracingEnabled() const;
+
+    /**
+     * Records a span of \p category that started at \p startTime
+     * and ended at \p endTime (in nanoseconds of traceTimestamp())
+     */
+    void reportTraceSpan(const char *category, const QString &name,
+                         qint64 startTime, qint64 endTime,
+                         const QRect &rect);
+
+    qint64 traceTimestamp() const;
+
+    /**
+     * Records the lifetime of the object as a trace span. Does
+     * nothing, when tracing is disabled.
+     */
+    class KRITAIMAGE_EXPORT TraceSpan
+    {
+    public:
+        TraceSpan(const char *category, const QString &name, const QRect &rect = QRect());
+
+        /**
+         * The name of \p node is fetched only when tracing is enabled.
+         * The node is passed as a raw pointer to avoid touching its
+         * reference counter when tracing is disabled.
+         */
+        TraceSpan(const char *category, const KisNode *node, const QRect &rect = QRect());
+        ~TraceSpan();
+
+        void setRect(const QRect &rect);
+
+    private:
+        Q_DISABLE_COPY(TraceSpan)
+
+        const char *m_category;
+        QString m_name;
+        QRect m_rect;
+        qint64 m_startTime = -1;
+    };
+
 
 private:
     struct Private;
@@ -7,7 +7,6 @@
 #include "kis_updater_context.h"
 
 #include <QThread>
-#include <QThreadPool>
 
 #include "kis_update_job_item.h"
 #include "kis_stroke_job.h"
@@ -15,7 +14,8 @@
 const int KisUpdaterContext::useIdealThreadCountTag = -1;
 
 KisUpdaterContext::KisUpdaterContext(qint32 threadCount, KisUpdateScheduler *parent)
-    : m_scheduler(parent)
+    : m_executor(1),
+      m_scheduler(parent)
 {
     if(threadCount <= 0) {
         threadCount = QThread::idealThreadCount();
@@ -27,7 +27,7 @@ KisUpdaterContext::KisUpdaterContext(qint32 threadCount, KisUpdateScheduler *par
 
 KisUpdaterContext::~KisUpdaterContext()
 {
-    m_threadPool.waitForDone();
+    m_executor.waitForDone();
 
     if (m_testingMode) {
         clear();
@@ -119,6 +119,20 @@ bool KisUpdaterContext::hasSpareThread()
     return found;
 }
 
+int KisUpdaterContext::numSpareThreads()
+{
+    int result = 0;
+
+    // see a comment in hasSpareThread()
+    for (const KisUpdateJobItem *item : std::as_const(m_jobs)) {
+        if (!item->isRunning()) {
+            result++;
+        }
+    }
+
+    return result;
+}
+
 bool KisUpdaterContext::isJobAllowed(KisBaseRectsWalkerSP walker)
 {
     int lod = this->currentLevelOfDetail();
@@ -149,7 +163,7 @@ void KisUpdaterContext::startThread(int index)
         m_numRunningThreads++;
     }
 
-    m_threadPool.start(m_jobs[index]);
+    m_executor.start(m_jobs[index]);
 }
 
 /**
@@ -247,13 +261,13 @@ void KisUpdaterContext::unlock()
 
 void KisUpdaterContext::setThreadsLimit(int value)
 {
-    m_threadPool.setMaxThreadCount(value);
-
     for (int i = 0; i < m_jobs.size(); i++) {
         KIS_SAFE_ASSERT_RECOVER_RETURN(!m_jobs[i]->isRunning());
         // don't delete the jobs until all of them are checked!
     }
 
+    m_executor.setMaxThreadCount(value);
+
     for (int i = 0; i < m_jobs.size(); i++) {
         delete m_jobs[i];
     }
@@ -267,10 +281,25 @@ void KisUpdaterContext::setThreadsLimit(int value)
 
 int KisUpdaterContext::threadsLimit() const
 {
-    KIS_SAFE_ASSERT_RECOVER_NOOP(m_jobs.size() == m_threadPool.maxThreadCount());
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_jobs.size() == m_executor.maxThreadCount());
     return m_jobs.size();
 }
 
+void KisUpdaterContext::setUseGroupCompositionCache(bool value)
+{
+    m_useGroupCompositionCache = value;
+}
+
+bool KisUpdaterContext::useGroupCompositionCache() const
+{
+    return m_useGroupCompositionCache;
+}
+
+KisWorkStealingExecutor::Statistics KisUpdaterContext::executorStatistics() const
+{
+    return m_executor.statistics();
+}
+
 void KisUpdaterContext::continueUpdate(const QRect& rc)
 {
     if (m_scheduler) m_scheduler->continueUpdate(rc);
@@ -9,12 +9,14 @@
 
 #include <QMutex>
 #include <QReadWriteLock>
-#include <QThreadPool>
 #include <QWaitCondition>
 
+#include <atomic>
+
 #include "kis_base_rects_walker.h"
 #include "kis_async_merger.h"
 #include "kis_lock_free_lod_counter.h"
+#include "KisWorkStealingExecutor.h"
 
 #include "KisUpdaterContextSnapshotEx.h"
 #include "kis_update_scheduler.h"
@@ -56,6 +58,12 @@ public:
      */
     bool hasSpareThread();
 
+    /**
+     * Returns the number of threads that are not running
+     * any job at the moment
+     */
+    int numSpareThreads();
+
     /**
      * Checks whether the walker intersects with any
      * of currently executing walkers. If it does,
@@ -127,6 +135,22 @@ public:
      */
     int threadsLimit() const;
 
+    /**
+     * Make the merge jobs use the composition caches of the group
+     * layers, \see KisGroupCompositionCache. The value is picked up
+     * by every merge job when it starts, so it can be changed at
+     * any moment.
+     */
+    void setUseGroupCompositionCache(bool value);
+    bool useGroupCompositionCache() const;
+
+    /**
+     * Returns the counters of the executor running the jobs of
+     * the context: the depth of the job queues and the number
+     * of the jobs stolen by idle threads
+     */
+    KisWorkStealingExecutor::Statistics executorStatistics() const;
+
     void continueUpdate(const QRect& rc);
     void doSomeUsefulWork();
     void jobFinished();
@@ -153,10 +177,11 @@ protected:
     int m_numRunningThreads = 0;
     QWaitCondition m_waitForDoneCondition;
     QVector<KisUpdateJobItem*> m_jobs;
-    QThreadPool m_threadPool;
+    KisWorkStealingExecutor m_executor;
     KisLockFreeLodCounter m_lodCounter;
     KisUpdateScheduler *m_scheduler;
     bool m_testingMode = false;
+    std::atomic<bool> m_useGroupCompositionCache {false};
 
 private:
 
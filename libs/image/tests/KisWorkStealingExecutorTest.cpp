@@ -0,0 +1,130 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisWorkStealingExecutorTest.h"
+
+#include <QAtomicInt>
+#include <QRunnable>
+
+#include "KisWorkStealingExecutor.h"
+
+namespace {
+
+class CountingJob : public QRunnable
+{
+public:
+    CountingJob(QAtomicInt *counter)
+        : m_counter(counter)
+    {
+    }
+
+    void run() override {
+        m_counter->ref();
+    }
+
+private:
+    QAtomicInt *m_counter;
+};
+
+/**
+ * Spawns two more jobs from inside the worker thread
+ * until the depth limit is reached
+ */
+class SpawningJob : public QRunnable
+{
+public:
+    SpawningJob(KisWorkStealingExecutor *executor, QAtomicInt *counter, int depth)
+        : m_executor(executor),
+          m_counter(counter),
+          m_depth(depth)
+    {
+    }
+
+    void run() override {
+        m_counter->ref();
+
+        if (m_depth > 0) {
+            m_executor->start(new SpawningJob(m_executor, m_counter, m_depth - 1));
+            m_executor->start(new SpawningJob(m_executor, m_counter, m_depth - 1));
+        }
+    }
+
+private:
+    KisWorkStealingExecutor *m_executor;
+    QAtomicInt *m_counter;
+    int m_depth;
+};
+
+}
+
+void KisWorkStealingExecutorTest::testRunJobs()
+{
+    const int numJobs = 1000;
+
+    KisWorkStealingExecutor executor(4);
+    QAtomicInt counter;
+
+    for (int i = 0; i < numJobs; i++) {
+        executor.start(new CountingJob(&counter));
+    }
+
+    executor.waitForDone();
+
+    QCOMPARE(counter.loadAcquire(), numJobs);
+
+    KisWorkStealingExecutor::Statistics stats = executor.statistics();
+    QCOMPARE(stats.numStartedJobs, qint64(numJobs));
+    QCOMPARE(stats.numLocalJobs + stats.numStolenJobs, qint64(numJobs));
+    QCOMPARE(stats.queueDepth, 0);
+    QVERIFY(stats.maxQueueDepth > 0);
+}
+
+void KisWorkStealingExecutorTest::testNestedJobs()
+{
+    const int depth = 12;
+    const int numJobs = (1 << (depth + 1)) - 1;
+
+    KisWorkStealingExecutor executor(4);
+    QAtomicInt counter;
+
+    executor.start(new SpawningJob(&executor, &counter, depth));
+    executor.waitForDone();
+
+    QCOMPARE(counter.loadAcquire(), numJobs);
+
+    KisWorkStealingExecutor::Statistics stats = executor.statistics();
+    QCOMPARE(stats.numStartedJobs, qint64(numJobs));
+    QCOMPARE(stats.numLocalJobs + stats.numStolenJobs, qint64(numJobs));
+    QCOMPARE(stats.queueDepth, 0);
+
+    executor.resetStatistics();
+    stats = executor.statistics();
+    QCOMPARE(stats.numStartedJobs, qint64(0));
+    QCOMPARE(stats.numStolenJobs, qint64(0));
+}
+
+void KisWorkStealingExecutorTest::testChangeThreadCount()
+{
+    KisWorkStealingExecutor executor(2);
+    QAtomicInt counter;
+
+    for (int i = 0; i < 100; i++) {
+        executor.start(new CountingJob(&counter));
+    }
+
+    executor.setMaxThreadCount(8);
+    QCOMPARE(executor.maxThreadCount(), 8);
+    QCOMPARE(counter.loadAcquire(), 100);
+
+    for (int i = 0; i < 100; i++) {
+        executor.start(new CountingJob(&counter));
+    }
+
+    executor.waitForDone();
+    QCOMPARE(counter.loadAcquire(), 200);
+}
+
+SIMPLE_TEST_MAIN(KisWorkStealingExecutorTest)
@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISWORKSTEALINGEXECUTORTEST_H
+#define KISWORKSTEALINGEXECUTORTEST_H
+
+#include <simpletest.h>
+
+class KisWorkStealingExecutorTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testRunJobs();
+    void testNestedJobs();
+    void testChangeThreadCount();
+};
+
+#endif // KISWORKSTEALINGEXECUTORTEST_H
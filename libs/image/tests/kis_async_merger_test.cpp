@@ -9,6 +9,7 @@
 #include "kis_merge_walker.h"
 #include "kis_full_refresh_walker.h"
 #include "kis_async_merger.h"
+#include "KisGroupCompositionCache.h"
 
 #include <simpletest.h>
 #include <KoColorSpaceRegistry.h>
@@ -497,5 +498,123 @@ void KisAsyncMergerTest::testFilterMaskOnFilterLayer()
 }
 
 
+/*
+  +--------------+
+  |root          |
+  | paint 4      |
+  | paint 3      |
+  | paint 2      |
+  | paint 1      |
+  +--------------+
+ */
+void KisAsyncMergerTest::testGroupCompositionCache()
+{
+    const QRect imageRect(0, 0, 128, 128);
+    const QRect dirtyRect(32, 32, 32, 32);
+
+    const KoColorSpace *colorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), colorSpace, "cache test");
+
+    KisPaintDeviceSP device1 = new KisPaintDevice(colorSpace);
+    device1->fill(imageRect, KoColor(Qt::white, colorSpace));
+    KisLayerSP paintLayer1 = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8, device1);
+
+    KisPaintDeviceSP device2 = new KisPaintDevice(colorSpace);
+    KisLayerSP paintLayer2 = new KisPaintLayer(image, "paint2", 200, device2);
+
+    KisPaintDeviceSP device3 = new KisPaintDevice(colorSpace);
+    device3->fill(QRect(40, 0, 16, 128), KoColor(Qt::red, colorSpace));
+    KisLayerSP paintLayer3 = new KisPaintLayer(image, "paint3", 128, device3);
+
+    KisPaintDeviceSP device4 = new KisPaintDevice(colorSpace);
+    device4->fill(QRect(0, 40, 128, 16), KoColor(Qt::blue, colorSpace));
+    KisLayerSP paintLayer4 = new KisPaintLayer(image, "paint4", 100, device4);
+
+    image->addNode(paintLayer1, image->rootLayer());
+    image->addNode(paintLayer2, image->rootLayer());
+    image->addNode(paintLayer3, image->rootLayer());
+    image->addNode(paintLayer4, image->rootLayer());
+
+    image->initialRefreshGraph();
+
+    KisGroupCompositionCache *cache = image->rootLayer()->compositionCache();
+
+    KisMergeWalker walker(imageRect);
+    KisAsyncMerger merger;
+    merger.setUseGroupCompositionCache(true);
+
+    // the first update of paint 2 fills the cache
+    device2->fill(dirtyRect, KoColor(Qt::green, colorSpace));
+    walker.collectRects(paintLayer2, dirtyRect);
+    merger.startMerge(walker);
+
+    QCOMPARE(cache->testingBelowRegion(), QRegion(dirtyRect));
+    QCOMPARE(cache->testingAboveRegion(), QRegion(dirtyRect));
+    QCOMPARE(cache->testingNumBelowHits(), 0);
+    QCOMPARE(cache->testingNumAboveHits(), 0);
+
+    // the second one composites the cached planes only
+    walker.collectRects(paintLayer2, dirtyRect);
+    merger.startMerge(walker);
+
+    QCOMPARE(cache->testingNumBelowHits(), 1);
+    QCOMPARE(cache->testingNumAboveHits(), 1);
+
+    // the result is the same as the one of the full composition
+    const QImage cachedImage = image->projection()->convertToQImage(0, imageRect);
+
+    {
+        KisFullRefreshWalker refreshWalker(imageRect);
+        KisAsyncMerger refreshMerger;
+
+        refreshWalker.collectRects(image->rootLayer(), imageRect);
+        refreshMerger.startMerge(refreshWalker);
+
+        QPoint pt;
+        QVERIFY(TestUtil::compareQImages(pt, cachedImage,
+                                         image->projection()->convertToQImage(0, imageRect), 1, 1));
+    }
+
+    // the full refresh has dropped the cached data
+    QVERIFY(cache->testingBelowRegion().isEmpty());
+    QVERIFY(cache->testingAboveRegion().isEmpty());
+
+    device2->fill(dirtyRect, KoColor(Qt::green, colorSpace));
+    walker.collectRects(paintLayer2, dirtyRect);
+    merger.startMerge(walker);
+
+    QCOMPARE(cache->testingBelowRegion(), QRegion(dirtyRect));
+
+    /**
+     * Change paint 1 without notifying the image. The next update of
+     * paint 2 takes the composition of paint 1 from the cache, so the
+     * change is not visible.
+     */
+    device1->fill(imageRect, KoColor(Qt::black, colorSpace));
+
+    walker.collectRects(paintLayer2, dirtyRect);
+    merger.startMerge(walker);
+
+    QCOMPARE(image->projection()->convertToQImage(0, dirtyRect).pixelColor(0, 0),
+             cachedImage.pixelColor(dirtyRect.topLeft()));
+
+    // the update of paint 1 rebinds the cache to it
+    walker.collectRects(paintLayer1, dirtyRect);
+    merger.startMerge(walker);
+
+    QVERIFY(cache->testingBelowRegion().isEmpty());
+    QCOMPARE(cache->testingAboveRegion(), QRegion(dirtyRect));
+    QVERIFY(image->projection()->convertToQImage(0, dirtyRect).pixelColor(0, 0) !=
+            cachedImage.pixelColor(dirtyRect.topLeft()));
+
+    // the disabled merger drops the cache
+    merger.setUseGroupCompositionCache(false);
+    walker.collectRects(paintLayer2, dirtyRect);
+    merger.startMerge(walker);
+
+    QVERIFY(cache->testingBelowRegion().isEmpty());
+    QVERIFY(cache->testingAboveRegion().isEmpty());
+}
+
 SIMPLE_TEST_MAIN(KisAsyncMergerTest)
 
@@ -1538,6 +1538,290 @@ void KisPaintDeviceTest::testLodDevice()
                                   "lod", "lod1-offset-6-14"));
 }
 
+void KisPaintDeviceTest::testLodPyramid()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect fillRect(10, 10, 80, 80);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    TestingLodDefaultBounds *bounds = new TestingLodDefaultBounds();
+    dev->setDefaultBounds(bounds);
+    fillGradientDevice(dev, fillRect);
+
+    KisPaintDeviceSP refDev = new KisPaintDevice(cs);
+    TestingLodDefaultBounds *refBounds = new TestingLodDefaultBounds();
+    refDev->setDefaultBounds(refBounds);
+    fillGradientDevice(refDev, fillRect);
+
+    QPoint errpoint;
+
+    // Lod2 generated from the Lod1 plane should match the one generated from Lod0
+    bounds->testingSetLevelOfDetail(1);
+    syncLodCache(dev, 1);
+
+    bounds->testingSetLevelOfDetail(2);
+    syncLodCache(dev, 2);
+
+    refBounds->testingSetLevelOfDetail(2);
+    syncLodCache(refDev, 2);
+
+    QCOMPARE(dev->exactBounds(), refDev->exactBounds());
+    QVERIFY(TestUtil::compareQImages(errpoint,
+                                     refDev->convertToQImage(0, 0, 0, 100, 100),
+                                     dev->convertToQImage(0, 0, 0, 100, 100),
+                                     1, 1));
+
+    // the Lod1 plane is kept in the pyramid and reused as it is
+    bounds->testingSetLevelOfDetail(1);
+    syncLodCache(dev, 1);
+    const QImage lod1Image = dev->convertToQImage(0, 0, 0, 100, 100);
+
+    const KoColor markColor(Qt::blue, cs);
+    dev->setPixel(20, 20, markColor);
+
+    bounds->testingSetLevelOfDetail(2);
+    syncLodCache(dev, 2);
+
+    bounds->testingSetLevelOfDetail(1);
+    syncLodCache(dev, 1);
+
+    KoColor color(cs);
+    dev->pixel(20, 20, &color);
+    QVERIFY(color == markColor);
+
+    // the modification of Lod0 invalidates the pyramid
+    bounds->testingSetLevelOfDetail(0);
+    fillGradientDevice(dev, fillRect);
+
+    bounds->testingSetLevelOfDetail(2);
+    syncLodCache(dev, 2);
+
+    bounds->testingSetLevelOfDetail(1);
+    syncLodCache(dev, 1);
+
+    QVERIFY(TestUtil::compareQImages(errpoint,
+                                     lod1Image,
+                                     dev->convertToQImage(0, 0, 0, 100, 100)));
+}
+
+void KisPaintDeviceTest::testLodPyramidLimit()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    TestingLodDefaultBounds *bounds = new TestingLodDefaultBounds();
+    dev->setDefaultBounds(bounds);
+    fillGradientDevice(dev, QRect(10, 10, 80, 80));
+
+    auto lodDataSize = [dev] () {
+        qint64 imageData = 0;
+        qint64 temporaryData = 0;
+        qint64 lodData = 0;
+        dev->estimateMemoryStats(imageData, temporaryData, lodData);
+        return lodData;
+    };
+
+    QVector<qint64> sizes;
+
+    // every plane of this device takes a single tile
+    for (int lod = 1; lod <= 5; lod++) {
+        bounds->testingSetLevelOfDetail(lod);
+        syncLodCache(dev, lod);
+        sizes << lodDataSize();
+    }
+
+    // the active plane and three inactive ones, the oldest one is dropped
+    QVERIFY(sizes[0] < sizes[1]);
+    QVERIFY(sizes[1] < sizes[2]);
+    QVERIFY(sizes[2] < sizes[3]);
+    QCOMPARE(sizes[4], sizes[3]);
+}
+
+void KisPaintDeviceTest::testLodIncrementalSync()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect fillRect(10, 10, 80, 80);
+    const QRect changeRect(70, 70, 15, 10);
+    const KoColor changeColor(Qt::green, cs);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    TestingLodDefaultBounds *bounds = new TestingLodDefaultBounds();
+    dev->setDefaultBounds(bounds);
+    fillGradientDevice(dev, fillRect);
+
+    KisPaintDeviceSP refDev = new KisPaintDevice(cs);
+    TestingLodDefaultBounds *refBounds = new TestingLodDefaultBounds();
+    refDev->setDefaultBounds(refBounds);
+    fillGradientDevice(refDev, fillRect);
+
+    bounds->testingSetLevelOfDetail(1);
+    syncLodCache(dev, 1);
+
+    /**
+     * The mark is outside the changed area, so it will survive
+     * the synchronization only if it is incremental
+     */
+    const KoColor markColor(Qt::blue, cs);
+    dev->setPixel(5, 5, markColor);
+
+    bounds->testingSetLevelOfDetail(0);
+
+    KisTransaction transaction(dev);
+    dev->fill(changeRect, changeColor);
+    QScopedPointer<KUndo2Command> cmd(transaction.endAndTake());
+
+    bounds->testingSetLevelOfDetail(1);
+    syncLodCache(dev, 1);
+
+    refDev->fill(changeRect, changeColor);
+    refBounds->testingSetLevelOfDetail(1);
+    syncLodCache(refDev, 1);
+
+    KoColor color(cs);
+    dev->pixel(5, 5, &color);
+    QVERIFY(color == markColor);
+
+    QPoint errpoint;
+    QVERIFY(TestUtil::compareQImages(errpoint,
+                                     refDev->convertToQImage(0, 0, 0, 50, 50),
+                                     dev->convertToQImage(0, 0, 0, 50, 50),
+                                     0, 0, 1));
+
+    // undo is tracked as well
+    bounds->testingSetLevelOfDetail(0);
+    cmd->undo();
+
+    bounds->testingSetLevelOfDetail(1);
+    syncLodCache(dev, 1);
+
+    refBounds->testingSetLevelOfDetail(0);
+    fillGradientDevice(refDev, fillRect);
+    refBounds->testingSetLevelOfDetail(1);
+    syncLodCache(refDev, 1);
+
+    dev->pixel(5, 5, &color);
+    QVERIFY(color == markColor);
+
+    QVERIFY(TestUtil::compareQImages(errpoint,
+                                     refDev->convertToQImage(0, 0, 0, 50, 50),
+                                     dev->convertToQImage(0, 0, 0, 50, 50),
+                                     0, 0, 1));
+
+    // a change made outside a transaction makes the plane regenerate
+    bounds->testingSetLevelOfDetail(0);
+    dev->fill(changeRect, changeColor);
+
+    bounds->testingSetLevelOfDetail(1);
+    syncLodCache(dev, 1);
+
+    dev->pixel(5, 5, &color);
+    QVERIFY(!(color == markColor));
+}
+
+void KisPaintDeviceTest::testLodStashProjection()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect fillRect(10, 10, 80, 80);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->setProjectionDevice(true);
+    TestingLodDefaultBounds *bounds = new TestingLodDefaultBounds();
+    dev->setDefaultBounds(bounds);
+    fillGradientDevice(dev, fillRect);
+
+    KisPaintDeviceSP refDev = new KisPaintDevice(cs);
+    TestingLodDefaultBounds *refBounds = new TestingLodDefaultBounds();
+    refDev->setDefaultBounds(refBounds);
+    fillGradientDevice(refDev, fillRect);
+
+    refBounds->testingSetLevelOfDetail(1);
+    syncLodCache(refDev, 1);
+
+    qint64 imageData = 0;
+    qint64 temporaryData = 0;
+    qint64 lodData = 0;
+
+    // pre-render the Lod1 plane while Lod0 is active
+    QVERIFY(!dev->hasUpToDateLodPlane(1));
+
+    {
+        QScopedPointer<KisPaintDevice::LodDataStruct> s(dev->createLodDataStruct(1));
+        Q_FOREACH (const QRect &rc, KritaUtils::splitRegionIntoPatches(dev->regionForLodSyncing(), KritaUtils::optimalPatchSize())) {
+            dev->updateLodDataStruct(s.data(), rc);
+        }
+        dev->stashLodDataStruct(s.data());
+    }
+
+    dev->estimateMemoryStats(imageData, temporaryData, lodData);
+    QVERIFY(lodData > 0);
+    QVERIFY(dev->hasUpToDateLodPlane(1));
+    QVERIFY(!dev->hasUpToDateLodPlane(2));
+
+    bounds->testingSetLevelOfDetail(1);
+
+    {
+        // the stashed plane needs no regeneration
+        QScopedPointer<KisPaintDevice::LodDataStruct> s(dev->createLodDataStruct(1));
+        dev->uploadLodDataStruct(s.data());
+    }
+
+    QPoint errpoint;
+    QCOMPARE(dev->exactBounds(), refDev->exactBounds());
+    QVERIFY(TestUtil::compareQImages(errpoint,
+                                     refDev->convertToQImage(0, 0, 0, 100, 100),
+                                     dev->convertToQImage(0, 0, 0, 100, 100)));
+
+    // the change of Lod0 invalidates the stashed plane
+    bounds->testingSetLevelOfDetail(0);
+
+    {
+        QScopedPointer<KisPaintDevice::LodDataStruct> s(dev->createLodDataStruct(1));
+        Q_FOREACH (const QRect &rc, KritaUtils::splitRegionIntoPatches(dev->regionForLodSyncing(), KritaUtils::optimalPatchSize())) {
+            dev->updateLodDataStruct(s.data(), rc);
+        }
+        dev->stashLodDataStruct(s.data());
+    }
+
+    const QRect changeRect(30, 30, 20, 20);
+    const KoColor changeColor(Qt::green, cs);
+    QVERIFY(dev->hasUpToDateLodPlane(1));
+    dev->fill(changeRect, changeColor);
+    QVERIFY(!dev->hasUpToDateLodPlane(1));
+
+    bounds->testingSetLevelOfDetail(1);
+    syncLodCache(dev, 1);
+
+    refBounds->testingSetLevelOfDetail(0);
+    refDev->fill(changeRect, changeColor);
+    refBounds->testingSetLevelOfDetail(1);
+    syncLodCache(refDev, 1);
+
+    QVERIFY(TestUtil::compareQImages(errpoint,
+                                     refDev->convertToQImage(0, 0, 0, 100, 100),
+                                     dev->convertToQImage(0, 0, 0, 100, 100)));
+
+    // the plane is not stashed if Lod0 is changed during its generation
+    KisPaintDeviceSP concurrentDev = new KisPaintDevice(cs);
+    concurrentDev->setProjectionDevice(true);
+    concurrentDev->setDefaultBounds(new TestingLodDefaultBounds());
+    fillGradientDevice(concurrentDev, fillRect);
+
+    {
+        QScopedPointer<KisPaintDevice::LodDataStruct> s(concurrentDev->createLodDataStruct(1));
+
+        concurrentDev->fill(changeRect, changeColor);
+
+        Q_FOREACH (const QRect &rc, KritaUtils::splitRegionIntoPatches(concurrentDev->regionForLodSyncing(), KritaUtils::optimalPatchSize())) {
+            concurrentDev->updateLodDataStruct(s.data(), rc);
+        }
+        concurrentDev->stashLodDataStruct(s.data());
+    }
+
+    concurrentDev->estimateMemoryStats(imageData, temporaryData, lodData);
+    QCOMPARE(lodData, qint64(0));
+    QVERIFY(!concurrentDev->hasUpToDateLodPlane(1));
+}
+
 void KisPaintDeviceTest::benchmarkLod1Generation()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
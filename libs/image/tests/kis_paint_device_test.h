@@ -53,6 +53,10 @@ private Q_SLOTS:
 
     void testLodTransform();
     void testLodDevice();
+    void testLodPyramid();
+    void testLodPyramidLimit();
+    void testLodIncrementalSync();
+    void testLodStashProjection();
     void benchmarkLod1Generation();
     void benchmarkLod2Generation();
     void benchmarkLod3Generation();
@@ -26,6 +26,11 @@
 #include <KisGlobalResourcesInterface.h>
 
 #include "lod_override.h"
+#include "kis_image_config.h"
+#include "tiles3/kis_tile_data_interface.h"
+#include "KisMpl.h"
+
+#include <QRegion>
 
 
 
@@ -278,5 +283,190 @@ void KisSimpleUpdateQueueTest::testSpontaneousJobsCompression()
     QCOMPARE(jobsList[0], job3);
 }
 
+void KisSimpleUpdateQueueTest::testSplitIntoTileAlignedUnits()
+{
+    const int tileWidth = KisTileData::WIDTH;
+    const int tileHeight = KisTileData::HEIGHT;
+
+    const QRect rc(10, 20, 16 * tileWidth, 4 * tileHeight);
+
+    QVector<QRect> units = KisSimpleUpdateQueue::splitIntoTileAlignedUnits(rc, 4, 2 * tileWidth);
+    QCOMPARE(units.size(), 4);
+
+    QRegion unitedRegion;
+
+    Q_FOREACH (const QRect &unit, units) {
+        QVERIFY(!unitedRegion.intersects(unit));
+        unitedRegion += unit;
+
+        // the inner boundaries lie on the tile grid
+        if (unit.left() != rc.left()) {
+            QCOMPARE(unit.left() % tileWidth, 0);
+        }
+        if (unit.top() != rc.top()) {
+            QCOMPARE(unit.top() % tileHeight, 0);
+        }
+    }
+
+    QCOMPARE(unitedRegion, QRegion(rc));
+
+    // too small to be split
+    units = KisSimpleUpdateQueue::splitIntoTileAlignedUnits(QRect(0, 0, 3 * tileWidth, tileHeight), 4, 2 * tileWidth);
+    QCOMPARE(units.size(), 1);
+
+    // never more units than asked for
+    units = KisSimpleUpdateQueue::splitIntoTileAlignedUnits(QRect(0, 0, 64 * tileWidth, 64 * tileHeight), 3, 2 * tileWidth);
+    QCOMPARE(units.size(), 3);
+}
+
+void KisSimpleUpdateQueueTest::testWorkUnitsProcessing()
+{
+    const int numThreads = 4;
+    KisTestableUpdaterContext context(numThreads);
+
+    QRect imageRect(0, 0, 16 * KisTileData::WIDTH, 4 * KisTileData::HEIGHT);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    KisImageConfig config(false);
+    const bool oldSplitUpdatesIntoWorkUnits = config.splitUpdatesIntoWorkUnits();
+    config.setSplitUpdatesIntoWorkUnits(true);
+
+    // the config is persistent, restore it even when a check fails
+    auto restoreConfig = kismpl::finally([&] () {
+        config.setSplitUpdatesIntoWorkUnits(oldSplitUpdatesIntoWorkUnits);
+    });
+
+    KisTestableSimpleUpdateQueue queue;
+    queue.updateSettings();
+
+    // a long stroke, it is not split by the patch size
+    QRect dirtyRect(0, 0, imageRect.width(), KisTileData::HEIGHT * 3);
+    queue.addUpdateJob(paintLayer, dirtyRect, imageRect, 0);
+    QCOMPARE(queue.getWalkersList().size(), 1);
+
+    queue.processQueue(context);
+
+    QVector<KisUpdateJobItem*> jobs = context.getJobs();
+    QRegion unitedRegion;
+
+    Q_FOREACH (KisUpdateJobItem *job, jobs) {
+        QVERIFY(job->isRunning());
+        QVERIFY(!unitedRegion.intersects(job->walker()->requestedRect()));
+        unitedRegion += job->walker()->requestedRect();
+    }
+
+    QCOMPARE(unitedRegion, QRegion(dirtyRect));
+    QVERIFY(queue.getWalkersList().isEmpty());
+}
+
+void KisSimpleUpdateQueueTest::testViewportPriority()
+{
+    KisTestableUpdaterContext context(1);
+
+    QRect imageRect(0,0,2000,200);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    QRect offscreenRect(0,0,100,100);
+    QRect visibleRect(1500,0,100,100);
+    QRect viewportRect(1000,0,1000,200);
+
+    KisImageConfig config(false);
+    config.setPrioritizeVisibleUpdates(true);
+    config.setOffscreenUpdatesDeadline(1000000);
+
+    {
+        KisTestableSimpleUpdateQueue queue;
+        queue.updateSettings();
+        queue.setViewportRects({viewportRect});
+
+        queue.addUpdateJob(paintLayer, offscreenRect, imageRect, 0);
+        queue.addUpdateJob(paintLayer, visibleRect, imageRect, 0);
+
+        queue.processQueue(context);
+
+        // the visible update jumps over the off-screen one
+        QVector<KisUpdateJobItem*> jobs = context.getJobs();
+        QVERIFY(checkWalker(jobs[0]->walker(), visibleRect));
+
+        KisWalkersList walkersList = queue.getWalkersList();
+        QCOMPARE(walkersList.size(), 1);
+        QVERIFY(checkWalker(walkersList[0], offscreenRect));
+
+        context.clear();
+
+        // when nothing visible is left, the off-screen update is started
+        queue.processQueue(context);
+
+        jobs = context.getJobs();
+        QVERIFY(checkWalker(jobs[0]->walker(), offscreenRect));
+        QVERIFY(queue.getWalkersList().isEmpty());
+
+        context.clear();
+    }
+
+    {
+        KisTestableUpdaterContext twoThreadsContext(2);
+
+        KisTestableSimpleUpdateQueue queue;
+        queue.updateSettings();
+        queue.setViewportRects({viewportRect});
+
+        queue.addUpdateJob(paintLayer, offscreenRect, imageRect, 0);
+        queue.addUpdateJob(paintLayer, visibleRect, imageRect, 0);
+        queue.addFullRefreshJob(paintLayer, visibleRect, imageRect, 0);
+
+        queue.processQueue(twoThreadsContext);
+
+        // the second visible walker is blocked by the first one,
+        // so the spare thread is given to the off-screen update
+        QVector<KisUpdateJobItem*> jobs = twoThreadsContext.getJobs();
+        QVERIFY(checkWalker(jobs[0]->walker(), visibleRect));
+        QVERIFY(checkWalker(jobs[1]->walker(), offscreenRect));
+
+        KisWalkersList walkersList = queue.getWalkersList();
+        QCOMPARE(walkersList.size(), 1);
+        QVERIFY(checkWalker(walkersList[0], visibleRect));
+
+        twoThreadsContext.clear();
+    }
+
+    config.setOffscreenUpdatesDeadline(0);
+
+    {
+        KisTestableSimpleUpdateQueue queue;
+        queue.updateSettings();
+        queue.setViewportRects({viewportRect});
+
+        queue.addUpdateJob(paintLayer, offscreenRect, imageRect, 0);
+        queue.addUpdateJob(paintLayer, visibleRect, imageRect, 0);
+
+        queue.processQueue(context);
+
+        // the deadline of the off-screen update has passed, so it keeps its place
+        QVector<KisUpdateJobItem*> jobs = context.getJobs();
+        QVERIFY(checkWalker(jobs[0]->walker(), offscreenRect));
+
+        context.clear();
+    }
+
+    config.setOffscreenUpdatesDeadline(config.offscreenUpdatesDeadline(true));
+}
+
 KISTEST_MAIN(KisSimpleUpdateQueueTest)
 
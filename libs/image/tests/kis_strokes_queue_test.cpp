@@ -14,6 +14,8 @@
 #include "kis_updater_context.h"
 #include "kis_update_job_item.h"
 #include "kis_merge_walker.h"
+#include "kis_stroke.h"
+#include "KisStrokeJobStatistics.h"
 
 
 void KisStrokesQueueTest::testSequentialJobs()
@@ -1126,5 +1128,96 @@ void KisStrokesQueueTest::testUniquelyConcurrentJobs()
     queue.endStroke(id1);
 }
 
+class KisBatchingTestingStrokeStrategy : public KisTestingStrokeStrategy
+{
+public:
+    KisBatchingTestingStrokeStrategy(const QLatin1String &prefix)
+        : KisTestingStrokeStrategy(prefix, false, true)
+    {
+        setSupportsJobBatching(true);
+    }
+};
+
+void KisStrokesQueueTest::testJobBatching()
+{
+    LodStrokesQueueTester t(true);
+    KisStrokesQueue &queue = t.queue;
+
+    queue.setStrokeJobBatchingLimits(8, 1000000);
+
+    KisStrokeId id1 = queue.startStroke(new KisBatchingTestingStrokeStrategy(QLatin1String("str1_")));
+
+    queue.addJob(id1,
+                 new KisTestingStrokeJobData(
+                     KisStrokeJobData::SEQUENTIAL,
+                     KisStrokeJobData::NORMAL,
+                     false, "1"));
+
+    // the duration of the jobs is not known yet, so no batching
+    t.processQueue();
+    t.checkOnlyExecutedJob("str1_dab_1");
+
+    queue.addJob(id1,
+                 new KisTestingStrokeJobData(
+                     KisStrokeJobData::SEQUENTIAL,
+                     KisStrokeJobData::NORMAL,
+                     true, "2"));
+
+    queue.addJob(id1,
+                 new KisTestingStrokeJobData(
+                     KisStrokeJobData::SEQUENTIAL,
+                     KisStrokeJobData::NORMAL,
+                     false, "3"));
+
+    queue.addJob(id1,
+                 new KisTestingStrokeJobData(
+                     KisStrokeJobData::SEQUENTIAL,
+                     KisStrokeJobData::NORMAL,
+                     false, "4"));
+
+    queue.endStroke(id1);
+
+    /**
+     * All three jobs are batched together, but the mutated
+     * jobs of the first one should be executed before the
+     * rest of the batch
+     */
+    t.processQueue();
+    t.checkOnlyExecutedJob("str1_dab_2");
+
+    t.processQueue();
+
+    QStringList refList;
+    refList << "str1_dab_mutated" << "str1_dab_mutated" << "str1_dab_mutated"
+            << "str1_dab_3" << "str1_dab_4";
+    t.checkExecutedJobs(refList);
+
+    KisStrokeSP stroke = id1.toStrongRef();
+    QVERIFY(stroke);
+
+    const KisStrokeJobStatistics *stats = stroke->jobStatistics();
+    QCOMPARE(stats->numJobs(), qint64(7));
+    QCOMPARE(stats->numBatches(), qint64(3));
+
+    /**
+     * The jobs 3 and 4 were taken back from the batch of the
+     * job 2 and executed in the batch of the mutated jobs
+     */
+    const QVector<qint64> batchSizes = stats->batchSizeHistogram();
+    QCOMPARE(batchSizes[0], qint64(2));
+    QCOMPARE(batchSizes[2], qint64(0));
+    QCOMPARE(batchSizes[4], qint64(1));
+
+    qint64 numBatchedJobs = 0;
+    for (int i = 0; i < batchSizes.size(); i++) {
+        numBatchedJobs += (i + 1) * batchSizes[i];
+    }
+    QCOMPARE(numBatchedJobs, stats->numJobs());
+
+    stroke.clear();
+
+    t.processQueue();
+    t.checkNothingExecuted();
+}
 
 KISTEST_MAIN(KisStrokesQueueTest)
@@ -7,6 +7,11 @@
 #include "kis_update_scheduler_test.h"
 #include <simpletest.h>
 
+#include <QTemporaryDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
 
@@ -401,6 +406,67 @@ void KisUpdateSchedulerTest::testTimeMonitor()
     KisUpdateTimeMonitor::instance()->endStrokeMeasure();
 }
 
+void KisUpdateSchedulerTest::testUpdateTrace()
+{
+    KisImageSP image = buildTestingImage();
+    KisNodeSP rootLayer = image->root();
+    KisNodeSP paintLayer1 = rootLayer->firstChild();
+
+    QTemporaryDir dir;
+    const QString fileName = dir.filePath("trace.json");
+
+    KisUpdateTimeMonitor *monitor = KisUpdateTimeMonitor::instance();
+
+    monitor->startTracing(fileName);
+    QVERIFY(monitor->isTracingEnabled());
+
+    paintLayer1->setDirty(QRect(10, 20, 30, 40));
+    image->waitForDone();
+
+    monitor->stopTracing();
+    QVERIFY(!monitor->isTracingEnabled());
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    const QJsonArray events = doc.object()["traceEvents"].toArray();
+
+    QSet<QString> categories;
+    QSet<int> namedThreads;
+    bool hasCollectSpan = false;
+
+    Q_FOREACH (const QJsonValue &value, events) {
+        const QJsonObject event = value.toObject();
+
+        if (event["ph"].toString() == "M") {
+            namedThreads.insert(event["tid"].toInt());
+            continue;
+        }
+
+        QCOMPARE(event["ph"].toString(), QString("X"));
+        QVERIFY(event["dur"].toDouble() >= 0.0);
+        QVERIFY(namedThreads.contains(event["tid"].toInt()));
+
+        categories.insert(event["cat"].toString());
+
+        if (event["cat"].toString() == "collect") {
+            const QJsonObject args = event["args"].toObject();
+
+            QCOMPARE(event["name"].toString(), QString("paint1"));
+            QCOMPARE(args["x"].toInt(), 10);
+            QCOMPARE(args["y"].toInt(), 20);
+            QCOMPARE(args["area"].toInt(), 30 * 40);
+            hasCollectSpan = true;
+        }
+    }
+
+    QVERIFY(hasCollectSpan);
+    QVERIFY(categories.contains("merge"));
+    QVERIFY(categories.contains("composite"));
+    QVERIFY(categories.contains("filter"));
+}
+
 void KisUpdateSchedulerTest::testLodSync()
 {
     KisImageSP image = buildTestingImage();
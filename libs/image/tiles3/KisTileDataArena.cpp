@@ -0,0 +1,317 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTileDataArena.h"
+
+#include <new>
+#include <cstdlib>
+
+#include <QVector>
+
+#include "kis_tile_data_interface.h"
+#include "kis_image_config.h"
+#include "kis_debug.h"
+
+#ifdef Q_OS_LINUX
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+/**
+ * The size of a huge page on x86_64 and most of the arm64 systems
+ */
+const qint64 ARENA_SIZE = 2 * 1024 * 1024;
+const qint64 NORMAL_PAGE_SIZE = 4096;
+
+const int NUM_SHARDS = 8;
+
+/**
+ * The free chunks are linked into a list through their own memory
+ */
+struct FreeChunk {
+    FreeChunk *next;
+};
+
+}
+
+struct KisTileDataArena::Slab
+{
+    Slab(qint32 _chunkSize)
+        : chunkSize(_chunkSize),
+          // with big tiles a chunk may be bigger than a huge page
+          arenaSize((qint64(_chunkSize) + ARENA_SIZE - 1) / ARENA_SIZE * ARENA_SIZE)
+    {
+    }
+
+    /**
+     * Each shard sits in its own cache line to avoid false sharing
+     * between the threads
+     */
+    struct alignas(64) Shard {
+        QMutex lock;
+        FreeChunk *head {nullptr};
+
+        bool pop(quint8 *&ptr) {
+            QMutexLocker l(&lock);
+            if (!head) return false;
+
+            ptr = reinterpret_cast<quint8*>(head);
+            head = head->next;
+            return true;
+        }
+
+        void push(quint8 *ptr) {
+            QMutexLocker l(&lock);
+            FreeChunk *chunk = reinterpret_cast<FreeChunk*>(ptr);
+            chunk->next = head;
+            head = chunk;
+        }
+    };
+
+    const qint32 chunkSize;
+    const qint64 arenaSize;
+    Shard shards[NUM_SHARDS];
+
+    /**
+     * Incremented *before* a chunk is taken from the free lists and
+     * decremented *after* it is returned there, so purgeMemory()
+     * never sees a slab empty while some chunk is in flight
+     */
+    QAtomicInteger<qint64> numUsedChunks;
+
+    QMutex arenasLock;
+    QVector<quint8*> arenas;
+    int numHugePageArenas {0};
+};
+
+
+qint64 KisTileDataArena::Statistics::numTlbEntries() const
+{
+    return hugePageSize / ARENA_SIZE +
+        (reservedSize - hugePageSize) / NORMAL_PAGE_SIZE;
+}
+
+
+KisTileDataArena::KisTileDataArena(qint32 pixelsPerTile, bool useHugePages)
+    : m_pixelsPerTile(pixelsPerTile),
+      m_useHugePages(useHugePages)
+{
+}
+
+KisTileDataArena::~KisTileDataArena()
+{
+    for (int i = 0; i <= MAX_PIXEL_SIZE; i++) {
+        Slab *slab = m_slabs[i].loadAcquire();
+        if (!slab) continue;
+
+        Q_FOREACH (quint8 *arena, slab->arenas) {
+            freeArena(arena, slab->arenaSize);
+        }
+
+        delete slab;
+    }
+}
+
+KisTileDataArena* KisTileDataArena::instance()
+{
+    static KisTileDataArena *arena =
+        new KisTileDataArena(KisTileData::WIDTH * KisTileData::HEIGHT,
+                             KisImageConfig(true).useHugePagesForTileData());
+    return arena;
+}
+
+quint8* KisTileDataArena::allocate(qint32 pixelSize)
+{
+    if (pixelSize > MAX_PIXEL_SIZE) {
+        quint8 *ptr = static_cast<quint8*>(::malloc(pixelSize * m_pixelsPerTile));
+        if (!ptr) throw std::bad_alloc();
+        return ptr;
+    }
+
+    Slab *slab = slabForPixelSize(pixelSize);
+    slab->numUsedChunks.ref();
+
+    const int ownShard = currentShard();
+    quint8 *ptr = 0;
+
+    for (int i = 0; i < NUM_SHARDS; i++) {
+        if (slab->shards[(ownShard + i) % NUM_SHARDS].pop(ptr)) {
+            return ptr;
+        }
+    }
+
+    /**
+     * All the free lists are empty, so cut a new arena into chunks. The
+     * first chunk goes to the caller, the rest goes to our own shard.
+     */
+    bool isHugePage = false;
+    quint8 *arena = allocateArena(slab->arenaSize, &isHugePage);
+
+    {
+        QMutexLocker l(&slab->arenasLock);
+        slab->arenas.append(arena);
+        if (isHugePage) {
+            slab->numHugePageArenas++;
+        }
+    }
+
+    const int numChunks = slab->arenaSize / slab->chunkSize;
+    Slab::Shard &shard = slab->shards[ownShard];
+
+    {
+        QMutexLocker l(&shard.lock);
+
+        for (int i = numChunks - 1; i >= 1; i--) {
+            FreeChunk *chunk = reinterpret_cast<FreeChunk*>(arena + i * slab->chunkSize);
+            chunk->next = shard.head;
+            shard.head = chunk;
+        }
+    }
+
+    return arena;
+}
+
+void KisTileDataArena::free(quint8 *ptr, qint32 pixelSize)
+{
+    if (pixelSize > MAX_PIXEL_SIZE) {
+        ::free(ptr);
+        return;
+    }
+
+    Slab *slab = m_slabs[pixelSize].loadAcquire();
+    KIS_SAFE_ASSERT_RECOVER_RETURN(slab);
+
+    slab->shards[currentShard()].push(ptr);
+    slab->numUsedChunks.deref();
+}
+
+void KisTileDataArena::purgeMemory()
+{
+    for (int i = 0; i <= MAX_PIXEL_SIZE; i++) {
+        Slab *slab = m_slabs[i].loadAcquire();
+        if (!slab) continue;
+
+        for (int j = 0; j < NUM_SHARDS; j++) {
+            slab->shards[j].lock.lock();
+        }
+
+        QMutexLocker l(&slab->arenasLock);
+
+        if (!slab->numUsedChunks.loadAcquire()) {
+            for (int j = 0; j < NUM_SHARDS; j++) {
+                slab->shards[j].head = nullptr;
+            }
+
+            Q_FOREACH (quint8 *arena, slab->arenas) {
+                freeArena(arena, slab->arenaSize);
+            }
+
+            slab->arenas.clear();
+            slab->numHugePageArenas = 0;
+        }
+
+        for (int j = NUM_SHARDS - 1; j >= 0; j--) {
+            slab->shards[j].lock.unlock();
+        }
+    }
+}
+
+KisTileDataArena::Statistics KisTileDataArena::statistics() const
+{
+    Statistics stats;
+
+    for (int i = 0; i <= MAX_PIXEL_SIZE; i++) {
+        Slab *slab = m_slabs[i].loadAcquire();
+        if (!slab) continue;
+
+        QMutexLocker l(&slab->arenasLock);
+
+        stats.numArenas += slab->arenas.size();
+        stats.reservedSize += slab->arenas.size() * slab->arenaSize;
+        stats.hugePageSize += slab->numHugePageArenas * slab->arenaSize;
+        stats.usedSize += slab->numUsedChunks.loadRelaxed() * slab->chunkSize;
+    }
+
+    return stats;
+}
+
+bool KisTileDataArena::useHugePages() const
+{
+    return m_useHugePages;
+}
+
+KisTileDataArena::Slab* KisTileDataArena::slabForPixelSize(qint32 pixelSize)
+{
+    Slab *slab = m_slabs[pixelSize].loadAcquire();
+
+    if (!slab) {
+        QMutexLocker l(&m_slabsLock);
+
+        slab = m_slabs[pixelSize].loadAcquire();
+        if (!slab) {
+            slab = new Slab(pixelSize * m_pixelsPerTile);
+            m_slabs[pixelSize].storeRelease(slab);
+        }
+    }
+
+    return slab;
+}
+
+quint8* KisTileDataArena::allocateArena(qint64 size, bool *isHugePage)
+{
+    *isHugePage = false;
+
+#ifdef Q_OS_LINUX
+    /**
+     * mmap() doesn't guarantee any alignment bigger than a normal page,
+     * so map a bit more and trim the unaligned ends
+     */
+    void *area = mmap(nullptr, size + ARENA_SIZE,
+                      PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (area == MAP_FAILED) throw std::bad_alloc();
+
+    quint8 *begin = static_cast<quint8*>(area);
+    quint8 *arena = reinterpret_cast<quint8*>(
+        (reinterpret_cast<quintptr>(begin) + ARENA_SIZE - 1) & ~quintptr(ARENA_SIZE - 1));
+    quint8 *end = begin + size + ARENA_SIZE;
+
+    if (arena > begin) {
+        munmap(begin, arena - begin);
+    }
+    if (end > arena + size) {
+        munmap(arena + size, end - (arena + size));
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (m_useHugePages) {
+        *isHugePage = !madvise(arena, size, MADV_HUGEPAGE);
+    }
+#endif
+
+    return arena;
+#else
+    quint8 *arena = static_cast<quint8*>(::malloc(size));
+    if (!arena) throw std::bad_alloc();
+    return arena;
+#endif
+}
+
+void KisTileDataArena::freeArena(quint8 *ptr, qint64 size)
+{
+#ifdef Q_OS_LINUX
+    munmap(ptr, size);
+#else
+    ::free(ptr);
+#endif
+}
+
+int KisTileDataArena::currentShard()
+{
+    static QAtomicInt nextShard;
+    thread_local int shard = nextShard.fetchAndAddRelaxed(1) % NUM_SHARDS;
+    return shard;
+}
@@ -0,0 +1,122 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTILEDATAARENA_H
+#define KISTILEDATAARENA_H
+
+#include <QtGlobal>
+#include <QMutex>
+#include <QAtomicInteger>
+#include <QAtomicPointer>
+
+#include "kritaimage_export.h"
+
+
+/**
+ * An allocator for the pixel data of the tiles. The tiles of every
+ * pixel size are allocated from their own slab: a list of big
+ * chunks of memory (arenas) cut into the pieces of the tile data size.
+ *
+ * The arenas are 2 MiB in size (or a multiple of it, when the tiles are
+ * bigger than that) and are aligned to 2 MiB, so on Linux
+ * the kernel can back them with transparent huge pages. One huge page
+ * takes one TLB entry instead of 512 ones for the normal 4 KiB pages,
+ * which matters a lot when the composition walks over hundreds of
+ * megabytes of tiles. On other platforms the arenas are allocated
+ * with the usual malloc().
+ *
+ * The free chunks of every slab are kept in several shards, each one
+ * having its own lock. A thread always takes and returns chunks to its
+ * own shard, so the worker threads don't fight for a single lock. It
+ * also means that the chunks tend to be reused by the thread that
+ * touched them last, which keeps them on the same NUMA node, since
+ * the kernel places the pages on the node of the first touch.
+ *
+ * The allocator never returns the memory of the arenas to the system
+ * by itself, use purgeMemory() when you know that there are no tiles
+ * allocated anymore.
+ */
+class KRITAIMAGE_EXPORT KisTileDataArena
+{
+public:
+    /**
+     * Tiles with bigger pixel size are allocated with malloc() directly
+     */
+    static const qint32 MAX_PIXEL_SIZE = 64;
+
+    struct Statistics {
+        /// The total size of all the arenas allocated from the system
+        qint64 reservedSize = 0;
+
+        /// The size of the chunks currently given out to the tiles
+        qint64 usedSize = 0;
+
+        /// The size of the arenas that have been advised to the kernel to
+        /// be backed by huge pages
+        qint64 hugePageSize = 0;
+
+        /// The number of the arenas
+        int numArenas = 0;
+
+        /**
+         * The share of the reserved memory not used by any tile, in range [0, 1]
+         */
+        qreal fragmentation() const {
+            return reservedSize ? qreal(reservedSize - usedSize) / reservedSize : 0.0;
+        }
+
+        /**
+         * An estimation of the number of TLB entries needed to map all the
+         * arenas, assuming that the kernel has managed to find huge pages
+         * for all the advised arenas
+         */
+        qint64 numTlbEntries() const;
+    };
+
+public:
+    KisTileDataArena(qint32 pixelsPerTile, bool useHugePages);
+    ~KisTileDataArena();
+
+    /**
+     * The arena used by KisTileData. It is intentionally never destroyed,
+     * because the tiles may be freed by static objects on exit.
+     */
+    static KisTileDataArena* instance();
+
+    quint8* allocate(qint32 pixelSize);
+    void free(quint8 *ptr, qint32 pixelSize);
+
+    /**
+     * Returns the arenas back to the system. Only the slabs that have no
+     * chunks in use are purged, the others are left untouched.
+     */
+    void purgeMemory();
+
+    Statistics statistics() const;
+
+    bool useHugePages() const;
+
+private:
+    struct Slab;
+
+    Slab* slabForPixelSize(qint32 pixelSize);
+
+    quint8* allocateArena(qint64 size, bool *isHugePage);
+    void freeArena(quint8 *ptr, qint64 size);
+
+    static int currentShard();
+
+private:
+    Q_DISABLE_COPY(KisTileDataArena)
+
+    const qint32 m_pixelsPerTile;
+    const bool m_useHugePages;
+
+    QAtomicPointer<Slab> m_slabs[MAX_PIXEL_SIZE + 1];
+    QMutex m_slabsLock;
+};
+
+#endif // KISTILEDATAARENA_H
@@ -0,0 +1,213 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTileDataDeduplicator.h"
+
+#include <QHash>
+
+#include "kis_tile.h"
+#include "kis_tiled_data_manager.h"
+#include "kis_tile_data_store.h"
+#include "kis_debug.h"
+
+#define TILE_DATA_SIZE(pixelSize) ((pixelSize) * KisTileData::WIDTH * KisTileData::HEIGHT)
+
+namespace {
+/**
+ * The highest bit of the content hash tells if the tile
+ * is uniform, so the check is redone only when the tile
+ * is changed and its hash is reset
+ */
+const quint32 UNIFORM_HASH_FLAG = 0x80000000;
+}
+
+
+KisTileDataDeduplicator::KisTileDataDeduplicator()
+{
+}
+
+KisTileDataDeduplicator::~KisTileDataDeduplicator()
+{
+    Q_FOREACH (KisTileData *td, m_tileDataByHash) {
+        td->deref();
+    }
+}
+
+int KisTileDataDeduplicator::updateContentHashes(KisTiledDataManager *dm, int maxTiles)
+{
+    KisTileHashTableConstIterator iter(dm->m_hashTable);
+    KisTileSP tile;
+    int numHashedTiles = 0;
+
+    while (numHashedTiles < maxTiles && (tile = iter.tile())) {
+        KisTileData *td = tile->tileData();
+
+        /**
+         * Don't bother swapping the data in, it is not
+         * consuming any memory at the moment
+         */
+        if (!td->contentHash() && td->data()) {
+            tile->lockForRead();
+            td = tile->tileData();
+            td->setContentHash(calculateHash(td));
+            tile->unlockForRead();
+            numHashedTiles++;
+        }
+
+        iter.next();
+    }
+
+    return numHashedTiles;
+}
+
+void KisTileDataDeduplicator::processDataManager(KisTiledDataManager *dm)
+{
+    KisTileHashTableConstIterator iter(dm->m_hashTable);
+    KisTileSP tile;
+
+    while ((tile = iter.tile())) {
+        processTile(tile.data(), dm);
+        iter.next();
+    }
+}
+
+void KisTileDataDeduplicator::processTile(KisTile *tile, KisTiledDataManager *dm)
+{
+    if (tryCompactUniformTile(tile, dm)) return;
+
+    KisTileData *td = tile->tileData();
+
+    /**
+     * The tile has been changed or swapped out since
+     * updateContentHashes(), just skip it
+     */
+    const quint32 hash = td->contentHash();
+    if (!hash) return;
+
+    auto it = m_tileDataByHash.find(hash);
+    for (; it != m_tileDataByHash.end() && it.key() == hash; ++it) {
+        KisTileData *candidate = it.value();
+
+        if (candidate == td) return;
+        if (candidate->pixelSize() != td->pixelSize()) continue;
+        if (!compareContent(candidate, td)) continue;
+
+        if (td->numUsers() == 1 && tile->shareTileData(candidate)) {
+            m_numMergedTiles++;
+            m_releasedMemory += TILE_DATA_SIZE(candidate->pixelSize());
+        }
+
+        return;
+    }
+
+    td->ref();
+    m_tileDataByHash.insert(hash, td);
+}
+
+bool KisTileDataDeduplicator::tryCompactUniformTile(KisTile *tile, KisTiledDataManager *dm)
+{
+    KisTileData *td = tile->tileData();
+
+    if (td->numUsers() != 1 || !td->data() ||
+        !isUniformHash(td->contentHash())) {
+
+        return false;
+    }
+
+    /**
+     * The cached flag may be stale if the tile has been written
+     * after updateContentHashes(), so recheck the data itself
+     * the same way compareContent() does before sharing
+     */
+    tile->lockForRead();
+    td = tile->tileData();
+    td->blockSwapping();
+    const bool uniform = isUniform(td);
+    const qint32 pixelSize = td->pixelSize();
+    const QByteArray pixel(reinterpret_cast<const char*>(td->data()), pixelSize);
+    td->unblockSwapping();
+    tile->unlockForRead();
+
+    if (!uniform) {
+        td->resetContentHash();
+        return false;
+    }
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    const quint8 *pixelPtr = reinterpret_cast<const quint8*>(pixel.constData());
+
+    KisTileData *sharedTileData = 0;
+
+    if (!memcmp(pixelPtr, dm->defaultPixel(), pixelSize)) {
+        sharedTileData = dm->m_hashTable->refAndFetchDefaultTileData();
+        sharedTileData->acquire();
+        sharedTileData->deref();
+    } else {
+        sharedTileData = store->acquireUniformTileData(pixelSize, pixelPtr);
+    }
+
+    if (tile->shareTileData(sharedTileData)) {
+        m_numMergedTiles++;
+        m_releasedMemory += TILE_DATA_SIZE(pixelSize);
+    }
+
+    sharedTileData->release();
+
+    return true;
+}
+
+quint32 KisTileDataDeduplicator::calculateHash(KisTileData *td)
+{
+    const quint32 hash =
+        quint32(qHashBits(td->data(), TILE_DATA_SIZE(td->pixelSize()))) & ~UNIFORM_HASH_FLAG;
+
+    if (isUniform(td)) {
+        return hash | UNIFORM_HASH_FLAG;
+    }
+
+    // zero is reserved for "unknown"
+    return hash ? hash : 1;
+}
+
+bool KisTileDataDeduplicator::isUniformHash(quint32 hash)
+{
+    return hash & UNIFORM_HASH_FLAG;
+}
+
+bool KisTileDataDeduplicator::isUniform(KisTileData *td)
+{
+    const qint32 pixelSize = td->pixelSize();
+    const quint8 *data = td->data();
+
+    /**
+     * The data is uniform iff it is equal to itself
+     * shifted by one pixel
+     */
+    return !memcmp(data, data + pixelSize, TILE_DATA_SIZE(pixelSize) - pixelSize);
+}
+
+bool KisTileDataDeduplicator::compareContent(KisTileData *lhs, KisTileData *rhs)
+{
+    lhs->blockSwapping();
+    rhs->blockSwapping();
+
+    const bool result = !memcmp(lhs->data(), rhs->data(), TILE_DATA_SIZE(lhs->pixelSize()));
+
+    rhs->unblockSwapping();
+    lhs->unblockSwapping();
+
+    return result;
+}
+
+int KisTileDataDeduplicator::numMergedTiles() const
+{
+    return m_numMergedTiles;
+}
+
+qint64 KisTileDataDeduplicator::releasedMemory() const
+{
+    return m_releasedMemory;
+}
@@ -0,0 +1,101 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTILEDATADEDUPLICATOR_H
+#define KISTILEDATADEDUPLICATOR_H
+
+#include <limits>
+#include <QMultiHash>
+#include "kritaimage_export.h"
+
+class KisTile;
+class KisTileData;
+class KisTiledDataManager;
+
+
+/**
+ * Finds byte-identical tiles in a set of data managers and makes
+ * them share the same tile data through COW, the same way the
+ * tiles of a copied paint device do. It is quite common to have
+ * such tiles in duplicated layers or in the keyframes of a raster
+ * animation copied from each other.
+ *
+ * The deduplication is done in two steps:
+ *
+ * 1) updateContentHashes() calculates the hashes of the tiles
+ *    that have been changed since the last pass and checks whether
+ *    they are uniform. It doesn't change anything in the data
+ *    manager, so it can be run concurrently with any readers of it.
+ *
+ * 2) processDataManager() merges the tiles with equal hashes and
+ *    content. It replaces the tile data under the feet of the data
+ *    manager, so nobody should copy tiles of this data manager
+ *    during the call (e.g. it can be run in an exclusive stroke job)
+ *
+ * The result of the uniformity check is cached in the content hash,
+ * so both steps touch the pixels of only the tiles that have been
+ * changed since the previous pass.
+ *
+ * Uniform tiles are not merged by hash, they are just switched to the
+ * tile data shared by all the uniform tiles of this color, see
+ * KisTileDataStore::acquireUniformTileData(), or to the default
+ * tile data of the data manager. Either way they get expanded
+ * back on the first write access through the usual COW.
+ *
+ * Only the tile data owned by a single tile is merged, since merging
+ * of the data shared with the undo history or other devices would not
+ * release any memory. The swapped-out tiles are ignored.
+ */
+class KRITAIMAGE_EXPORT KisTileDataDeduplicator
+{
+public:
+    KisTileDataDeduplicator();
+    ~KisTileDataDeduplicator();
+
+    /**
+     * Hashes at most \p maxTiles tiles of \p dm that have no hash
+     * yet. The rest of them will be hashed by the next calls.
+     *
+     * \return the number of tiles hashed
+     */
+    static int updateContentHashes(KisTiledDataManager *dm,
+                                   int maxTiles = std::numeric_limits<int>::max());
+
+    void processDataManager(KisTiledDataManager *dm);
+
+    /**
+     * The number of tiles merged by all the processDataManager() calls
+     */
+    int numMergedTiles() const;
+
+    /**
+     * The amount of memory released by all the processDataManager() calls
+     */
+    qint64 releasedMemory() const;
+
+private:
+    void processTile(KisTile *tile, KisTiledDataManager *dm);
+    bool tryCompactUniformTile(KisTile *tile, KisTiledDataManager *dm);
+
+    static quint32 calculateHash(KisTileData *td);
+    static bool isUniform(KisTileData *td);
+    static bool isUniformHash(quint32 hash);
+    static bool compareContent(KisTileData *lhs, KisTileData *rhs);
+
+private:
+    Q_DISABLE_COPY(KisTileDataDeduplicator)
+
+    /**
+     * All the tile data objects seen during the pass, the
+     * deduplicator holds a reference to every one of them
+     */
+    QMultiHash<quint32, KisTileData*> m_tileDataByHash;
+
+    int m_numMergedTiles {0};
+    qint64 m_releasedMemory {0};
+};
+
+#endif // KISTILEDATADEDUPLICATOR_H
@@ -0,0 +1,131 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_memento_item.h"
+
+#include "kis_debug.h"
+#include "swap/kis_lzf_compression.h"
+
+#define TILE_DATA_SIZE(pixelSize) ((pixelSize) * KisTileData::WIDTH * KisTileData::HEIGHT)
+
+/**
+ * The delta is stored only if it is at least this many times
+ * smaller than the data itself, otherwise the undo operation
+ * would pay for decompression for almost nothing.
+ */
+#define MIN_DELTA_COMPRESSION_RATIO 4
+
+
+bool KisMementoItem::tryEncodeDelta(KisMementoItem *base)
+{
+    if (!m_committedFlag || !m_tileData || isDeltaEncoded()) return false;
+    if (!base || !base->m_committedFlag || !base->m_tileData) return false;
+    if (m_type != CHANGED || base->m_type != CHANGED) return false;
+    if (m_tileData == base->m_tileData) return false;
+    if (m_tileData->pixelSize() != base->m_tileData->pixelSize()) return false;
+
+    /**
+     * If the data is shared with anyone else (a live tile, a copy of
+     * the device or an old-data tile), releasing it will not save us
+     * anything
+     */
+    if (!m_tileData->historical()) return false;
+
+    const qint32 pixelSize = m_tileData->pixelSize();
+    const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize);
+
+    KisLzfCompression compression;
+    QByteArray xorBuffer(tileDataSize, Qt::Uninitialized);
+    QByteArray compressedBuffer(compression.outputBufferSize(tileDataSize), Qt::Uninitialized);
+
+    m_tileData->blockSwapping();
+    base->m_tileData->blockSwapping();
+
+    const quint8 *src = m_tileData->data();
+    const quint8 *ref = base->m_tileData->data();
+    quint8 *dst = reinterpret_cast<quint8*>(xorBuffer.data());
+
+    for (qint32 i = 0; i < tileDataSize; i++) {
+        dst[i] = src[i] ^ ref[i];
+    }
+
+    base->m_tileData->unblockSwapping();
+    m_tileData->unblockSwapping();
+
+    const qint32 compressedSize =
+        compression.compress(dst, tileDataSize,
+                             reinterpret_cast<quint8*>(compressedBuffer.data()),
+                             compressedBuffer.size());
+
+    if (compressedSize <= 0 ||
+        compressedSize * MIN_DELTA_COMPRESSION_RATIO > tileDataSize) {
+
+        return false;
+    }
+
+    releaseTileData();
+    m_tileData = 0;
+
+    m_deltaData = compressedBuffer.left(compressedSize);
+    m_deltaBase = base;
+    m_deltaPixelSize = pixelSize;
+
+    return true;
+}
+
+void KisMementoItem::restoreDataTo(quint8 *dst)
+{
+    if (m_tileData) {
+        m_tileData->blockSwapping();
+        memcpy(dst, m_tileData->data(), TILE_DATA_SIZE(m_tileData->pixelSize()));
+        m_tileData->unblockSwapping();
+        return;
+    }
+
+    KIS_SAFE_ASSERT_RECOVER_RETURN(isDeltaEncoded());
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_deltaBase.isValid());
+
+    m_deltaBase->restoreDataTo(dst);
+
+    const qint32 tileDataSize = TILE_DATA_SIZE(m_deltaPixelSize);
+    QByteArray xorBuffer(tileDataSize, Qt::Uninitialized);
+    quint8 *delta = reinterpret_cast<quint8*>(xorBuffer.data());
+
+    KisLzfCompression compression;
+    const qint32 bytesWritten =
+        compression.decompress(reinterpret_cast<const quint8*>(m_deltaData.constData()),
+                               m_deltaData.size(),
+                               delta, tileDataSize);
+
+    KIS_SAFE_ASSERT_RECOVER_RETURN(bytesWritten == tileDataSize);
+
+    for (qint32 i = 0; i < tileDataSize; i++) {
+        dst[i] ^= delta[i];
+    }
+}
+
+void KisMementoItem::restoreFromDelta()
+{
+    if (!isDeltaEncoded()) return;
+
+    // the data is decoded right into the new tile, so it is not prefilled
+    KisTileData *td =
+        KisTileDataStore::instance()->createDefaultTileData(m_deltaPixelSize, nullptr);
+
+    td->blockSwapping();
+    restoreDataTo(td->data());
+    td->unblockSwapping();
+
+    resetDelta();
+
+    /**
+     * The item is committed, so it should be a rightful
+     * co-owner of the data, see commit()
+     */
+    m_tileData = td;
+    m_tileData->acquire();
+    m_tileData->setMementoed(true);
+}
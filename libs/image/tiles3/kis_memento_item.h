@@ -7,6 +7,7 @@
 #ifndef KIS_MEMENTO_ITEM_H_
 #define KIS_MEMENTO_ITEM_H_
 
+#include <QByteArray>
 #include <kis_shared.h>
 #include <kis_shared_ptr.h>
 #include "kis_tile.h"
@@ -14,6 +15,7 @@
 
 class KisMementoItem;
 typedef KisSharedPtr<KisMementoItem> KisMementoItemSP;
+typedef KisWeakSharedPtr<KisMementoItem> KisMementoItemWSP;
 
 class KisMementoItem : public KisShared
 {
@@ -36,7 +38,10 @@ public:
             m_col(rhs.m_col),
             m_row(rhs.m_row),
             m_next(0),
-            m_parent(0) {
+            m_parent(0),
+            m_deltaData(rhs.m_deltaData),
+            m_deltaBase(rhs.m_deltaBase),
+            m_deltaPixelSize(rhs.m_deltaPixelSize) {
         if (m_tileData) {
             if (m_committedFlag)
                 m_tileData->acquire();
@@ -104,6 +109,7 @@ public:
         releaseTileData();
         m_tileData = 0;
         m_committedFlag = false;
+        resetDelta();
     }
 
     void deleteTile(KisTile* tile, KisTileData* defaultTileData) {
@@ -141,6 +147,35 @@ public:
         m_committedFlag = true;
     }
 
+    /**
+     * Delta compression of the historical tile data.
+     *
+     * When a committed item gets superseded by a newer one, its tile
+     * data is usually referenced by the history only. In such a case
+     * the data can be replaced with an LZF-compressed XOR of it and
+     * the data of the newer item (\p base). Since committed tile data
+     * is never changed, the delta stays valid as long as the base item
+     * exists, which is guaranteed by the base holding us as its parent.
+     *
+     * The data of the base can be delta-encoded itself, so restoring
+     * may walk up the chain to the HEAD revision. The undo operation
+     * only ever restores the parents of the HEAD items, so the chain is
+     * usually one item long.
+     *
+     * \return true if the data has been encoded
+     */
+    bool tryEncodeDelta(KisMementoItem *base);
+
+    /**
+     * Converts the delta-encoded item back into a normal one
+     * with real tile data. Does nothing if the item is not encoded.
+     */
+    void restoreFromDelta();
+
+    inline bool isDeltaEncoded() const {
+        return !m_deltaData.isEmpty();
+    }
+
     inline KisTileSP tile(KisMementoManager *mm) {
         Q_ASSERT(m_tileData);
         return KisTileSP(new KisTile(m_col, m_row, m_tileData, mm));
@@ -177,7 +212,7 @@ public:
     void debugPrintInfo() {
         QString s = QString("------\n"
                    "Memento item:\t\t0x%1 (0x%2)\n"
-                   "   status:\t(%3,%4) %5%6\n"
+                   "   status:\t(%3,%4) %5%6%11\n"
                    "   parent:\t0x%7 (0x%8)\n"
                    "   next:\t0x%9 (0x%10)\n")
                 .arg((quintptr)this)
@@ -189,11 +224,20 @@ public:
                 .arg((quintptr)m_parent.data())
                 .arg(m_parent ? (quintptr)m_parent->m_tileData : 0)
                 .arg((quintptr)m_next.data())
-                .arg(m_next ? (quintptr)m_next->m_tileData : 0);
+                .arg(m_next ? (quintptr)m_next->m_tileData : 0)
+                .arg(isDeltaEncoded() ? " [delta]" : "");
         dbgKrita << s;
     }
 
 protected:
+    void restoreDataTo(quint8 *dst);
+
+    void resetDelta() {
+        m_deltaData.clear();
+        m_deltaBase = 0;
+        m_deltaPixelSize = 0;
+    }
+
     void releaseTileData() {
         if (m_tileData) {
             if (m_committedFlag) {
@@ -216,6 +260,14 @@ protected:
 
     KisMementoItemSP m_next;
     KisMementoItemSP m_parent;
+
+    /**
+     * The state of a delta-encoded item: m_tileData is null
+     * in this case, see tryEncodeDelta()
+     */
+    QByteArray m_deltaData;
+    KisMementoItemWSP m_deltaBase;
+    qint32 m_deltaPixelSize {0};
 private:
 };
 
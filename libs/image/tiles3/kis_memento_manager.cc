@@ -7,6 +7,7 @@
 #include <QtGlobal>
 #include "kis_memento_manager.h"
 #include "kis_memento.h"
+#include "kis_image_config.h"
 
 
 //#define DEBUG_MM
@@ -61,10 +62,23 @@
 
 #define namedTransactionInProgress() ((bool)m_currentMemento)
 
+namespace {
+bool defaultDeltaCompressionEnabled()
+{
+    /**
+     * Memento managers are created for every paint device,
+     * so don't touch the config file every time
+     */
+    static const bool value = KisImageConfig(true).useMementoDeltaCompression();
+    return value;
+}
+}
+
 KisMementoManager::KisMementoManager()
     : m_index(0),
       m_headsHashTable(0),
-      m_registrationBlocked(false)
+      m_registrationBlocked(false),
+      m_deltaCompressionEnabled(defaultDeltaCompressionEnabled())
 {
     /**
      * Tile change/delete registration is enabled for all
@@ -78,7 +92,8 @@ KisMementoManager::KisMementoManager(const KisMementoManager& rhs)
         m_cancelledRevisions(rhs.m_cancelledRevisions),
         m_headsHashTable(rhs.m_headsHashTable, 0),
         m_currentMemento(rhs.m_currentMemento),
-        m_registrationBlocked(rhs.m_registrationBlocked)
+        m_registrationBlocked(rhs.m_registrationBlocked),
+        m_deltaCompressionEnabled(rhs.m_deltaCompressionEnabled)
 {
     Q_ASSERT_X(!m_registrationBlocked,
                "KisMementoManager", "(impossible happened) "
@@ -192,6 +207,14 @@ void KisMementoManager::commit()
         mi->commit();
         revisionList.append(mi);
 
+        /**
+         * The parent is not a HEAD anymore, so it is used
+         * by undo only. Let it keep the delta only.
+         */
+        if (m_deltaCompressionEnabled) {
+            parentMI->tryEncodeDelta(mi.data());
+        }
+
         m_headsHashTable.deleteTile(mi->col(), mi->row());
 
         iter.moveCurrentToHashTable(&m_headsHashTable);
@@ -283,6 +306,9 @@ void KisMementoManager::rollback(KisTileHashTable *ht, KisMementoSP memento)
         mi=*iter;
         parentMI = mi->parent();
 
+        // the parent becomes HEAD again, so it needs real data
+        parentMI->restoreFromDelta();
+
         if (mi->type() == KisMementoItem::CHANGED)
             ht->deleteTile(mi->col(), mi->row());
         if (parentMI->type() == KisMementoItem::CHANGED)
@@ -398,6 +424,16 @@ void KisMementoManager::resetRevisionHistory(KisMementoItemList list)
     }
 }
 
+void KisMementoManager::setDeltaCompressionEnabled(bool value)
+{
+    m_deltaCompressionEnabled = value;
+}
+
+bool KisMementoManager::deltaCompressionEnabled() const
+{
+    return m_deltaCompressionEnabled;
+}
+
 void KisMementoManager::setDefaultTileData(KisTileData *defaultTileData)
 {
     m_headsHashTable.setDefaultTileData(defaultTileData);
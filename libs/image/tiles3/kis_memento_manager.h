@@ -113,6 +113,16 @@ public:
      */
     void purgeHistory(KisMementoSP oldestMemento);
 
+    /**
+     * When enabled, the tile data that becomes purely historical
+     * on commit() is replaced with a compressed XOR delta against
+     * the newer revision of the tile. The data is restored lazily
+     * on rollback(). The default value is taken from
+     * KisImageConfig::useMementoDeltaCompression()
+     */
+    void setDeltaCompressionEnabled(bool value);
+    bool deltaCompressionEnabled() const;
+
 protected:
     qint32 findRevisionByMemento(KisMementoSP memento) const;
     void resetRevisionHistory(KisMementoItemList list);
@@ -158,6 +168,11 @@ protected:
      * \see rollforward()
      */
     bool m_registrationBlocked;
+
+    /**
+     * \see setDeltaCompressionEnabled()
+     */
+    bool m_deltaCompressionEnabled;
 };
 
 #endif /* KIS_MEMENTO_MANAGER_ */
@@ -204,6 +204,43 @@ inline void KisTile::safeReleaseOldTileData(KisTileData *td)
     }
 }
 
+KisTileData* KisTile::refSwappedOutTileData()
+{
+    /**
+     * m_tileData can be replaced only under m_COWMutex,
+     * so holding it guarantees the tile data will not be
+     * released before we ref it.
+     */
+    QMutexLocker locker(&m_COWMutex);
+
+    if (m_tileData->data()) return 0;
+
+    m_tileData->ref();
+    return m_tileData;
+}
+
+bool KisTile::shareTileData(KisTileData *tileData)
+{
+    QMutexLocker locker(&m_COWMutex);
+
+    /**
+     * Holding the barrier lock guarantees nobody
+     * can start reading the data while we replace it
+     */
+    QMutexLocker barrierLocker(&m_swapBarrierLock);
+
+    if (m_lockCounter > 0 || m_tileData == tileData) return false;
+
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(tileData->pixelSize() == m_tileData->pixelSize(), false);
+
+    tileData->acquire();
+    KisTileData *oldTileData = m_tileData;
+    m_tileData = tileData;
+    oldTileData->release();
+
+    return true;
+}
+
 void KisTile::lockForRead() const
 {
 #ifdef DEAD_TILES_SANITY_CHECK
@@ -257,6 +294,8 @@ void KisTile::lockForWrite()
 #endif
     }
 
+    m_tileData->resetContentHash();
+
     DEBUG_LOG_ACTION("lock [W]");
 }
 
@@ -119,6 +119,31 @@ public:
         return m_tileData;
     }
 
+    /**
+     * If the tile data of the tile is currently swapped out, refs
+     * it and returns the pointer to it, otherwise returns null. The
+     * caller should deref() the returned tile data when it is not
+     * needed anymore.
+     *
+     * Used by the swap prefetcher. The check is not atomic in
+     * regard to the swapper, so the result is only a hint.
+     */
+    KisTileData* refSwappedOutTileData();
+
+    /**
+     * Replaces the tile data of the tile with \p tileData, which
+     * must have exactly the same content. The tile becomes one more
+     * COW-user of \p tileData, the old tile data is released.
+     *
+     * The replacement is done only when nobody holds a lock on
+     * the tile, otherwise the function does nothing.
+     *
+     * Used by KisTileDataDeduplicator only.
+     *
+     * \return true if the tile data has been replaced
+     */
+    bool shareTileData(KisTileData *tileData);
+
 private:
     void init(qint32 col, qint32 row,
               KisTileData *defaultTileData, KisMementoManager* mm);
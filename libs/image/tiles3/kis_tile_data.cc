@@ -9,53 +9,25 @@
 #include "kis_tile_data.h"
 #include "kis_tile_data_store.h"
 
+#include <limits>
+
 #include <kis_debug.h>
 
-#include <boost/pool/singleton_pool.hpp>
 #include "kis_tile_data_store_iterators.h"
-
-// BPP == bytes per pixel
-#define TILE_SIZE_4BPP (4 * __TILE_DATA_WIDTH * __TILE_DATA_HEIGHT)
-#define TILE_SIZE_8BPP (8 * __TILE_DATA_WIDTH * __TILE_DATA_HEIGHT)
-
-typedef boost::singleton_pool<KisTileData, TILE_SIZE_4BPP, boost::default_user_allocator_new_delete, boost::details::pool::default_mutex, 256, 4096> BoostPool4BPP;
-typedef boost::singleton_pool<KisTileData, TILE_SIZE_8BPP, boost::default_user_allocator_new_delete, boost::details::pool::default_mutex, 128, 2048> BoostPool8BPP;
+#include "KisTileDataArena.h"
 
 const qint32 KisTileData::WIDTH = __TILE_DATA_WIDTH;
 const qint32 KisTileData::HEIGHT = __TILE_DATA_HEIGHT;
-
-SimpleCache KisTileData::m_cache;
-
-SimpleCache::~SimpleCache()
-{
-    clear();
-}
-
-void SimpleCache::clear()
-{
-    QWriteLocker l(&m_cacheLock);
-    quint8 *ptr = 0;
-
-    while (m_4Pool.pop(ptr)) {
-        BoostPool4BPP::free(ptr);
-    }
-
-    while (m_8Pool.pop(ptr)) {
-        BoostPool8BPP::free(ptr);
-    }
-
-    while (m_16Pool.pop(ptr)) {
-        free(ptr);
-    }
-}
-
+const int KisTileData::NEVER_REUSED = std::numeric_limits<int>::max();
 
 KisTileData::KisTileData(qint32 pixelSize, const quint8 *defPixel, KisTileDataStore *store, bool checkFreeMemory)
     : m_state(NORMAL),
       m_mementoFlag(0),
-      m_age(0),
+      m_lastAccessEpoch(store->accessEpoch()),
+      m_prevAccessEpoch(KisTileDataStore::NEVER_ACCESSED_EPOCH),
       m_usersCount(0),
       m_refCount(0),
+      m_contentHash(0),
       m_pixelSize(pixelSize),
       m_store(store)
 {
@@ -64,7 +36,9 @@ KisTileData::KisTileData(qint32 pixelSize, const quint8 *defPixel, KisTileDataSt
     }
     m_data = allocateData(m_pixelSize);
 
-    fillWithPixel(defPixel);
+    if (defPixel) {
+        fillWithPixel(defPixel);
+    }
 }
 
 
@@ -82,9 +56,11 @@ KisTileData::KisTileData(qint32 pixelSize, const quint8 *defPixel, KisTileDataSt
 KisTileData::KisTileData(const KisTileData& rhs, bool checkFreeMemory)
     : m_state(NORMAL),
       m_mementoFlag(0),
-      m_age(0),
+      m_lastAccessEpoch(rhs.m_lastAccessEpoch.loadRelaxed()),
+      m_prevAccessEpoch(rhs.m_prevAccessEpoch.loadRelaxed()),
       m_usersCount(0),
       m_refCount(0),
+      m_contentHash(rhs.contentHash()),
       m_pixelSize(rhs.m_pixelSize),
       m_store(rhs.m_store)
 {
@@ -134,40 +110,12 @@ void KisTileData::allocateMemory()
 
 quint8* KisTileData::allocateData(const qint32 pixelSize)
 {
-    quint8 *ptr = 0;
-
-    if (!m_cache.pop(pixelSize, ptr)) {
-        switch (pixelSize) {
-        case 4:
-            ptr = (quint8*)BoostPool4BPP::malloc();
-            break;
-        case 8:
-            ptr = (quint8*)BoostPool8BPP::malloc();
-            break;
-        default:
-            ptr = (quint8*) malloc(pixelSize * WIDTH * HEIGHT);
-            break;
-        }
-    }
-
-    return ptr;
+    return KisTileDataArena::instance()->allocate(pixelSize);
 }
 
 void KisTileData::freeData(quint8* ptr, const qint32 pixelSize)
 {
-    if (!m_cache.push(pixelSize, ptr)) {
-        switch (pixelSize) {
-        case 4:
-            BoostPool4BPP::free(ptr);
-            break;
-        case 8:
-            BoostPool8BPP::free(ptr);
-            break;
-        default:
-            free(ptr);
-            break;
-        }
-    }
+    KisTileDataArena::instance()->free(ptr, pixelSize);
 }
 
 //#define DEBUG_POOL_RELEASE
@@ -198,10 +146,7 @@ void KisTileData::releaseInternalPools()
             }
 
             // check if the tile data has actually been pooled
-            if (item->m_pixelSize != 4 &&
-                item->m_pixelSize != 8 &&
-                item->m_pixelSize != 16) {
-
+            if (item->m_pixelSize > KisTileDataArena::MAX_PIXEL_SIZE) {
                 continue;
             }
 
@@ -221,10 +166,13 @@ void KisTileData::releaseInternalPools()
         }
 
         if (!failedToLock) {
-            // purge the pools memory
-            m_cache.clear();
-            BoostPool4BPP::purge_memory();
-            BoostPool8BPP::purge_memory();
+            // the arena purges only the slabs that have no chunks in use
+            Q_FOREACH (KisTileData *item, dataObjects) {
+                freeData(item->m_data, item->m_pixelSize);
+                item->m_data = 0;
+            }
+
+            KisTileDataArena::instance()->purgeMemory();
 
             auto it = dataObjects.begin();
             auto chunkIt = memoryChunks.constBegin();
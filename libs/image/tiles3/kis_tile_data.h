@@ -26,6 +26,7 @@ inline quint8* KisTileData::data() const {
 void KisTileData::setData(const quint8 *data) {
     Q_ASSERT(m_data);
     memcpy(m_data, data, m_pixelSize*WIDTH*HEIGHT);
+    resetContentHash();
 }
 
 inline quint32 KisTileData::pixelSize() const {
@@ -108,18 +109,39 @@ inline bool KisTileData::historical() const {
 }
 
 inline int KisTileData::age() const {
-    return m_age;
+    return m_store->accessEpoch() - m_lastAccessEpoch.loadRelaxed();
 }
 inline void KisTileData::resetAge() {
-    m_age = 0;
+    const int epoch = m_store->accessEpoch();
+    const int lastEpoch = m_lastAccessEpoch.loadRelaxed();
+
+    /**
+     * Don't touch the cache line more than once per epoch
+     */
+    if (lastEpoch != epoch) {
+        m_prevAccessEpoch.storeRelaxed(lastEpoch);
+        m_lastAccessEpoch.storeRelaxed(epoch);
+    }
 }
-inline void KisTileData::markOld() {
-    m_age++;
+inline int KisTileData::reuseDistance() const {
+    const int prevEpoch = m_prevAccessEpoch.loadRelaxed();
+    return prevEpoch != KisTileDataStore::NEVER_ACCESSED_EPOCH ?
+        m_store->accessEpoch() - prevEpoch : NEVER_REUSED;
 }
 
 inline qint32 KisTileData::numUsers() const {
     return m_usersCount;
 }
 
+inline quint32 KisTileData::contentHash() const {
+    return m_contentHash.loadAcquire();
+}
+inline void KisTileData::setContentHash(quint32 value) {
+    m_contentHash.storeRelease(value);
+}
+inline void KisTileData::resetContentHash() {
+    m_contentHash.storeRelease(0);
+}
+
 #endif /* KIS_TILE_DATA_H_ */
 
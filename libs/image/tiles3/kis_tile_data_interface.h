@@ -14,15 +14,20 @@
 #include "kis_lockless_stack.h"
 #include "swap/kis_chunk_allocator.h"
 
+#include "config-tile-size.h"
+
 class KisTileData;
 class KisTileDataStore;
 
 /**
  * WARNING: Those definitions for internal use only!
  * Please use KisTileData::WIDTH/HEIGHT instead
+ *
+ * The size is chosen at build time with KRITA_TILE_SIZE
+ * cmake option.
  */
-#define __TILE_DATA_WIDTH 64
-#define __TILE_DATA_HEIGHT 64
+#define __TILE_DATA_WIDTH KRITA_TILE_SIZE
+#define __TILE_DATA_HEIGHT KRITA_TILE_SIZE
 
 typedef KisLocklessStack<KisTileData*> KisTileDataCache;
 
@@ -31,63 +36,17 @@ typedef KisTileDataList::iterator KisTileDataListIterator;
 typedef KisTileDataList::const_iterator KisTileDataListConstIterator;
 
 
-class SimpleCache
-{
-public:
-    SimpleCache() = default;
-    ~SimpleCache();
-
-    bool push(int pixelSize, quint8 *&ptr)
-    {
-        QReadLocker l(&m_cacheLock);
-        switch (pixelSize) {
-        case 4:
-            m_4Pool.push(ptr);
-            break;
-        case 8:
-            m_8Pool.push(ptr);
-            break;
-        case 16:
-            m_16Pool.push(ptr);
-            break;
-        default:
-            return false;
-        }
-
-        return true;
-    }
-
-    bool pop(int pixelSize, quint8 *&ptr)
-    {
-        QReadLocker l(&m_cacheLock);
-        switch (pixelSize) {
-        case 4:
-            return m_4Pool.pop(ptr);
-        case 8:
-            return m_8Pool.pop(ptr);
-        case 16:
-            return m_16Pool.pop(ptr);
-        default:
-            return false;
-        }
-    }
-
-    void clear();
-
-private:
-    QReadWriteLock m_cacheLock;
-    KisLocklessStack<quint8*> m_4Pool;
-    KisLocklessStack<quint8*> m_8Pool;
-    KisLocklessStack<quint8*> m_16Pool;
-};
-
-
 /**
  * Stores actual tile's data
  */
 class KRITAIMAGE_EXPORT KisTileData
 {
 public:
+    /**
+     * Creates a tile data filled with \p defPixel. If \p defPixel is
+     * null, the data is left uninitialized, the caller is expected
+     * to write the whole tile itself.
+     */
     KisTileData(qint32 pixelSize, const quint8 *defPixel, KisTileDataStore *store, bool checkFreeMemory = true);
 
 private:
@@ -160,11 +119,23 @@ public:
     inline void setMementoed(bool value);
 
     /**
-     * Controlling methods for setting 'age' marks
+     * Controlling methods for setting 'age' marks. The age is
+     * the number of access epochs passed since the last access
+     * to the tile data, see KisTileDataStore::advanceAccessEpoch().
      */
     inline int age() const;
     inline void resetAge();
-    inline void markOld();
+
+    /**
+     * The number of access epochs passed since the last but one
+     * access to the tile data, that is the backward 2-distance of
+     * the LRU-2 policy. The tile data accessed only once (e.g. by
+     * a single pass of a filter) returns NEVER_REUSED, so it is
+     * swapped out before the tiles that are accessed regularly.
+     */
+    inline int reuseDistance() const;
+
+    static const int NEVER_REUSED;
 
     /**
      * Returns number of tiles (or memento items),
@@ -172,6 +143,16 @@ public:
      */
     inline qint32 numUsers() const;
 
+    /**
+     * The cached hash of the tile's content, used by
+     * KisTileDataDeduplicator. Zero means the hash is not known.
+     * The hash is reset every time the tile data is locked for
+     * writing or its content is overwritten with setData().
+     */
+    inline quint32 contentHash() const;
+    inline void setContentHash(quint32 value);
+    inline void resetContentHash();
+
     /**
      * Convenience method. Returns true iff the tile data is linked to
      * information only and therefore can be swapped out easily.
@@ -201,7 +182,7 @@ public:
     /**
      * Releases internal pools, which keep blobs where the tiles are
      * stored.  The point is that we don't allocate the tiles from
-     * glibc directly, but use pools (implemented via boost) to
+     * glibc directly, but use pools (see KisTileDataArena) to
      * allocate bigger chunks. This method should be called when one
      * knows that we have just free'd quite a lot of memory and we
      * won't need it anymore. E.g. when a document has been closed.
@@ -263,12 +244,14 @@ private:
     qint32 m_mementoFlag;
 
     /**
-     * Counts up time after last access to the tile data.
-     * 0 - recently accessed
-     * 1+ - not recently accessed
+     * The access epochs of the last and the last but one accesses
+     * to the tile data, KisTileDataStore::NEVER_ACCESSED_EPOCH
+     * means "never". Written without any
+     * locking, since a lost update just makes the eviction a bit
+     * less precise.
      */
-    //FIXME: make memory aligned
-    int m_age;
+    QAtomicInt m_lastAccessEpoch;
+    QAtomicInt m_prevAccessEpoch;
 
 
     /**
@@ -300,12 +283,16 @@ private:
      */
     mutable QAtomicInt m_refCount;
 
+    /**
+     * \see contentHash()
+     */
+    QAtomicInteger<quint32> m_contentHash;
+
 
     qint32 m_pixelSize;
     //qint32 m_timeStamp;
 
     KisTileDataStore *m_store;
-    static SimpleCache m_cache;
 
 public:
     static const qint32 WIDTH;
@@ -19,6 +19,17 @@ const qint32 KisTileDataPooler::MAX_TIMEOUT = 60000; // 01m00s
 const qint32 KisTileDataPooler::MIN_TIMEOUT = 100; // 00m00.100s
 const qint32 KisTileDataPooler::TIMEOUT_FACTOR = 2;
 
+/**
+ * The age of the tile data is the number of swapper cycles passed
+ * since its last access (see KisTileDataStore::accessEpoch()). The
+ * tiles accessed after the start of the latest swapper cycle are
+ * considered active: they get the clones precalculated, and the
+ * older ones donate their clones. This is the same split the pooler
+ * used to make by the old age marks, which were set by the swapper
+ * cycles as well.
+ */
+const qint32 KisTileDataPooler::MAX_ACTIVE_AGE = 0;
+
 //#define DEBUG_POOLER
 
 #ifdef DEBUG_POOLER
@@ -270,15 +281,20 @@ inline void KisTileDataPooler::tryFreeOrphanedClones(KisTileData *td)
     }
 }
 
+inline bool KisTileDataPooler::isActive(KisTileData *td)
+{
+    return td->age() <= MAX_ACTIVE_AGE;
+}
+
 inline qint32 KisTileDataPooler::needMemory(KisTileData *td)
 {
-    qint32 clonesNeeded = !td->age() ? qMax(0, numClonesNeeded(td)) : 0;
+    qint32 clonesNeeded = isActive(td) ? qMax(0, numClonesNeeded(td)) : 0;
     return clonesMetric(td, clonesNeeded);
 }
 
 inline qint32 KisTileDataPooler::canDonorMemory(KisTileData *td)
 {
-    return td->age() && clonesMetric(td);
+    return !isActive(td) && clonesMetric(td);
 }
 
 template<class Iter>
@@ -46,6 +46,7 @@ protected:
     static const qint32 MAX_TIMEOUT;
     static const qint32 MIN_TIMEOUT;
     static const qint32 TIMEOUT_FACTOR;
+    static const qint32 MAX_ACTIVE_AGE;
 
     void waitForWork();
     qint32 numClonesNeeded(KisTileData *td) const;
@@ -55,6 +56,7 @@ protected:
     inline int clonesMetric(KisTileData *td, int numClones);
     inline int clonesMetric(KisTileData *td);
 
+    inline bool isActive(KisTileData *td);
     inline void tryFreeOrphanedClones(KisTileData *td);
     inline qint32 needMemory(KisTileData *td);
     inline qint32 canDonorMemory(KisTileData *td);
@@ -15,6 +15,7 @@
 #include "kis_debug.h"
 
 #include "kis_tile_data_store_iterators.h"
+#include "swap/kis_tile_data_swapper_p.h"
 
 Q_GLOBAL_STATIC(KisTileDataStore, s_instance)
 
@@ -58,20 +59,33 @@ qint64 __preclone_miss_age = 0;
 KisTileDataStore::KisTileDataStore()
     : m_pooler(this),
       m_swapper(this),
+      m_prefetcher(this),
       m_numTiles(0),
       m_memoryMetric(0),
       m_counter(1),
-      m_clockIndex(1)
+      m_clockIndex(1),
+      m_accessEpoch(FIRST_ACCESS_EPOCH),
+      m_deduplicatedMemory(0)
 {
     m_pooler.start();
     m_swapper.start();
+    m_prefetcher.start();
 }
 
 KisTileDataStore::~KisTileDataStore()
 {
+    m_prefetcher.terminatePrefetcher();
     m_pooler.terminatePooler();
     m_swapper.terminateSwapper();
 
+    {
+        QMutexLocker locker(&m_uniformTileDataLock);
+        Q_FOREACH (KisTileData *td, m_uniformTileData) {
+            td->release();
+        }
+        m_uniformTileData.clear();
+    }
+
     if (numTiles() > 0) {
         errKrita << "Warning: some tiles have leaked:";
         errKrita << "\tTiles in memory:" << numTilesInMemory() << "\n"
@@ -84,6 +98,50 @@ KisTileDataStore* KisTileDataStore::instance()
     return s_instance;
 }
 
+/**
+ * Every uniform color cached by the store costs a full tile,
+ * so keep only the colors that are actually in use
+ */
+#define MAX_UNIFORM_TILE_DATA 256
+
+KisTileData* KisTileDataStore::acquireUniformTileData(qint32 pixelSize, const quint8 *pixel)
+{
+    const QByteArray key(reinterpret_cast<const char*>(pixel), pixelSize);
+
+    QMutexLocker locker(&m_uniformTileDataLock);
+
+    KisTileData *td = m_uniformTileData.value(key, 0);
+
+    if (!td) {
+        td = allocTileData(pixelSize, pixel);
+
+        if (m_uniformTileData.size() >= MAX_UNIFORM_TILE_DATA) {
+            releaseUnusedUniformTileData();
+        }
+
+        if (m_uniformTileData.size() < MAX_UNIFORM_TILE_DATA) {
+            td->acquire();
+            m_uniformTileData.insert(key, td);
+        }
+    }
+
+    td->acquire();
+    return td;
+}
+
+void KisTileDataStore::releaseUnusedUniformTileData()
+{
+    auto it = m_uniformTileData.begin();
+    while (it != m_uniformTileData.end()) {
+        if ((*it)->numUsers() <= 1) {
+            (*it)->release();
+            it = m_uniformTileData.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 KisTileDataStore::MemoryStatistics KisTileDataStore::memoryStatistics()
 {
     QReadLocker lock(&m_iteratorLock);
@@ -100,6 +158,8 @@ KisTileDataStore::MemoryStatistics KisTileDataStore::memoryStatistics()
 
     stats.swapSize = m_swappedStore.totalSwapMemoryUsed();
 
+    stats.deduplicatedSize = m_deduplicatedMemory.loadAcquire();
+
     return stats;
 }
 
@@ -259,6 +319,52 @@ void KisTileDataStore::ensureTileDataLoaded(KisTileData *td)
     }
 }
 
+void KisTileDataStore::swapInTileDataBatch(const QVector<KisTileData*> &tileData)
+{
+    /**
+     * We follow the same lock ordering as ensureTileDataLoaded()
+     * does: m_iteratorLock first, then the swap lock of the tile
+     * data. The swap locks are only *tried*, because the tile
+     * data being locked means someone is already loading it.
+     *
+     * The locks are taken for a single span of the swap file only,
+     * so the foreground swap-ins and the swapper never wait for
+     * the whole speculative batch.
+     */
+    QVector<KisTileData*> pendingTileData = tileData;
+
+    while (!pendingTileData.isEmpty()) {
+        QWriteLocker l(&m_iteratorLock);
+
+        QVector<KisTileData*> lockedTileData;
+        lockedTileData.reserve(pendingTileData.size());
+
+        Q_FOREACH (KisTileData *td, pendingTileData) {
+            if (!td->m_swapLock.tryLockForWrite()) continue;
+
+            if (!td->data()) {
+                lockedTileData.append(td);
+            } else {
+                td->m_swapLock.unlock();
+            }
+        }
+
+        const QVector<KisTileData*> loadedTileData =
+            m_swappedStore.swapInTileDataSpan(lockedTileData);
+
+        Q_FOREACH (KisTileData *td, loadedTileData) {
+            registerTileDataImp(td);
+            td->m_swapLock.unlock();
+        }
+
+        Q_FOREACH (KisTileData *td, lockedTileData) {
+            td->m_swapLock.unlock();
+        }
+
+        pendingTileData = lockedTileData;
+    }
+}
+
 bool KisTileDataStore::trySwapTileData(KisTileData *td)
 {
     /**
@@ -347,8 +453,19 @@ void KisTileDataStore::debugSwapAll()
 //    m_swappedStore.debugStatistics();
 }
 
+bool KisTileDataStore::isAboveSoftLimit() const
+{
+    return memoryMetric() > KisStoreLimits().softLimitThreshold();
+}
+
 void KisTileDataStore::debugClear()
 {
+    {
+        // the tile data objects are deleted below
+        QMutexLocker locker(&m_uniformTileDataLock);
+        m_uniformTileData.clear();
+    }
+
     QWriteLocker l(&m_iteratorLock);
     ConcurrentMap<int, KisTileData*>::Iterator iter(m_tileDataMap);
 
@@ -367,6 +484,7 @@ void KisTileDataStore::testingRereadConfig()
 {
     m_pooler.testingRereadConfig();
     m_swapper.testingRereadConfig();
+    m_prefetcher.testingRereadConfig();
     kickPooler();
 }
 
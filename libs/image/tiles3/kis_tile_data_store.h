@@ -11,10 +11,14 @@
 #include "kritaimage_export.h"
 
 #include <QReadWriteLock>
+#include <QMutex>
+#include <QHash>
+#include <QByteArray>
 #include "kis_tile_data_interface.h"
 
 #include "kis_tile_data_pooler.h"
 #include "swap/kis_tile_data_swapper.h"
+#include "swap/kis_tile_data_prefetcher.h"
 #include "swap/kis_swapped_data_store.h"
 #include "3rdparty/lock_free_map/concurrent_map.h"
 
@@ -42,6 +46,8 @@ public:
         qint64 poolSize;
 
         qint64 swapSize;
+
+        qint64 deduplicatedSize;
     };
 
     MemoryStatistics memoryStatistics();
@@ -77,6 +83,35 @@ public:
         return m_memoryMetric.loadAcquire();
     }
 
+    /**
+     * Returns true if the tiles take more memory than the soft limit
+     * set by the user, that is, the swapper has started swapping out
+     * the undo data. Caches should avoid growing in this state.
+     */
+    bool isAboveSoftLimit() const;
+
+    /**
+     * The tile data objects remember the epochs of their last two
+     * accesses. The swapper starts a new epoch on every cycle, so
+     * the age of a tile data is the number of swapper cycles
+     * it hasn't been accessed for.
+     *
+     * NEVER_ACCESSED_EPOCH is never a valid epoch, so the accesses
+     * made before the first swapper cycle are still counted.
+     */
+    static constexpr int NEVER_ACCESSED_EPOCH = 0;
+    static constexpr int FIRST_ACCESS_EPOCH = NEVER_ACCESSED_EPOCH + 1;
+
+    inline int accessEpoch() const
+    {
+        return m_accessEpoch.loadRelaxed();
+    }
+
+    inline void advanceAccessEpoch()
+    {
+        m_accessEpoch.ref();
+    }
+
     KisTileDataStoreIterator* beginIteration();
     void endIteration(KisTileDataStoreIterator* iterator);
 
@@ -91,6 +126,29 @@ public:
         return allocTileData(pixelSize, defPixel);
     }
 
+    /**
+     * Returns a tile data filled with \p pixel that is shared by all
+     * the uniform tiles of this color in all the devices. The tile
+     * data is kept by the store itself, so it is always COW-shared
+     * and gets expanded into a separate copy on the first write
+     * access to a tile.
+     *
+     * The returned tile data is acquire()'d for the caller, it
+     * must be release()'d after use.
+     */
+    KisTileData* acquireUniformTileData(qint32 pixelSize, const quint8 *pixel);
+
+    /**
+     * Called by KisTileDataDeduplicator users to report the amount
+     * of memory released by merging identical tiles. The value is
+     * accumulated for the whole session and reported in
+     * MemoryStatistics::deduplicatedSize.
+     */
+    inline void registerDeduplicatedMemory(qint64 size)
+    {
+        m_deduplicatedMemory.fetchAndAddRelaxed(size);
+    }
+
     // Called by The Memento Manager after every commit
     inline void kickPooler()
     {
@@ -129,6 +187,35 @@ public:
      */
     void ensureTileDataLoaded(KisTileData *td);
 
+    /**
+     * Asks the prefetcher thread to load the tile data objects
+     * from the swap in background. Every tile data in the list
+     * must be ref()'ed by the caller, the store will deref() them
+     * when the request is processed.
+     */
+    inline void prefetchTileData(const QVector<KisTileData*> &tileData)
+    {
+        m_prefetcher.prefetch(tileData);
+    }
+
+    /**
+     * Returns true if there is at least one tile data stored in the
+     * swap file, that is, if there is anything to prefetch at all.
+     */
+    inline bool hasSwappedTileData() const
+    {
+        return m_swappedStore.numTiles() > 0;
+    }
+
+    /**
+     * Loads the swapped-out tile data from \p tileData from the swap
+     * file in a single batch. The tile data that is already present in
+     * memory or is being accessed by someone else is skipped.
+     *
+     * Used by KisTileDataPrefetcher only.
+     */
+    void swapInTileDataBatch(const QVector<KisTileData*> &tileData);
+
     void registerTileData(KisTileData *td);
     void unregisterTileData(KisTileData *td);
 
@@ -144,6 +231,8 @@ private:
     void debugSwapAll();
     void debugClear();
 
+    void releaseUnusedUniformTileData();
+
     friend class KisTiledDataManagerTest;
     void testingSuspendPooler();
     void testingResumePooler();
@@ -153,6 +242,7 @@ private:
 private:
     KisTileDataPooler m_pooler;
     KisTileDataSwapper m_swapper;
+    KisTileDataPrefetcher m_prefetcher;
 
     friend class KisTileDataStoreTest;
     friend class KisTileDataPoolerTest;
@@ -167,6 +257,14 @@ private:
     QAtomicInt m_memoryMetric;
     QAtomicInt m_counter;
     QAtomicInt m_clockIndex;
+    QAtomicInt m_accessEpoch;
+    QAtomicInteger<qint64> m_deduplicatedMemory;
+
+    /**
+     * \see acquireUniformTileData(), the key is the bytes of the pixel
+     */
+    QMutex m_uniformTileDataLock;
+    QHash<QByteArray, KisTileData*> m_uniformTileData;
     ConcurrentMap<int, KisTileData*> m_tileDataMap;
     QReadWriteLock m_iteratorLock;
 };
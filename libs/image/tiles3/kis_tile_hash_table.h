@@ -10,6 +10,8 @@
 
 #include "kis_tile.h"
 
+#include "config-hash-table-implementation.h"
+
 
 
 /**
@@ -217,8 +219,10 @@ private:
 };
 
 
+#ifndef USE_LOCK_FREE_HASH_TABLE
 typedef KisTileHashTableTraits<KisTile> KisTileHashTable;
 typedef KisTileHashTableIteratorTraits<KisTile, QWriteLocker> KisTileHashTableIterator;
 typedef KisTileHashTableIteratorTraits<KisTile, QReadLocker> KisTileHashTableConstIterator;
+#endif /* USE_LOCK_FREE_HASH_TABLE */
 
 #endif /* KIS_TILEHASHTABLE_H_ */
@@ -7,12 +7,16 @@
 #ifndef KIS_TILEHASHTABLE_2_H
 #define KIS_TILEHASHTABLE_2_H
 
+#include <QThread>
+
 #include "kis_shared.h"
 #include "kis_shared_ptr.h"
 #include "3rdparty/lock_free_map/concurrent_map.h"
 #include "kis_tile.h"
 #include "kis_debug.h"
 
+#include "config-hash-table-implementation.h"
+
 #define SANITY_CHECK
 
 /**
@@ -26,6 +30,11 @@
  *   1) each hash must be unique, otherwise tiles would rewrite each-other
  *   2) 0 key is reserved, so can't be used
  *   3) col and row must be less than 0x7FFF to guarantee uniqueness of hash for each pair
+ *
+ * The table takes no locks. All the raw pointers read from the map (tiles,
+ * tables and the default tile data) are protected by the epoch-based
+ * reclamation of the map (QSBR): the objects removed from the table are
+ * released only when no thread holds raw pointer access anymore.
  */
 
 template <class T>
@@ -123,6 +132,30 @@ private:
         TileType *d;
     };
 
+    struct DefaultTileDataReclaimer {
+        DefaultTileDataReclaimer(KisTileData *data) : d(data) {}
+
+        void destroy()
+        {
+            d->release();
+            delete this;
+        }
+
+    private:
+        KisTileData *d;
+    };
+
+    /**
+     * Creates a detached tile with the default tile data
+     */
+    TileTypeSP createDefaultTile(qint32 col, qint32 row)
+    {
+        KisTileData *td = refAndFetchDefaultTileData();
+        TileTypeSP tile = new TileType(col, row, td, 0);
+        td->deref();
+        return tile;
+    }
+
     inline quint32 calculateHashImpl(qint32 col, qint32 row)
     {
         if (col == 0 && row == 0) {
@@ -157,11 +190,8 @@ private:
         TileTypeSP::ref(&item, item.data());
         TileType *tile = 0;
 
-        {
-            QReadLocker locker(&m_iteratorLock);
-            m_map.getGC().lockRawPointerAccess();
-            tile = m_map.assign(idx, item.data());
-        }
+        m_map.getGC().lockRawPointerAccess();
+        tile = m_map.assign(idx, item.data());
 
         if (tile) {
             tile->notifyDeadWithoutDetaching();
@@ -176,6 +206,18 @@ private:
     }
 
     inline bool erase(quint32 idx)
+    {
+        const bool wasDeleted = eraseNoUpdate(idx);
+        m_map.getGC().update();
+        return wasDeleted;
+    }
+
+    /**
+     * Erases the tile without trying to release the pending GC
+     * actions. Used by the iterator, because the GC might wait for
+     * the raw pointer access held by the iterator itself.
+     */
+    inline bool eraseNoUpdate(quint32 idx)
     {
         m_map.getGC().lockRawPointerAccess();
 
@@ -192,7 +234,6 @@ private:
 
         m_map.getGC().unlockRawPointerAccess();
 
-        m_map.getGC().update();
         return wasDeleted;
     }
 
@@ -201,15 +242,14 @@ private:
     typedef typename LockFreeTileMap::Mutator LockFreeTileMapMutator;
     mutable LockFreeTileMap m_map;
 
+    QAtomicInt m_numTiles;
+
     /**
-     * We still need something to guard changes in m_defaultTileData,
-     * otherwise there will be concurrent read/writes, resulting in broken memory.
+     * The old default tile data is released through the GC of the
+     * map, so the readers may use the pointer while holding raw
+     * pointer access
      */
-    QReadWriteLock m_defaultPixelDataLock;
-    mutable QReadWriteLock m_iteratorLock;
-
-    QAtomicInt m_numTiles;
-    KisTileData *m_defaultTileData;
+    QAtomicPointer<KisTileData> m_defaultTileData;
     KisMementoManager *m_mementoManager;
 };
 
@@ -221,25 +261,41 @@ public:
     typedef KisSharedPtr<T> TileTypeSP;
     typedef typename ConcurrentMap<quint32, TileType*>::Iterator Iterator;
 
+    /**
+     * The iterator walks through the live table and doesn't block the
+     * writers. The raw pointer access is held for the whole iteration,
+     * so neither the tiles nor the table itself are reclaimed under its
+     * feet. The tiles added during the iteration may or may not be
+     * visited.
+     *
+     * If a writer resizes the table during the iteration, the iteration
+     * is restarted on the new table, so some tiles may be visited twice.
+     *
+     * The pending GC actions are released only when the iteration
+     * is finished, so keep the iteration short.
+     */
     KisTileHashTableIteratorTraits2(KisTileHashTableTraits2<T> *ht) : m_ht(ht)
     {
-        m_ht->m_iteratorLock.lockForWrite();
+        m_ht->m_map.getGC().lockRawPointerAccess();
         m_iter.setMap(m_ht->m_map);
+        restartIfRedirected();
     }
 
     ~KisTileHashTableIteratorTraits2()
     {
-        m_ht->m_iteratorLock.unlock();
+        m_ht->m_map.getGC().unlockRawPointerAccess();
+        m_ht->m_map.getGC().update();
     }
 
     void next()
     {
         m_iter.next();
+        restartIfRedirected();
     }
 
     TileTypeSP tile() const
     {
-        return TileTypeSP(m_iter.getValue());
+        return !isDone() ? TileTypeSP(m_iter.getValue()) : TileTypeSP();
     }
 
     bool isDone() const
@@ -249,7 +305,7 @@ public:
 
     void deleteCurrent()
     {
-        m_ht->erase(m_iter.getKey());
+        m_ht->eraseNoUpdate(m_iter.getKey());
         next();
     }
 
@@ -259,14 +315,26 @@ public:
         next();
 
         quint32 idx = m_ht->calculateHash(tile->col(), tile->row());
-        m_ht->erase(idx);
+        m_ht->eraseNoUpdate(idx);
         newHashTable->insert(idx, tile);
     }
 
+private:
+    void restartIfRedirected()
+    {
+        while (!m_iter.isValid() && m_iter.wasRedirected()) {
+            // the table is being resized by a writer, just wait
+            // until the new table is published
+            QThread::yieldCurrentThread();
+            m_iter.setMap(m_ht->m_map);
+        }
+    }
+
 private:
     KisTileHashTableTraits2<T> *m_ht;
     Iterator m_iter;
 };
+};
 
 template <class T>
 KisTileHashTableTraits2<T>::KisTileHashTableTraits2(KisMementoManager *mm)
@@ -278,14 +346,23 @@ template <class T>
 KisTileHashTableTraits2<T>::KisTileHashTableTraits2(const KisTileHashTableTraits2<T> &ht, KisMementoManager *mm)
     : KisTileHashTableTraits2(mm)
 {
-    setDefaultTileData(ht.m_defaultTileData);
+    KisTileHashTableTraits2<T> &srcTable = const_cast<KisTileHashTableTraits2<T>&>(ht);
 
-    QWriteLocker locker(&ht.m_iteratorLock);
-    typename ConcurrentMap<quint32, TileType*>::Iterator iter(ht.m_map);
+    KisTileData *defaultTileData =
+        srcTable.defaultTileData() ? srcTable.refAndFetchDefaultTileData() : 0;
+
+    setDefaultTileData(defaultTileData);
+
+    if (defaultTileData) {
+        defaultTileData->deref();
+    }
 
-    while (iter.isValid()) {
-        TileTypeSP tile = new TileType(*iter.getValue(), m_mementoManager);
-        insert(iter.getKey(), tile);
+    KisTileHashTableIteratorTraits2<T> iter(&srcTable);
+    TileTypeSP srcTile;
+
+    while ((srcTile = iter.tile())) {
+        TileTypeSP tile = new TileType(*srcTile, m_mementoManager);
+        insert(calculateHash(tile->col(), tile->row()), tile);
         iter.next();
     }
 }
@@ -334,8 +411,7 @@ typename KisTileHashTableTraits2<T>::TileTypeSP KisTileHashTableTraits2<T>::getT
         /// manager
         newTile = false;
 
-        QReadLocker locker(&m_defaultPixelDataLock);
-        return new TileType(col, row, m_defaultTileData, 0);
+        return createDefaultTile(col, row);
     }
 
     // we are going to assign a raw-pointer tile from the table
@@ -349,18 +425,11 @@ typename KisTileHashTableTraits2<T>::TileTypeSP KisTileHashTableTraits2<T>::getT
         // raw-pointer lock held
         m_map.getGC().unlockRawPointerAccess();
 
-        {
-            QReadLocker locker(&m_defaultPixelDataLock);
-            tile = new TileType(col, row, m_defaultTileData, 0);
-        }
+        tile = createDefaultTile(col, row);
 
         TileTypeSP::ref(&tile, tile.data());
         TileType *discardedTile = 0;
 
-        // iterator lock should be taken **before**
-        // the pointers are locked
-        m_iteratorLock.lockForRead();
-
         // and now lock raw-pointers again
         m_map.getGC().lockRawPointerAccess();
 
@@ -373,8 +442,6 @@ typename KisTileHashTableTraits2<T>::TileTypeSP KisTileHashTableTraits2<T>::getT
             discardedTile = tile.data();
         }
 
-        m_iteratorLock.unlock();
-
         if (discardedTile) {
             // we've got our tile back, it didn't manage to
             // get into the table. Now release the allocated
@@ -414,8 +481,7 @@ typename KisTileHashTableTraits2<T>::TileTypeSP KisTileHashTableTraits2<T>::getR
         /// getTileLazy())
         existingTile = false;
 
-        QReadLocker locker(&m_defaultPixelDataLock);
-        return new TileType(col, row, m_defaultTileData, 0);
+        return createDefaultTile(col, row);
     }
 
     m_map.getGC().lockRawPointerAccess();
@@ -425,8 +491,7 @@ typename KisTileHashTableTraits2<T>::TileTypeSP KisTileHashTableTraits2<T>::getR
     existingTile = tile;
 
     if (!existingTile) {
-        QReadLocker locker(&m_defaultPixelDataLock);
-        tile = new TileType(col, row, m_defaultTileData, 0);
+        tile = createDefaultTile(col, row);
     }
 
     m_map.getGC().update();
@@ -461,61 +526,46 @@ bool KisTileHashTableTraits2<T>::deleteTile(qint32 col, qint32 row)
 template<class T>
 void KisTileHashTableTraits2<T>::clear()
 {
-    {
-        QWriteLocker locker(&m_iteratorLock);
-
-        typename ConcurrentMap<quint32, TileType*>::Iterator iter(m_map);
-        TileType *tile = 0;
+    KisTileHashTableIteratorTraits2<T> iter(this);
 
-        while (iter.isValid()) {
-            m_map.getGC().lockRawPointerAccess();
-            tile = m_map.erase(iter.getKey());
-
-            if (tile) {
-                tile->notifyDetachedFromDataManager();
-                m_map.getGC().enqueue(&MemoryReclaimer::destroy, new MemoryReclaimer(tile));
-            }
-            m_map.getGC().unlockRawPointerAccess();
-
-            iter.next();
-        }
-
-        m_numTiles.storeRelaxed(0);
+    while (!iter.isDone()) {
+        iter.deleteCurrent();
     }
-
-    // garbage collection must **not** be run with locks held
-    m_map.getGC().update();
 }
 
 template <class T>
 inline void KisTileHashTableTraits2<T>::setDefaultTileData(KisTileData *defaultTileData)
 {
-    QWriteLocker locker(&m_defaultPixelDataLock);
-
-    if (m_defaultTileData) {
-        m_defaultTileData->release();
-        m_defaultTileData = 0;
-    }
-
     if (defaultTileData) {
         defaultTileData->acquire();
-        m_defaultTileData = defaultTileData;
     }
+
+    KisTileData *oldTileData = m_defaultTileData.fetchAndStoreOrdered(defaultTileData);
+
+    if (oldTileData) {
+        // someone may still be creating a tile with the old data
+        m_map.getGC().enqueue(&DefaultTileDataReclaimer::destroy,
+                              new DefaultTileDataReclaimer(oldTileData));
+    }
+
+    m_map.getGC().update();
 }
 
 template <class T>
 inline KisTileData* KisTileHashTableTraits2<T>::defaultTileData()
 {
-    QReadLocker locker(&m_defaultPixelDataLock);
-    return m_defaultTileData;
+    return m_defaultTileData.loadAcquire();
 }
 
 template <class T>
 inline KisTileData* KisTileHashTableTraits2<T>::refAndFetchDefaultTileData()
 {
-    QReadLocker locker(&m_defaultPixelDataLock);
-    m_defaultTileData->ref();
-    return m_defaultTileData;
+    m_map.getGC().lockRawPointerAccess();
+    KisTileData *tileData = m_defaultTileData.loadAcquire();
+    tileData->ref();
+    m_map.getGC().unlockRawPointerAccess();
+
+    return tileData;
 }
 
 
@@ -529,8 +579,10 @@ void KisTileHashTableTraits2<T>::debugMaxListLength(qint32 &/*min*/, qint32 &/*m
 {
 }
 
+#ifdef USE_LOCK_FREE_HASH_TABLE
 typedef KisTileHashTableTraits2<KisTile> KisTileHashTable;
 typedef KisTileHashTableIteratorTraits2<KisTile> KisTileHashTableIterator;
 typedef KisTileHashTableIteratorTraits2<KisTile> KisTileHashTableConstIterator;
+#endif // USE_LOCK_FREE_HASH_TABLE
 
 #endif // KIS_TILEHASHTABLE_2_H
@@ -22,7 +22,7 @@
 #include "kis_global.h"
 
 
-/* The data area is divided into tiles each say 64x64 pixels (defined at compiletime)
+/* The data area is divided into tiles each say 64x64 pixels (KRITA_TILE_SIZE, defined at compiletime)
  * The tiles are laid out in a matrix that can have negative indexes.
  * The matrix grows automatically if needed (a call for writeacces to a tile
  * outside the current extent)
@@ -103,13 +103,18 @@ bool KisTiledDataManager::write(KisPaintDeviceWriter &store)
 
     bool retval = true;
 
+    const QSize fileTileSize(FILE_TILE_SIZE, FILE_TILE_SIZE);
+    const qint32 fileTilesPerTile =
+        (KisTileData::WIDTH / FILE_TILE_SIZE) * (KisTileData::HEIGHT / FILE_TILE_SIZE);
+    const quint32 numFileTiles = m_hashTable->numTiles() * fileTilesPerTile;
+
     if(CURRENT_VERSION == LEGACY_VERSION) {
         char str[80];
-        sprintf(str, "%d\n", m_hashTable->numTiles());
+        sprintf(str, "%d\n", numFileTiles);
         retval = store.write(str, strlen(str));
     }
     else {
-        retval = writeTilesHeader(store, m_hashTable->numTiles());
+        retval = writeTilesHeader(store, numFileTiles);
     }
 
 
@@ -118,6 +123,7 @@ bool KisTiledDataManager::write(KisPaintDeviceWriter &store)
 
     KisAbstractTileCompressorSP compressor =
         KisTileCompressorFactory::create(CURRENT_VERSION);
+    compressor->setTileSize(fileTileSize);
 
     while ((tile = iter.tile())) {
         retval = compressor->writeTile(tile, store);
@@ -148,6 +154,7 @@ bool KisTiledDataManager::read(QIODevice *stream)
 
     quint32 numTiles;
     qint32 tilesVersion = LEGACY_VERSION;
+    QSize tileSize(KisTileData::WIDTH, KisTileData::HEIGHT);
 
     if (line[0] == 'V') {
         QList<QByteArray> lineItems = line.split(' ');
@@ -157,7 +164,7 @@ bool KisTiledDataManager::read(QIODevice *stream)
 
         tilesVersion = lineItems.takeFirst().toInt();
 
-        if(!processTilesHeader(stream, numTiles))
+        if(!processTilesHeader(stream, numTiles, tileSize))
             return false;
     }
     else {
@@ -166,6 +173,7 @@ bool KisTiledDataManager::read(QIODevice *stream)
 
     KisAbstractTileCompressorSP compressor =
         KisTileCompressorFactory::create(tilesVersion);
+    compressor->setTileSize(tileSize);
 
     bool readSuccess = true;
     for (quint32 i = 0; i < numTiles; i++) {
@@ -188,8 +196,8 @@ bool KisTiledDataManager::writeTilesHeader(KisPaintDeviceWriter &store, quint32
                      "PIXELSIZE %4\n"
                      "DATA %5\n")
         .arg(CURRENT_VERSION)
-        .arg(KisTileData::WIDTH)
-        .arg(KisTileData::HEIGHT)
+        .arg(FILE_TILE_SIZE)
+        .arg(FILE_TILE_SIZE)
         .arg(pixelSize())
         .arg(numTiles);
 
@@ -206,7 +214,7 @@ bool KisTiledDataManager::writeTilesHeader(KisPaintDeviceWriter &store, quint32
     } while(0)                                                  \
 
 
-bool KisTiledDataManager::processTilesHeader(QIODevice *stream, quint32 &numTiles)
+bool KisTiledDataManager::processTilesHeader(QIODevice *stream, quint32 &numTiles, QSize &tileSize)
 {
     /**
      * We assume that there is only one version of this header
@@ -225,13 +233,19 @@ bool KisTiledDataManager::processTilesHeader(QIODevice *stream, quint32 &numTile
     while(!foundDataMark && stream->canReadLine()) {
         takeOneLine(stream, maxLineLength, keyword, value);
 
+        /**
+         * The file may come from a build with a different tile
+         * size, the compressor will convert the tiles then
+         */
         if (keyword == "TILEWIDTH") {
-            if(value != KisTileData::WIDTH)
+            if(value <= 0)
                 goto wrongString;
+            tileSize.setWidth(value);
         }
         else if (keyword == "TILEHEIGHT") {
-            if(value != KisTileData::HEIGHT)
+            if(value <= 0)
                 goto wrongString;
+            tileSize.setHeight(value);
         }
         else if (keyword == "PIXELSIZE") {
             if((quint32)value != pixelSize())
@@ -348,8 +362,7 @@ void KisTiledDataManager::clear(QRect clearRect, const quint8 *clearPixel)
         clearRect.width() >= KisTileData::WIDTH &&
         clearRect.height() >= KisTileData::HEIGHT) {
 
-        td = KisTileDataStore::instance()->createDefaultTileData(pixelSize, clearPixel);
-        td->acquire();
+        td = KisTileDataStore::instance()->acquireUniformTileData(pixelSize, clearPixel);
     }
 
     for (qint32 row = firstRow; row <= lastRow; ++row) {
@@ -577,6 +590,31 @@ void KisTiledDataManager::bitBltRoughOldData(KisTiledDataManager *srcDM, const Q
     bitBltRoughImpl<true>(srcDM, rect);
 }
 
+void KisTiledDataManager::prefetchSwappedTiles(const QRect &rect)
+{
+    KisTileDataStore *store = KisTileDataStore::instance();
+    if (!store->hasSwappedTileData() || rect.isEmpty()) return;
+
+    const QRect tilesRect(QPoint(xToCol(rect.left()), yToRow(rect.top())),
+                          QPoint(xToCol(rect.right()), yToRow(rect.bottom())));
+
+    QVector<KisTileData*> swappedTileData;
+
+    for (qint32 row = tilesRect.top(); row <= tilesRect.bottom(); row++) {
+        for (qint32 col = tilesRect.left(); col <= tilesRect.right(); col++) {
+            KisTileSP tile = m_hashTable->getExistingTile(col, row);
+            if (!tile) continue;
+
+            KisTileData *td = tile->refSwappedOutTileData();
+            if (td) {
+                swappedTileData.append(td);
+            }
+        }
+    }
+
+    store->prefetchTileData(swappedTileData);
+}
+
 void KisTiledDataManager::setExtent(qint32 x, qint32 y, qint32 w, qint32 h)
 {
     setExtent(QRect(x, y, w, h));
@@ -58,6 +58,13 @@ private:
     static const qint32 LEGACY_VERSION = 1;
     static const qint32 CURRENT_VERSION = 2;
 
+    /**
+     * The size of the tiles written into the files. It doesn't depend
+     * on KRITA_TILE_SIZE, so that the files saved by any build can be
+     * opened by the others. The native tiles are split on saving.
+     */
+    static const qint32 FILE_TILE_SIZE = 64;
+
 protected:
     /*FIXME:*/
 public:
@@ -75,6 +82,8 @@ protected:
     friend class KisTiledRandomAccessor;
     friend class KisRandomAccessor2;
     friend class KisStressJob;
+    friend class KisTiledDataManagerTest;
+    friend class KisTileDataDeduplicator;
 
 public:
     void setDefaultPixel(const quint8 *defPixel);
@@ -249,6 +258,13 @@ public:
      */
     void bitBltRoughOldData(KisTiledDataManager *srcDM, const QRect &rect);
 
+    /**
+     * Asks the tile data store to load the tiles of \p rect from the
+     * swap in background. Does nothing if nothing is swapped out.
+     * The call is cheap and never blocks on the swap file.
+     */
+    void prefetchSwappedTiles(const QRect &rect);
+
     /**
      * write the specified data to x, y. There is no checking on pixelSize!
      */
@@ -358,7 +374,7 @@ private:
     void setDefaultPixelImpl(const quint8 *defPixel);
 
     bool writeTilesHeader(KisPaintDeviceWriter &store, quint32 numTiles);
-    bool processTilesHeader(QIODevice *stream, quint32 &numTiles);
+    bool processTilesHeader(QIODevice *stream, quint32 &numTiles, QSize &tileSize);
 
     inline qint32 divideRoundDown(qint32 x, const qint32 y) const
     {
@@ -0,0 +1,248 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisMemoryPressureMonitor.h"
+
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QTextStream>
+
+#include "kis_debug.h"
+
+namespace {
+
+/**
+ * cgroup v1 reports "no limit" as a huge number rounded to the page size
+ */
+const qint64 UNLIMITED_THRESHOLD = qint64(1) << 60;
+
+const qreal MODERATE_USAGE_RATIO = 0.85;
+const qreal CRITICAL_USAGE_RATIO = 0.95;
+const qreal COMFORTABLE_USAGE_RATIO = 0.8;
+
+const qreal MODERATE_STALL_PERCENT = 1.0;
+const qreal CRITICAL_STALL_PERCENT = 10.0;
+
+QByteArray readFirstLine(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) return QByteArray();
+
+    return file.readLine().trimmed();
+}
+
+}
+
+KisMemoryPressureMonitor::KisMemoryPressureMonitor(const QString &rootPath)
+    : m_rootPath(rootPath)
+{
+    if (!m_rootPath.endsWith('/')) {
+        m_rootPath += '/';
+    }
+
+    QFile file(m_rootPath + "proc/self/cgroup");
+    if (!file.open(QIODevice::ReadOnly)) return;
+
+    QString unifiedPath;
+    QString memoryControllerPath;
+
+    QTextStream stream(&file);
+    QString line;
+
+    /**
+     * Every line looks like "hierarchy-ID:controller-list:cgroup-path".
+     * The unified (v2) hierarchy has ID 0 and an empty controller list.
+     */
+    while (stream.readLineInto(&line)) {
+        const int firstColon = line.indexOf(':');
+        const int secondColon = line.indexOf(':', firstColon + 1);
+        if (firstColon < 0 || secondColon < 0) continue;
+
+        const QString id = line.left(firstColon);
+        const QStringList controllers =
+            line.mid(firstColon + 1, secondColon - firstColon - 1).split(',');
+        const QString path = line.mid(secondColon + 1);
+
+        if (id == "0" && controllers == QStringList(QString())) {
+            unifiedPath = path;
+        } else if (controllers.contains("memory")) {
+            memoryControllerPath = path;
+        }
+    }
+
+    /**
+     * On hybrid systems the memory controller is still
+     * attached to the v1 hierarchy
+     */
+    if (!memoryControllerPath.isEmpty()) {
+        m_isCgroupV1 = true;
+        m_cgroupMountPath = m_rootPath + "sys/fs/cgroup/memory";
+        m_cgroupPath = memoryControllerPath;
+    } else if (!unifiedPath.isEmpty()) {
+        m_cgroupMountPath = m_rootPath + "sys/fs/cgroup";
+        m_cgroupPath = unifiedPath;
+    } else {
+        return;
+    }
+
+    /**
+     * Inside a container without its own cgroup namespace the path
+     * points to the host's hierarchy, while our cgroup is mounted
+     * right at the mount point
+     */
+    if (!QFileInfo(m_cgroupMountPath + m_cgroupPath).isDir()) {
+        m_cgroupPath = "/";
+    }
+}
+
+qint64 KisMemoryPressureMonitor::memoryLimit() const
+{
+    if (m_cgroupMountPath.isEmpty()) return -1;
+
+    qint64 limit = -1;
+
+    auto updateLimit = [&limit] (qint64 value) {
+        if (value >= 0 && (limit < 0 || value < limit)) {
+            limit = value;
+        }
+    };
+
+    /**
+     * The limits of the parent cgroups apply to us as well
+     */
+    QString path = QDir::cleanPath(m_cgroupPath);
+
+    while (true) {
+        const QString dir = m_cgroupMountPath + (path == "/" ? QString() : path) + '/';
+
+        if (m_isCgroupV1) {
+            updateLimit(readLimitFile(dir + "memory.limit_in_bytes"));
+        } else {
+            updateLimit(readLimitFile(dir + "memory.high"));
+            updateLimit(readLimitFile(dir + "memory.max"));
+        }
+
+        if (path == "/" || path.isEmpty()) break;
+
+        const int lastSlash = path.lastIndexOf('/');
+        path = lastSlash > 0 ? path.left(lastSlash) : "/";
+    }
+
+    return limit;
+}
+
+qint64 KisMemoryPressureMonitor::memoryUsage() const
+{
+    if (m_cgroupMountPath.isEmpty()) return -1;
+
+    const QString dir = m_cgroupMountPath + QDir::cleanPath(m_cgroupPath) + '/';
+    return readValueFile(dir + (m_isCgroupV1 ? "memory.usage_in_bytes" : "memory.current"));
+}
+
+qreal KisMemoryPressureMonitor::stallPercent() const
+{
+    QString fileName = m_rootPath + "proc/pressure/memory";
+
+    if (!m_cgroupMountPath.isEmpty() && !m_isCgroupV1) {
+        const QString cgroupFileName =
+            m_cgroupMountPath + QDir::cleanPath(m_cgroupPath) + "/memory.pressure";
+
+        if (QFile::exists(cgroupFileName)) {
+            fileName = cgroupFileName;
+        }
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) return -1;
+
+    /**
+     * The format is:
+     * some avg10=0.00 avg60=0.00 avg300=0.00 total=0
+     * full avg10=0.00 avg60=0.00 avg300=0.00 total=0
+     */
+    QTextStream stream(&file);
+    QString line;
+
+    while (stream.readLineInto(&line)) {
+        if (!line.startsWith("some ")) continue;
+
+        Q_FOREACH (const QString &field, line.split(' ', Qt::SkipEmptyParts)) {
+            if (field.startsWith("avg10=")) {
+                bool ok = false;
+                const qreal value = field.mid(6).toDouble(&ok);
+                return ok ? value : -1;
+            }
+        }
+    }
+
+    return -1;
+}
+
+KisMemoryPressureMonitor::PressureLevel KisMemoryPressureMonitor::pressureLevel() const
+{
+    PressureLevel level = NoPressure;
+
+    const qint64 limit = memoryLimit();
+    const qint64 usage = limit > 0 ? memoryUsage() : -1;
+
+    if (usage >= 0) {
+        const qreal ratio = qreal(usage) / limit;
+
+        if (ratio >= CRITICAL_USAGE_RATIO) {
+            return CriticalPressure;
+        } else if (ratio >= MODERATE_USAGE_RATIO) {
+            level = ModeratePressure;
+        }
+    }
+
+    const qreal stall = stallPercent();
+
+    if (stall >= CRITICAL_STALL_PERCENT) {
+        return CriticalPressure;
+    } else if (stall >= MODERATE_STALL_PERCENT) {
+        level = ModeratePressure;
+    }
+
+    return level;
+}
+
+qint64 KisMemoryPressureMonitor::excessMemory() const
+{
+    const qint64 limit = memoryLimit();
+    if (limit <= 0) return 0;
+
+    const qint64 usage = memoryUsage();
+    if (usage < 0) return 0;
+
+    return qMax(qint64(0), usage - qint64(limit * COMFORTABLE_USAGE_RATIO));
+}
+
+qint64 KisMemoryPressureMonitor::cgroupMemoryLimit()
+{
+    return KisMemoryPressureMonitor().memoryLimit();
+}
+
+qint64 KisMemoryPressureMonitor::readLimitFile(const QString &fileName) const
+{
+    const QByteArray value = readFirstLine(fileName);
+    if (value.isEmpty() || value == "max") return -1;
+
+    bool ok = false;
+    const qint64 limit = value.toLongLong(&ok);
+
+    return ok && limit < UNLIMITED_THRESHOLD ? limit : -1;
+}
+
+qint64 KisMemoryPressureMonitor::readValueFile(const QString &fileName) const
+{
+    const QByteArray value = readFirstLine(fileName);
+
+    bool ok = false;
+    const qint64 result = value.toLongLong(&ok);
+
+    return ok ? result : -1;
+}
@@ -0,0 +1,93 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISMEMORYPRESSUREMONITOR_H
+#define KISMEMORYPRESSUREMONITOR_H
+
+#include <QString>
+
+#include "kritaimage_export.h"
+
+
+/**
+ * Reads the memory pressure signals of the system, so the swapper
+ * could start swapping out tiles before the kernel OOM-killer comes
+ * for us. It knows about two sources of the signals:
+ *
+ * 1) The memory controller of the cgroup we run in (both v1 and v2).
+ *    When Krita runs inside a container or a systemd slice, the
+ *    limit of the cgroup (memory.high or memory.max) is much lower
+ *    than the amount of physical RAM, so the limits, calculated from
+ *    the RAM size, are useless.
+ *
+ * 2) Linux Pressure Stall Information (PSI), that is, the share of
+ *    time the tasks have been stalled waiting for memory recently.
+ *    The cgroup's own memory.pressure file is preferred over the
+ *    system-wide /proc/pressure/memory.
+ *
+ * On the systems without these interfaces (or non-Linux ones) the
+ * monitor always reports no pressure and no limit.
+ *
+ * The root path is configurable for the sake of unit tests only.
+ */
+class KRITAIMAGE_EXPORT KisMemoryPressureMonitor
+{
+public:
+    enum PressureLevel {
+        NoPressure,
+        ModeratePressure,
+        CriticalPressure
+    };
+
+public:
+    KisMemoryPressureMonitor(const QString &rootPath = QString("/"));
+
+    /**
+     * The memory limit of our cgroup in bytes, that is the lowest
+     * memory.high or memory.max of the cgroup and all its parents.
+     * Returns -1 if there is no limit.
+     */
+    qint64 memoryLimit() const;
+
+    /**
+     * The memory used by our cgroup in bytes, -1 if unknown
+     */
+    qint64 memoryUsage() const;
+
+    /**
+     * The share of the last 10 seconds, in percents, when at least
+     * one task was stalled waiting for memory ("some avg10" of PSI).
+     * Returns -1 if PSI is not available.
+     */
+    qreal stallPercent() const;
+
+    PressureLevel pressureLevel() const;
+
+    /**
+     * The amount of memory in bytes we should release to get the usage
+     * of the cgroup back to the comfortable level. Returns 0 if we are
+     * fine or the cgroup is not limited.
+     */
+    qint64 excessMemory() const;
+
+    /**
+     * The memory limit of the cgroup of the current process,
+     * \see memoryLimit()
+     */
+    static qint64 cgroupMemoryLimit();
+
+private:
+    qint64 readLimitFile(const QString &fileName) const;
+    qint64 readValueFile(const QString &fileName) const;
+
+private:
+    QString m_rootPath;
+    QString m_cgroupPath;
+    QString m_cgroupMountPath;
+    bool m_isCgroupV1 {false};
+};
+
+#endif // KISMEMORYPRESSUREMONITOR_H
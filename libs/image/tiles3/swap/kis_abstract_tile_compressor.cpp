@@ -7,9 +7,20 @@
 #include "kis_abstract_tile_compressor.h"
 
 KisAbstractTileCompressor::KisAbstractTileCompressor()
+    : m_tileSize(KisTileData::WIDTH, KisTileData::HEIGHT)
 {
 }
 
 KisAbstractTileCompressor::~KisAbstractTileCompressor()
 {
 }
+
+void KisAbstractTileCompressor::setTileSize(const QSize &size)
+{
+    m_tileSize = size;
+}
+
+QSize KisAbstractTileCompressor::tileSize() const
+{
+    return m_tileSize;
+}
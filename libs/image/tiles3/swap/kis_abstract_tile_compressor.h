@@ -43,6 +43,20 @@ public:
      */
     virtual bool readTile(QIODevice *stream, KisTiledDataManager *dm) = 0;
 
+    /**
+     * Sets the size of the tiles stored in the stream passed to
+     * readTile() and writeTile(). The stream might have been written
+     * by a build of Krita with a different tile size (see
+     * KRITA_TILE_SIZE), then the tiles are written into the data
+     * manager pixel-by-pixel. On writing, every native tile is split
+     * into several tiles of this size, so the size must divide
+     * KisTileData::WIDTH/HEIGHT.
+     *
+     * By default the size is equal to KisTileData::WIDTH/HEIGHT.
+     */
+    void setTileSize(const QSize &size);
+    QSize tileSize() const;
+
     /**
      * Compresses a \p tileData and writes it into the \p buffer.
      * The buffer must be at least tileDataBufferSize() bytes long.
@@ -79,6 +93,19 @@ public:
     virtual qint32 tileDataBufferSize(KisTileData *tileData) = 0;
 
 protected:
+    inline bool isNativeTileSize() const {
+        return m_tileSize.width() == KisTileData::WIDTH &&
+            m_tileSize.height() == KisTileData::HEIGHT;
+    }
+
+    /**
+     * Writes the data of a tile with a non-native size into \p dm
+     */
+    inline void writeForeignTile(KisTiledDataManager *dm, const quint8 *data,
+                                 qint32 x, qint32 y, const QSize &size) {
+        dm->writeBytesBody(data, x, y, size.width(), size.height());
+    }
+
     inline qint32 xToCol(KisTiledDataManager *dm, qint32 x) {
         return dm->xToCol(x);
     }
@@ -90,6 +117,9 @@ protected:
     inline qint32 pixelSize(KisTiledDataManager *dm) {
         return dm->pixelSize();
     }
+
+private:
+    QSize m_tileSize;
 };
 
 #endif /* __KIS_ABSTRACT_TILE_COMPRESSOR_H */
@@ -101,15 +101,30 @@ bool KisChunkAllocator::tryInsertChunk(KisChunkDataList &list,
     return result;
 }
 
-void KisChunkAllocator::freeChunk(KisChunk chunk)
+void KisChunkAllocator::freeChunk(KisChunk chunk, KisChunkData *freeSpace)
 {
+    KisChunkDataListIterator next;
+
     if(m_iterator != m_list.end() && m_iterator == chunk.position()) {
-        m_iterator = m_list.erase(m_iterator);
-        return;
+        next = m_iterator = m_list.erase(m_iterator);
+    }
+    else {
+        Q_ASSERT(chunk.position()->m_begin == chunk.begin());
+        next = m_list.erase(chunk.position());
     }
 
-    Q_ASSERT(chunk.position()->m_begin == chunk.begin());
-    m_list.erase(chunk.position());
+    if(freeSpace) {
+        quint64 lowBound = 0;
+        quint64 highBound = m_storeSize;
+
+        if(HAS_PREVIOUS(m_list, next))
+            lowBound = PEEK_PREVIOUS(next).m_end + 1;
+
+        if(HAS_NEXT(m_list, next))
+            highBound = PEEK_NEXT(next).m_begin;
+
+        freeSpace->setChunk(lowBound, highBound - lowBound);
+    }
 }
 
 
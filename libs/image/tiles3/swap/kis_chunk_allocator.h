@@ -125,7 +125,14 @@ public:
     }
 
     KisChunk getChunk(quint64 size);
-    void freeChunk(KisChunk chunk);
+
+    /**
+     * Frees the chunk. If \p freeSpace is not null, it is set to
+     * the whole unused region of the store the chunk has become
+     * a part of, that is the gap between its former neighbours.
+     * This region can be safely discarded by the backing storage.
+     */
+    void freeChunk(KisChunk chunk, KisChunkData *freeSpace = nullptr);
 
     void debugChunks();
     bool sanityCheck(bool pleaseCrash = true);
@@ -51,7 +51,28 @@ bool KisLegacyTileCompressor::readTile(QIODevice *stream, KisTiledDataManager *d
     qint32 width, height;
 
     stream->readLine((char *)headerBuffer, bufferSize);
-    sscanf((char *) headerBuffer, "%d,%d,%d,%d", &x, &y, &width, &height);
+    const int numFields = sscanf((char *) headerBuffer, "%d,%d,%d,%d", &x, &y, &width, &height);
+
+    delete[] headerBuffer;
+
+    if (numFields != 4 || width <= 0 || height <= 0) {
+        return false;
+    }
+
+    /**
+     * The legacy header stores the size of every tile,
+     * so we don't need a global tile size for it
+     */
+    if (width != KisTileData::WIDTH || height != KisTileData::HEIGHT) {
+        const QSize foreignTileSize(width, height);
+        QScopedArrayPointer<quint8> foreignData(
+            new quint8[pixelSize(dm) * width * height]);
+
+        stream->read((char *)foreignData.data(), pixelSize(dm) * width * height);
+        writeForeignTile(dm, foreignData.data(), x, y, foreignTileSize);
+
+        return true;
+    }
 
     qint32 row = yToRow(dm, y);
     qint32 col = xToCol(dm, x);
@@ -9,10 +9,44 @@
 
 #include <QDir>
 
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#endif
+
+#if defined(Q_OS_LINUX) && defined(FALLOC_FL_PUNCH_HOLE) && defined(FALLOC_FL_KEEP_SIZE)
+#define HAVE_PUNCH_HOLE
+#endif
+
 #define SWP_PREFIX "KRITA_SWAP_FILE_XXXXXX"
 
+/**
+ * Punching holes smaller than that would just waste syscalls,
+ * the file system will not be able to reuse such small holes
+ * effectively anyway.
+ */
+#define MIN_HOLE_SIZE (64 * 1024)
+
+#ifdef HAVE_PUNCH_HOLE
+namespace {
+inline quint64 pageSize()
+{
+    static const quint64 size = quint64(sysconf(_SC_PAGESIZE));
+    return size;
+}
+}
+#endif
+
 KisMemoryWindow::KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize)
-    : m_readWindowEx(writeWindowSize / 4),
+    : m_holePunchingEnabled(false),
+      m_discardedTailBegin(0),
+      m_readWindowEx(writeWindowSize / 4),
       m_writeWindowEx(writeWindowSize)
 {
     m_valid = true;
@@ -62,9 +96,96 @@ quint8* KisMemoryWindow::getWriteChunkPtr(const KisChunkData &writeChunk)
         return nullptr;
     }
 
+#ifdef HAVE_PUNCH_HOLE
+    if (writeChunk.m_end + 1 > m_discardedTailBegin) {
+        const quint64 pageMask = ~(pageSize() - 1);
+        m_discardedTailBegin = (writeChunk.m_end + pageSize()) & pageMask;
+    }
+#endif
+
     return m_writeWindowEx.calculatePointer(writeChunk);
 }
 
+void KisMemoryWindow::setHolePunchingEnabled(bool value)
+{
+#ifdef HAVE_PUNCH_HOLE
+    m_holePunchingEnabled = value;
+#else
+    Q_UNUSED(value);
+#endif
+}
+
+bool KisMemoryWindow::holePunchingEnabled() const
+{
+    return m_holePunchingEnabled;
+}
+
+void KisMemoryWindow::discardChunk(const KisChunkData &chunk)
+{
+#ifdef HAVE_PUNCH_HOLE
+    if (!m_valid || !m_holePunchingEnabled) return;
+
+    const quint64 pageMask = ~(pageSize() - 1);
+
+    const quint64 fileSize = quint64(m_file.size());
+    const quint64 regionEnd = qMin(chunk.m_end + 1, fileSize);
+
+    /**
+     * Only the pages that are fully covered by the chunk can be
+     * discarded, the rest of the pages may still contain live data
+     */
+    const quint64 begin = (chunk.m_begin + pageSize() - 1) & pageMask;
+    quint64 end = regionEnd & pageMask;
+
+    /**
+     * The free region at the end of the file grows with every freed
+     * chunk, don't punch its already discarded part again
+     */
+    const bool isTail = regionEnd == fileSize;
+    if (isTail) {
+        end = qMin(end, m_discardedTailBegin);
+    }
+
+    if (end <= begin || end - begin < MIN_HOLE_SIZE) return;
+
+    if (fallocate(m_file.handle(),
+                  FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                  off_t(begin), off_t(end - begin)) < 0) {
+
+        const int error = errno;
+
+        /**
+         * The file system of the swap directory doesn't support
+         * sparse files, just don't try anymore.
+         */
+        if (error == EOPNOTSUPP || error == ENOSYS) {
+            warnTiles << "KisMemoryWindow: the swap file system doesn't support hole punching; disabling it";
+            m_holePunchingEnabled = false;
+        } else {
+            warnTiles << "KisMemoryWindow: failed to punch a hole in the swap file:" << strerror(error);
+        }
+    } else if (isTail) {
+        m_discardedTailBegin = qMin(m_discardedTailBegin, begin);
+    }
+#else
+    Q_UNUSED(chunk);
+#endif
+}
+
+quint64 KisMemoryWindow::allocatedSize() const
+{
+#ifdef Q_OS_UNIX
+    struct stat fileStat;
+
+    if (m_valid && !fstat(m_file.handle(), &fileStat)) {
+        // st_blocks is always measured in 512-byte units
+        return quint64(fileStat.st_blocks) * 512;
+    }
+#endif
+
+    return quint64(m_file.size());
+}
+
 bool KisMemoryWindow::adjustWindow(const KisChunkData &requestedChunk,
                                    MappingWindow *adjustingWindow,
                                    MappingWindow *otherWindow)
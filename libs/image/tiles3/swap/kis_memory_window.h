@@ -35,6 +35,37 @@ public:
     quint8* getReadChunkPtr(const KisChunkData &readChunk);
     quint8* getWriteChunkPtr(const KisChunkData &writeChunk);
 
+    /**
+     * The default size of the mapping used for reading. Requesting
+     * a read chunk that is not larger than this size guarantees
+     * that the window will not be enlarged.
+     */
+    inline quint64 readWindowSize() const {
+        return m_readWindowEx.defaultSize;
+    }
+
+    /**
+     * Tells the file system that the content of \p chunk is not
+     * needed anymore. The pages fully covered by the chunk are
+     * punched out of the swap file, so the disk space is released
+     * while the file keeps its size. Reading from the discarded
+     * region returns zeroes afterwards.
+     *
+     * Does nothing if hole punching is disabled or is not
+     * supported by the platform or the file system.
+     */
+    void discardChunk(const KisChunkData &chunk);
+
+    void setHolePunchingEnabled(bool value);
+    bool holePunchingEnabled() const;
+
+    /**
+     * @return the amount of disk space actually occupied by
+     * the swap file, which may be smaller than its size if the
+     * file is sparse
+     */
+    quint64 allocatedSize() const;
+
 private:
     struct MappingWindow {
         MappingWindow(quint64 _defaultSize)
@@ -63,6 +94,16 @@ private:
     QTemporaryFile m_file;
 
     bool m_valid;
+    bool m_holePunchingEnabled;
+
+    /**
+     * All the pages of the file starting from this offset have
+     * already been punched out (or have never been written), so
+     * freeing the tail of the file needs to discard only the range
+     * before it.
+     */
+    quint64 m_discardedTailBegin;
+
     MappingWindow m_readWindowEx;
     MappingWindow m_writeWindowEx;
 };
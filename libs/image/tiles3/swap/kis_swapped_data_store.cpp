@@ -11,6 +11,8 @@
 
 #include "kis_tile_compressor_2.h"
 
+#include <algorithm>
+
 //#define COMPRESSOR_VERSION 2
 
 KisSwappedDataStore::KisSwappedDataStore()
@@ -23,9 +25,10 @@ KisSwappedDataStore::KisSwappedDataStore()
 
     m_allocator = new KisChunkAllocator(swapSlabSize, maxSwapSize);
     m_swapSpace = new KisMemoryWindow(config.swapDir(), swapWindowSize);
+    m_swapSpace->setHolePunchingEnabled(config.enableSwapHolePunching());
 
     // FIXME: use a factory after the patch is committed
-    m_compressor = new KisTileCompressor2();
+    m_compressor = new KisTileCompressor2(config.swapCompressionAlgorithm());
 }
 
 KisSwappedDataStore::~KisSwappedDataStore()
@@ -84,6 +87,56 @@ void KisSwappedDataStore::swapInTileData(KisTileData *td)
 
     // see comment in swapOutTileData()
 
+    swapInTileDataImpl(td);
+}
+
+QVector<KisTileData*> KisSwappedDataStore::swapInTileDataSpan(QVector<KisTileData*> &tileData)
+{
+    if (tileData.isEmpty()) return {};
+
+    std::sort(tileData.begin(), tileData.end(),
+              [] (KisTileData *lhs, KisTileData *rhs) {
+                  return lhs->swapChunk().begin() < rhs->swapChunk().begin();
+              });
+
+    QMutexLocker locker(&m_lock);
+
+    // see comment in swapOutTileData()
+
+    const quint64 maxSpanSize = m_swapSpace->readWindowSize();
+
+    const quint64 spanBegin = tileData.first()->swapChunk().begin();
+    quint64 spanEnd = tileData.first()->swapChunk().end();
+
+    auto spanIt = tileData.begin() + 1;
+    while (spanIt != tileData.end() &&
+           (*spanIt)->swapChunk().end() - spanBegin < maxSpanSize) {
+
+        spanEnd = (*spanIt)->swapChunk().end();
+        ++spanIt;
+    }
+
+    const QVector<KisTileData*> span(tileData.begin(), spanIt);
+    tileData.erase(tileData.begin(), spanIt);
+
+    /**
+     * Map the whole span of the file at once, so that all the
+     * chunks of the span are read from the same window
+     */
+    if (span.size() > 1) {
+        m_swapSpace->getReadChunkPtr(KisChunkData(spanBegin, spanEnd - spanBegin + 1));
+    }
+
+    Q_FOREACH (KisTileData *td, span) {
+        Q_ASSERT(!td->data());
+        swapInTileDataImpl(td);
+    }
+
+    return span;
+}
+
+void KisSwappedDataStore::swapInTileDataImpl(KisTileData *td)
+{
     KisChunk chunk = td->swapChunk();
     m_totalSwapMemoryUsed -= chunk.size();
 
@@ -93,7 +146,24 @@ void KisSwappedDataStore::swapInTileData(KisTileData *td)
     quint8 *ptr = m_swapSpace->getReadChunkPtr(chunk);
     Q_ASSERT(ptr);
     m_compressor->decompressTileData(ptr, chunk.size(), td);
-    m_allocator->freeChunk(chunk);
+    freeChunk(chunk);
+}
+
+void KisSwappedDataStore::freeChunk(KisChunk chunk)
+{
+    if (!m_swapSpace->holePunchingEnabled()) {
+        m_allocator->freeChunk(chunk);
+        return;
+    }
+
+    /**
+     * Release the whole free region around the chunk, not only
+     * the chunk itself, otherwise the pages shared between
+     * the neighbouring free chunks would never be discarded
+     */
+    KisChunkData freeSpace(0, 0);
+    m_allocator->freeChunk(chunk, &freeSpace);
+    m_swapSpace->discardChunk(freeSpace);
 }
 
 void KisSwappedDataStore::forgetTileData(KisTileData *td)
@@ -102,7 +172,7 @@ void KisSwappedDataStore::forgetTileData(KisTileData *td)
 
     m_totalSwapMemoryUsed -= td->swapChunk().size();
 
-    m_allocator->freeChunk(td->swapChunk());
+    freeChunk(td->swapChunk());
     td->setSwapChunk(KisChunk());
 }
 
@@ -11,6 +11,7 @@
 
 #include <QMutex>
 #include <QByteArray>
+#include <QVector>
 
 
 class QMutex;
@@ -46,6 +47,21 @@ public:
      */
     void swapInTileData(KisTileData *td);
 
+    /**
+     * Restore the data of the tile data objects that lie in the
+     * first span of the swap file covered by \p tileData. The span is
+     * fetched with a single mapping of the file. The restored objects
+     * are removed from \p tileData and returned, the rest of the
+     * objects are sorted by their position in the swap file.
+     *
+     * The store is locked for one span only, so the caller can
+     * release the other users between the spans.
+     *
+     * LOCKING: the locks on all the tile data should be taken
+     *          by the caller before making a call.
+     */
+    QVector<KisTileData*> swapInTileDataSpan(QVector<KisTileData*> &tileData);
+
     /**
      * Forget all the information linked with the tile data.
      * This should be done before deleting of the tile data,
@@ -64,6 +80,10 @@ public:
      */
     void debugStatistics();
 
+private:
+    void swapInTileDataImpl(KisTileData *td);
+    void freeChunk(KisChunk chunk);
+
 private:
     QByteArray m_buffer;
     KisAbstractTileCompressor *m_compressor;
@@ -5,17 +5,24 @@
  */
 
 #include "kis_tile_compressor_2.h"
+#include "kis_tile_compressor_factory.h"
 #include "kis_lzf_compression.h"
 #include <QIODevice>
 #include "kis_paint_device_writer.h"
+#include "kis_assert.h"
 #define TILE_DATA_SIZE(pixelSize) ((pixelSize) * KisTileData::WIDTH * KisTileData::HEIGHT)
 
-const QString KisTileCompressor2::m_compressionName = "LZF";
 
-
-KisTileCompressor2::KisTileCompressor2()
+KisTileCompressor2::KisTileCompressor2(const QString &compressionName)
+    : m_compressionName(compressionName)
 {
-    m_compression = new KisLzfCompression();
+    m_compression = KisTileCompressorFactory::createCompression(m_compressionName);
+
+    if (!m_compression) {
+        warnTiles << "Tile compression" << m_compressionName << "is not supported, falling back to LZF";
+        m_compressionName = "LZF";
+        m_compression = new KisLzfCompression();
+    }
 }
 
 KisTileCompressor2::~KisTileCompressor2()
@@ -25,6 +32,10 @@ KisTileCompressor2::~KisTileCompressor2()
 
 bool KisTileCompressor2::writeTile(KisTileSP tile, KisPaintDeviceWriter &store)
 {
+    if (!isNativeTileSize()) {
+        return writeSplitTile(tile, store);
+    }
+
     const qint32 tileDataSize = TILE_DATA_SIZE(tile->pixelSize());
     prepareStreamingBuffer(tileDataSize);
 
@@ -35,7 +46,65 @@ bool KisTileCompressor2::writeTile(KisTileSP tile, KisPaintDeviceWriter &store)
                      m_streamingBuffer.size(), bytesWritten);
     tile->unlockForRead();
 
-    QString header = getHeader(tile, bytesWritten);
+    const QRect extent = tile->extent();
+    return writeStreamingBuffer(extent.x(), extent.y(), bytesWritten, store);
+}
+
+bool KisTileCompressor2::writeSplitTile(KisTileSP tile, KisPaintDeviceWriter &store)
+{
+    const QSize partSize = this->tileSize();
+    const qint32 pixelSize = tile->pixelSize();
+    const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize);
+    const qint32 partRowSize = partSize.width() * pixelSize;
+    const qint32 partDataSize = partRowSize * partSize.height();
+
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(KisTileData::WIDTH % partSize.width() == 0 &&
+                                         KisTileData::HEIGHT % partSize.height() == 0, false);
+
+    if (m_foreignTileBuffer.size() < tileDataSize) {
+        m_foreignTileBuffer.resize(tileDataSize);
+    }
+
+    if (m_splitTileBuffer.size() < partDataSize) {
+        m_splitTileBuffer.resize(partDataSize);
+    }
+
+    prepareStreamingBuffer(partDataSize);
+
+    tile->lockForRead();
+    memcpy(m_foreignTileBuffer.data(), tile->data(), tileDataSize);
+    tile->unlockForRead();
+
+    const QRect extent = tile->extent();
+    const quint8 *tileData = (const quint8*)m_foreignTileBuffer.constData();
+    quint8 *partData = (quint8*)m_splitTileBuffer.data();
+
+    for (qint32 partY = 0; partY < KisTileData::HEIGHT; partY += partSize.height()) {
+        for (qint32 partX = 0; partX < KisTileData::WIDTH; partX += partSize.width()) {
+            for (qint32 row = 0; row < partSize.height(); row++) {
+                memcpy(partData + row * partRowSize,
+                       tileData + ((partY + row) * KisTileData::WIDTH + partX) * pixelSize,
+                       partRowSize);
+            }
+
+            qint32 bytesWritten;
+            compressData(partData, partDataSize, pixelSize,
+                         (quint8*)m_streamingBuffer.data(), bytesWritten);
+
+            if (!writeStreamingBuffer(extent.x() + partX, extent.y() + partY,
+                                      bytesWritten, store)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool KisTileCompressor2::writeStreamingBuffer(qint32 x, qint32 y, qint32 bytesWritten,
+                                              KisPaintDeviceWriter &store)
+{
+    QString header = getHeader(x, y, bytesWritten);
     bool retval = true;
     retval = store.write(header.toLatin1());
     if (!retval) {
@@ -50,7 +119,9 @@ bool KisTileCompressor2::writeTile(KisTileSP tile, KisPaintDeviceWriter &store)
 
 bool KisTileCompressor2::readTile(QIODevice *stream, KisTiledDataManager *dm)
 {
-    const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize(dm));
+    const qint32 pixelSize = this->pixelSize(dm);
+    const QSize tileSize = this->tileSize();
+    const qint32 tileDataSize = pixelSize * tileSize.width() * tileSize.height();
     prepareStreamingBuffer(tileDataSize);
 
     QByteArray header = stream->readLine(maxHeaderLength());
@@ -65,13 +136,28 @@ bool KisTileCompressor2::readTile(QIODevice *stream, KisTiledDataManager *dm)
         Q_ASSERT(headerItems.isEmpty());
         Q_ASSERT(compressionName == m_compressionName);
 
+        stream->read(m_streamingBuffer.data(), dataSize);
+
+        if (!isNativeTileSize()) {
+            if (m_foreignTileBuffer.size() < tileDataSize) {
+                m_foreignTileBuffer.resize(tileDataSize);
+            }
+
+            quint8 *foreignData = (quint8*)m_foreignTileBuffer.data();
+
+            bool res = decompressData((quint8*)m_streamingBuffer.data(), dataSize,
+                                      foreignData, tileDataSize, pixelSize);
+            if (res) {
+                writeForeignTile(dm, foreignData, x, y, tileSize);
+            }
+            return res;
+        }
+
         qint32 row = yToRow(dm, y);
         qint32 col = xToCol(dm, x);
 
         KisTileSP tile = dm->getTile(col, row, true);
 
-        stream->read(m_streamingBuffer.data(), dataSize);
-
         tile->lockForWrite();
         bool res = decompressTileData((quint8*)m_streamingBuffer.data(), dataSize, tile->tileData());
         tile->unlockForWrite();
@@ -109,28 +195,35 @@ void KisTileCompressor2::compressTileData(KisTileData *tileData,
 {
     const qint32 pixelSize = tileData->pixelSize();
     const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize);
-    qint32 compressedBytes;
 
     Q_UNUSED(bufferSize);
     Q_ASSERT(bufferSize >= tileDataSize + 1);
 
-    prepareWorkBuffers(tileDataSize);
+    compressData(tileData->data(), tileDataSize, pixelSize, buffer, bytesWritten);
+}
+
+void KisTileCompressor2::compressData(quint8 *data, qint32 dataSize, qint32 pixelSize,
+                                      quint8 *buffer, qint32 &bytesWritten)
+{
+    qint32 compressedBytes;
+
+    prepareWorkBuffers(dataSize);
 
-    KisAbstractCompression::linearizeColors(tileData->data(), (quint8*)m_linearizationBuffer.data(),
-                                            tileDataSize, pixelSize);
+    KisAbstractCompression::linearizeColors(data, (quint8*)m_linearizationBuffer.data(),
+                                            dataSize, pixelSize);
 
-    compressedBytes = m_compression->compress((quint8*)m_linearizationBuffer.data(), tileDataSize,
+    compressedBytes = m_compression->compress((quint8*)m_linearizationBuffer.data(), dataSize,
                                               (quint8*)m_compressionBuffer.data(), m_compressionBuffer.size());
 
-    if(compressedBytes < tileDataSize) {
+    if(compressedBytes < dataSize) {
         buffer[0] = COMPRESSED_DATA_FLAG;
         memcpy(buffer + 1, m_compressionBuffer.data(), compressedBytes);
         bytesWritten = compressedBytes + 1;
     }
     else {
         buffer[0] = RAW_DATA_FLAG;
-        memcpy(buffer + 1, tileData->data(), tileDataSize);
-        bytesWritten = tileDataSize + 1;
+        memcpy(buffer + 1, data, dataSize);
+        bytesWritten = dataSize + 1;
     }
 }
 
@@ -139,8 +232,14 @@ bool KisTileCompressor2::decompressTileData(quint8 *buffer,
                                             KisTileData *tileData)
 {
     const qint32 pixelSize = tileData->pixelSize();
-    const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize);
+    return decompressData(buffer, bufferSize,
+                          tileData->data(), TILE_DATA_SIZE(pixelSize), pixelSize);
+}
 
+bool KisTileCompressor2::decompressData(quint8 *buffer, qint32 bufferSize,
+                                        quint8 *data, qint32 tileDataSize,
+                                        qint32 pixelSize)
+{
     if(buffer[0] == COMPRESSED_DATA_FLAG) {
         prepareWorkBuffers(tileDataSize);
 
@@ -149,14 +248,14 @@ bool KisTileCompressor2::decompressTileData(quint8 *buffer,
                                                  (quint8*)m_linearizationBuffer.data(), tileDataSize);
         if (bytesWritten == tileDataSize) {
             KisAbstractCompression::delinearizeColors((quint8*)m_linearizationBuffer.data(),
-                                                      tileData->data(),
+                                                      data,
                                                       tileDataSize, pixelSize);
             return true;
         }
         return false;
     }
     else {
-        memcpy(tileData->data(), buffer + 1, tileDataSize);
+        memcpy(data, buffer + 1, tileDataSize);
         return true;
     }
     return false;
@@ -177,12 +276,8 @@ inline qint32 KisTileCompressor2::maxHeaderLength()
     return 3 * QINT32_LENGTH + COMPRESSION_NAME_LENGTH + SEPARATORS_LENGTH;
 }
 
-inline QString KisTileCompressor2::getHeader(KisTileSP tile,
+inline QString KisTileCompressor2::getHeader(qint32 x, qint32 y,
                                              qint32 compressedSize)
 {
-    qint32 x, y;
-    qint32 width, height;
-    tile->extent().getRect(&x, &y, &width, &height);
-
     return QString("%1,%2,%3,%4\n").arg(x).arg(y).arg(m_compressionName).arg(compressedSize);
 }
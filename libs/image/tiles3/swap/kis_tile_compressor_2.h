@@ -14,7 +14,15 @@ class KisAbstractCompression;
 class KRITAIMAGE_EXPORT KisTileCompressor2 : public KisAbstractTileCompressor
 {
 public:
-    KisTileCompressor2();
+    /**
+     * Creates a compressor that uses the compression backend named
+     * \p compressionName (see KisTileCompressorFactory::availableCompressions()).
+     * If the backend is not available in this build, LZF is used.
+     *
+     * NOTE: the files saved into .kra must always use LZF, other
+     *       backends are meant for the swap file only.
+     */
+    KisTileCompressor2(const QString &compressionName = QString("LZF"));
     ~KisTileCompressor2() override;
 
     bool writeTile(KisTileSP tile, KisPaintDeviceWriter &store) override;
@@ -32,7 +40,17 @@ private:
      */
     qint32 maxHeaderLength();
 
-    QString getHeader(KisTileSP tile, qint32 compressedSize);
+    QString getHeader(qint32 x, qint32 y, qint32 compressedSize);
+
+    bool writeStreamingBuffer(qint32 x, qint32 y, qint32 bytesWritten,
+                              KisPaintDeviceWriter &store);
+    bool writeSplitTile(KisTileSP tile, KisPaintDeviceWriter &store);
+
+    void compressData(quint8 *data, qint32 dataSize, qint32 pixelSize,
+                      quint8 *buffer, qint32 &bytesWritten);
+
+    bool decompressData(quint8 *buffer, qint32 bufferSize,
+                        quint8 *data, qint32 tileDataSize, qint32 pixelSize);
 
     void prepareWorkBuffers(qint32 tileDataSize);
     void prepareStreamingBuffer(qint32 tileDataSize);
@@ -45,8 +63,10 @@ private:
     QByteArray m_linearizationBuffer;
     QByteArray m_compressionBuffer;
     QByteArray m_streamingBuffer;
+    QByteArray m_foreignTileBuffer;
+    QByteArray m_splitTileBuffer;
     KisAbstractCompression *m_compression;
-    static const QString m_compressionName;
+    QString m_compressionName;
 };
 
 #endif /* __KIS_TILE_COMPRESSOR_2_H */
@@ -0,0 +1,58 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_compressor_factory.h"
+
+#include <QStringList>
+#include <config-tile-compression.h>
+
+#include "kis_lzf_compression.h"
+
+#ifdef HAVE_LZ4
+#include "kis_lz4_compression.h"
+#endif
+
+#ifdef HAVE_ZSTD
+#include "kis_zstd_compression.h"
+#endif
+
+
+KisAbstractCompression* KisTileCompressorFactory::createCompression(const QString &name)
+{
+    if (name == "LZF") {
+        return new KisLzfCompression();
+    }
+
+#ifdef HAVE_LZ4
+    if (name == "LZ4") {
+        return new KisLz4Compression();
+    }
+#endif
+
+#ifdef HAVE_ZSTD
+    if (name == "ZSTD") {
+        return new KisZstdCompression();
+    }
+#endif
+
+    return 0;
+}
+
+QStringList KisTileCompressorFactory::availableCompressions()
+{
+    QStringList result;
+    result << "LZF";
+
+#ifdef HAVE_LZ4
+    result << "LZ4";
+#endif
+
+#ifdef HAVE_ZSTD
+    result << "ZSTD";
+#endif
+
+    return result;
+}
@@ -10,6 +10,10 @@
 #include "tiles3/swap/kis_legacy_tile_compressor.h"
 #include "tiles3/swap/kis_tile_compressor_2.h"
 
+#include <QStringList>
+
+class KisAbstractCompression;
+
 class KRITAIMAGE_EXPORT KisTileCompressorFactory
 {
 public:
@@ -27,9 +31,24 @@ public:
         };
     }
 
+    /**
+     * Creates a raw compression backend by its short name, as written
+     * into the tile headers ("LZF", "LZ4", "ZSTD").
+     *
+     * \return the new compression object or null if the backend is
+     *         unknown or Krita was built without support for it.
+     *         The caller takes the ownership of the object.
+     */
+    static KisAbstractCompression* createCompression(const QString &name);
+
+    /**
+     * The list of compression backends available in this build. "LZF"
+     * is always present and is always the first element of the list.
+     */
+    static QStringList availableCompressions();
+
 private:
     KisTileCompressorFactory();
 };
 
 #endif /* __KIS_TILE_COMPRESSOR_FACTORY_H */
-
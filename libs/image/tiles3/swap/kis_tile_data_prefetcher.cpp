@@ -0,0 +1,171 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <QSemaphore>
+#include <QMutex>
+
+#include "tiles3/swap/kis_tile_data_prefetcher.h"
+#include "tiles3/swap/kis_tile_data_swapper_p.h"
+#include "tiles3/kis_tile_data.h"
+#include "tiles3/kis_tile_data_store.h"
+#include "kis_debug.h"
+
+/**
+ * The store is locked for one span of the batch at a time, still
+ * the batch should be small enough to let the newer requests
+ * overtake the older ones
+ */
+const int KisTileDataPrefetcher::MAX_BATCH_SIZE = 64;
+
+/**
+ * If the painting threads are too far ahead of us, there
+ * is no reason to keep the old requests.
+ */
+const int KisTileDataPrefetcher::MAX_QUEUE_SIZE = 4096;
+
+//#define DEBUG_PREFETCHER
+
+#ifdef DEBUG_PREFETCHER
+#define DEBUG_ACTION(action) dbgKrita << action
+#define DEBUG_VALUE(value) dbgKrita << "\t" << ppVar(value)
+#else
+#define DEBUG_ACTION(action)
+#define DEBUG_VALUE(value)
+#endif
+
+
+struct Q_DECL_HIDDEN KisTileDataPrefetcher::Private
+{
+public:
+    QSemaphore semaphore;
+    QAtomicInt shouldExitFlag;
+    KisTileDataStore *store;
+    KisStoreLimits limits;
+
+    QMutex queueLock;
+    QVector<KisTileData*> queue;
+};
+
+KisTileDataPrefetcher::KisTileDataPrefetcher(KisTileDataStore *store)
+    : QThread(),
+      m_d(new Private())
+{
+    m_d->shouldExitFlag = 0;
+    m_d->store = store;
+}
+
+KisTileDataPrefetcher::~KisTileDataPrefetcher()
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_d->queue.isEmpty());
+    delete m_d;
+}
+
+void KisTileDataPrefetcher::prefetch(const QVector<KisTileData*> &tileData)
+{
+    if (tileData.isEmpty()) return;
+
+    QVector<KisTileData*> droppedItems;
+    bool wasEmpty = false;
+
+    {
+        QMutexLocker l(&m_d->queueLock);
+        wasEmpty = m_d->queue.isEmpty();
+        m_d->queue.append(tileData);
+
+        const int overflow = m_d->queue.size() - MAX_QUEUE_SIZE;
+        if (overflow > 0) {
+            droppedItems = m_d->queue.mid(0, overflow);
+            m_d->queue.remove(0, overflow);
+        }
+    }
+
+    // deref() may free the tile data, so do it without the lock held
+    dropBatch(droppedItems);
+
+    /**
+     * The thread takes care of the non-empty queue itself, so
+     * wake it up only when the queue becomes non-empty. Otherwise
+     * the semaphore would count the calls, not the batches.
+     */
+    if (wasEmpty) {
+        m_d->semaphore.release();
+    }
+}
+
+void KisTileDataPrefetcher::terminatePrefetcher()
+{
+    unsigned long exitTimeout = 100;
+    do {
+        m_d->shouldExitFlag = true;
+        m_d->semaphore.release();
+    } while(!wait(exitTimeout));
+
+    /**
+     * The queued tile data must be released while the store
+     * is still alive
+     */
+    QMutexLocker l(&m_d->queueLock);
+    dropBatch(m_d->queue);
+}
+
+void KisTileDataPrefetcher::run()
+{
+    while (1) {
+        m_d->semaphore.acquire();
+
+        if (m_d->shouldExitFlag)
+            return;
+
+        QVector<KisTileData*> batch;
+
+        {
+            QMutexLocker l(&m_d->queueLock);
+
+            /**
+             * The latest requests are the most relevant ones,
+             * so take them first
+             */
+            const int batchSize = qMin(MAX_BATCH_SIZE, m_d->queue.size());
+            batch = m_d->queue.mid(m_d->queue.size() - batchSize);
+            m_d->queue.resize(m_d->queue.size() - batchSize);
+
+            // the rest of the queue is processed in the next cycle
+            if (!m_d->queue.isEmpty()) {
+                m_d->semaphore.release();
+            }
+        }
+
+        processBatch(batch);
+    }
+}
+
+void KisTileDataPrefetcher::processBatch(QVector<KisTileData*> &batch)
+{
+    if (batch.isEmpty()) return;
+
+    DEBUG_ACTION("Prefetching batch");
+    DEBUG_VALUE(batch.size());
+    DEBUG_VALUE(m_d->store->memoryMetric());
+
+    if (m_d->store->memoryMetric() < m_d->limits.hardLimit()) {
+        m_d->store->swapInTileDataBatch(batch);
+    }
+
+    dropBatch(batch);
+}
+
+void KisTileDataPrefetcher::dropBatch(QVector<KisTileData*> &batch)
+{
+    Q_FOREACH (KisTileData *td, batch) {
+        td->deref();
+    }
+    batch.clear();
+}
+
+void KisTileDataPrefetcher::testingRereadConfig()
+{
+    m_d->limits = KisStoreLimits();
+}
@@ -0,0 +1,68 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KIS_TILE_DATA_PREFETCHER_H_
+#define KIS_TILE_DATA_PREFETCHER_H_
+
+#include <QThread>
+#include <QVector>
+
+#include "kritaimage_export.h"
+
+
+class KisTileDataStore;
+class KisTileData;
+
+/**
+ * A background thread that loads swapped-out tile data back into
+ * memory *before* the painting threads actually access it.
+ *
+ * The users (e.g. KisSimpleUpdateQueue) predict which tiles will be
+ * needed soon and pass them to prefetch(). The prefetcher collects
+ * the requests and swaps the tiles in batches, sorted by their
+ * position in the swap file, so that KisSwappedDataStore can serve
+ * the whole batch with a single mapping of the swap file.
+ *
+ * The prefetcher never loads anything when the store is already
+ * above the hard memory limit, otherwise it would just fight
+ * with the swapper.
+ */
+class KRITAIMAGE_EXPORT KisTileDataPrefetcher : public QThread
+{
+    Q_OBJECT
+
+public:
+    KisTileDataPrefetcher(KisTileDataStore *store);
+    ~KisTileDataPrefetcher() override;
+
+    /**
+     * Adds the tile data objects into the prefetch queue.
+     *
+     * The caller must ref() every tile data in the list before
+     * passing it here, the prefetcher will deref() them after
+     * processing.
+     */
+    void prefetch(const QVector<KisTileData*> &tileData);
+
+    void terminatePrefetcher();
+
+    void testingRereadConfig();
+
+private:
+    void run() override;
+
+    void processBatch(QVector<KisTileData*> &batch);
+    void dropBatch(QVector<KisTileData*> &batch);
+
+private:
+    static const int MAX_BATCH_SIZE;
+    static const int MAX_QUEUE_SIZE;
+
+private:
+    struct Private;
+    Private * const m_d;
+};
+
+#endif /* KIS_TILE_DATA_PREFETCHER_H_ */
@@ -5,9 +5,12 @@
  */
 
 #include <QSemaphore>
+#include <QVector>
+#include <algorithm>
 
 #include "tiles3/swap/kis_tile_data_swapper.h"
 #include "tiles3/swap/kis_tile_data_swapper_p.h"
+#include "tiles3/swap/KisMemoryPressureMonitor.h"
 #include "tiles3/kis_tile_data.h"
 #include "tiles3/kis_tile_data_store.h"
 #include "tiles3/kis_tile_data_store_iterators.h"
@@ -17,6 +20,9 @@
 
 const qint32 KisTileDataSwapper::TIMEOUT = -1;
 const qint32 KisTileDataSwapper::DELAY = 0.7 * SEC;
+const qint32 KisTileDataSwapper::PRESSURE_POLL_INTERVAL = 1 * SEC;
+const qint32 KisTileDataSwapper::MAX_SAMPLE_SIZE = 4096;
+const qint32 KisTileDataSwapper::SAMPLE_OVERCOMMIT_FACTOR = 4;
 
 //#define DEBUG_SWAPPER
 
@@ -40,6 +46,17 @@ public:
     KisTileDataStore *store;
     KisStoreLimits limits;
     QMutex cycleLock;
+
+    KisMemoryPressureMonitor pressureMonitor;
+    bool trackMemoryPressure = KisImageConfig(true).trackSystemMemoryPressure();
+
+    /**
+     * The memory metric we are still allowed to swap out because
+     * of the current critical pressure episode. The episode ends
+     * when the pressure goes below the critical level.
+     */
+    bool criticalPressureEpisode = false;
+    qint64 criticalPressureBudget = 0;
 };
 
 KisTileDataSwapper::KisTileDataSwapper(KisTileDataStore *store)
@@ -69,22 +86,36 @@ void KisTileDataSwapper::terminateSwapper()
     } while(!wait(exitTimeout));
 }
 
-void KisTileDataSwapper::waitForWork()
+bool KisTileDataSwapper::waitForWork()
 {
-    m_d->semaphore.tryAcquire(1, TIMEOUT);
+#ifdef Q_OS_LINUX
+    /**
+     * The memory pressure may come from outside, so when tracking
+     * it, we should wake up from time to time even without a kick.
+     * The pressure sources exist on Linux only.
+     */
+    if (m_d->trackMemoryPressure) {
+        return m_d->semaphore.tryAcquire(1, PRESSURE_POLL_INTERVAL);
+    }
+#endif
+
+    return m_d->semaphore.tryAcquire(1, TIMEOUT);
 }
 
 void KisTileDataSwapper::run()
 {
     while (1) {
-        waitForWork();
+        const bool kicked = waitForWork();
 
         if (m_d->shouldExitFlag)
             return;
 
-        QThread::msleep(DELAY);
-
-        doJob();
+        if (kicked) {
+            QThread::msleep(DELAY);
+            doJob();
+        } else if (m_d->pressureMonitor.pressureLevel() != KisMemoryPressureMonitor::NoPressure) {
+            doJob();
+        }
     }
 }
 
@@ -103,31 +134,78 @@ void KisTileDataSwapper::doJob()
      */
     QMutexLocker locker(&m_d->cycleLock);
 
-    qint32 memoryMetric = m_d->store->memoryMetric();
+    /**
+     * Everything accessed before this point becomes one cycle older
+     */
+    m_d->store->advanceAccessEpoch();
+
+    qint64 memoryMetric = m_d->store->memoryMetric();
+
+    const KisMemoryPressureMonitor::PressureLevel pressure =
+        m_d->trackMemoryPressure ?
+        m_d->pressureMonitor.pressureLevel() : KisMemoryPressureMonitor::NoPressure;
 
     DEBUG_ACTION("Started swap cycle");
     DEBUG_VALUE(m_d->store->numTiles());
     DEBUG_VALUE(m_d->store->numTilesInMemory());
     DEBUG_VALUE(memoryMetric);
+    DEBUG_VALUE(pressure);
 
     DEBUG_VALUE(m_d->limits.softLimitThreshold());
     DEBUG_VALUE(m_d->limits.hardLimitThreshold());
 
+    /**
+     * Under any system memory pressure we drop the undo history
+     * tiles down to the soft limit, even when the threshold is not
+     * reached yet. Under critical pressure we also swap out the
+     * working tiles, as much as the cgroup asks us to release.
+     */
+    if (memoryMetric > m_d->limits.softLimitThreshold() ||
+        (pressure != KisMemoryPressureMonitor::NoPressure &&
+         memoryMetric > m_d->limits.softLimit())) {
 
-    if(memoryMetric > m_d->limits.softLimitThreshold()) {
-        qint32 softFree =  memoryMetric - m_d->limits.softLimit();
+        qint64 softFree =  memoryMetric - m_d->limits.softLimit();
         DEBUG_VALUE(softFree);
         DEBUG_ACTION("\t pass0");
         memoryMetric -= pass<SoftSwapStrategy>(softFree);
         DEBUG_VALUE(memoryMetric);
+    }
+
+    qint64 hardFree = memoryMetric > m_d->limits.hardLimitThreshold() ?
+        memoryMetric - m_d->limits.hardLimit() : 0;
+
+    /**
+     * The pressure may be caused by other processes, and it will not
+     * go away whatever we swap out. So the working tiles are swapped
+     * out because of the pressure only once per critical episode, and
+     * the next portion is released only after the pressure has gone
+     * down and become critical again.
+     */
+    qint64 pressureFree = 0;
+
+    if (pressure == KisMemoryPressureMonitor::CriticalPressure) {
+        if (!m_d->criticalPressureEpisode) {
+            const qint64 excessMetric =
+                m_d->pressureMonitor.excessMemory() / (KisTileData::WIDTH * KisTileData::HEIGHT);
 
-        if(memoryMetric > m_d->limits.hardLimitThreshold()) {
-            qint32 hardFree =  memoryMetric - m_d->limits.hardLimit();
-            DEBUG_VALUE(hardFree);
-            DEBUG_ACTION("\t pass1");
-            memoryMetric -= pass<AggressiveSwapStrategy>(hardFree);
-            DEBUG_VALUE(memoryMetric);
+            m_d->criticalPressureEpisode = true;
+            m_d->criticalPressureBudget = qMax(excessMetric, memoryMetric / 8);
         }
+
+        pressureFree = m_d->criticalPressureBudget;
+    } else {
+        m_d->criticalPressureEpisode = false;
+        m_d->criticalPressureBudget = 0;
+    }
+
+    if (hardFree > 0 || pressureFree > 0) {
+        DEBUG_VALUE(hardFree);
+        DEBUG_VALUE(pressureFree);
+        DEBUG_ACTION("\t pass1");
+        const qint64 freed = pass<AggressiveSwapStrategy>(qMax(hardFree, pressureFree));
+        memoryMetric -= freed;
+        m_d->criticalPressureBudget = qMax(qint64(0), m_d->criticalPressureBudget - freed);
+        DEBUG_VALUE(memoryMetric);
     }
 }
 
@@ -149,10 +227,6 @@ public:
         // We are working with mementoed tiles only...
         return td->historical();
     }
-
-    static inline bool swapOutFirst(KisTileData *td) {
-        return td->age() > 0;
-    }
 };
 
 class AggressiveSwapStrategy
@@ -173,48 +247,91 @@ public:
         Q_UNUSED(td);
         return true; // >:)
     }
+};
+
+
+namespace {
 
-    static inline bool swapOutFirst(KisTileData *td) {
-        return td->age() > 0;
+struct SwapCandidate {
+    int reuseDistance;
+    int age;
+    KisTileData *td;
+
+    /**
+     * The approximation of LRU-2: first go the tiles that have been
+     * accessed only once (e.g. by a single filter pass), then the
+     * ones that haven't been reused for the longest time.
+     */
+    bool operator<(const SwapCandidate &rhs) const {
+        if (reuseDistance != rhs.reuseDistance) return reuseDistance > rhs.reuseDistance;
+        if (age != rhs.age) return age > rhs.age;
+        return td < rhs.td;
     }
 };
 
+}
 
 template<class strategy>
 qint64 KisTileDataSwapper::pass(qint64 needToFreeMetric)
 {
     qint64 freedMetric = 0;
-    QList<KisTileData*> additionalCandidates;
+    QVector<SwapCandidate> candidates;
+    QVector<KisTileData*> youngCandidates;
 
     typename strategy::iterator *iter =
         strategy::beginIteration(m_d->store);
 
     KisTileData *item = 0;
 
-    while (iter->hasNext()) {
-        item = iter->next();
+    /**
+     * The store may contain millions of tiles and the iteration
+     * blocks all the allocations, so we never sort the whole store.
+     * Instead, we take the candidates in bounded samples, just big
+     * enough to cover the rest of the needed memory a few times, and
+     * swap out the best ones of every sample. The tiles accessed
+     * during the current cycle are postponed until the iteration
+     * is over, like the old age-based pass did.
+     */
+    while (freedMetric < needToFreeMetric && iter->hasNext()) {
+        const qint64 sampleMetricLimit =
+            SAMPLE_OVERCOMMIT_FACTOR * (needToFreeMetric - freedMetric);
+        qint64 sampleMetric = 0;
+
+        candidates.clear();
 
-        if (freedMetric >= needToFreeMetric) break;
+        while (iter->hasNext() &&
+               candidates.size() < MAX_SAMPLE_SIZE &&
+               sampleMetric < sampleMetricLimit) {
+
+            item = iter->next();
 
-        if (!strategy::isInteresting(item)) continue;
+            if (!strategy::isInteresting(item)) continue;
 
-        if (strategy::swapOutFirst(item)) {
-            if (iter->trySwapOut(item)) {
-                freedMetric += item->pixelSize();
+            if (!item->age()) {
+                youngCandidates.append(item);
+                continue;
             }
+
+            candidates.append({item->reuseDistance(), item->age(), item});
+            sampleMetric += item->pixelSize();
         }
-        else {
-            item->markOld();
-            additionalCandidates.append(item);
-        }
 
+        std::sort(candidates.begin(), candidates.end());
+
+        Q_FOREACH (const SwapCandidate &candidate, candidates) {
+            if (freedMetric >= needToFreeMetric) break;
+
+            if (iter->trySwapOut(candidate.td)) {
+                freedMetric += candidate.td->pixelSize();
+            }
+        }
     }
 
-    Q_FOREACH (item, additionalCandidates) {
+    Q_FOREACH (KisTileData *td, youngCandidates) {
         if (freedMetric >= needToFreeMetric) break;
 
-        if (iter->trySwapOut(item)) {
-            freedMetric += item->pixelSize();
+        if (iter->trySwapOut(td)) {
+            freedMetric += td->pixelSize();
         }
     }
 
@@ -226,4 +343,7 @@ qint64 KisTileDataSwapper::pass(qint64 needToFreeMetric)
 void KisTileDataSwapper::testingRereadConfig()
 {
     m_d->limits = KisStoreLimits();
+    m_d->trackMemoryPressure = KisImageConfig(true).trackSystemMemoryPressure();
+    m_d->criticalPressureEpisode = false;
+    m_d->criticalPressureBudget = 0;
 }
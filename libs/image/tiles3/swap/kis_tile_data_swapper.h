@@ -31,7 +31,7 @@ public:
     void testingRereadConfig();
 
 private:
-    void waitForWork();
+    bool waitForWork();
     void run() override;
 
     void doJob();
@@ -40,6 +40,9 @@ private:
 private:
     static const qint32 TIMEOUT;
     static const qint32 DELAY;
+    static const qint32 PRESSURE_POLL_INTERVAL;
+    static const qint32 MAX_SAMPLE_SIZE;
+    static const qint32 SAMPLE_OVERCOMMIT_FACTOR;
 
 private:
     struct Private;
@@ -0,0 +1,49 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_ZSTD_COMPRESSION_H
+#define __KIS_ZSTD_COMPRESSION_H
+
+#include "kis_abstract_compression.h"
+
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+
+/**
+ * A wrapper around the low-level (non-streaming) Zstandard API.
+ *
+ * The compression and decompression contexts are created once and
+ * reused for every call, so the object is *not* thread-safe. The
+ * owners of the compressor (KisTileCompressor2 and its users) already
+ * guarantee exclusive access.
+ *
+ * The class is available only when Krita is built with Zstandard
+ * support (HAVE_ZSTD in config-tile-compression.h)
+ */
+class KRITAIMAGE_EXPORT KisZstdCompression : public KisAbstractCompression
+{
+public:
+    /**
+     * \p compressionLevel is passed to Zstandard as is. Negative values
+     * select the "fast" levels, which is what the swapper needs most.
+     */
+    KisZstdCompression(int compressionLevel = 1);
+    ~KisZstdCompression() override;
+
+    qint32 compress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength) override;
+    qint32 decompress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength) override;
+
+    qint32 outputBufferSize(qint32 dataSize) override;
+
+private:
+    Q_DISABLE_COPY(KisZstdCompression)
+
+    ZSTD_CCtx_s *m_compressionContext;
+    ZSTD_DCtx_s *m_decompressionContext;
+    int m_compressionLevel;
+};
+
+#endif /* __KIS_ZSTD_COMPRESSION_H */
@@ -0,0 +1,170 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisMemoryPressureMonitorTest.h"
+
+#include <QTemporaryDir>
+#include <QFileInfo>
+#include <QDir>
+#include <QFile>
+
+#include "tiles3/swap/KisMemoryPressureMonitor.h"
+
+namespace {
+
+const qint64 MiB = 1 << 20;
+
+void writeFile(const QString &root, const QString &fileName, const QByteArray &content)
+{
+    const QString path = root + "/" + fileName;
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(content);
+}
+
+QByteArray pressureFile(qreal someAvg10)
+{
+    return QString("some avg10=%1 avg60=0.00 avg300=0.00 total=100\n"
+                   "full avg10=0.00 avg60=0.00 avg300=0.00 total=10\n")
+        .arg(someAvg10, 0, 'f', 2).toLatin1();
+}
+
+}
+
+void KisMemoryPressureMonitorTest::testNoCgroup()
+{
+    QTemporaryDir root;
+    QVERIFY(root.isValid());
+
+    KisMemoryPressureMonitor monitor(root.path());
+
+    QCOMPARE(monitor.memoryLimit(), qint64(-1));
+    QCOMPARE(monitor.memoryUsage(), qint64(-1));
+    QCOMPARE(monitor.stallPercent(), -1.0);
+    QCOMPARE(monitor.pressureLevel(), KisMemoryPressureMonitor::NoPressure);
+    QCOMPARE(monitor.excessMemory(), qint64(0));
+}
+
+void KisMemoryPressureMonitorTest::testCgroupV2()
+{
+    QTemporaryDir root;
+    QVERIFY(root.isValid());
+
+    writeFile(root.path(), "proc/self/cgroup", "0::/render.slice/krita\n");
+
+    const QString cgroup = "sys/fs/cgroup/render.slice/krita/";
+    writeFile(root.path(), cgroup + "memory.max", "max\n");
+    writeFile(root.path(), cgroup + "memory.high", QByteArray::number(1000 * MiB) + "\n");
+    writeFile(root.path(), cgroup + "memory.current", QByteArray::number(500 * MiB) + "\n");
+    writeFile(root.path(), cgroup + "memory.pressure", pressureFile(0.0));
+
+    {
+        KisMemoryPressureMonitor monitor(root.path());
+
+        QCOMPARE(monitor.memoryLimit(), 1000 * MiB);
+        QCOMPARE(monitor.memoryUsage(), 500 * MiB);
+        QCOMPARE(monitor.stallPercent(), 0.0);
+        QCOMPARE(monitor.pressureLevel(), KisMemoryPressureMonitor::NoPressure);
+        QCOMPARE(monitor.excessMemory(), qint64(0));
+    }
+
+    writeFile(root.path(), cgroup + "memory.current", QByteArray::number(900 * MiB) + "\n");
+
+    {
+        KisMemoryPressureMonitor monitor(root.path());
+        QCOMPARE(monitor.pressureLevel(), KisMemoryPressureMonitor::ModeratePressure);
+        QCOMPARE(monitor.excessMemory(), 100 * MiB);
+    }
+
+    writeFile(root.path(), cgroup + "memory.current", QByteArray::number(990 * MiB) + "\n");
+
+    {
+        KisMemoryPressureMonitor monitor(root.path());
+        QCOMPARE(monitor.pressureLevel(), KisMemoryPressureMonitor::CriticalPressure);
+        QCOMPARE(monitor.excessMemory(), 190 * MiB);
+    }
+
+    // the stalls are reported even when the usage is fine
+    writeFile(root.path(), cgroup + "memory.current", QByteArray::number(100 * MiB) + "\n");
+    writeFile(root.path(), cgroup + "memory.pressure", pressureFile(25.0));
+
+    {
+        KisMemoryPressureMonitor monitor(root.path());
+        QCOMPARE(monitor.stallPercent(), 25.0);
+        QCOMPARE(monitor.pressureLevel(), KisMemoryPressureMonitor::CriticalPressure);
+    }
+}
+
+void KisMemoryPressureMonitorTest::testCgroupV2ParentLimit()
+{
+    QTemporaryDir root;
+    QVERIFY(root.isValid());
+
+    writeFile(root.path(), "proc/self/cgroup", "0::/render.slice/krita\n");
+
+    writeFile(root.path(), "sys/fs/cgroup/render.slice/memory.max", QByteArray::number(800 * MiB) + "\n");
+    writeFile(root.path(), "sys/fs/cgroup/render.slice/krita/memory.high", QByteArray::number(2000 * MiB) + "\n");
+    writeFile(root.path(), "sys/fs/cgroup/render.slice/krita/memory.max", "max\n");
+
+    KisMemoryPressureMonitor monitor(root.path());
+    QCOMPARE(monitor.memoryLimit(), 800 * MiB);
+}
+
+void KisMemoryPressureMonitorTest::testCgroupV1()
+{
+    QTemporaryDir root;
+    QVERIFY(root.isValid());
+
+    writeFile(root.path(), "proc/self/cgroup",
+              "12:cpu,cpuacct:/docker/1234\n"
+              "4:memory:/docker/1234\n"
+              "0::/docker/1234\n");
+
+    // inside the container our cgroup is mounted at the root
+    writeFile(root.path(), "sys/fs/cgroup/memory/memory.limit_in_bytes", QByteArray::number(512 * MiB) + "\n");
+    writeFile(root.path(), "sys/fs/cgroup/memory/memory.usage_in_bytes", QByteArray::number(256 * MiB) + "\n");
+
+    {
+        KisMemoryPressureMonitor monitor(root.path());
+
+        QCOMPARE(monitor.memoryLimit(), 512 * MiB);
+        QCOMPARE(monitor.memoryUsage(), 256 * MiB);
+        QCOMPARE(monitor.pressureLevel(), KisMemoryPressureMonitor::NoPressure);
+    }
+
+    // the unlimited cgroup
+    writeFile(root.path(), "sys/fs/cgroup/memory/memory.limit_in_bytes", "9223372036854771712\n");
+
+    {
+        KisMemoryPressureMonitor monitor(root.path());
+        QCOMPARE(monitor.memoryLimit(), qint64(-1));
+    }
+}
+
+void KisMemoryPressureMonitorTest::testSystemPressureStall()
+{
+    QTemporaryDir root;
+    QVERIFY(root.isValid());
+
+    writeFile(root.path(), "proc/pressure/memory", pressureFile(0.5));
+
+    {
+        KisMemoryPressureMonitor monitor(root.path());
+        QCOMPARE(monitor.stallPercent(), 0.5);
+        QCOMPARE(monitor.pressureLevel(), KisMemoryPressureMonitor::NoPressure);
+    }
+
+    writeFile(root.path(), "proc/pressure/memory", pressureFile(3.0));
+
+    {
+        KisMemoryPressureMonitor monitor(root.path());
+        QCOMPARE(monitor.pressureLevel(), KisMemoryPressureMonitor::ModeratePressure);
+    }
+}
+
+SIMPLE_TEST_MAIN(KisMemoryPressureMonitorTest)
@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISMEMORYPRESSUREMONITORTEST_H
+#define KISMEMORYPRESSUREMONITORTEST_H
+
+#include <simpletest.h>
+
+class KisMemoryPressureMonitorTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testNoCgroup();
+    void testCgroupV2();
+    void testCgroupV2ParentLimit();
+    void testCgroupV1();
+    void testSystemPressureStall();
+};
+
+#endif // KISMEMORYPRESSUREMONITORTEST_H
@@ -0,0 +1,170 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTileDataArenaTest.h"
+#include <simpletest.h>
+
+#include <QThreadPool>
+#include <QRunnable>
+
+#include "kis_debug.h"
+
+#include "tiles3/KisTileDataArena.h"
+
+#define PIXELS_PER_TILE (64 * 64)
+#define ARENA_SIZE (2 * 1024 * 1024)
+
+
+void KisTileDataArenaTest::testAllocation()
+{
+    KisTileDataArena arena(PIXELS_PER_TILE, true);
+
+    quint8 *ptr1 = arena.allocate(4);
+    quint8 *ptr2 = arena.allocate(4);
+    quint8 *ptr3 = arena.allocate(8);
+
+    QVERIFY(ptr1 != ptr2);
+
+    // the whole chunk should be writable
+    memset(ptr1, 0x11, 4 * PIXELS_PER_TILE);
+    memset(ptr2, 0x22, 4 * PIXELS_PER_TILE);
+    memset(ptr3, 0x33, 8 * PIXELS_PER_TILE);
+
+    QCOMPARE(ptr1[4 * PIXELS_PER_TILE - 1], quint8(0x11));
+    QCOMPARE(ptr2[0], quint8(0x22));
+
+    KisTileDataArena::Statistics stats = arena.statistics();
+    QCOMPARE(stats.numArenas, 2);
+    QCOMPARE(stats.reservedSize, qint64(2 * ARENA_SIZE));
+    QCOMPARE(stats.usedSize, qint64(16 * PIXELS_PER_TILE));
+    QVERIFY(stats.fragmentation() > 0.9);
+    QVERIFY(stats.numTlbEntries() > 0);
+
+#ifdef Q_OS_LINUX
+    // the arenas should be aligned to be backed by huge pages
+    QCOMPARE(reinterpret_cast<quintptr>(ptr3) % ARENA_SIZE, quintptr(0));
+#endif
+
+    // the freed chunk is reused
+    arena.free(ptr2, 4);
+    quint8 *ptr4 = arena.allocate(4);
+    QCOMPARE(ptr4, ptr2);
+
+    // big pixels are not pooled
+    quint8 *ptr5 = arena.allocate(KisTileDataArena::MAX_PIXEL_SIZE + 1);
+    QCOMPARE(arena.statistics().numArenas, 2);
+
+    arena.free(ptr1, 4);
+    arena.free(ptr3, 8);
+    arena.free(ptr4, 4);
+    arena.free(ptr5, KisTileDataArena::MAX_PIXEL_SIZE + 1);
+
+    stats = arena.statistics();
+    QCOMPARE(stats.usedSize, qint64(0));
+    QCOMPARE(stats.fragmentation(), 1.0);
+}
+
+void KisTileDataArenaTest::testPurge()
+{
+    KisTileDataArena arena(PIXELS_PER_TILE, false);
+
+    quint8 *ptr1 = arena.allocate(4);
+    quint8 *ptr2 = arena.allocate(8);
+    QCOMPARE(arena.statistics().numArenas, 2);
+    QCOMPARE(arena.statistics().hugePageSize, qint64(0));
+
+    arena.free(ptr1, 4);
+
+    // the slab of 8-byte pixels is still in use
+    arena.purgeMemory();
+    QCOMPARE(arena.statistics().numArenas, 1);
+    QCOMPARE(arena.statistics().reservedSize, qint64(ARENA_SIZE));
+
+    arena.free(ptr2, 8);
+    arena.purgeMemory();
+    QCOMPARE(arena.statistics().numArenas, 0);
+
+    // the purged arena is usable again
+    ptr1 = arena.allocate(4);
+    memset(ptr1, 0x11, 4 * PIXELS_PER_TILE);
+    QCOMPARE(arena.statistics().numArenas, 1);
+    arena.free(ptr1, 4);
+}
+
+class KisArenaStressJob : public QRunnable
+{
+public:
+    KisArenaStressJob(KisTileDataArena &arena, quint8 fillValue)
+        : m_arena(arena), m_fillValue(fillValue)
+    {
+    }
+
+    void run() override {
+        const int numChunks = 200;
+        const int chunkSize = 4 * PIXELS_PER_TILE;
+
+        QVector<quint8*> chunks;
+
+        for (int i = 0; i < numChunks; i++) {
+            quint8 *ptr = m_arena.allocate(4);
+            memset(ptr, m_fillValue, chunkSize);
+            chunks << ptr;
+
+            // free some of them to shuffle the free lists
+            if (i % 3 == 2) {
+                m_arena.free(chunks.takeFirst(), 4);
+            }
+        }
+
+        Q_FOREACH (quint8 *ptr, chunks) {
+            m_dataIsValid &= ptr[0] == m_fillValue && ptr[chunkSize - 1] == m_fillValue;
+            m_arena.free(ptr, 4);
+        }
+    }
+
+    bool dataIsValid() const {
+        return m_dataIsValid;
+    }
+
+private:
+    KisTileDataArena &m_arena;
+    quint8 m_fillValue;
+    bool m_dataIsValid {true};
+};
+
+void KisTileDataArenaTest::testConcurrentAllocation()
+{
+    KisTileDataArena arena(PIXELS_PER_TILE, true);
+
+    const int numThreads = 8;
+
+    QList<KisArenaStressJob*> jobsList;
+
+    for (int i = 0; i < numThreads; i++) {
+        KisArenaStressJob *job = new KisArenaStressJob(arena, i + 1);
+        job->setAutoDelete(false);
+        jobsList.append(job);
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(numThreads);
+
+    Q_FOREACH (KisArenaStressJob *job, jobsList) {
+        pool.start(job);
+    }
+
+    pool.waitForDone();
+
+    Q_FOREACH (KisArenaStressJob *job, jobsList) {
+        QVERIFY(job->dataIsValid());
+    }
+
+    qDeleteAll(jobsList);
+
+    QCOMPARE(arena.statistics().usedSize, qint64(0));
+}
+
+SIMPLE_TEST_MAIN(KisTileDataArenaTest)
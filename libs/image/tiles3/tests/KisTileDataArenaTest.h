@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISTILEDATAARENATEST_H
+#define KISTILEDATAARENATEST_H
+
+#include <simpletest.h>
+
+class KisTileDataArenaTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testAllocation();
+    void testPurge();
+    void testConcurrentAllocation();
+};
+
+#endif // KISTILEDATAARENATEST_H
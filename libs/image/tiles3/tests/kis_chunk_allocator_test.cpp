@@ -30,6 +30,40 @@ void KisChunkAllocatorTest::testOperations()
     QVERIFY(qFuzzyCompare(allocator.debugFragmentation(), 1./6));
 }
 
+void KisChunkAllocatorTest::testFreeSpace()
+{
+    KisChunkAllocator allocator;
+
+    KisChunkData freeSpace(0, 0);
+
+    KisChunk chunk1 = allocator.getChunk(10);
+    allocator.getChunk(15);
+    KisChunk chunk3 = allocator.getChunk(20);
+    KisChunk chunk4 = allocator.getChunk(25);
+    KisChunk chunk5 = allocator.getChunk(30);
+
+    QCOMPARE(chunk3.begin(), 25ULL);
+
+    allocator.freeChunk(chunk3, &freeSpace);
+    QCOMPARE(freeSpace.m_begin, 25ULL);
+    QCOMPARE(freeSpace.m_end, 44ULL);
+
+    // the tail of the store is free as well
+    allocator.freeChunk(chunk5, &freeSpace);
+    QCOMPARE(freeSpace.m_begin, 70ULL);
+    QCOMPARE(freeSpace.m_end, DEFAULT_SLAB_SIZE - 1);
+
+    // the gap is merged with both neighbouring gaps
+    allocator.freeChunk(chunk4, &freeSpace);
+    QCOMPARE(freeSpace.m_begin, 25ULL);
+    QCOMPARE(freeSpace.m_end, DEFAULT_SLAB_SIZE - 1);
+
+    allocator.freeChunk(chunk1, &freeSpace);
+    QCOMPARE(freeSpace.m_begin, 0ULL);
+    QCOMPARE(freeSpace.m_end, 9ULL);
+
+    allocator.sanityCheck();
+}
 
 #define NUM_TRANSACTIONS 30
 #define NUM_CHUNKS_ALLOC 15000
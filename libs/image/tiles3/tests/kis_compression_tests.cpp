@@ -5,12 +5,16 @@
  */
 
 #include "kis_compression_tests.h"
-#include <simpletest.h>
+#include <kistest.h>
 
 #include <QImage>
 
+#include <KoColorSpaceRegistry.h>
+#include <KoColorModelStandardIds.h>
+
 #include "../../../sdk/tests/testutil.h"
 #include "tiles3/swap/kis_lzf_compression.h"
+#include "tiles3/swap/kis_tile_compressor_factory.h"
 #include <kis_debug.h>
 
 #define TEST_FILE "tile.png"
@@ -80,94 +84,120 @@ void KisCompressionTests::roundTripTwoPass(KisAbstractCompression *compression)
     QVERIFY(referenceImage == image);
 }
 
-void KisCompressionTests::benchmarkCompression(KisAbstractCompression *compression)
+QByteArray KisCompressionTests::loadTileData(const QString &depthId, int *pixelSize)
 {
     QImage image(QString(FILES_DATA_DIR) + QDir::separator() + TEST_FILE);
+    image = image.convertToFormat(QImage::Format_ARGB32);
+
+    const KoColorSpace *srcColorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *dstColorSpace =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), depthId, 0);
+    KIS_ASSERT(dstColorSpace);
+
+    const int numPixels = image.width() * image.height();
+    QByteArray data(numPixels * dstColorSpace->pixelSize(), 0);
+
+    /**
+     * The high bit depth tiles are converted from the 8-bit one, so
+     * all the variants represent the same image content.
+     */
+    srcColorSpace->convertPixelsTo(image.constBits(),
+                                   reinterpret_cast<quint8*>(data.data()),
+                                   dstColorSpace, numPixels,
+                                   KoColorConversionTransformation::internalRenderingIntent(),
+                                   KoColorConversionTransformation::internalConversionFlags());
+
+    *pixelSize = dstColorSpace->pixelSize();
+    return data;
+}
 
-    qint32 srcSize = image.byteCount();
+void KisCompressionTests::benchmarkCompression(KisAbstractCompression *compression, QByteArray data)
+{
+    qint32 srcSize = data.size();
     qint32 outputSize = compression->outputBufferSize(srcSize);
 
-    quint8 *output = new quint8[outputSize];
+    QByteArray output(outputSize, 0);
 
     qint32 compressedBytes;
 
     QBENCHMARK {
-        compressedBytes = compression->compress(image.bits(), srcSize,
-                                                output, outputSize);
+        compressedBytes = compression->compress(reinterpret_cast<quint8*>(data.data()), srcSize,
+                                                reinterpret_cast<quint8*>(output.data()), outputSize);
     }
-    Q_UNUSED(compressedBytes);
+
+    PRINT_COMPRESSION("Single-pass:\t", srcSize, compressedBytes);
 }
 
-void KisCompressionTests::benchmarkCompressionTwoPass(KisAbstractCompression *compression)
+void KisCompressionTests::benchmarkCompressionTwoPass(KisAbstractCompression *compression, QByteArray data, int pixelSize)
 {
-    QImage image(QString(FILES_DATA_DIR) + QDir::separator() + TEST_FILE);
-
-    qint32 srcSize = image.byteCount();
+    qint32 srcSize = data.size();
     qint32 outputSize = compression->outputBufferSize(srcSize);
 
-    quint8 *output = new quint8[outputSize];
+    QByteArray output(outputSize, 0);
+    QByteArray tempBuffer(srcSize, 0);
 
     qint32 compressedBytes;
 
-    quint8 *tempBuffer = new quint8[srcSize];
-
     QBENCHMARK {
-        KisAbstractCompression::linearizeColors(image.bits(), tempBuffer,
-                                                srcSize, 4);
-        compressedBytes = compression->compress(tempBuffer, srcSize,
-                                                output, outputSize);
+        KisAbstractCompression::linearizeColors(reinterpret_cast<quint8*>(data.data()),
+                                                reinterpret_cast<quint8*>(tempBuffer.data()),
+                                                srcSize, pixelSize);
+        compressedBytes = compression->compress(reinterpret_cast<quint8*>(tempBuffer.data()), srcSize,
+                                                reinterpret_cast<quint8*>(output.data()), outputSize);
     }
-    Q_UNUSED(compressedBytes);
+
+    PRINT_COMPRESSION("Two-pass:\t", srcSize, compressedBytes);
 }
 
-void KisCompressionTests::benchmarkDecompression(KisAbstractCompression *compression)
+void KisCompressionTests::benchmarkDecompression(KisAbstractCompression *compression, QByteArray data)
 {
-    QImage image(QString(FILES_DATA_DIR) + QDir::separator() + TEST_FILE);
-
-    qint32 srcSize = image.byteCount();
+    qint32 srcSize = data.size();
     qint32 outputSize = compression->outputBufferSize(srcSize);
 
-    quint8 *output = new quint8[outputSize];
+    QByteArray output(outputSize, 0);
 
     qint32 compressedBytes;
     qint32 uncompressedBytes;
 
-    compressedBytes = compression->compress(image.bits(), srcSize,
-                                            output, outputSize);
+    compressedBytes = compression->compress(reinterpret_cast<quint8*>(data.data()), srcSize,
+                                            reinterpret_cast<quint8*>(output.data()), outputSize);
 
     QBENCHMARK {
-        uncompressedBytes = compression->decompress(output, compressedBytes,
-                                                    image.bits(), srcSize);
+        uncompressedBytes = compression->decompress(reinterpret_cast<quint8*>(output.data()), compressedBytes,
+                                                    reinterpret_cast<quint8*>(data.data()), srcSize);
     }
-    Q_UNUSED(uncompressedBytes);
+
+    QCOMPARE(uncompressedBytes, srcSize);
 }
 
-void KisCompressionTests::benchmarkDecompressionTwoPass(KisAbstractCompression *compression)
+void KisCompressionTests::benchmarkDecompressionTwoPass(KisAbstractCompression *compression, QByteArray data, int pixelSize)
 {
-    QImage image(QString(FILES_DATA_DIR) + QDir::separator() + TEST_FILE);
-
-    qint32 srcSize = image.byteCount();
+    qint32 srcSize = data.size();
     qint32 outputSize = compression->outputBufferSize(srcSize);
 
-    quint8 *output = new quint8[outputSize];
+    QByteArray output(outputSize, 0);
+    QByteArray tempBuffer(srcSize, 0);
 
     qint32 compressedBytes;
     qint32 uncompressedBytes;
 
-    quint8 *tempBuffer = new quint8[srcSize];
-    KisAbstractCompression::linearizeColors(image.bits(), tempBuffer, srcSize, 4);
+    KisAbstractCompression::linearizeColors(reinterpret_cast<quint8*>(data.data()),
+                                            reinterpret_cast<quint8*>(tempBuffer.data()),
+                                            srcSize, pixelSize);
 
-    compressedBytes = compression->compress(tempBuffer, srcSize,
-                                            output, outputSize);
+    compressedBytes = compression->compress(reinterpret_cast<quint8*>(tempBuffer.data()), srcSize,
+                                            reinterpret_cast<quint8*>(output.data()), outputSize);
 
     QBENCHMARK {
-        uncompressedBytes = compression->decompress(output, compressedBytes,
-                                                    tempBuffer, srcSize);
+        uncompressedBytes = compression->decompress(reinterpret_cast<quint8*>(output.data()), compressedBytes,
+                                                    reinterpret_cast<quint8*>(tempBuffer.data()), srcSize);
 
-        KisAbstractCompression::delinearizeColors(tempBuffer, image.bits(),
-                                                  srcSize, 4);
+        KisAbstractCompression::delinearizeColors(reinterpret_cast<quint8*>(tempBuffer.data()),
+                                                  reinterpret_cast<quint8*>(data.data()),
+                                                  srcSize, pixelSize);
     }
-    Q_UNUSED(uncompressedBytes);
+
+    QCOMPARE(uncompressedBytes, srcSize);
 }
 
 void KisCompressionTests::testOverflow(KisAbstractCompression *compression)
@@ -225,30 +255,159 @@ void KisCompressionTests::benchmarkMemCpy()
 void KisCompressionTests::benchmarkCompressionLzf()
 {
     KisAbstractCompression *compression = new KisLzfCompression();
-    benchmarkCompression(compression);
+    int pixelSize = 0;
+    const QByteArray data = loadTileData(Integer8BitsColorDepthID.id(), &pixelSize);
+    Q_UNUSED(pixelSize);
+    benchmarkCompression(compression, data);
     delete compression;
 }
 
 void KisCompressionTests::benchmarkCompressionLzfTwoPass()
 {
     KisAbstractCompression *compression = new KisLzfCompression();
-    benchmarkCompressionTwoPass(compression);
+    int pixelSize = 0;
+    const QByteArray data = loadTileData(Integer8BitsColorDepthID.id(), &pixelSize);
+    benchmarkCompressionTwoPass(compression, data, pixelSize);
     delete compression;
 }
 
 void KisCompressionTests::benchmarkDecompressionLzf()
 {
     KisAbstractCompression *compression = new KisLzfCompression();
-    benchmarkDecompression(compression);
+    int pixelSize = 0;
+    const QByteArray data = loadTileData(Integer8BitsColorDepthID.id(), &pixelSize);
+    Q_UNUSED(pixelSize);
+    benchmarkDecompression(compression, data);
     delete compression;
 }
 
 void KisCompressionTests::benchmarkDecompressionLzfTwoPass()
 {
     KisAbstractCompression *compression = new KisLzfCompression();
-    benchmarkDecompressionTwoPass(compression);
+    int pixelSize = 0;
+    const QByteArray data = loadTileData(Integer8BitsColorDepthID.id(), &pixelSize);
+    benchmarkDecompressionTwoPass(compression, data, pixelSize);
     delete compression;
 }
 
-SIMPLE_TEST_MAIN(KisCompressionTests)
+KisAbstractCompression* KisCompressionTests::createCompressionOrSkip(const QString &name)
+{
+    KisAbstractCompression *compression = KisTileCompressorFactory::createCompression(name);
+    if (!compression) {
+        qWarning() << "Compression" << name << "is not available in this build";
+    }
+    return compression;
+}
+
+void addCodecRows()
+{
+    QTest::addColumn<QString>("codec");
+
+    QTest::newRow("LZF") << "LZF";
+    QTest::newRow("LZ4") << "LZ4";
+    QTest::newRow("ZSTD") << "ZSTD";
+}
+
+void addCodecAndDepthRows()
+{
+    QTest::addColumn<QString>("codec");
+    QTest::addColumn<QString>("depth");
+
+    const QStringList codecs = {"LZF", "LZ4", "ZSTD"};
+    const QList<KoID> depths = {Integer8BitsColorDepthID, Integer16BitsColorDepthID, Float32BitsColorDepthID};
+
+    Q_FOREACH (const QString &codec, codecs) {
+        Q_FOREACH (const KoID &depth, depths) {
+            QTest::newRow(QString("%1-%2").arg(codec, depth.id()).toLatin1().data()) << codec << depth.id();
+        }
+    }
+}
+
+#define CODEC_OR_SKIP(compression)                                      \
+    QFETCH(QString, codec);                                             \
+    QScopedPointer<KisAbstractCompression> compression(createCompressionOrSkip(codec)); \
+    if (!compression) {                                                 \
+        QSKIP("The codec is not available in this build");              \
+    }
+
+#define FETCH_TILE_DATA(data, pixelSize)                                \
+    QFETCH(QString, depth);                                             \
+    int pixelSize = 0;                                                  \
+    const QByteArray data = loadTileData(depth, &pixelSize);
+
+void KisCompressionTests::testCodecRoundTrip_data()
+{
+    addCodecRows();
+}
+
+void KisCompressionTests::testCodecRoundTrip()
+{
+    CODEC_OR_SKIP(compression);
+
+    roundTrip(compression.data());
+    roundTripTwoPass(compression.data());
+}
+
+void KisCompressionTests::testCodecOverflow_data()
+{
+    addCodecRows();
+}
+
+void KisCompressionTests::testCodecOverflow()
+{
+    CODEC_OR_SKIP(compression);
+    testOverflow(compression.data());
+}
+
+void KisCompressionTests::benchmarkCompressionCodec_data()
+{
+    addCodecAndDepthRows();
+}
+
+void KisCompressionTests::benchmarkCompressionCodec()
+{
+    CODEC_OR_SKIP(compression);
+    FETCH_TILE_DATA(data, pixelSize);
+    Q_UNUSED(pixelSize);
+    benchmarkCompression(compression.data(), data);
+}
+
+void KisCompressionTests::benchmarkCompressionCodecTwoPass_data()
+{
+    addCodecAndDepthRows();
+}
+
+void KisCompressionTests::benchmarkCompressionCodecTwoPass()
+{
+    CODEC_OR_SKIP(compression);
+    FETCH_TILE_DATA(data, pixelSize);
+    benchmarkCompressionTwoPass(compression.data(), data, pixelSize);
+}
+
+void KisCompressionTests::benchmarkDecompressionCodec_data()
+{
+    addCodecAndDepthRows();
+}
+
+void KisCompressionTests::benchmarkDecompressionCodec()
+{
+    CODEC_OR_SKIP(compression);
+    FETCH_TILE_DATA(data, pixelSize);
+    Q_UNUSED(pixelSize);
+    benchmarkDecompression(compression.data(), data);
+}
+
+void KisCompressionTests::benchmarkDecompressionCodecTwoPass_data()
+{
+    addCodecAndDepthRows();
+}
+
+void KisCompressionTests::benchmarkDecompressionCodecTwoPass()
+{
+    CODEC_OR_SKIP(compression);
+    FETCH_TILE_DATA(data, pixelSize);
+    benchmarkDecompressionTwoPass(compression.data(), data, pixelSize);
+}
+
+KISTEST_MAIN(KisCompressionTests)
 
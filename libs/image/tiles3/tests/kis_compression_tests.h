@@ -18,14 +18,18 @@ private:
     void roundTrip(KisAbstractCompression *compression);
     void roundTripTwoPass(KisAbstractCompression *compression);
 
-    void benchmarkCompression(KisAbstractCompression *compression);
-    void benchmarkCompressionTwoPass(KisAbstractCompression *compression);
+    QByteArray loadTileData(const QString &depthId, int *pixelSize);
 
-    void benchmarkDecompression(KisAbstractCompression *compression);
-    void benchmarkDecompressionTwoPass(KisAbstractCompression *compression);
+    void benchmarkCompression(KisAbstractCompression *compression, QByteArray data);
+    void benchmarkCompressionTwoPass(KisAbstractCompression *compression, QByteArray data, int pixelSize);
+
+    void benchmarkDecompression(KisAbstractCompression *compression, QByteArray data);
+    void benchmarkDecompressionTwoPass(KisAbstractCompression *compression, QByteArray data, int pixelSize);
 
     void testOverflow(KisAbstractCompression *compression);
 
+    KisAbstractCompression* createCompressionOrSkip(const QString &name);
+
 private Q_SLOTS:
     void testLzfRoundTrip();
     void testLzfOverflow();
@@ -36,6 +40,20 @@ private Q_SLOTS:
     void benchmarkCompressionLzfTwoPass();
     void benchmarkDecompressionLzf();
     void benchmarkDecompressionLzfTwoPass();
+
+    void testCodecRoundTrip_data();
+    void testCodecRoundTrip();
+    void testCodecOverflow_data();
+    void testCodecOverflow();
+
+    void benchmarkCompressionCodec_data();
+    void benchmarkCompressionCodec();
+    void benchmarkCompressionCodecTwoPass_data();
+    void benchmarkCompressionCodecTwoPass();
+    void benchmarkDecompressionCodec_data();
+    void benchmarkDecompressionCodec();
+    void benchmarkDecompressionCodecTwoPass_data();
+    void benchmarkDecompressionCodecTwoPass();
 };
 
 #endif /* KIS_COMPRESSION_TESTS_H */
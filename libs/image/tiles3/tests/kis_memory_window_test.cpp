@@ -42,6 +42,108 @@ void KisMemoryWindowTest::testWindow()
     QVERIFY(!memcmp(ptr, oddBuf, chunkLength));
 }
 
+void KisMemoryWindowTest::testDiscardChunk()
+{
+    QTemporaryDir swapDir;
+    KisMemoryWindow memory(swapDir.path(), 16 * MiB);
+    memory.setHolePunchingEnabled(true);
+
+    if (!memory.holePunchingEnabled()) {
+        QSKIP("Hole punching is not supported on this platform");
+    }
+
+    const quint8 oddValue = 0xee;
+    const quint64 chunkLength = 4 * MiB;
+
+    KisChunkData chunk1(0, chunkLength);
+    KisChunkData chunk2(chunkLength, chunkLength);
+
+    quint8 *ptr;
+
+    ptr = memory.getWriteChunkPtr(chunk1);
+    memset(ptr, oddValue, chunkLength);
+
+    ptr = memory.getWriteChunkPtr(chunk2);
+    memset(ptr, oddValue, chunkLength);
+
+    const quint64 sizeBefore = memory.allocatedSize();
+    QVERIFY(sizeBefore >= 2 * chunkLength);
+
+    // the chunk ends in the middle of the page, it should be kept
+    memory.discardChunk(KisChunkData(0, chunkLength + 100));
+
+    if (!memory.holePunchingEnabled()) {
+        QSKIP("Hole punching is not supported by the file system");
+    }
+
+    QVERIFY(memory.allocatedSize() <= sizeBefore - chunkLength);
+
+    ptr = memory.getReadChunkPtr(KisChunkData(0, 1));
+    QCOMPARE(*ptr, quint8(0));
+
+    ptr = memory.getReadChunkPtr(chunk2);
+    for (quint64 i = 0; i < chunkLength; i++) {
+        if (ptr[i] != oddValue) {
+            QFAIL(QString("Data corrupted at offset %1").arg(i).toLatin1());
+        }
+    }
+}
+
+void KisMemoryWindowTest::testDiscardTail()
+{
+    QTemporaryDir swapDir;
+    KisMemoryWindow memory(swapDir.path(), 16 * MiB);
+    memory.setHolePunchingEnabled(true);
+
+    if (!memory.holePunchingEnabled()) {
+        QSKIP("Hole punching is not supported on this platform");
+    }
+
+    const quint8 oddValue = 0xee;
+    const quint64 chunkLength = 4 * MiB;
+
+    KisChunkData chunk1(0, chunkLength);
+    KisChunkData chunk2(chunkLength, chunkLength);
+
+    // the free regions at the tail reach far beyond the end of the file
+    KisChunkData tail1(0, 64 * MiB);
+    KisChunkData tail2(chunkLength, 64 * MiB);
+
+    quint8 *ptr;
+
+    ptr = memory.getWriteChunkPtr(chunk1);
+    memset(ptr, oddValue, chunkLength);
+
+    ptr = memory.getWriteChunkPtr(chunk2);
+    memset(ptr, oddValue, chunkLength);
+
+    const quint64 sizeBefore = memory.allocatedSize();
+    QVERIFY(sizeBefore >= 2 * chunkLength);
+
+    memory.discardChunk(tail2);
+
+    if (!memory.holePunchingEnabled()) {
+        QSKIP("Hole punching is not supported by the file system");
+    }
+
+    QVERIFY(memory.allocatedSize() <= sizeBefore - chunkLength);
+
+    // the tail grows, only the first chunk is left
+    memory.discardChunk(tail1);
+    QVERIFY(memory.allocatedSize() < chunkLength);
+
+    // the data written into the discarded tail should be discarded again
+    ptr = memory.getWriteChunkPtr(chunk2);
+    memset(ptr, oddValue, chunkLength);
+    QVERIFY(memory.allocatedSize() >= chunkLength);
+
+    memory.discardChunk(tail1);
+    QVERIFY(memory.allocatedSize() < chunkLength);
+
+    ptr = memory.getReadChunkPtr(KisChunkData(chunkLength, 1));
+    QCOMPARE(*ptr, quint8(0));
+}
+
 void KisMemoryWindowTest::testTopReports()
 {
 
@@ -15,6 +15,8 @@ class KisMemoryWindowTest : public QObject
 
 private Q_SLOTS:
     void testWindow();
+    void testDiscardChunk();
+    void testDiscardTail();
 
 private:
     // disabled since long-running
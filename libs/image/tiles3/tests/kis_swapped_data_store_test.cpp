@@ -9,6 +9,8 @@
 
 #include <QRandomGenerator>
 
+#include <algorithm>
+
 #include "kis_debug.h"
 
 #include "kis_image_config.h"
@@ -121,5 +123,65 @@ void KisSwappedDataStoreTest::testRandomAccess()
         delete tileDataList[i];
 }
 
+void KisSwappedDataStoreTest::testBatchRoundTrip()
+{
+    const qint32 pixelSize = 1;
+    const quint8 defaultPixel = 128;
+    const qint32 NUM_TILES = 10000;
+    const qint32 BATCH_SIZE = 64;
+
+    KisImageConfig config(false);
+    config.setMaxSwapSize(4);
+    config.setSwapSlabSize(1);
+    config.setSwapWindowSize(1);
+
+
+    KisSwappedDataStore store;
+
+    QVector<KisTileData*> tileDataList;
+    for(qint32 i = 0; i < NUM_TILES; i++)
+        tileDataList.append(new KisTileData(pixelSize, &defaultPixel, KisTileDataStore::instance()));
+
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = tileDataList[i];
+        memset(td->data(), COLUMN2COLOR(i), TILESIZE);
+
+        // FIXME: take a lock of the tile data
+        QVERIFY(store.trySwapOutTileData(td));
+    }
+
+    // swap-in the batches in the reverse order to check the sorting
+    for(qint32 i = NUM_TILES - BATCH_SIZE; i >= 0; i -= BATCH_SIZE) {
+        QVector<KisTileData*> batch = tileDataList.mid(i, BATCH_SIZE);
+        std::reverse(batch.begin(), batch.end());
+
+        // FIXME: take a lock of the tile data
+        while (!batch.isEmpty()) {
+            const int numPendingTiles = batch.size();
+            const QVector<KisTileData*> span = store.swapInTileDataSpan(batch);
+
+            QVERIFY(!span.isEmpty());
+            QCOMPARE(span.size() + batch.size(), numPendingTiles);
+        }
+    }
+
+    // the leftovers are swapped-in one by one
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = tileDataList[i];
+
+        if (!td->data()) {
+            store.swapInTileData(td);
+        }
+
+        QVERIFY(memoryIsFilled(COLUMN2COLOR(i), td->data(), TILESIZE));
+    }
+
+    QCOMPARE(store.numTiles(), 0ULL);
+    store.debugStatistics();
+
+    for(qint32 i = 0; i < NUM_TILES; i++)
+        delete tileDataList[i];
+}
+
 SIMPLE_TEST_MAIN(KisSwappedDataStoreTest)
 
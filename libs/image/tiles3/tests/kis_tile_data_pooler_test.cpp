@@ -7,6 +7,8 @@
 #include "kis_tile_data_pooler_test.h"
 #include <simpletest.h>
 
+#include <QVector>
+
 #include "tiles3/kis_tiled_data_manager.h"
 
 #include "tiles3/kis_tile_data_store.h"
@@ -32,6 +34,8 @@ void KisTileDataPoolerTest::testCycles()
 
     KisTileDataStore::instance()->debugClear();
 
+    QVector<KisTileData*> tileDataObjects;
+
     for(int i = 0; i < 12; i++) {
         KisTileData *td =
             KisTileDataStore::instance()->createDefaultTileData(pixelSize, &defaultPixel);
@@ -40,15 +44,22 @@ void KisTileDataPoolerTest::testCycles()
             td->acquire();
         }
 
-        if(!(i/6)) {
-            td->markOld();
-        }
-
         if(!((i / 3) & 1)) {
             td->m_clonesStack.push(new KisTileData(*td));
         }
 
-        PRETTY_TILE(i, td);
+        tileDataObjects << td;
+    }
+
+    // the first six tiles become old, the rest are accessed again
+    KisTileDataStore::instance()->advanceAccessEpoch();
+
+    for(int i = 6; i < 12; i++) {
+        tileDataObjects[i]->resetAge();
+    }
+
+    for(int i = 0; i < 12; i++) {
+        PRETTY_TILE(i, tileDataObjects[i]);
     }
 
     {
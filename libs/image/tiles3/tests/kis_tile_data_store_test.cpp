@@ -18,6 +18,16 @@
 #include "tiles3/kis_tile_data_store_iterators.h"
 
 
+void KisTileDataStoreTest::initTestCase()
+{
+    /**
+     * Make sure the swapper doesn't start new access epochs on its own,
+     * the config is read on the creation of the store
+     */
+    KisImageConfig config(false);
+    config.setTrackSystemMemoryPressure(false);
+}
+
 void KisTileDataStoreTest::testClockIterator()
 {
     KisTileDataStore *store = KisTileDataStore::instance();
@@ -176,5 +186,50 @@ void KisTileDataStoreTest::testSwapping()
     }
 }
 
+void KisTileDataStoreTest::testAccessEpochs()
+{
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->debugClear();
+
+    const qint32 pixelSize = 1;
+    quint8 defaultPixel = 128;
+
+    KisTileData *td = new KisTileData(pixelSize, &defaultPixel, store, false);
+    store->registerTileData(td);
+
+    // the current epoch is never confused with "never accessed"
+    QVERIFY(store->accessEpoch() != KisTileDataStore::NEVER_ACCESSED_EPOCH);
+
+    // creation counts as the first access
+    QCOMPARE(td->age(), 0);
+    QCOMPARE(td->reuseDistance(), KisTileData::NEVER_REUSED);
+
+    store->advanceAccessEpoch();
+    store->advanceAccessEpoch();
+
+    QCOMPARE(td->age(), 2);
+    QCOMPARE(td->reuseDistance(), KisTileData::NEVER_REUSED);
+
+    td->blockSwapping();
+    td->unblockSwapping();
+
+    QCOMPARE(td->age(), 0);
+    QCOMPARE(td->reuseDistance(), 2);
+
+    // repeated accesses during the same epoch change nothing
+    td->blockSwapping();
+    td->unblockSwapping();
+
+    QCOMPARE(td->age(), 0);
+    QCOMPARE(td->reuseDistance(), 2);
+
+    store->advanceAccessEpoch();
+
+    QCOMPARE(td->age(), 1);
+    QCOMPARE(td->reuseDistance(), 3);
+
+    store->freeTileData(td);
+}
+
 SIMPLE_TEST_MAIN(KisTileDataStoreTest)
 
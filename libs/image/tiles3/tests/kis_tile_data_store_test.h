@@ -15,9 +15,11 @@ class KisTileDataStoreTest : public QObject
 private:
 
 private Q_SLOTS:
+    void initTestCase();
     void testClockIterator();
     void testLeaks();
     void testSwapping();
+    void testAccessEpochs();
 };
 
 #endif /* KIS_TILE_DATA_STORE_TEST_H */
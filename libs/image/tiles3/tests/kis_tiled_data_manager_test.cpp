@@ -8,11 +8,15 @@
 #include <simpletest.h>
 
 #include <QRandomGenerator>
+#include <QBuffer>
 
 #include "tiles3/kis_tiled_data_manager.h"
+#include "tiles3/KisTileDataDeduplicator.h"
+#include "tiles3/kis_tile_data_store.h"
 
 #include "tiles_test_utils.h"
 #include "config-limit-long-tests.h"
+#include "config-hash-table-implementation.h"
 
 bool KisTiledDataManagerTest::checkHole(quint8* buffer,
                                         quint8 holeColor, QRect holeRect,
@@ -464,6 +468,337 @@ void KisTiledDataManagerTest::testPurgeHistory()
     dm.purgeHistory(memento4);
 }
 
+void KisTiledDataManagerTest::testMementoDeltaCompression()
+{
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm(1, &defaultPixel);
+    dm.m_mementoManager->setDeltaCompressionEnabled(true);
+
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+    quint8 oddPixel3 = 130;
+
+    const QRect tileRect(0, 0, 64, 64);
+    const QRect holeRect2(10, 10, 4, 4);
+    const QRect holeRect3(20, 20, 4, 4);
+
+    quint8 *buffer = new quint8[tileRect.width() * tileRect.height()];
+
+    KisMementoSP memento1 = dm.getMemento();
+    dm.clear(tileRect, &oddPixel1);
+    dm.commit();
+
+    KisMementoSP memento2 = dm.getMemento();
+    dm.clear(holeRect2, &oddPixel2);
+    dm.commit();
+
+    KisMementoSP memento3 = dm.getMemento();
+    dm.clear(holeRect3, &oddPixel3);
+    dm.commit();
+
+    /**
+     * Both older revisions of the tile are stored as deltas now,
+     * so undo has to restore them from the chain
+     */
+
+    dm.rollback(memento3);
+    dm.readBytes(buffer, 0, 0, 64, 64);
+    QVERIFY(checkHole(buffer, oddPixel2, holeRect2, oddPixel1, tileRect));
+
+    dm.rollback(memento2);
+    dm.readBytes(buffer, 0, 0, 64, 64);
+    QVERIFY(checkHole(buffer, oddPixel1, QRect(), oddPixel1, tileRect));
+
+    dm.rollforward(memento2);
+    dm.readBytes(buffer, 0, 0, 64, 64);
+    QVERIFY(checkHole(buffer, oddPixel2, holeRect2, oddPixel1, tileRect));
+
+    dm.rollforward(memento3);
+    dm.readBytes(buffer, 0, 0, 64, 16);
+    QVERIFY(checkHole(buffer, oddPixel2, holeRect2, oddPixel1, QRect(0, 0, 64, 16)));
+    dm.readBytes(buffer, 0, 16, 64, 48);
+    QVERIFY(checkHole(buffer, oddPixel3, holeRect3, oddPixel1, QRect(0, 16, 64, 48)));
+
+    /**
+     * Undo the whole history to check the chain
+     * works after the redo as well
+     */
+
+    dm.rollback(memento3);
+    dm.rollback(memento2);
+    dm.rollback(memento1);
+    dm.readBytes(buffer, 0, 0, 64, 64);
+    QVERIFY(checkHole(buffer, defaultPixel, QRect(), defaultPixel, tileRect));
+
+    delete[] buffer;
+}
+
+void KisTiledDataManagerTest::testTileDeduplication()
+{
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm1(1, &defaultPixel);
+    KisTiledDataManager dm2(1, &defaultPixel);
+
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+
+    // equal content, but separate tile data objects
+    dm1.setPixel(10, 10, &oddPixel1);
+    dm2.setPixel(10, 10, &oddPixel1);
+
+    // different content
+    dm1.setPixel(100, 10, &oddPixel1);
+    dm2.setPixel(100, 10, &oddPixel2);
+
+    QVERIFY(dm1.getTile(0, 0, false)->tileData() != dm2.getTile(0, 0, false)->tileData());
+
+    {
+        KisTileDataDeduplicator deduplicator;
+
+        KisTileDataDeduplicator::updateContentHashes(&dm1);
+        KisTileDataDeduplicator::updateContentHashes(&dm2);
+
+        deduplicator.processDataManager(&dm1);
+        deduplicator.processDataManager(&dm2);
+
+        QCOMPARE(deduplicator.numMergedTiles(), 1);
+        QCOMPARE(deduplicator.releasedMemory(), qint64(KisTileData::WIDTH * KisTileData::HEIGHT));
+    }
+
+    QCOMPARE(dm1.getTile(0, 0, false)->tileData(), dm2.getTile(0, 0, false)->tileData());
+    QCOMPARE(dm1.getTile(0, 0, false)->tileData()->numUsers(), 2);
+    QVERIFY(dm1.getTile(1, 0, false)->tileData() != dm2.getTile(1, 0, false)->tileData());
+
+    // writing should detach the shared tile data
+
+    dm2.setPixel(11, 10, &oddPixel2);
+
+    QVERIFY(dm1.getTile(0, 0, false)->tileData() != dm2.getTile(0, 0, false)->tileData());
+
+    quint8 pixel = 0;
+    dm1.readBytes(&pixel, 11, 10, 1, 1);
+    QCOMPARE(pixel, defaultPixel);
+    dm2.readBytes(&pixel, 11, 10, 1, 1);
+    QCOMPARE(pixel, oddPixel2);
+    dm2.readBytes(&pixel, 10, 10, 1, 1);
+    QCOMPARE(pixel, oddPixel1);
+}
+
+void KisTiledDataManagerTest::testUniformTileCompaction()
+{
+    quint8 defaultPixel = 0;
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+
+    KisTiledDataManager dm1(1, &defaultPixel);
+    KisTiledDataManager dm2(1, &defaultPixel);
+
+    // filled tiles share the data across the devices right away
+    dm1.clear(0, 0, 64, 64, &oddPixel1);
+    dm2.clear(0, 0, 64, 64, &oddPixel1);
+
+    QCOMPARE(dm1.getTile(0, 0, false)->tileData(), dm2.getTile(0, 0, false)->tileData());
+
+    KisTiledDataManager dm3(1, &defaultPixel);
+
+    QScopedArrayPointer<quint8> buffer(new quint8[64 * 64]);
+
+    memset(buffer.data(), oddPixel2, 64 * 64);
+    dm3.writeBytes(buffer.data(), 0, 0, 64, 64);
+
+    memset(buffer.data(), defaultPixel, 64 * 64);
+    dm3.writeBytes(buffer.data(), 64, 0, 64, 64);
+
+    {
+        KisTileDataDeduplicator deduplicator;
+        KisTileDataDeduplicator::updateContentHashes(&dm3);
+        deduplicator.processDataManager(&dm3);
+
+        QCOMPARE(deduplicator.numMergedTiles(), 2);
+    }
+
+    KisTileData *uniformTileData = store->acquireUniformTileData(1, &oddPixel2);
+    QCOMPARE(dm3.getTile(0, 0, false)->tileData(), uniformTileData);
+    uniformTileData->release();
+
+    KisTileData *defaultTileData = dm3.m_hashTable->refAndFetchDefaultTileData();
+    QCOMPARE(dm3.getTile(1, 0, false)->tileData(), defaultTileData);
+    defaultTileData->deref();
+
+    // the compacted tile is expanded back on write
+
+    dm3.setPixel(10, 10, &oddPixel1);
+    QVERIFY(dm3.getTile(0, 0, false)->tileData() != uniformTileData);
+
+    dm3.readBytes(buffer.data(), 0, 0, 64, 64);
+    QVERIFY(checkHole(buffer.data(), oddPixel1, QRect(10, 10, 1, 1),
+                      oddPixel2, QRect(0, 0, 64, 64)));
+
+    dm3.readBytes(buffer.data(), 64, 0, 64, 64);
+    QVERIFY(checkHole(buffer.data(), defaultPixel, QRect(),
+                      defaultPixel, QRect(64, 0, 64, 64)));
+
+    // the tiles left over the hashing limit are processed by the next pass
+
+    KisTiledDataManager dm4(1, &defaultPixel);
+
+    memset(buffer.data(), oddPixel2, 64 * 64);
+    dm4.writeBytes(buffer.data(), 0, 0, 64, 64);
+    dm4.writeBytes(buffer.data(), 64, 0, 64, 64);
+
+    {
+        KisTileDataDeduplicator deduplicator;
+
+        QCOMPARE(KisTileDataDeduplicator::updateContentHashes(&dm4, 1), 1);
+        deduplicator.processDataManager(&dm4);
+        QCOMPARE(deduplicator.numMergedTiles(), 1);
+
+        KisTileDataDeduplicator::updateContentHashes(&dm4);
+        deduplicator.processDataManager(&dm4);
+        QCOMPARE(deduplicator.numMergedTiles(), 2);
+    }
+}
+
+void KisTiledDataManagerTest::testReadForeignTileSize()
+{
+    quint8 defaultPixel = 0;
+    quint8 oddPixel1 = 128;
+
+    /**
+     * A stream saved by a build with 32x32 tiles, it contains
+     * a single raw (uncompressed) tile
+     */
+    const int foreignTileSize = 32;
+    const QRect foreignTileRect(32, 64, foreignTileSize, foreignTileSize);
+    const int foreignDataSize = foreignTileSize * foreignTileSize;
+
+    QByteArray data;
+    data += "VERSION 2\n"
+            "TILEWIDTH 32\n"
+            "TILEHEIGHT 32\n"
+            "PIXELSIZE 1\n"
+            "DATA 1\n";
+    data += QString("%1,%2,LZF,%3\n")
+        .arg(foreignTileRect.x()).arg(foreignTileRect.y())
+        .arg(foreignDataSize + 1).toLatin1();
+    data += char(0); // RAW_DATA_FLAG
+    data += QByteArray(foreignDataSize, char(oddPixel1));
+
+    QBuffer stream(&data);
+    stream.open(QIODevice::ReadOnly);
+
+    KisTiledDataManager dm(1, &defaultPixel);
+    QVERIFY(dm.read(&stream));
+
+    const QRect nativeTileRect(0, 0, KisTileData::WIDTH, KisTileData::HEIGHT);
+    const QRect expectedExtent =
+        nativeTileRect.translated(
+            foreignTileRect.x() / KisTileData::WIDTH * KisTileData::WIDTH,
+            foreignTileRect.y() / KisTileData::HEIGHT * KisTileData::HEIGHT);
+
+    QCOMPARE(dm.extent(), expectedExtent);
+
+    QScopedArrayPointer<quint8> buffer(new quint8[expectedExtent.width() * expectedExtent.height()]);
+    dm.readBytes(buffer.data(), expectedExtent.x(), expectedExtent.y(),
+                 expectedExtent.width(), expectedExtent.height());
+
+    QVERIFY(checkHole(buffer.data(), oddPixel1, foreignTileRect,
+                      defaultPixel, expectedExtent));
+}
+
+void KisTiledDataManagerTest::testWriteFileTileSize()
+{
+    quint8 defaultPixel = 0;
+    quint8 oddPixel1 = 128;
+
+    const QRect rc(10, 20, 3 * KisTileData::WIDTH, 2 * KisTileData::HEIGHT);
+
+    KisTiledDataManager dm(1, &defaultPixel);
+    dm.clear(rc.x(), rc.y(), rc.width(), rc.height(), &oddPixel1);
+
+    KoStoreFake fakeStore;
+    KisFakePaintDeviceWriter writer(&fakeStore);
+    QVERIFY(dm.write(writer));
+
+    fakeStore.startReading();
+    QIODevice *stream = fakeStore.device();
+
+    /**
+     * The files always contain 64x64 tiles, whatever the
+     * KRITA_TILE_SIZE of the build is
+     */
+    const int fileTilesPerTile = (KisTileData::WIDTH / 64) * (KisTileData::HEIGHT / 64);
+    const QByteArray header = stream->peek(100);
+    QVERIFY(header.contains("TILEWIDTH 64\n"));
+    QVERIFY(header.contains("TILEHEIGHT 64\n"));
+    QVERIFY(header.contains(QString("DATA %1\n")
+                            .arg(dm.m_hashTable->numTiles() * fileTilesPerTile)
+                            .toLatin1()));
+
+    KisTiledDataManager dm2(1, &defaultPixel);
+    QVERIFY(dm2.read(stream));
+
+    QCOMPARE(dm2.extent(), dm.extent());
+
+    const QRect extent = dm.extent();
+    QScopedArrayPointer<quint8> buffer(new quint8[extent.width() * extent.height()]);
+    dm2.readBytes(buffer.data(), extent.x(), extent.y(), extent.width(), extent.height());
+
+    QVERIFY(checkHole(buffer.data(), oddPixel1, rc, defaultPixel, extent));
+}
+
+void KisTiledDataManagerTest::testIterationDoesNotBlockWriters()
+{
+#ifndef USE_LOCK_FREE_HASH_TABLE
+    QSKIP("The legacy hash table locks the writers out during the iteration");
+#else
+    quint8 defaultPixel = 0;
+    quint8 oddPixel1 = 128;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    dm.clear(0, 0, 4 * KisTileData::WIDTH, KisTileData::HEIGHT, &oddPixel1);
+    QCOMPARE(dm.m_hashTable->numTiles(), 4);
+
+    int numAddedTiles = 0;
+    QSet<int> visitedOriginalColumns;
+
+    {
+        KisTileHashTableConstIterator iter(dm.m_hashTable);
+        KisTileSP tile;
+
+        while ((tile = iter.tile())) {
+            /**
+             * Adding new tiles and changing the default pixel from inside
+             * the iteration used to deadlock with the lock-free table
+             */
+            if (numAddedTiles < 4) {
+                bool newTile = false;
+                dm.m_hashTable->getTileLazy(numAddedTiles, 10, newTile);
+                QVERIFY(newTile);
+
+                quint8 newDefaultPixel = numAddedTiles + 1;
+                dm.setDefaultPixel(&newDefaultPixel);
+
+                numAddedTiles++;
+            }
+
+            if (tile->row() == 0) {
+                visitedOriginalColumns.insert(tile->col());
+            }
+            iter.next();
+        }
+    }
+
+    // all the original tiles are visited, the added ones may be visited too
+    QCOMPARE(visitedOriginalColumns, QSet<int>({0, 1, 2, 3}));
+
+    QCOMPARE(numAddedTiles, 4);
+    QCOMPARE(dm.m_hashTable->numTiles(), 8);
+#endif
+}
+
 void KisTiledDataManagerTest::testUndoSetDefaultPixel()
 {
     quint8 defaultPixel = 0;
@@ -40,6 +40,12 @@ private Q_SLOTS:
     void testTransactions();
     void testPurgeHistory();
     void testUndoSetDefaultPixel();
+    void testMementoDeltaCompression();
+    void testTileDeduplication();
+    void testUniformTileCompaction();
+    void testReadForeignTileSize();
+    void testWriteFileTileSize();
+    void testIterationDoesNotBlockWriters();
 
     void benchmarkReadOnlyTileLazy();
     void benchmarkSharedPointers();
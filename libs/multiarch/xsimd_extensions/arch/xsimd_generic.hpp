@@ -63,6 +63,22 @@ inline T load_and_extend(const T2 *src) noexcept
         T{});
 }
 
+/******************************
+ * Narrowing unaligned stores *
+ ******************************/
+
+// Store the values of `src` into the array of `T2` elements.
+template<typename T2, typename T, typename A>
+inline void store_and_narrow(T2 *dst, const batch<T, A> &src) noexcept
+{
+    alignas(A::alignment()) std::array<T, batch<T, A>::size> buf;
+    src.store_aligned(buf.data());
+
+    for (size_t i = 0; i < batch<T, A>::size; i++) {
+        dst[i] = static_cast<T2>(buf[i]);
+    }
+}
+
 /*************************************************
  * Type-inferred, auto-aligned memory allocation *
  *************************************************/
@@ -39,6 +39,14 @@ inline auto set_one(const batch<T, A> &src, const batch_bool<T, A> &mask) noexce
 template<typename T, typename T2>
 inline T load_and_extend(const T2 *src) noexcept;
 
+/******************************
+ * Narrowing unaligned stores *
+ ******************************/
+
+// Store the values of `src` into the array of `T2` elements.
+template<typename T2, typename T, typename A>
+inline void store_and_narrow(T2 *dst, const batch<T, A> &src) noexcept;
+
 /*************************************************
  * Type-inferred, auto-aligned memory allocation *
  *************************************************/
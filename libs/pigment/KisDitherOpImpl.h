@@ -24,6 +24,7 @@
 
 #include "KisDitherOp.h"
 #include "KisDitherMaths.h"
+#include "KisOptimizedDitherOpFactory.h"
 
 template<typename srcCSTraits, typename dstCSTraits, DitherType dType> class KisDitherOpImpl : public KisDitherOp
 {
@@ -185,10 +186,21 @@ private:
     }
 };
 
+/**
+ * Creates a vectorized version of the dither op when it is available
+ * for the pair of the color spaces, otherwise falls back to the generic
+ * implementation.
+ */
+template<typename srcCSTraits, class dstCSTraits, DitherType dType> inline KisDitherOp *createDitherOp(const KoID &srcDepth, const KoID &dstDepth)
+{
+    KisDitherOp *op = KisOptimizedDitherOpFactory::create(srcDepth, dstDepth, srcCSTraits::channels_nb, srcCSTraits::alpha_pos, false, dType);
+    return op ? op : new KisDitherOpImpl<srcCSTraits, dstCSTraits, dType>(srcDepth, dstDepth);
+}
+
 template<typename srcCSTraits, class dstCSTraits> inline void addDitherOpsByDepth(KoColorSpace *cs, const KoID &dstDepth)
 {
     const KoID &srcDepth {cs->colorDepthId()};
     cs->addDitherOp(new KisDitherOpImpl<srcCSTraits, dstCSTraits, DITHER_NONE>(srcDepth, dstDepth));
-    cs->addDitherOp(new KisDitherOpImpl<srcCSTraits, dstCSTraits, DITHER_BAYER>(srcDepth, dstDepth));
-    cs->addDitherOp(new KisDitherOpImpl<srcCSTraits, dstCSTraits, DITHER_BLUE_NOISE>(srcDepth, dstDepth));
+    cs->addDitherOp(createDitherOp<srcCSTraits, dstCSTraits, DITHER_BAYER>(srcDepth, dstDepth));
+    cs->addDitherOp(createDitherOp<srcCSTraits, dstCSTraits, DITHER_BLUE_NOISE>(srcDepth, dstDepth));
 }
@@ -0,0 +1,325 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISOPTIMIZEDDITHEROP_H
+#define KISOPTIMIZEDDITHEROP_H
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#include <KoID.h>
+
+#include "KisDitherMaths.h"
+#include "KisDitherOp.h"
+#include "KoCmykColorSpaceMaths.h"
+#include "KoColorSpaceMaths.h"
+#include "KoMultiArchBuildSupport.h"
+
+/**
+ * Floating point CMYK color spaces store the color channels in
+ * [0, unitValueCMYK] range, integer ones use the standard range.
+ */
+template<typename channels_type, typename EnableDummyType = void>
+struct KisDitherCmykUnitValue
+{
+    static float value()
+    {
+        return KoColorSpaceMathsTraits<channels_type>::unitValue;
+    }
+};
+
+template<typename channels_type>
+struct KisDitherCmykUnitValue<channels_type,
+                              typename std::enable_if<!std::numeric_limits<channels_type>::is_integer>::type>
+{
+    static float value()
+    {
+        return KoCmykColorSpaceMathsTraits<channels_type>::unitValueCMYK;
+    }
+};
+
+/**
+ * The common part of the optimized dither ops: the per-pixel dithering
+ * and the math of a single channel. It follows KisDitherOpImpl and
+ * KisCmykDitherOpImpl exactly, so the ops can replace each other.
+ *
+ * The destination is expected to be an integer color space, otherwise
+ * the dithering is a no-op and there is no point in optimizing it.
+ */
+template<typename src_channels_type,
+         typename dst_channels_type,
+         int channels_nb,
+         int alpha_pos,
+         DitherType dType,
+         bool cmykNormalization>
+class KisOptimizedDitherOpBase : public KisDitherOp
+{
+    static_assert(std::numeric_limits<dst_channels_type>::is_integer,
+                  "the optimized dither ops support integer destinations only");
+
+    static_assert(dType == DITHER_BAYER || dType == DITHER_BLUE_NOISE,
+                  "the optimized dither ops support ordered and blue noise dithering only");
+
+public:
+    KisOptimizedDitherOpBase(const KoID &srcId, const KoID &dstId)
+        : m_srcDepthId(srcId)
+        , m_dstDepthId(dstId)
+    {
+    }
+
+    void dither(const quint8 *src, quint8 *dst, int x, int y) const override
+    {
+        const src_channels_type *nativeSrc = reinterpret_cast<const src_channels_type *>(src);
+        dst_channels_type *nativeDst = reinterpret_cast<dst_channels_type *>(dst);
+
+        const float f = factor(x, y);
+
+        for (int channelIndex = 0; channelIndex < channels_nb; ++channelIndex) {
+            nativeDst[channelIndex] = ditherChannel(nativeSrc[channelIndex], channelIndex, f);
+        }
+    }
+
+    KoID sourceDepthId() const override
+    {
+        return m_srcDepthId;
+    }
+
+    KoID destinationDepthId() const override
+    {
+        return m_dstDepthId;
+    }
+
+    DitherType type() const override
+    {
+        return dType;
+    }
+
+protected:
+    static constexpr float scale()
+    {
+        return 1.f / static_cast<float>(1 << KoColorSpaceMathsTraits<dst_channels_type>::bits);
+    }
+
+    static inline float factor(int x, int y)
+    {
+        return dType == DITHER_BAYER ? KisDitherMaths::dither_factor_bayer_8(x, y)
+                                     : KisDitherMaths::dither_factor_blue_noise_64(x, y);
+    }
+
+    static inline bool isCmykColorChannel(int channelIndex)
+    {
+        return cmykNormalization && channelIndex != alpha_pos;
+    }
+
+    static inline dst_channels_type ditherChannel(src_channels_type value, int channelIndex, float f)
+    {
+        if (!isCmykColorChannel(channelIndex)) {
+            float c = KoColorSpaceMaths<src_channels_type, float>::scaleToA(value);
+            c = KisDitherMaths::apply_dither(c, f, scale());
+            return KoColorSpaceMaths<float, dst_channels_type>::scaleToA(c);
+        } else {
+            // CMYK color channels are truncated, not rounded
+            const float unitValue = KoColorSpaceMathsTraits<dst_channels_type>::unitValue;
+
+            float c = static_cast<float>(value) / KisDitherCmykUnitValue<src_channels_type>::value();
+            c = KisDitherMaths::apply_dither(c, f, scale());
+            return static_cast<dst_channels_type>(qBound(0.f, c * unitValue, unitValue));
+        }
+    }
+
+private:
+    const KoID m_srcDepthId, m_dstDepthId;
+};
+
+template<typename src_channels_type,
+         typename dst_channels_type,
+         int channels_nb,
+         int alpha_pos,
+         DitherType dType,
+         bool cmykNormalization,
+         typename _impl,
+         typename EnableDummyType = void>
+class KisOptimizedDitherOp
+    : public KisOptimizedDitherOpBase<src_channels_type, dst_channels_type, channels_nb, alpha_pos, dType, cmykNormalization>
+{
+    using BaseClass = KisOptimizedDitherOpBase<src_channels_type, dst_channels_type, channels_nb, alpha_pos, dType, cmykNormalization>;
+
+public:
+    using BaseClass::BaseClass;
+    using BaseClass::dither;
+
+    void dither(const quint8 *srcRowStart, int srcRowStride, quint8 *dstRowStart, int dstRowStride, int x, int y, int columns, int rows) const override
+    {
+        for (int row = 0; row < rows; ++row) {
+            const src_channels_type *srcPtr = reinterpret_cast<const src_channels_type *>(srcRowStart);
+            dst_channels_type *dstPtr = reinterpret_cast<dst_channels_type *>(dstRowStart);
+
+            for (int col = 0; col < columns; ++col) {
+                const float f = BaseClass::factor(x + col, y + row);
+
+                for (int channelIndex = 0; channelIndex < channels_nb; ++channelIndex) {
+                    dstPtr[channelIndex] = BaseClass::ditherChannel(srcPtr[channelIndex], channelIndex, f);
+                }
+
+                srcPtr += channels_nb;
+                dstPtr += channels_nb;
+            }
+
+            srcRowStart += srcRowStride;
+            dstRowStart += dstRowStride;
+        }
+    }
+};
+
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+#include "KoStreamedMath.h"
+
+/**
+ * The vectorized version treats a row of pixels as a flat array of
+ * channels. Both dither patterns repeat every 64 pixels (the Bayer
+ * matrix is 8x8, the blue noise mask is 64x64), so the factors of
+ * a row are precalculated for 64 pixels and loaded as vectors of
+ * the same layout as the channels.
+ */
+template<typename src_channels_type,
+         typename dst_channels_type,
+         int channels_nb,
+         int alpha_pos,
+         DitherType dType,
+         bool cmykNormalization,
+         typename _impl>
+class KisOptimizedDitherOp<
+        src_channels_type, dst_channels_type, channels_nb, alpha_pos, dType, cmykNormalization, _impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+    : public KisOptimizedDitherOpBase<src_channels_type, dst_channels_type, channels_nb, alpha_pos, dType, cmykNormalization>
+{
+    using BaseClass = KisOptimizedDitherOpBase<src_channels_type, dst_channels_type, channels_nb, alpha_pos, dType, cmykNormalization>;
+
+    using float_v = typename KoStreamedMath<_impl>::float_v;
+    using int_v = typename KoStreamedMath<_impl>::int_v;
+
+    static constexpr int vectorSize = static_cast<int>(float_v::size);
+    static constexpr int patternSize = 64;
+    static constexpr int tablePeriod = patternSize * channels_nb;
+    static constexpr int tableSize = tablePeriod + vectorSize;
+
+public:
+    KisOptimizedDitherOp(const KoID &srcId, const KoID &dstId)
+        : BaseClass(srcId, dstId)
+    {
+        // the per-channel normalization repeats every pixel,
+        // which is a divisor of the table period
+        for (int i = 0; i < tableSize; ++i) {
+            const int channelIndex = i % channels_nb;
+
+            if (BaseClass::isCmykColorChannel(channelIndex)) {
+                m_srcUnitRec[i] = 1.f / KisDitherCmykUnitValue<src_channels_type>::value();
+                m_roundingOffset[i] = 0.f;
+            } else {
+                m_srcUnitRec[i] = 1.f / static_cast<float>(KoColorSpaceMathsTraits<src_channels_type>::unitValue);
+                m_roundingOffset[i] = 0.5f;
+            }
+        }
+    }
+
+    using BaseClass::dither;
+
+    void dither(const quint8 *srcRowStart, int srcRowStride, quint8 *dstRowStart, int dstRowStride, int x, int y, int columns, int rows) const override
+    {
+        const int numValues = columns * channels_nb;
+        const int block1 = numValues / vectorSize;
+        const int block2 = numValues % vectorSize;
+
+        const float_v srcUnitRec(1.f / static_cast<float>(KoColorSpaceMathsTraits<src_channels_type>::unitValue));
+        const float_v dstUnit(static_cast<float>(KoColorSpaceMathsTraits<dst_channels_type>::unitValue));
+        const float_v scale(BaseClass::scale());
+        const float_v zeroValue(0.f);
+        const float_v halfValue(0.5f);
+
+        float factors[tableSize];
+
+        // the pattern is shifted by x, so every row starts at the beginning of the table
+        const int tablePixels = std::min(columns, patternSize);
+
+        for (int row = 0; row < rows; ++row) {
+            for (int col = 0; col < tablePixels; ++col) {
+                std::fill_n(factors + col * channels_nb, channels_nb, BaseClass::factor(x + col, y + row));
+            }
+
+            if (columns > patternSize) {
+                std::copy_n(factors, vectorSize, factors + tablePeriod);
+            }
+
+            const src_channels_type *srcPtr = reinterpret_cast<const src_channels_type *>(srcRowStart);
+            dst_channels_type *dstPtr = reinterpret_cast<dst_channels_type *>(dstRowStart);
+
+            int tableOffset = 0;
+
+            for (int i = 0; i < block1; ++i) {
+                float_v c = loadChannels(srcPtr);
+                const float_v f = float_v::load_unaligned(factors + tableOffset);
+
+                if (cmykNormalization) {
+                    c *= float_v::load_unaligned(m_srcUnitRec + tableOffset);
+                } else {
+                    c *= srcUnitRec;
+                }
+
+                c += (f - c) * scale;
+                c = xsimd::min(xsimd::max(c * dstUnit, zeroValue), dstUnit);
+
+                if (cmykNormalization) {
+                    c += float_v::load_unaligned(m_roundingOffset + tableOffset);
+                } else {
+                    c += halfValue;
+                }
+
+                xsimd::store_and_narrow(dstPtr, xsimd::batch_cast<int>(c));
+
+                srcPtr += vectorSize;
+                dstPtr += vectorSize;
+
+                tableOffset += vectorSize;
+                if (tableOffset >= tablePeriod) {
+                    tableOffset -= tablePeriod;
+                }
+            }
+
+            for (int i = 0; i < block2; ++i) {
+                const int channelIndex = (tableOffset + i) % channels_nb;
+                dstPtr[i] = BaseClass::ditherChannel(srcPtr[i], channelIndex, factors[tableOffset + i]);
+            }
+
+            srcRowStart += srcRowStride;
+            dstRowStart += dstRowStride;
+        }
+    }
+
+private:
+    template<typename T = src_channels_type,
+             typename std::enable_if<std::numeric_limits<T>::is_integer, void>::type * = nullptr>
+    static ALWAYS_INLINE float_v loadChannels(const T *src)
+    {
+        return xsimd::batch_cast<float>(xsimd::load_and_extend<int_v>(src));
+    }
+
+    template<typename T = src_channels_type,
+             typename std::enable_if<!std::numeric_limits<T>::is_integer, void>::type * = nullptr>
+    static ALWAYS_INLINE float_v loadChannels(const T *src)
+    {
+        return float_v::load_unaligned(src);
+    }
+
+private:
+    float m_srcUnitRec[tableSize];
+    float m_roundingOffset[tableSize];
+};
+
+#endif /* defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE) */
+
+#endif // KISOPTIMIZEDDITHEROP_H
@@ -0,0 +1,75 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisOptimizedDitherOpFactory.h"
+
+#include <KoColorModelStandardIds.h>
+
+#include "KisOptimizedDitherOpFactoryImpl.h"
+
+namespace {
+
+template<typename src_channels_type, typename dst_channels_type>
+KisDitherOp *createForChannelTypes(const KoID &srcDepthId,
+                                   const KoID &dstDepthId,
+                                   int numChannels,
+                                   int alphaPos,
+                                   bool cmykNormalization,
+                                   DitherType type)
+{
+    if (cmykNormalization) {
+        if (numChannels == 5 && alphaPos == 4) {
+            return createOptimizedClass<
+                KisOptimizedDitherOpFactoryImpl<src_channels_type, dst_channels_type, 5, 4, true>>(srcDepthId, dstDepthId, type);
+        }
+    } else if (numChannels == 4 && alphaPos == 3) {
+        return createOptimizedClass<
+            KisOptimizedDitherOpFactoryImpl<src_channels_type, dst_channels_type, 4, 3, false>>(srcDepthId, dstDepthId, type);
+    } else if (numChannels == 2 && alphaPos == 1) {
+        return createOptimizedClass<
+            KisOptimizedDitherOpFactoryImpl<src_channels_type, dst_channels_type, 2, 1, false>>(srcDepthId, dstDepthId, type);
+    }
+
+    return nullptr;
+}
+
+template<typename src_channels_type>
+KisDitherOp *createForSourceChannelType(const KoID &srcDepthId,
+                                        const KoID &dstDepthId,
+                                        int numChannels,
+                                        int alphaPos,
+                                        bool cmykNormalization,
+                                        DitherType type)
+{
+    // dithering into floating point color spaces is a no-op
+    if (dstDepthId == Integer8BitsColorDepthID) {
+        return createForChannelTypes<src_channels_type, quint8>(srcDepthId, dstDepthId, numChannels, alphaPos, cmykNormalization, type);
+    } else if (dstDepthId == Integer16BitsColorDepthID) {
+        return createForChannelTypes<src_channels_type, quint16>(srcDepthId, dstDepthId, numChannels, alphaPos, cmykNormalization, type);
+    }
+
+    return nullptr;
+}
+
+}
+
+KisDitherOp *KisOptimizedDitherOpFactory::create(const KoID &srcDepthId, const KoID &dstDepthId, int numChannels, int alphaPos, bool cmykNormalization, DitherType type)
+{
+    if (type != DITHER_BAYER && type != DITHER_BLUE_NOISE) {
+        return nullptr;
+    }
+
+    // half-float sources don't have a fast vector load, so they stay scalar
+    if (srcDepthId == Integer8BitsColorDepthID) {
+        return createForSourceChannelType<quint8>(srcDepthId, dstDepthId, numChannels, alphaPos, cmykNormalization, type);
+    } else if (srcDepthId == Integer16BitsColorDepthID) {
+        return createForSourceChannelType<quint16>(srcDepthId, dstDepthId, numChannels, alphaPos, cmykNormalization, type);
+    } else if (srcDepthId == Float32BitsColorDepthID) {
+        return createForSourceChannelType<float>(srcDepthId, dstDepthId, numChannels, alphaPos, cmykNormalization, type);
+    }
+
+    return nullptr;
+}
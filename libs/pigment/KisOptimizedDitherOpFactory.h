@@ -0,0 +1,41 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISOPTIMIZEDDITHEROPFACTORY_H
+#define KISOPTIMIZEDDITHEROPFACTORY_H
+
+#include "kritapigment_export.h"
+
+#include <KoID.h>
+#include <KisDitherOp.h>
+
+/**
+ * Creates vectorized versions of the ordered (Bayer) and blue noise
+ * dither ops. The implementation is selected at runtime depending
+ * on the instruction set of the CPU.
+ */
+class KRITAPIGMENT_EXPORT KisOptimizedDitherOpFactory
+{
+public:
+    /**
+     * Creates a dither op of \p type for the pixels of \p numChannels
+     * channels with alpha at \p alphaPos. If \p cmykNormalization is
+     * true, the color channels of the floating point source are
+     * normalized with the CMYK unit value.
+     *
+     * Returns nullptr if there is no optimized version of the op: the
+     * source depth should be U8, U16 or F32, the destination depth U8
+     * or U16, and the pixel layout one of RGBA, GrayA or CMYKA.
+     */
+    static KisDitherOp* create(const KoID &srcDepthId,
+                               const KoID &dstDepthId,
+                               int numChannels,
+                               int alphaPos,
+                               bool cmykNormalization,
+                               DitherType type);
+};
+
+#endif // KISOPTIMIZEDDITHEROPFACTORY_H
@@ -0,0 +1,64 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisOptimizedDitherOpFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KisOptimizedDitherOp.h"
+
+template<typename src_channels_type, typename dst_channels_type, int channels_nb, int alpha_pos, bool cmykNormalization>
+template<typename _impl>
+KisDitherOp *
+KisOptimizedDitherOpFactoryImpl<src_channels_type, dst_channels_type, channels_nb, alpha_pos, cmykNormalization>::
+    create(const KoID &srcDepthId, const KoID &dstDepthId, DitherType type)
+{
+    switch (type) {
+    case DITHER_BAYER:
+        return new KisOptimizedDitherOp<src_channels_type,
+                                        dst_channels_type,
+                                        channels_nb,
+                                        alpha_pos,
+                                        DITHER_BAYER,
+                                        cmykNormalization,
+                                        _impl>(srcDepthId, dstDepthId);
+    case DITHER_BLUE_NOISE:
+        return new KisOptimizedDitherOp<src_channels_type,
+                                        dst_channels_type,
+                                        channels_nb,
+                                        alpha_pos,
+                                        DITHER_BLUE_NOISE,
+                                        cmykNormalization,
+                                        _impl>(srcDepthId, dstDepthId);
+    default:
+        return nullptr;
+    }
+}
+
+// RGB, Lab, XYZ, YCbCr
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<quint8,  quint8,  4, 3, false>::create<xsimd::current_arch>(const KoID &, const KoID &, DitherType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<quint8,  quint16, 4, 3, false>::create<xsimd::current_arch>(const KoID &, const KoID &, DitherType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<quint16, quint8,  4, 3, false>::create<xsimd::current_arch>(const KoID &, const KoID &, DitherType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<quint16, quint16, 4, 3, false>::create<xsimd::current_arch>(const KoID &, const KoID &, DitherType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<float,   quint8,  4, 3, false>::create<xsimd::current_arch>(const KoID &, const KoID &, DitherType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<float,   quint16, 4, 3, false>::create<xsimd::current_arch>(const KoID &, const KoID &, DitherType);
+
+// Gray
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<quint8,  quint8,  2, 1, false>::create<xsimd::current_arch>(const KoID &, const KoID &, DitherType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<quint8,  quint16, 2, 1, false>::create<xsimd::current_arch>(const KoID &, const KoID &, DitherType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<quint16, quint8,  2, 1, false>::create<xsimd::current_arch>(const KoID &, const KoID &, DitherType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<quint16, quint16, 2, 1, false>::create<xsimd::current_arch>(const KoID &, const KoID &, DitherType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<float,   quint8,  2, 1, false>::create<xsimd::current_arch>(const KoID &, const KoID &, DitherType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<float,   quint16, 2, 1, false>::create<xsimd::current_arch>(const KoID &, const KoID &, DitherType);
+
+// CMYK
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<quint8,  quint8,  5, 4, true >::create<xsimd::current_arch>(const KoID &, const KoID &, DitherType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<quint8,  quint16, 5, 4, true >::create<xsimd::current_arch>(const KoID &, const KoID &, DitherType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<quint16, quint8,  5, 4, true >::create<xsimd::current_arch>(const KoID &, const KoID &, DitherType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<quint16, quint16, 5, 4, true >::create<xsimd::current_arch>(const KoID &, const KoID &, DitherType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<float,   quint8,  5, 4, true >::create<xsimd::current_arch>(const KoID &, const KoID &, DitherType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<float,   quint16, 5, 4, true >::create<xsimd::current_arch>(const KoID &, const KoID &, DitherType);
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
@@ -0,0 +1,25 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISOPTIMIZEDDITHEROPFACTORYIMPL_H
+#define KISOPTIMIZEDDITHEROPFACTORYIMPL_H
+
+#include <KisDitherOp.h>
+#include <KoMultiArchBuildSupport.h>
+
+template<typename src_channels_type,
+         typename dst_channels_type,
+         int channels_nb,
+         int alpha_pos,
+         bool cmykNormalization>
+class KRITAPIGMENT_EXPORT KisOptimizedDitherOpFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KisDitherOp *create(const KoID &srcDepthId, const KoID &dstDepthId, DitherType type);
+};
+
+#endif // KISOPTIMIZEDDITHEROPFACTORYIMPL_H
@@ -7,7 +7,6 @@
 #include "KoColorConversionCache.h"
 
 #include <QHash>
-#include <QList>
 #include <QMutex>
 #include <QThreadStorage>
 
@@ -61,13 +60,94 @@ struct KoColorConversionCache::CachedTransformation {
     QAtomicInt use;
 };
 
-typedef QPair<KoColorConversionCacheKey, KoCachedColorConversionTransformation> FastPathCacheItem;
+/**
+ * A small per-thread cache of the recently used transformations. The
+ * lookup in it is lock-free and compares the color spaces by pointer,
+ * without dereferencing them.
+ *
+ * The items don't hold a reference to the transformation, it is owned
+ * by the shared cache. When any color space is destroyed, the global
+ * generation is incremented and all the per-thread caches drop their
+ * items on the next lookup.
+ */
+struct ThreadLocalCache {
+    static const int maxItems = 8;
+
+    struct Item {
+        const KoColorSpace* src;
+        const KoColorSpace* dst;
+        KoColorConversionTransformation::Intent renderingIntent;
+        KoColorConversionTransformation::ConversionFlags conversionFlags;
+        KoColorConversionCache::CachedTransformation* transfo;
+    };
+
+    KoColorConversionCache::CachedTransformation* find(const KoColorConversionCacheKey& key) const {
+        for (int i = 0; i < numItems; i++) {
+            const Item &item = items[i];
+            if (item.src == key.src && item.dst == key.dst &&
+                item.renderingIntent == key.renderingIntent &&
+                item.conversionFlags == key.conversionFlags) {
+
+                return item.transfo;
+            }
+        }
+        return 0;
+    }
 
-struct KoColorConversionCache::Private {
-    QMultiHash< KoColorConversionCacheKey, CachedTransformation*> cache;
+    void insert(const KoColorConversionCacheKey& key, KoColorConversionCache::CachedTransformation* transfo) {
+        Item &item = items[nextItem];
+        item.src = key.src;
+        item.dst = key.dst;
+        item.renderingIntent = key.renderingIntent;
+        item.conversionFlags = key.conversionFlags;
+        item.transfo = transfo;
+
+        numItems = qMax(numItems, nextItem + 1);
+        nextItem = (nextItem + 1) % maxItems;
+    }
+
+    void clear() {
+        numItems = 0;
+        nextItem = 0;
+    }
+
+    Item items[maxItems];
+    int numItems = 0;
+    int nextItem = 0;
+    int generation = 0;
+};
+
+/**
+ * The shared cache is split into several shards with separate locks,
+ * so the threads that miss their per-thread caches don't wait for each
+ * other unless they request the same conversion.
+ */
+struct CacheShard {
+    QMultiHash< KoColorConversionCacheKey, KoColorConversionCache::CachedTransformation*> cache;
     QMutex cacheMutex;
+};
+
+struct KoColorConversionCache::Private {
+    static const int numShards = 16;
+
+    CacheShard shards[numShards];
+    QAtomicInt generation;
 
-    QThreadStorage<FastPathCacheItem*> fastStorage;
+    QThreadStorage<ThreadLocalCache*> threadLocalStorage;
+
+    CacheShard& shardForKey(const KoColorConversionCacheKey& key) {
+        return shards[qHash(key) % numShards];
+    }
+
+    ThreadLocalCache* threadLocalCache() {
+        ThreadLocalCache *cache = threadLocalStorage.localData();
+        if (!cache) {
+            cache = new ThreadLocalCache();
+            cache->generation = generation.loadAcquire();
+            threadLocalStorage.setLocalData(cache);
+        }
+        return cache;
+    }
 };
 
 
@@ -77,8 +157,10 @@ KoColorConversionCache::KoColorConversionCache() : d(new Private)
 
 KoColorConversionCache::~KoColorConversionCache()
 {
-    Q_FOREACH (CachedTransformation* transfo, d->cache) {
-        delete transfo;
+    for (int i = 0; i < Private::numShards; i++) {
+        Q_FOREACH (CachedTransformation* transfo, d->shards[i].cache) {
+            delete transfo;
+        }
     }
     delete d;
 }
@@ -90,52 +172,58 @@ KoCachedColorConversionTransformation KoColorConversionCache::cachedConverter(co
 {
     KoColorConversionCacheKey key(src, dst, _renderingIntent, _conversionFlags);
 
-    FastPathCacheItem *cacheItem =
-        d->fastStorage.localData();
+    ThreadLocalCache *localCache = d->threadLocalCache();
 
-    if (cacheItem) {
-        if (cacheItem->first == key) {
-            return cacheItem->second;
-        }
+    const int generation = d->generation.loadAcquire();
+    if (localCache->generation != generation) {
+        localCache->clear();
+        localCache->generation = generation;
+    }
+
+    CachedTransformation *cachedTransfo = localCache->find(key);
+    if (cachedTransfo) {
+        return KoCachedColorConversionTransformation(cachedTransfo);
     }
 
-    cacheItem = 0;
+    CacheShard &shard = d->shardForKey(key);
 
-    QMutexLocker lock(&d->cacheMutex);
-    QList< CachedTransformation* > cachedTransfos = d->cache.values(key);
-    if (cachedTransfos.size() != 0) {
-        Q_FOREACH (CachedTransformation* ct, cachedTransfos) {
-            ct->transfo->setSrcColorSpace(src);
-            ct->transfo->setDstColorSpace(dst);
+    {
+        QMutexLocker lock(&shard.cacheMutex);
 
-            cacheItem = new FastPathCacheItem(key, KoCachedColorConversionTransformation(ct));
-            break;
+        auto it = shard.cache.constFind(key);
+        if (it != shard.cache.constEnd()) {
+            cachedTransfo = it.value();
+            cachedTransfo->transfo->setSrcColorSpace(src);
+            cachedTransfo->transfo->setDstColorSpace(dst);
+        } else {
+            KoColorConversionTransformation* transfo = src->createColorConverter(dst, _renderingIntent, _conversionFlags);
+            cachedTransfo = new CachedTransformation(transfo);
+            shard.cache.insert(key, cachedTransfo);
         }
     }
-    if (!cacheItem) {
-        KoColorConversionTransformation* transfo = src->createColorConverter(dst, _renderingIntent, _conversionFlags);
-        CachedTransformation* ct = new CachedTransformation(transfo);
-        d->cache.insert(key, ct);
-        cacheItem = new FastPathCacheItem(key, KoCachedColorConversionTransformation(ct));
-    }
 
-    d->fastStorage.setLocalData(cacheItem);
-    return cacheItem->second;
+    localCache->insert(key, cachedTransfo);
+    return KoCachedColorConversionTransformation(cachedTransfo);
 }
 
 void KoColorConversionCache::colorSpaceIsDestroyed(const KoColorSpace* cs)
 {
-    d->fastStorage.setLocalData(0);
-
-    QMutexLocker lock(&d->cacheMutex);
-    QMultiHash< KoColorConversionCacheKey, CachedTransformation*>::iterator endIt = d->cache.end();
-    for (QMultiHash< KoColorConversionCacheKey, CachedTransformation*>::iterator it = d->cache.begin(); it != endIt;) {
-        if (it.key().src == cs || it.key().dst == cs) {
-            Q_ASSERT(it.value()->isNotInUse()); // That's terribly evil, if that assert fails, that means that someone is using a color transformation with a color space which is currently being deleted
-            delete it.value();
-            it = d->cache.erase(it);
-        } else {
-            ++it;
+    // make all the per-thread caches drop their items
+    d->generation.ref();
+
+    for (int i = 0; i < Private::numShards; i++) {
+        CacheShard &shard = d->shards[i];
+
+        QMutexLocker lock(&shard.cacheMutex);
+        QMultiHash< KoColorConversionCacheKey, CachedTransformation*>::iterator endIt = shard.cache.end();
+        for (QMultiHash< KoColorConversionCacheKey, CachedTransformation*>::iterator it = shard.cache.begin(); it != endIt;) {
+            if (it.key().src == cs || it.key().dst == cs) {
+                Q_ASSERT(it.value()->isNotInUse()); // That's terribly evil, if that assert fails, that means that someone is using a color transformation with a color space which is currently being deleted
+                delete it.value();
+                it = shard.cache.erase(it);
+            } else {
+                ++it;
+            }
         }
     }
 }
@@ -15,6 +15,12 @@ class KoColorSpace;
 /**
  * This class holds a cache of KoColorConversionTransformations.
  *
+ * The cache is supposed to be used from many threads at once. Every
+ * thread keeps a few recently used transformations in its own storage,
+ * which doesn't need any locking. The shared storage is split into
+ * shards with separate locks. The transformations themselves are shared
+ * between the threads.
+ *
  * This class is not part of public API, and can be changed without notice.
  */
 class KoColorConversionCache
@@ -16,6 +16,7 @@
 #include "KoColorSpace.h"
 #include "KoCopyColorConversionTransformation.h"
 #include "KoMultipleColorConversionTransformation.h"
+#include "KoOptimizedRgbPixelConverterFactory.h"
 
 
 KoColorConversionSystem::KoColorConversionSystem(RegistryInterface *registryInterface)
@@ -224,6 +225,19 @@ KoColorConversionTransformation* KoColorConversionSystem::createColorConverter(c
     if (*srcColorSpace == *dstColorSpace) {
         return new KoCopyColorConversionTransformation(srcColorSpace);
     }
+
+    /**
+     * Depth conversions in the same RGB profile and conversions between
+     * sRGB and linear sRGB don't need color management at all, so they
+     * are done by optimized kernels instead of LCMS
+     */
+    KoColorConversionTransformation *optimizedTransfo =
+        KoOptimizedRgbPixelConverterFactory::createColorTransformation(srcColorSpace, dstColorSpace,
+                                                                       renderingIntent, conversionFlags);
+    if (optimizedTransfo) {
+        return optimizedTransfo;
+    }
+
     dbgPigmentCCS << srcColorSpace->id() << (srcColorSpace->profile() ? srcColorSpace->profile()->name() : "default");
     dbgPigmentCCS << dstColorSpace->id() << (dstColorSpace->profile() ? dstColorSpace->profile()->name() : "default");
     Path path = findBestPath(
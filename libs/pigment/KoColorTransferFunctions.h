@@ -141,6 +141,26 @@ ALWAYS_INLINE float removeSMPTE_ST_428Curve(float x) noexcept
     return (52.37f / 48.0f) * powf(x, 2.6f);
 }
 
+// IEC 61966-2-1, the values outside [0, 1] range are extended the
+// same way as LCMS does it in the unbounded mode
+ALWAYS_INLINE float applySrgbCurve(float x) noexcept
+{
+    if (x <= 0.0031308f) {
+        return x * 12.92f;
+    } else {
+        return 1.055f * powf(x, 1.f / 2.4f) - 0.055f;
+    }
+}
+
+ALWAYS_INLINE float removeSrgbCurve(float x) noexcept
+{
+    if (x <= 0.04045f) {
+        return x * (1.f / 12.92f);
+    } else {
+        return powf((x + 0.055f) * (1.f / 1.055f), 2.4f);
+    }
+}
+
 #include <KoMultiArchBuildSupport.h>
 
 #if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
@@ -182,6 +202,28 @@ struct KoColorTransferFunctions {
     {
         x = (52.37f / 48.0f) * xsimd::pow(x, float_v(2.6f));
     }
+
+    static ALWAYS_INLINE void applySrgbCurve(float_v &x) noexcept
+    {
+        constexpr float threshold = 0.0031308f;
+
+        const float_v x1 = x * 12.92f;
+        // the linear segment is selected for small values, so pow() is
+        // never fed with a negative value
+        const float_v x2 =
+            1.055f * xsimd::pow(xsimd::max(x, float_v(threshold)), float_v(1.f / 2.4f)) - 0.055f;
+        x = xsimd::select(x <= float_v(threshold), x1, x2);
+    }
+
+    static ALWAYS_INLINE void removeSrgbCurve(float_v &x) noexcept
+    {
+        constexpr float threshold = 0.04045f;
+
+        const float_v x1 = x * (1.f / 12.92f);
+        const float_v x2 =
+            xsimd::pow((xsimd::max(x, float_v(threshold)) + 0.055f) * (1.f / 1.055f), float_v(2.4f));
+        x = xsimd::select(x <= float_v(threshold), x1, x2);
+    }
 };
 
 #endif // HAVE_XSIMD
@@ -0,0 +1,211 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOOPTIMIZEDRGBPIXELCONVERTER_H
+#define KOOPTIMIZEDRGBPIXELCONVERTER_H
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#include "KoOptimizedRgbPixelConverterBase.h"
+#include "KoColorSpaceMaths.h"
+#include "KoColorTransferFunctions.h"
+#include "KoMultiArchBuildSupport.h"
+
+
+/**
+ * The integer RGB color spaces store the channels in BGRA order, the
+ * floating point ones in RGBA order. So when converting between them
+ * we need to swap red and blue channels.
+ */
+template<typename src_channels_type, typename dst_channels_type>
+constexpr bool rgbConversionNeedsSwap()
+{
+    return std::numeric_limits<src_channels_type>::is_integer !=
+        std::numeric_limits<dst_channels_type>::is_integer;
+}
+
+template<KoOptimizedRgbPixelConverterBase::CurvePolicy curvePolicy>
+ALWAYS_INLINE float applyRgbConversionCurve(float value)
+{
+    if (curvePolicy == KoOptimizedRgbPixelConverterBase::RemoveSrgbCurve) {
+        return removeSrgbCurve(value);
+    } else if (curvePolicy == KoOptimizedRgbPixelConverterBase::ApplySrgbCurve) {
+        return applySrgbCurve(value);
+    }
+    return value;
+}
+
+template<typename src_channels_type,
+         typename dst_channels_type,
+         KoOptimizedRgbPixelConverterBase::CurvePolicy curvePolicy>
+ALWAYS_INLINE void convertOneRgbPixelScalar(const src_channels_type *src, dst_channels_type *dst)
+{
+    const int redPos = 0;
+    const int bluePos = 2;
+    const int alphaPos = 3;
+
+    // copy the source pixel to allow in-place conversion
+    src_channels_type srcPixel[4];
+    std::copy(src, src + 4, srcPixel);
+    src = srcPixel;
+
+    for (int i = 0; i < 3; i++) {
+        const int dstIndex =
+            !rgbConversionNeedsSwap<src_channels_type, dst_channels_type>() ? i :
+            i == redPos ? bluePos :
+            i == bluePos ? redPos : i;
+
+        if (curvePolicy == KoOptimizedRgbPixelConverterBase::KeepTheSame) {
+            dst[dstIndex] = KoColorSpaceMaths<src_channels_type, dst_channels_type>::scaleToA(src[i]);
+        } else {
+            const float value = KoColorSpaceMaths<src_channels_type, float>::scaleToA(src[i]);
+            dst[dstIndex] = KoColorSpaceMaths<float, dst_channels_type>::scaleToA(
+                applyRgbConversionCurve<curvePolicy>(value));
+        }
+    }
+
+    dst[alphaPos] = KoColorSpaceMaths<src_channels_type, dst_channels_type>::scaleToA(src[alphaPos]);
+}
+
+template<typename src_channels_type,
+         typename dst_channels_type,
+         KoOptimizedRgbPixelConverterBase::CurvePolicy curvePolicy,
+         typename _impl,
+         typename EnableDummyType = void>
+struct KoOptimizedRgbPixelConverter : public KoOptimizedRgbPixelConverterBase
+{
+    void convertPixels(const quint8 *src, quint8 *dst, int numPixels) const override
+    {
+        const src_channels_type *srcPtr = reinterpret_cast<const src_channels_type*>(src);
+        dst_channels_type *dstPtr = reinterpret_cast<dst_channels_type*>(dst);
+
+        for (int i = 0; i < numPixels; i++) {
+            convertOneRgbPixelScalar<src_channels_type, dst_channels_type, curvePolicy>(srcPtr, dstPtr);
+
+            srcPtr += 4;
+            dstPtr += 4;
+        }
+    }
+};
+
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+#include "KoStreamedMath.h"
+
+template<typename channels_type>
+struct IsVectorizableRgbChannelType
+    : std::integral_constant<bool,
+                             std::is_same<channels_type, quint8>::value ||
+                             std::is_same<channels_type, quint16>::value ||
+                             std::is_same<channels_type, float>::value>
+{
+};
+
+/**
+ * PixelWrapper reads the channels in the order they are stored in
+ * memory, except the U8 version, which unpacks the pixel as a
+ * quint32, so that its first color channel is the last one in memory.
+ * Therefore the red channel is in the first register for U8 (BGRA)
+ * and F32 (RGBA) color spaces, and in the third register for U16
+ * (BGRA) ones.
+ */
+template<typename channels_type>
+constexpr bool redIsInFirstRegister()
+{
+    return !std::is_same<channels_type, quint16>::value;
+}
+
+template<typename src_channels_type,
+         typename dst_channels_type,
+         KoOptimizedRgbPixelConverterBase::CurvePolicy curvePolicy,
+         typename _impl>
+struct KoOptimizedRgbPixelConverter<
+        src_channels_type, dst_channels_type, curvePolicy, _impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value &&
+                                IsVectorizableRgbChannelType<src_channels_type>::value &&
+                                IsVectorizableRgbChannelType<dst_channels_type>::value>::type>
+    : public KoOptimizedRgbPixelConverterBase
+{
+    using float_v = typename KoStreamedMath<_impl>::float_v;
+
+    static constexpr bool dstIsInteger = std::numeric_limits<dst_channels_type>::is_integer;
+    static constexpr bool swapRegisters =
+        redIsInFirstRegister<src_channels_type>() != redIsInFirstRegister<dst_channels_type>();
+
+    void convertPixels(const quint8 *src, quint8 *dst, int numPixels) const override
+    {
+        const int block1 = numPixels / static_cast<int>(float_v::size);
+        const int block2 = numPixels % static_cast<int>(float_v::size);
+
+        const int srcVectorStride = 4 * sizeof(src_channels_type) * static_cast<int>(float_v::size);
+        const int dstVectorStride = 4 * sizeof(dst_channels_type) * static_cast<int>(float_v::size);
+
+        PixelWrapper<src_channels_type, _impl> srcWrapper;
+        PixelWrapper<dst_channels_type, _impl> dstWrapper;
+
+        const float_v srcUnitRec(1.0f / float(KoColorSpaceMathsTraits<src_channels_type>::unitValue));
+        const float_v dstUnit(float(KoColorSpaceMathsTraits<dst_channels_type>::unitValue));
+        const float_v zeroValue(0.0f);
+        const float_v oneValue(1.0f);
+
+        for (int i = 0; i < block1; i++) {
+            float_v c1;
+            float_v c2;
+            float_v c3;
+            float_v alpha;
+
+            // the alpha channel is already normalized by the wrapper
+            srcWrapper.read(src, c1, c2, c3, alpha);
+
+            c1 *= srcUnitRec;
+            c2 *= srcUnitRec;
+            c3 *= srcUnitRec;
+
+            if (swapRegisters) {
+                std::swap(c1, c3);
+            }
+
+            if (curvePolicy == KoOptimizedRgbPixelConverterBase::RemoveSrgbCurve) {
+                KoColorTransferFunctions<_impl>::removeSrgbCurve(c1);
+                KoColorTransferFunctions<_impl>::removeSrgbCurve(c2);
+                KoColorTransferFunctions<_impl>::removeSrgbCurve(c3);
+            } else if (curvePolicy == KoOptimizedRgbPixelConverterBase::ApplySrgbCurve) {
+                KoColorTransferFunctions<_impl>::applySrgbCurve(c1);
+                KoColorTransferFunctions<_impl>::applySrgbCurve(c2);
+                KoColorTransferFunctions<_impl>::applySrgbCurve(c3);
+            }
+
+            // the wrappers don't saturate the values on write
+            if (dstIsInteger) {
+                c1 = xsimd::min(xsimd::max(c1, zeroValue), oneValue);
+                c2 = xsimd::min(xsimd::max(c2, zeroValue), oneValue);
+                c3 = xsimd::min(xsimd::max(c3, zeroValue), oneValue);
+                alpha = xsimd::min(xsimd::max(alpha, zeroValue), oneValue);
+            }
+
+            dstWrapper.write(dst, c1 * dstUnit, c2 * dstUnit, c3 * dstUnit, alpha);
+
+            src += srcVectorStride;
+            dst += dstVectorStride;
+        }
+
+        const src_channels_type *srcPtr = reinterpret_cast<const src_channels_type*>(src);
+        dst_channels_type *dstPtr = reinterpret_cast<dst_channels_type*>(dst);
+
+        for (int i = 0; i < block2; i++) {
+            convertOneRgbPixelScalar<src_channels_type, dst_channels_type, curvePolicy>(srcPtr, dstPtr);
+
+            srcPtr += 4;
+            dstPtr += 4;
+        }
+    }
+};
+
+#endif /* defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE) */
+
+#endif // KOOPTIMIZEDRGBPIXELCONVERTER_H
@@ -0,0 +1,56 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOOPTIMIZEDRGBPIXELCONVERTERBASE_H
+#define KOOPTIMIZEDRGBPIXELCONVERTERBASE_H
+
+#include <QtGlobal>
+#include "kritapigment_export.h"
+
+/**
+ * @brief Converts pixels between two RGBA color spaces without LCMS
+ *
+ * Some conversions between RGBA color spaces don't need any color
+ * management at all:
+ *
+ * 1) conversion between two bit depths in the same profile is just
+ *    a scaling of the channel values;
+ *
+ * 2) conversion between an sRGB-TRC profile and a linear profile with
+ *    the same colorants and white point is just an application (or
+ *    removal) of the sRGB tone curve.
+ *
+ * Such conversions are requested quite often (image-wide depth
+ * conversions, layer thumbnails, linear working spaces), so they are
+ * done by a vectorized kernel instead of the generic LCMS transform.
+ * The kernel also takes care of the different channel order of the
+ * integer (BGRA) and floating point (RGBA) color spaces.
+ *
+ * The actual implementation is placed in class
+ * `KoOptimizedRgbPixelConverter`. Use `KoOptimizedRgbPixelConverterFactory`
+ * to create a version optimized for your CPU architecture.
+ */
+class KRITAPIGMENT_EXPORT KoOptimizedRgbPixelConverterBase
+{
+public:
+    enum CurvePolicy {
+        KeepTheSame,     ///< the profiles are the same, only the bit depth changes
+        RemoveSrgbCurve, ///< sRGB-TRC source, linear destination
+        ApplySrgbCurve   ///< linear source, sRGB-TRC destination
+    };
+
+public:
+    virtual ~KoOptimizedRgbPixelConverterBase();
+
+    /**
+     * Converts \p numPixels pixels from \p src into \p dst. The
+     * conversion can be done in-place if the pixel sizes of the color
+     * spaces are equal.
+     */
+    virtual void convertPixels(const quint8 *src, quint8 *dst, int numPixels) const = 0;
+};
+
+#endif // KOOPTIMIZEDRGBPIXELCONVERTERBASE_H
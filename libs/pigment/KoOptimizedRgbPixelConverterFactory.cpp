@@ -0,0 +1,184 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoOptimizedRgbPixelConverterFactory.h"
+
+#include <QScopedPointer>
+
+#include <KoColorModelStandardIds.h>
+#include <KoColorModelStandardIdsUtils.h>
+#include <KoColorProfile.h>
+#include <KoColorSpace.h>
+
+#include "KoOptimizedRgbPixelConverterFactoryImpl.h"
+
+namespace {
+
+template <typename src_channels_type>
+struct CreateConverterForSource
+{
+    template <typename dst_channels_type>
+    struct CreateConverter
+    {
+        KoOptimizedRgbPixelConverterBase *operator() (KoOptimizedRgbPixelConverterBase::CurvePolicy curvePolicy) {
+            return createOptimizedClass<
+                KoOptimizedRgbPixelConverterFactoryImpl<src_channels_type, dst_channels_type>>(curvePolicy);
+        }
+    };
+
+    KoOptimizedRgbPixelConverterBase *operator() (const KoID &dstDepthId, KoOptimizedRgbPixelConverterBase::CurvePolicy curvePolicy) {
+        return channelTypeForColorDepthId<CreateConverter>(dstDepthId, curvePolicy);
+    }
+};
+
+class KoOptimizedRgbColorConversionTransformation : public KoColorConversionTransformation
+{
+public:
+    KoOptimizedRgbColorConversionTransformation(const KoColorSpace *srcCs,
+                                                const KoColorSpace *dstCs,
+                                                Intent renderingIntent,
+                                                ConversionFlags conversionFlags,
+                                                KoOptimizedRgbPixelConverterBase::CurvePolicy curvePolicy)
+        : KoColorConversionTransformation(srcCs, dstCs, renderingIntent, conversionFlags),
+          m_converter(KoOptimizedRgbPixelConverterFactory::create(srcCs->colorDepthId(),
+                                                                  dstCs->colorDepthId(),
+                                                                  curvePolicy))
+    {
+    }
+
+    void transform(const quint8 *src, quint8 *dst, qint32 nPixels) const override {
+        m_converter->convertPixels(src, dst, nPixels);
+    }
+
+private:
+    QScopedPointer<KoOptimizedRgbPixelConverterBase> m_converter;
+};
+
+bool isSupportedDepth(const KoID &depthId)
+{
+    return depthId == Integer8BitsColorDepthID ||
+        depthId == Integer16BitsColorDepthID ||
+#ifdef HAVE_OPENEXR
+        depthId == Float16BitsColorDepthID ||
+#endif
+        depthId == Float32BitsColorDepthID;
+}
+
+/**
+ * The PQ color spaces are implemented with custom conversion links:
+ * the integer versions store the PQ-encoded values, the floating point
+ * ones store linear values, so the conversion between them is not just
+ * a scaling.
+ */
+bool isPQProfile(const KoColorProfile *profile)
+{
+    return profile->name() == "High Dynamic Range UHDTV Wide Color Gamut Display (Rec. 2020) - SMPTE ST 2084 PQ EOTF";
+}
+
+bool fuzzyCompareVectors(const QVector<qreal> &a, const QVector<qreal> &b)
+{
+    const qreal eps = 1e-4;
+
+    if (a.size() != b.size()) return false;
+
+    for (int i = 0; i < a.size(); i++) {
+        if (qAbs(a[i] - b[i]) > eps) return false;
+    }
+
+    return true;
+}
+
+bool hasSameColorants(const KoColorProfile *p1, const KoColorProfile *p2)
+{
+    return p1->hasColorants() && p2->hasColorants() &&
+        fuzzyCompareVectors(p1->getColorantsXYZ(), p2->getColorantsXYZ()) &&
+        fuzzyCompareVectors(p1->getWhitePointXYZ(), p2->getWhitePointXYZ());
+}
+
+bool hasSrgbTRC(const KoColorProfile *profile)
+{
+    if (!profile->hasTRC()) return false;
+
+    // compareTRC() checks the red curve only, so make sure the other
+    // curves are roughly the same
+    const QVector<qreal> estimatedTRC = profile->getEstimatedTRC();
+    if (estimatedTRC.size() < 3 ||
+        qAbs(estimatedTRC[0] - estimatedTRC[1]) > 1e-3 ||
+        qAbs(estimatedTRC[0] - estimatedTRC[2]) > 1e-3) {
+
+        return false;
+    }
+
+    return profile->compareTRC(TRC_IEC_61966_2_1, 1e-4f);
+}
+
+}
+
+KoOptimizedRgbPixelConverterBase *KoOptimizedRgbPixelConverterFactory::create(const KoID &srcDepthId, const KoID &dstDepthId, KoOptimizedRgbPixelConverterBase::CurvePolicy curvePolicy)
+{
+    return channelTypeForColorDepthId<CreateConverterForSource>(srcDepthId, dstDepthId, curvePolicy);
+}
+
+bool KoOptimizedRgbPixelConverterFactory::canConvertDirectly(const KoColorSpace *srcColorSpace, const KoColorSpace *dstColorSpace, KoOptimizedRgbPixelConverterBase::CurvePolicy *curvePolicy)
+{
+    if (srcColorSpace->colorModelId() != RGBAColorModelID ||
+        dstColorSpace->colorModelId() != RGBAColorModelID ||
+        !isSupportedDepth(srcColorSpace->colorDepthId()) ||
+        !isSupportedDepth(dstColorSpace->colorDepthId())) {
+
+        return false;
+    }
+
+    const KoColorProfile *srcProfile = srcColorSpace->profile();
+    const KoColorProfile *dstProfile = dstColorSpace->profile();
+
+    if (!srcProfile || !dstProfile ||
+        isPQProfile(srcProfile) || isPQProfile(dstProfile)) {
+
+        return false;
+    }
+
+    if (*srcProfile == *dstProfile) {
+        if (srcColorSpace->colorDepthId() == dstColorSpace->colorDepthId()) {
+            // should have been handled by KoCopyColorConversionTransformation
+            return false;
+        }
+
+        *curvePolicy = KoOptimizedRgbPixelConverterBase::KeepTheSame;
+        return true;
+    }
+
+    if (!hasSameColorants(srcProfile, dstProfile)) {
+        return false;
+    }
+
+    if (hasSrgbTRC(srcProfile) && dstProfile->isLinear()) {
+        *curvePolicy = KoOptimizedRgbPixelConverterBase::RemoveSrgbCurve;
+        return true;
+    }
+
+    if (srcProfile->isLinear() && hasSrgbTRC(dstProfile)) {
+        *curvePolicy = KoOptimizedRgbPixelConverterBase::ApplySrgbCurve;
+        return true;
+    }
+
+    return false;
+}
+
+KoColorConversionTransformation *KoOptimizedRgbPixelConverterFactory::createColorTransformation(const KoColorSpace *srcColorSpace, const KoColorSpace *dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags)
+{
+    KoOptimizedRgbPixelConverterBase::CurvePolicy curvePolicy = KoOptimizedRgbPixelConverterBase::KeepTheSame;
+
+    if (!canConvertDirectly(srcColorSpace, dstColorSpace, &curvePolicy)) {
+        return nullptr;
+    }
+
+    return new KoOptimizedRgbColorConversionTransformation(srcColorSpace,
+                                                           dstColorSpace,
+                                                           renderingIntent,
+                                                           conversionFlags,
+                                                           curvePolicy);
+}
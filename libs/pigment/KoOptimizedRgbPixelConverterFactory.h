@@ -0,0 +1,53 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOOPTIMIZEDRGBPIXELCONVERTERFACTORY_H
+#define KOOPTIMIZEDRGBPIXELCONVERTERFACTORY_H
+
+#include "kritapigment_export.h"
+
+#include <KoID.h>
+#include <KoOptimizedRgbPixelConverterBase.h>
+#include <KoColorConversionTransformation.h>
+
+class KoColorSpace;
+
+/**
+ * \see KoOptimizedRgbPixelConverterBase
+ */
+class KRITAPIGMENT_EXPORT KoOptimizedRgbPixelConverterFactory
+{
+public:
+    /**
+     * Creates a converter from RGBA color space with \p srcDepthId to
+     * RGBA color space with \p dstDepthId. The depths should be one of
+     * U8, U16, F16 or F32.
+     */
+    static KoOptimizedRgbPixelConverterBase* create(const KoID &srcDepthId,
+                                                    const KoID &dstDepthId,
+                                                    KoOptimizedRgbPixelConverterBase::CurvePolicy curvePolicy);
+
+    /**
+     * Checks whether the conversion from \p srcColorSpace to \p dstColorSpace
+     * can be done without color management (see KoOptimizedRgbPixelConverterBase).
+     * If it can, the corresponding curve policy is written into \p curvePolicy.
+     */
+    static bool canConvertDirectly(const KoColorSpace *srcColorSpace,
+                                   const KoColorSpace *dstColorSpace,
+                                   KoOptimizedRgbPixelConverterBase::CurvePolicy *curvePolicy);
+
+    /**
+     * Creates a color conversion transformation based on the optimized
+     * converter, or returns nullptr if the pair of the color spaces is
+     * not supported by the fast path.
+     */
+    static KoColorConversionTransformation* createColorTransformation(const KoColorSpace *srcColorSpace,
+                                                                      const KoColorSpace *dstColorSpace,
+                                                                      KoColorConversionTransformation::Intent renderingIntent,
+                                                                      KoColorConversionTransformation::ConversionFlags conversionFlags);
+};
+
+#endif // KOOPTIMIZEDRGBPIXELCONVERTERFACTORY_H
@@ -0,0 +1,68 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoOptimizedRgbPixelConverterFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KoOptimizedRgbPixelConverter.h"
+
+#include <KoConfig.h>
+#ifdef HAVE_OPENEXR
+#include <half.h>
+#endif
+
+template<typename src_channels_type, typename dst_channels_type>
+template<typename _impl>
+KoOptimizedRgbPixelConverterBase *
+KoOptimizedRgbPixelConverterFactoryImpl<src_channels_type, dst_channels_type>::
+    create(KoOptimizedRgbPixelConverterBase::CurvePolicy curvePolicy)
+{
+    switch (curvePolicy) {
+    case KoOptimizedRgbPixelConverterBase::RemoveSrgbCurve:
+        return new KoOptimizedRgbPixelConverter<src_channels_type,
+                                                dst_channels_type,
+                                                KoOptimizedRgbPixelConverterBase::RemoveSrgbCurve,
+                                                _impl>();
+    case KoOptimizedRgbPixelConverterBase::ApplySrgbCurve:
+        return new KoOptimizedRgbPixelConverter<src_channels_type,
+                                                dst_channels_type,
+                                                KoOptimizedRgbPixelConverterBase::ApplySrgbCurve,
+                                                _impl>();
+    case KoOptimizedRgbPixelConverterBase::KeepTheSame:
+    default:
+        return new KoOptimizedRgbPixelConverter<src_channels_type,
+                                                dst_channels_type,
+                                                KoOptimizedRgbPixelConverterBase::KeepTheSame,
+                                                _impl>();
+    }
+}
+
+template KoOptimizedRgbPixelConverterBase* KoOptimizedRgbPixelConverterFactoryImpl<quint8,  quint8 >::create<xsimd::current_arch>(KoOptimizedRgbPixelConverterBase::CurvePolicy);
+template KoOptimizedRgbPixelConverterBase* KoOptimizedRgbPixelConverterFactoryImpl<quint8,  quint16>::create<xsimd::current_arch>(KoOptimizedRgbPixelConverterBase::CurvePolicy);
+#ifdef HAVE_OPENEXR
+template KoOptimizedRgbPixelConverterBase* KoOptimizedRgbPixelConverterFactoryImpl<quint8,  half   >::create<xsimd::current_arch>(KoOptimizedRgbPixelConverterBase::CurvePolicy);
+#endif
+template KoOptimizedRgbPixelConverterBase* KoOptimizedRgbPixelConverterFactoryImpl<quint8,  float  >::create<xsimd::current_arch>(KoOptimizedRgbPixelConverterBase::CurvePolicy);
+template KoOptimizedRgbPixelConverterBase* KoOptimizedRgbPixelConverterFactoryImpl<quint16, quint8 >::create<xsimd::current_arch>(KoOptimizedRgbPixelConverterBase::CurvePolicy);
+template KoOptimizedRgbPixelConverterBase* KoOptimizedRgbPixelConverterFactoryImpl<quint16, quint16>::create<xsimd::current_arch>(KoOptimizedRgbPixelConverterBase::CurvePolicy);
+#ifdef HAVE_OPENEXR
+template KoOptimizedRgbPixelConverterBase* KoOptimizedRgbPixelConverterFactoryImpl<quint16, half   >::create<xsimd::current_arch>(KoOptimizedRgbPixelConverterBase::CurvePolicy);
+#endif
+template KoOptimizedRgbPixelConverterBase* KoOptimizedRgbPixelConverterFactoryImpl<quint16, float  >::create<xsimd::current_arch>(KoOptimizedRgbPixelConverterBase::CurvePolicy);
+#ifdef HAVE_OPENEXR
+template KoOptimizedRgbPixelConverterBase* KoOptimizedRgbPixelConverterFactoryImpl<half,    quint8 >::create<xsimd::current_arch>(KoOptimizedRgbPixelConverterBase::CurvePolicy);
+template KoOptimizedRgbPixelConverterBase* KoOptimizedRgbPixelConverterFactoryImpl<half,    quint16>::create<xsimd::current_arch>(KoOptimizedRgbPixelConverterBase::CurvePolicy);
+template KoOptimizedRgbPixelConverterBase* KoOptimizedRgbPixelConverterFactoryImpl<half,    half   >::create<xsimd::current_arch>(KoOptimizedRgbPixelConverterBase::CurvePolicy);
+template KoOptimizedRgbPixelConverterBase* KoOptimizedRgbPixelConverterFactoryImpl<half,    float  >::create<xsimd::current_arch>(KoOptimizedRgbPixelConverterBase::CurvePolicy);
+#endif
+template KoOptimizedRgbPixelConverterBase* KoOptimizedRgbPixelConverterFactoryImpl<float,   quint8 >::create<xsimd::current_arch>(KoOptimizedRgbPixelConverterBase::CurvePolicy);
+template KoOptimizedRgbPixelConverterBase* KoOptimizedRgbPixelConverterFactoryImpl<float,   quint16>::create<xsimd::current_arch>(KoOptimizedRgbPixelConverterBase::CurvePolicy);
+#ifdef HAVE_OPENEXR
+template KoOptimizedRgbPixelConverterBase* KoOptimizedRgbPixelConverterFactoryImpl<float,   half   >::create<xsimd::current_arch>(KoOptimizedRgbPixelConverterBase::CurvePolicy);
+#endif
+template KoOptimizedRgbPixelConverterBase* KoOptimizedRgbPixelConverterFactoryImpl<float,   float  >::create<xsimd::current_arch>(KoOptimizedRgbPixelConverterBase::CurvePolicy);
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
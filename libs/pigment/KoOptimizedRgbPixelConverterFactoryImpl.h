@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOOPTIMIZEDRGBPIXELCONVERTERFACTORYIMPL_H
+#define KOOPTIMIZEDRGBPIXELCONVERTERFACTORYIMPL_H
+
+#include <KoOptimizedRgbPixelConverterBase.h>
+#include <KoMultiArchBuildSupport.h>
+
+template<typename src_channels_type,
+         typename dst_channels_type>
+class KRITAPIGMENT_EXPORT KoOptimizedRgbPixelConverterFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KoOptimizedRgbPixelConverterBase *create(KoOptimizedRgbPixelConverterBase::CurvePolicy curvePolicy);
+};
+
+#endif // KOOPTIMIZEDRGBPIXELCONVERTERFACTORYIMPL_H
@@ -9,6 +9,12 @@
 #include <simpletest.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoColorSpace.h>
+#include <KoColorModelStandardIds.h>
+#include <KisDitherOp.h>
+
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
 
 #define NB_PIXELS 1000000
 
@@ -134,4 +140,133 @@ void KoColorSpacesBenchmark::benchmarkSetAlpha2IndividualCall()
     END_BENCHMARK
 }
 
+namespace {
+
+/**
+ * Converts tiny chunks of data into several color spaces in a row, so
+ * that most of the time is spent on fetching the transformation from
+ * the conversion cache
+ */
+class ConversionCacheJob : public QRunnable
+{
+public:
+    ConversionCacheJob(const KoColorSpace *srcColorSpace, const QVector<const KoColorSpace*> &dstColorSpaces)
+        : m_srcColorSpace(srcColorSpace),
+          m_dstColorSpaces(dstColorSpaces)
+    {
+    }
+
+    void run() override {
+        const int numPixels = 16;
+        const int numIterations = 20000;
+
+        QByteArray srcData(numPixels * m_srcColorSpace->pixelSize(), '\0');
+        QByteArray dstData(numPixels * 16, '\0');
+
+        for (int i = 0; i < numIterations; i++) {
+            m_srcColorSpace->convertPixelsTo(reinterpret_cast<const quint8*>(srcData.constData()),
+                                             reinterpret_cast<quint8*>(dstData.data()),
+                                             m_dstColorSpaces[i % m_dstColorSpaces.size()],
+                                             numPixels,
+                                             KoColorConversionTransformation::internalRenderingIntent(),
+                                             KoColorConversionTransformation::internalConversionFlags());
+        }
+    }
+
+private:
+    const KoColorSpace *m_srcColorSpace;
+    QVector<const KoColorSpace*> m_dstColorSpaces;
+};
+
+}
+
+void KoColorSpacesBenchmark::benchmarkConversionCacheContention()
+{
+    KoColorSpaceRegistry *registry = KoColorSpaceRegistry::instance();
+
+    const KoColorSpace *srcColorSpace = registry->rgb8();
+    const QVector<const KoColorSpace*> dstColorSpaces = {
+        registry->rgb16(),
+        registry->lab16(),
+        registry->colorSpace(RGBAColorModelID.id(), Float32BitsColorDepthID.id(), 0),
+        registry->graya8()
+    };
+
+    QVERIFY(srcColorSpace);
+    Q_FOREACH (const KoColorSpace *cs, dstColorSpaces) {
+        QVERIFY(cs);
+    }
+
+    // create all the transformations beforehand
+    ConversionCacheJob(srcColorSpace, dstColorSpaces).run();
+
+    const int numThreads = QThread::idealThreadCount();
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(numThreads);
+
+    QBENCHMARK {
+        for (int i = 0; i < numThreads; i++) {
+            threadPool.start(new ConversionCacheJob(srcColorSpace, dstColorSpaces));
+        }
+        threadPool.waitForDone();
+    }
+}
+
+void KoColorSpacesBenchmark::benchmarkDither_data()
+{
+    QTest::addColumn<QString>("modelID");
+    QTest::addColumn<QString>("depthID");
+    QTest::addColumn<int>("ditherType");
+
+    const QVector<KoID> models = {RGBAColorModelID, GrayAColorModelID, CMYKAColorModelID};
+    const QVector<KoID> depths = {Integer16BitsColorDepthID, Float32BitsColorDepthID};
+
+    Q_FOREACH (const KoID &model, models) {
+        Q_FOREACH (const KoID &depth, depths) {
+            QTest::newRow(QString("%1%2-bayer").arg(model.id(), depth.id()).toLatin1().data())
+                << model.id() << depth.id() << int(DITHER_BAYER);
+            QTest::newRow(QString("%1%2-blue-noise").arg(model.id(), depth.id()).toLatin1().data())
+                << model.id() << depth.id() << int(DITHER_BLUE_NOISE);
+        }
+    }
+}
+
+void KoColorSpacesBenchmark::benchmarkDither()
+{
+    QFETCH(QString, modelID);
+    QFETCH(QString, depthID);
+    QFETCH(int, ditherType);
+
+    const KoColorSpace *srcColorSpace = KoColorSpaceRegistry::instance()->colorSpace(modelID, depthID, 0);
+    QVERIFY(srcColorSpace);
+
+    const KisDitherOp *op = srcColorSpace->ditherOp(Integer8BitsColorDepthID.id(), DitherType(ditherType));
+    QVERIFY(op);
+
+    const int numColumns = 1024;
+    const int numRows = NB_PIXELS / numColumns;
+
+    const int srcPixelSize = srcColorSpace->pixelSize();
+    const int dstPixelSize = srcColorSpace->channelCount() * sizeof(quint8);
+
+    QVector<quint8> srcData(numColumns * numRows * srcPixelSize);
+    QVector<quint8> dstData(numColumns * numRows * dstPixelSize);
+
+    // fill the source with a gradient, the zero-filled buffer would
+    // be too simple to represent the real data
+    QVector<float> channels(srcColorSpace->channelCount());
+    for (int i = 0; i < numColumns * numRows; i++) {
+        for (int ch = 0; ch < channels.size(); ch++) {
+            channels[ch] = float((i + ch * 37) % 1000) / 999.0f;
+        }
+        srcColorSpace->fromNormalisedChannelsValue(srcData.data() + i * srcPixelSize, channels);
+    }
+
+    QBENCHMARK {
+        op->dither(srcData.constData(), numColumns * srcPixelSize,
+                   dstData.data(), numColumns * dstPixelSize,
+                   0, 0, numColumns, numRows);
+    }
+}
+
 SIMPLE_TEST_MAIN(KoColorSpacesBenchmark)
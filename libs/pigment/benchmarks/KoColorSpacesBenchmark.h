@@ -27,6 +27,9 @@ private Q_SLOTS:
     void benchmarkSetAlphaIndividualCall();
     void benchmarkSetAlpha2IndividualCall_data();
     void benchmarkSetAlpha2IndividualCall();
+    void benchmarkConversionCacheContention();
+    void benchmarkDither_data();
+    void benchmarkDither();
 };
 
 #endif
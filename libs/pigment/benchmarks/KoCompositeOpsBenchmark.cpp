@@ -8,6 +8,10 @@
 
 #include "../compositeops/KoCompositeOpAlphaDarken.h"
 #include "../compositeops/KoCompositeOpOver.h"
+#include "../compositeops/KoCompositeOpGeneric.h"
+#include "../compositeops/KoColorSpaceBlendingPolicy.h"
+#include <KoCompositeOpFunctions.h>
+#include <KoCompositeOpRegistry.h>
 #include <KoOptimizedCompositeOpFactory.h>
 
 #include <KoColorSpaceTraits.h>
@@ -29,11 +33,11 @@ const int TILES_IN_WIDTH = IMG_WIDTH / TILE_WIDTH;
 const int TILES_IN_HEIGHT = IMG_HEIGHT / TILE_HEIGHT;
 
 
-#define COMPOSITE_BENCHMARK \
+#define COMPOSITE_BENCHMARK_TRAITS(_Traits_) \
         for (int y = 0; y < TILES_IN_HEIGHT; y++){                                              \
             for (int x = 0; x < TILES_IN_WIDTH; x++) {                                           \
-                const int rowStride = IMG_WIDTH * KoBgrU8Traits::pixelSize;  \
-                const int bufOffset = y * rowStride + x * TILE_WIDTH * KoBgrU8Traits::pixelSize;  \
+                const int rowStride = IMG_WIDTH * _Traits_::pixelSize;  \
+                const int bufOffset = y * rowStride + x * TILE_WIDTH * _Traits_::pixelSize;  \
                 compositeOp->composite(m_dstBuffer + bufOffset, rowStride,      \
                                       m_srcBuffer + bufOffset, rowStride,      \
                                       m_mskBuffer + bufOffset, rowStride,                                                            \
@@ -42,9 +46,31 @@ const int TILES_IN_HEIGHT = IMG_HEIGHT / TILE_HEIGHT;
             }                                                                                   \
         }
 
+#define COMPOSITE_BENCHMARK COMPOSITE_BENCHMARK_TRAITS(KoBgrU8Traits)
+
+/**
+ * The random bytes written by init() are valid pixels for 8-bit
+ * colorspaces only, so the ops of other depths fill the buffers
+ * with the pixels of their own channel type
+ */
+template<typename channels_type>
+void fillRandomPixels(quint8 *srcBuffer, quint8 *dstBuffer)
+{
+    QRandomGenerator rng(42);
+
+    channels_type *src = reinterpret_cast<channels_type*>(srcBuffer);
+    channels_type *dst = reinterpret_cast<channels_type*>(dstBuffer);
+
+    for (int i = 0; i < IMG_WIDTH * IMG_HEIGHT * 4; i++) {
+        src[i] = KoColorSpaceMaths<float, channels_type>::scaleToA(float(rng.generateDouble()));
+        dst[i] = KoColorSpaceMaths<float, channels_type>::scaleToA(float(rng.generateDouble()));
+    }
+}
+
 void KoCompositeOpsBenchmark::initTestCase()
 {
-    const int bufLen = IMG_HEIGHT * IMG_WIDTH * KoBgrU8Traits::pixelSize;
+    // big enough for the biggest pixel used in the benchmarks
+    const int bufLen = IMG_HEIGHT * IMG_WIDTH * KoRgbF32Traits::pixelSize;
 
     m_dstBuffer = new quint8[bufLen];
     m_srcBuffer = new quint8[bufLen];
@@ -56,7 +82,7 @@ void KoCompositeOpsBenchmark::init()
 {
     QRandomGenerator rng(42);
 
-    for (int i = 0; i < int(IMG_WIDTH * IMG_HEIGHT * KoBgrU8Traits::pixelSize); i++) {
+    for (int i = 0; i < int(IMG_WIDTH * IMG_HEIGHT * KoRgbF32Traits::pixelSize); i++) {
         const int randVal = rng.bounded(RAND_MAX);
 
         m_srcBuffer[i] = randVal & 0x0000FF;
@@ -98,5 +124,251 @@ void KoCompositeOpsBenchmark::benchmarkCompositeAlphaDarkenCreamy()
     }
 }
 
+void KoCompositeOpsBenchmark::benchmarkCompositeMultiply()
+{
+    QScopedPointer<KoCompositeOp> compositeOp(
+        KoOptimizedCompositeOpFactory::createGenericSCOp32(KoColorSpaceRegistry::instance()->rgb8(),
+                                                           COMPOSITE_MULT, KoCompositeOp::categoryArithmetic()));
+    if (!compositeOp) {
+        QSKIP("No optimized version of the op is available");
+    }
+
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeMultiplyScalar()
+{
+    QScopedPointer<KoCompositeOp> compositeOp(
+        new KoCompositeOpGenericSC<KoBgrU8Traits, &cfMultiply<quint8>, KoAdditiveBlendingPolicy<KoBgrU8Traits>>(
+            KoColorSpaceRegistry::instance()->rgb8(), COMPOSITE_MULT, KoCompositeOp::categoryArithmetic()));
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeScreen()
+{
+    QScopedPointer<KoCompositeOp> compositeOp(
+        KoOptimizedCompositeOpFactory::createGenericSCOp32(KoColorSpaceRegistry::instance()->rgb8(),
+                                                           COMPOSITE_SCREEN, KoCompositeOp::categoryLight()));
+    if (!compositeOp) {
+        QSKIP("No optimized version of the op is available");
+    }
+
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeScreenScalar()
+{
+    QScopedPointer<KoCompositeOp> compositeOp(
+        new KoCompositeOpGenericSC<KoBgrU8Traits, &cfScreen<quint8>, KoAdditiveBlendingPolicy<KoBgrU8Traits>>(
+            KoColorSpaceRegistry::instance()->rgb8(), COMPOSITE_SCREEN, KoCompositeOp::categoryLight()));
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeOverlay()
+{
+    QScopedPointer<KoCompositeOp> compositeOp(
+        KoOptimizedCompositeOpFactory::createGenericSCOp32(KoColorSpaceRegistry::instance()->rgb8(),
+                                                           COMPOSITE_OVERLAY, KoCompositeOp::categoryMix()));
+    if (!compositeOp) {
+        QSKIP("No optimized version of the op is available");
+    }
+
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeOverlayScalar()
+{
+    QScopedPointer<KoCompositeOp> compositeOp(
+        new KoCompositeOpGenericSCFunctor<KoBgrU8Traits, CFOverlay<quint8>, KoAdditiveBlendingPolicy<KoBgrU8Traits>>(
+            KoColorSpaceRegistry::instance()->rgb8(), COMPOSITE_OVERLAY, KoCompositeOp::categoryMix()));
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeMultiplyU16()
+{
+    QScopedPointer<KoCompositeOp> compositeOp(
+        KoOptimizedCompositeOpFactory::createGenericSCOpU64(KoColorSpaceRegistry::instance()->rgb16(),
+                                                           COMPOSITE_MULT, KoCompositeOp::categoryArithmetic()));
+    if (!compositeOp) {
+        QSKIP("No optimized version of the op is available");
+    }
+
+    fillRandomPixels<quint16>(m_srcBuffer, m_dstBuffer);
+
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK_TRAITS(KoBgrU16Traits)
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeMultiplyU16Scalar()
+{
+    QScopedPointer<KoCompositeOp> compositeOp(
+        new KoCompositeOpGenericSC<KoBgrU16Traits, &cfMultiply<quint16>, KoAdditiveBlendingPolicy<KoBgrU16Traits>>(
+            KoColorSpaceRegistry::instance()->rgb16(), COMPOSITE_MULT, KoCompositeOp::categoryArithmetic()));
+
+    fillRandomPixels<quint16>(m_srcBuffer, m_dstBuffer);
+
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK_TRAITS(KoBgrU16Traits)
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeMultiplyF32()
+{
+    QScopedPointer<KoCompositeOp> compositeOp(
+        KoOptimizedCompositeOpFactory::createGenericSCOp128(KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", ""),
+                                                           COMPOSITE_MULT, KoCompositeOp::categoryArithmetic()));
+    if (!compositeOp) {
+        QSKIP("No optimized version of the op is available");
+    }
+
+    fillRandomPixels<float>(m_srcBuffer, m_dstBuffer);
+
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK_TRAITS(KoRgbF32Traits)
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeMultiplyF32Scalar()
+{
+    QScopedPointer<KoCompositeOp> compositeOp(
+        new KoCompositeOpGenericSC<KoRgbF32Traits, &cfMultiply<float>, KoAdditiveBlendingPolicy<KoRgbF32Traits>>(
+            KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", ""), COMPOSITE_MULT, KoCompositeOp::categoryArithmetic()));
+
+    fillRandomPixels<float>(m_srcBuffer, m_dstBuffer);
+
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK_TRAITS(KoRgbF32Traits)
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeScreenU16()
+{
+    QScopedPointer<KoCompositeOp> compositeOp(
+        KoOptimizedCompositeOpFactory::createGenericSCOpU64(KoColorSpaceRegistry::instance()->rgb16(),
+                                                           COMPOSITE_SCREEN, KoCompositeOp::categoryLight()));
+    if (!compositeOp) {
+        QSKIP("No optimized version of the op is available");
+    }
+
+    fillRandomPixels<quint16>(m_srcBuffer, m_dstBuffer);
+
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK_TRAITS(KoBgrU16Traits)
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeScreenU16Scalar()
+{
+    QScopedPointer<KoCompositeOp> compositeOp(
+        new KoCompositeOpGenericSC<KoBgrU16Traits, &cfScreen<quint16>, KoAdditiveBlendingPolicy<KoBgrU16Traits>>(
+            KoColorSpaceRegistry::instance()->rgb16(), COMPOSITE_SCREEN, KoCompositeOp::categoryLight()));
+
+    fillRandomPixels<quint16>(m_srcBuffer, m_dstBuffer);
+
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK_TRAITS(KoBgrU16Traits)
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeScreenF32()
+{
+    QScopedPointer<KoCompositeOp> compositeOp(
+        KoOptimizedCompositeOpFactory::createGenericSCOp128(KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", ""),
+                                                           COMPOSITE_SCREEN, KoCompositeOp::categoryLight()));
+    if (!compositeOp) {
+        QSKIP("No optimized version of the op is available");
+    }
+
+    fillRandomPixels<float>(m_srcBuffer, m_dstBuffer);
+
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK_TRAITS(KoRgbF32Traits)
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeScreenF32Scalar()
+{
+    QScopedPointer<KoCompositeOp> compositeOp(
+        new KoCompositeOpGenericSC<KoRgbF32Traits, &cfScreen<float>, KoAdditiveBlendingPolicy<KoRgbF32Traits>>(
+            KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", ""), COMPOSITE_SCREEN, KoCompositeOp::categoryLight()));
+
+    fillRandomPixels<float>(m_srcBuffer, m_dstBuffer);
+
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK_TRAITS(KoRgbF32Traits)
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeOverlayU16()
+{
+    QScopedPointer<KoCompositeOp> compositeOp(
+        KoOptimizedCompositeOpFactory::createGenericSCOpU64(KoColorSpaceRegistry::instance()->rgb16(),
+                                                           COMPOSITE_OVERLAY, KoCompositeOp::categoryMix()));
+    if (!compositeOp) {
+        QSKIP("No optimized version of the op is available");
+    }
+
+    fillRandomPixels<quint16>(m_srcBuffer, m_dstBuffer);
+
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK_TRAITS(KoBgrU16Traits)
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeOverlayU16Scalar()
+{
+    QScopedPointer<KoCompositeOp> compositeOp(
+        new KoCompositeOpGenericSCFunctor<KoBgrU16Traits, CFOverlay<quint16>, KoAdditiveBlendingPolicy<KoBgrU16Traits>>(
+            KoColorSpaceRegistry::instance()->rgb16(), COMPOSITE_OVERLAY, KoCompositeOp::categoryMix()));
+
+    fillRandomPixels<quint16>(m_srcBuffer, m_dstBuffer);
+
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK_TRAITS(KoBgrU16Traits)
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeOverlayF32()
+{
+    QScopedPointer<KoCompositeOp> compositeOp(
+        KoOptimizedCompositeOpFactory::createGenericSCOp128(KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", ""),
+                                                           COMPOSITE_OVERLAY, KoCompositeOp::categoryMix()));
+    if (!compositeOp) {
+        QSKIP("No optimized version of the op is available");
+    }
+
+    fillRandomPixels<float>(m_srcBuffer, m_dstBuffer);
+
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK_TRAITS(KoRgbF32Traits)
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeOverlayF32Scalar()
+{
+    QScopedPointer<KoCompositeOp> compositeOp(
+        new KoCompositeOpGenericSCFunctor<KoRgbF32Traits, CFOverlay<float>, KoAdditiveBlendingPolicy<KoRgbF32Traits>>(
+            KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", ""), COMPOSITE_OVERLAY, KoCompositeOp::categoryMix()));
+
+    fillRandomPixels<float>(m_srcBuffer, m_dstBuffer);
+
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK_TRAITS(KoRgbF32Traits)
+    }
+}
+
 
 QTEST_GUILESS_MAIN(KoCompositeOpsBenchmark)
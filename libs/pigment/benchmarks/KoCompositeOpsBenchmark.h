@@ -22,6 +22,28 @@ private Q_SLOTS:
     void benchmarkCompositeAlphaDarkenHard();
     void benchmarkCompositeAlphaDarkenCreamy();
 
+    void benchmarkCompositeMultiply();
+    void benchmarkCompositeMultiplyScalar();
+    void benchmarkCompositeScreen();
+    void benchmarkCompositeScreenScalar();
+    void benchmarkCompositeOverlay();
+    void benchmarkCompositeOverlayScalar();
+
+    void benchmarkCompositeMultiplyU16();
+    void benchmarkCompositeMultiplyU16Scalar();
+    void benchmarkCompositeMultiplyF32();
+    void benchmarkCompositeMultiplyF32Scalar();
+
+    void benchmarkCompositeScreenU16();
+    void benchmarkCompositeScreenU16Scalar();
+    void benchmarkCompositeScreenF32();
+    void benchmarkCompositeScreenF32Scalar();
+
+    void benchmarkCompositeOverlayU16();
+    void benchmarkCompositeOverlayU16Scalar();
+    void benchmarkCompositeOverlayF32();
+    void benchmarkCompositeOverlayF32Scalar();
+
 private:
     quint8 * m_dstBuffer;
     quint8 * m_srcBuffer;
@@ -56,6 +56,21 @@ struct OptimizedOpsSelector
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return new KoCompositeOpCopy2<Traits>(cs);
     }
+
+    static KoCompositeOp* createBehindOp(const KoColorSpace *cs) {
+        return new KoCompositeOpBehind<Traits, KoAdditiveBlendingPolicy<Traits>>(cs);
+    }
+
+    static KoCompositeOp* createEraseOp(const KoColorSpace *cs) {
+        return new KoCompositeOpErase<Traits>(cs);
+    }
+
+    static KoCompositeOp* createGenericSCOp(const KoColorSpace *cs, const QString& id, const QString& category) {
+        Q_UNUSED(cs);
+        Q_UNUSED(id);
+        Q_UNUSED(category);
+        return nullptr;
+    }
 };
 
 template<>
@@ -73,6 +88,18 @@ struct OptimizedOpsSelector<KoBgrU8Traits>
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createCopyOp32(cs);
     }
+
+    static KoCompositeOp* createBehindOp(const KoColorSpace *cs) {
+        return new KoCompositeOpBehind<KoBgrU8Traits, KoAdditiveBlendingPolicy<KoBgrU8Traits>>(cs);
+    }
+
+    static KoCompositeOp* createEraseOp(const KoColorSpace *cs) {
+        return new KoCompositeOpErase<KoBgrU8Traits>(cs);
+    }
+
+    static KoCompositeOp* createGenericSCOp(const KoColorSpace *cs, const QString& id, const QString& category) {
+        return KoOptimizedCompositeOpFactory::createGenericSCOp32(cs, id, category);
+    }
 };
 
 template<>
@@ -89,6 +116,21 @@ struct OptimizedOpsSelector<KoLabU8Traits>
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createCopyOp32(cs);
     }
+
+    static KoCompositeOp* createBehindOp(const KoColorSpace *cs) {
+        return new KoCompositeOpBehind<KoLabU8Traits, KoAdditiveBlendingPolicy<KoLabU8Traits>>(cs);
+    }
+
+    static KoCompositeOp* createEraseOp(const KoColorSpace *cs) {
+        return new KoCompositeOpErase<KoLabU8Traits>(cs);
+    }
+
+    static KoCompositeOp* createGenericSCOp(const KoColorSpace *cs, const QString& id, const QString& category) {
+        Q_UNUSED(cs);
+        Q_UNUSED(id);
+        Q_UNUSED(category);
+        return nullptr;
+    }
 };
 
 template<>
@@ -106,6 +148,18 @@ struct OptimizedOpsSelector<KoRgbF32Traits>
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createCopyOp128(cs);
     }
+
+    static KoCompositeOp* createBehindOp(const KoColorSpace *cs) {
+        return new KoCompositeOpBehind<KoRgbF32Traits, KoAdditiveBlendingPolicy<KoRgbF32Traits>>(cs);
+    }
+
+    static KoCompositeOp* createEraseOp(const KoColorSpace *cs) {
+        return new KoCompositeOpErase<KoRgbF32Traits>(cs);
+    }
+
+    static KoCompositeOp* createGenericSCOp(const KoColorSpace *cs, const QString& id, const QString& category) {
+        return KoOptimizedCompositeOpFactory::createGenericSCOp128(cs, id, category);
+    }
 };
 
 template<>
@@ -123,6 +177,18 @@ struct OptimizedOpsSelector<KoBgrU16Traits>
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createCopyOpU64(cs);
     }
+
+    static KoCompositeOp* createBehindOp(const KoColorSpace *cs) {
+        return KoOptimizedCompositeOpFactory::createBehindOpU64(cs);
+    }
+
+    static KoCompositeOp* createEraseOp(const KoColorSpace *cs) {
+        return KoOptimizedCompositeOpFactory::createEraseOpU64(cs);
+    }
+
+    static KoCompositeOp* createGenericSCOp(const KoColorSpace *cs, const QString& id, const QString& category) {
+        return KoOptimizedCompositeOpFactory::createGenericSCOpU64(cs, id, category);
+    }
 };
 
 
@@ -143,7 +209,8 @@ struct AddGeneralOps<Traits, true>
                 cs->addCompositeOp(new KoCompositeOpGenericSC<Traits, func, KoAdditiveBlendingPolicy<Traits>>(cs, id, category));
             }
         } else {
-            cs->addCompositeOp(new KoCompositeOpGenericSC<Traits, func, KoAdditiveBlendingPolicy<Traits>>(cs, id, category));
+            KoCompositeOp *op = OptimizedOpsSelector<Traits>::createGenericSCOp(cs, id, category);
+            cs->addCompositeOp(op ? op : new KoCompositeOpGenericSC<Traits, func, KoAdditiveBlendingPolicy<Traits>>(cs, id, category));
         }
      }
 
@@ -156,7 +223,8 @@ struct AddGeneralOps<Traits, true>
                  cs->addCompositeOp(new KoCompositeOpGenericSCFunctor<Traits, Functor, KoAdditiveBlendingPolicy<Traits>>(cs, id, category));
              }
          } else {
-             cs->addCompositeOp(new KoCompositeOpGenericSCFunctor<Traits, Functor, KoAdditiveBlendingPolicy<Traits>>(cs, id, category));
+             KoCompositeOp *op = OptimizedOpsSelector<Traits>::createGenericSCOp(cs, id, category);
+             cs->addCompositeOp(op ? op : new KoCompositeOpGenericSCFunctor<Traits, Functor, KoAdditiveBlendingPolicy<Traits>>(cs, id, category));
          }
      }
 
@@ -166,7 +234,7 @@ struct AddGeneralOps<Traits, true>
          cs->addCompositeOp(OptimizedOpsSelector<Traits>::createOverOp(cs));
          cs->addCompositeOp(OptimizedOpsSelector<Traits>::createAlphaDarkenOp(cs));
          cs->addCompositeOp(OptimizedOpsSelector<Traits>::createCopyOp(cs));
-         cs->addCompositeOp(new KoCompositeOpErase<Traits>(cs));
+         cs->addCompositeOp(OptimizedOpsSelector<Traits>::createEraseOp(cs));
 
          if constexpr (std::is_base_of_v<KoCmykTraits<typename Traits::channels_type>, Traits>) {
             if (useSubtractiveBlendingForCmykColorSpaces()) {
@@ -175,7 +243,7 @@ struct AddGeneralOps<Traits, true>
                 cs->addCompositeOp(new KoCompositeOpBehind<Traits, KoAdditiveBlendingPolicy<Traits>>(cs));
             }
          } else {
-            cs->addCompositeOp(new KoCompositeOpBehind<Traits, KoAdditiveBlendingPolicy<Traits>>(cs));
+            cs->addCompositeOp(OptimizedOpsSelector<Traits>::createBehindOp(cs));
          }
 
          cs->addCompositeOp(new KoCompositeOpDestinationIn<Traits>(cs));
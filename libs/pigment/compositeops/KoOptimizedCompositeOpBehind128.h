@@ -0,0 +1,210 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPBEHIND128_H
+#define KOOPTIMIZEDCOMPOSITEOPBEHIND128_H
+
+#include "KoCompositeOpBase.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoStreamedMath.h"
+
+/**
+ * The math of KoCompositeOpBehind for the additive colorspaces: the
+ * source is painted as if it was placed *below* the destination:
+ *
+ * newAlpha = dstAlpha + srcAlpha - dstAlpha * srcAlpha
+ * newColor = (srcColor * srcAlpha * (1 - dstAlpha) + dstColor * dstAlpha) / newAlpha
+ */
+template<typename channels_type, bool alphaLocked, bool allChannelsFlag>
+struct BehindCompositor128 {
+    struct ParamsWrapper {
+        ParamsWrapper(const KoCompositeOp::ParameterInfo& params)
+            : channelFlags(params.channelFlags)
+        {
+        }
+        const QBitArray &channelFlags;
+    };
+
+    /**
+     * Normalized alpha of a fully opaque pixel. It is calculated exactly
+     * the same way as PixelWrapper does it, so the values can be compared
+     * directly.
+     */
+    template<typename _impl>
+    static ALWAYS_INLINE float opaqueAlpha()
+    {
+        float alpha = KoColorSpaceMathsTraits<channels_type>::unitValue;
+        PixelWrapper<channels_type, _impl>::normalizeAlpha(alpha);
+        return alpha;
+    }
+
+    // \see docs in AlphaDarkenCompositor32
+    template<bool haveMask, bool src_aligned, typename _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        Q_UNUSED(oparams);
+
+        using float_v = typename KoStreamedMath<_impl>::float_v;
+        using float_m = typename float_v::batch_bool_type;
+
+        float_v src_alpha;
+        float_v dst_alpha;
+
+        float_v src_c1;
+        float_v src_c2;
+        float_v src_c3;
+
+        PixelWrapper<channels_type, _impl> dataWrapper;
+        dataWrapper.read(src, src_c1, src_c2, src_c3, src_alpha);
+
+        src_alpha *= float_v(opacity);
+
+        if (haveMask) {
+            const float_v uint8MaxRec1(1.0f / 255.0f);
+            const float_v mask_vec = KoStreamedMath<_impl>::fetch_mask_8(mask);
+            src_alpha *= mask_vec * uint8MaxRec1;
+        }
+
+        const float_v zeroValue(0.0f);
+        const float_v oneValue(1.0f);
+
+        // The source cannot change the colors in the destination,
+        // since its fully transparent
+        if (xsimd::all(src_alpha == zeroValue)) {
+            return;
+        }
+
+        float_v dst_c1;
+        float_v dst_c2;
+        float_v dst_c3;
+
+        dataWrapper.read(dst, dst_c1, dst_c2, dst_c3, dst_alpha);
+
+        // The source is fully covered by the opaque destination
+        const float_m unchanged = (src_alpha == zeroValue) | (dst_alpha == float_v(opaqueAlpha<_impl>()));
+
+        if (xsimd::all(unchanged)) {
+            return;
+        }
+
+        // the new alpha is never null when the source is not transparent
+        const float_v new_alpha = dst_alpha + src_alpha - dst_alpha * src_alpha;
+        const float_v new_alpha_rec = oneValue / xsimd::select(unchanged, oneValue, new_alpha);
+
+        const float_v src_weight = src_alpha * (oneValue - dst_alpha) * new_alpha_rec;
+        const float_v dst_weight = dst_alpha * new_alpha_rec;
+
+        dst_c1 = xsimd::select(unchanged, dst_c1, src_c1 * src_weight + dst_c1 * dst_weight);
+        dst_c2 = xsimd::select(unchanged, dst_c2, src_c2 * src_weight + dst_c2 * dst_weight);
+        dst_c3 = xsimd::select(unchanged, dst_c3, src_c3 * src_weight + dst_c3 * dst_weight);
+
+        dataWrapper.write(dst, dst_c1, dst_c2, dst_c3, xsimd::select(unchanged, dst_alpha, new_alpha));
+    }
+
+    template<bool haveMask, typename _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src,
+                                                      quint8 *dst,
+                                                      const quint8 *mask,
+                                                      float opacity,
+                                                      const ParamsWrapper &oparams)
+    {
+        const qint32 alpha_pos = 3;
+
+        const auto *s = reinterpret_cast<const channels_type*>(src);
+        auto *d = reinterpret_cast<channels_type*>(dst);
+
+        float srcAlpha = s[alpha_pos];
+        PixelWrapper<channels_type, _impl>::normalizeAlpha(srcAlpha);
+        srcAlpha *= opacity;
+
+        if (haveMask) {
+            const float uint8Rec1 = 1.0f / 255.0f;
+            srcAlpha *= float(*mask) * uint8Rec1;
+        }
+
+        float dstAlpha = d[alpha_pos];
+        PixelWrapper<channels_type, _impl>::normalizeAlpha(dstAlpha);
+
+        // see KoCompositeOpBase::genericComposite()
+        if (!allChannelsFlag && dstAlpha == 0.0f) {
+            KoStreamedMathFunctions::clearPixel<4 * sizeof(channels_type)>(dst);
+        }
+
+        if (dstAlpha == opaqueAlpha<_impl>() || srcAlpha == 0.0f) return;
+
+        const float newAlpha = dstAlpha + srcAlpha - dstAlpha * srcAlpha;
+        const float newAlphaRec = 1.0f / newAlpha;
+
+        const float srcWeight = srcAlpha * (1.0f - dstAlpha) * newAlphaRec;
+        const float dstWeight = dstAlpha * newAlphaRec;
+
+        for (int i = 0; i < 3; i++) {
+            if (!allChannelsFlag && !oparams.channelFlags.at(i)) continue;
+
+            // don't blend if the color of the destination is undefined
+            d[i] = dstAlpha != 0.0f ?
+                PixelWrapper<channels_type, _impl>::roundFloatToUint(s[i] * srcWeight + d[i] * dstWeight) :
+                s[i];
+        }
+
+        if (!alphaLocked) {
+            float dstAlphaNative = newAlpha;
+            PixelWrapper<channels_type, _impl>::denormalizeAlpha(dstAlphaNative);
+            d[alpha_pos] = PixelWrapper<channels_type, _impl>::roundFloatToUint(dstAlphaNative);
+        }
+    }
+};
+
+/**
+ * An optimized version of KoCompositeOpBehind for the use in 8 byte
+ * colorspaces with 16-bit channels and alpha channel placed at the
+ * last position: C1_C2_C3_A.
+ */
+template<typename _impl>
+class KoOptimizedCompositeOpBehindU64 : public KoCompositeOp
+{
+public:
+    KoOptimizedCompositeOpBehindU64(const KoColorSpace* cs)
+        : KoCompositeOp(cs, COMPOSITE_BEHIND, KoCompositeOp::categoryMix()) {}
+
+    using KoCompositeOp::composite;
+
+    void composite(const KoCompositeOp::ParameterInfo& params) const override
+    {
+        if(params.maskRowStart) {
+            composite<true>(params);
+        } else {
+            composite<false>(params);
+        }
+    }
+
+    template <bool haveMask>
+    inline void composite(const KoCompositeOp::ParameterInfo& params) const {
+        if (params.channelFlags.isEmpty() ||
+            params.channelFlags == QBitArray(4, true)) {
+
+            KoStreamedMath<_impl>::template genericComposite64<haveMask, false, BehindCompositor128<quint16, false, true> >(params);
+        } else {
+            const bool allChannelsFlag =
+                params.channelFlags.at(0) &&
+                params.channelFlags.at(1) &&
+                params.channelFlags.at(2);
+
+            const bool alphaLocked =
+                !params.channelFlags.at(3);
+
+            if (allChannelsFlag && alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite64_novector<haveMask, false, BehindCompositor128<quint16, true, true> >(params);
+            } else if (!allChannelsFlag && !alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite64_novector<haveMask, false, BehindCompositor128<quint16, false, false> >(params);
+            } else /*if (!allChannelsFlag && alphaLocked) */{
+                KoStreamedMath<_impl>::template genericComposite64_novector<haveMask, false, BehindCompositor128<quint16, true, false> >(params);
+            }
+        }
+    }
+};
+
+#endif // KOOPTIMIZEDCOMPOSITEOPBEHIND128_H
@@ -0,0 +1,127 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPERASE128_H
+#define KOOPTIMIZEDCOMPOSITEOPERASE128_H
+
+#include "KoCompositeOpBase.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoStreamedMath.h"
+
+/**
+ * The math of KoCompositeOpErase: the alpha of the destination is
+ * multiplied by the inverted alpha of the source, the color channels
+ * are kept unchanged. Like the generic op, the compositor ignores the
+ * channel flags.
+ */
+template<typename channels_type>
+struct EraseCompositor128 {
+    struct ParamsWrapper {
+        ParamsWrapper(const KoCompositeOp::ParameterInfo& params)
+        {
+            Q_UNUSED(params);
+        }
+    };
+
+    // \see docs in AlphaDarkenCompositor32
+    template<bool haveMask, bool src_aligned, typename _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        Q_UNUSED(oparams);
+
+        using float_v = typename KoStreamedMath<_impl>::float_v;
+
+        float_v src_alpha;
+        float_v dst_alpha;
+
+        float_v src_c1;
+        float_v src_c2;
+        float_v src_c3;
+
+        PixelWrapper<channels_type, _impl> dataWrapper;
+        dataWrapper.read(src, src_c1, src_c2, src_c3, src_alpha);
+
+        src_alpha *= float_v(opacity);
+
+        if (haveMask) {
+            const float_v uint8MaxRec1(1.0f / 255.0f);
+            const float_v mask_vec = KoStreamedMath<_impl>::fetch_mask_8(mask);
+            src_alpha *= mask_vec * uint8MaxRec1;
+        }
+
+        // The transparent source erases nothing
+        if (xsimd::all(src_alpha == float_v(0.0f))) {
+            return;
+        }
+
+        float_v dst_c1;
+        float_v dst_c2;
+        float_v dst_c3;
+
+        /**
+         * The color channels are written back as they are: the integer
+         * values are represented in float exactly, so there is no
+         * rounding error
+         */
+        dataWrapper.read(dst, dst_c1, dst_c2, dst_c3, dst_alpha);
+        dst_alpha *= float_v(1.0f) - src_alpha;
+        dataWrapper.write(dst, dst_c1, dst_c2, dst_c3, dst_alpha);
+    }
+
+    template<bool haveMask, typename _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src,
+                                                      quint8 *dst,
+                                                      const quint8 *mask,
+                                                      float opacity,
+                                                      const ParamsWrapper &oparams)
+    {
+        Q_UNUSED(oparams);
+
+        const qint32 alpha_pos = 3;
+
+        const auto *s = reinterpret_cast<const channels_type*>(src);
+        auto *d = reinterpret_cast<channels_type*>(dst);
+
+        float srcAlpha = s[alpha_pos];
+        PixelWrapper<channels_type, _impl>::normalizeAlpha(srcAlpha);
+        srcAlpha *= opacity;
+
+        if (haveMask) {
+            const float uint8Rec1 = 1.0f / 255.0f;
+            srcAlpha *= float(*mask) * uint8Rec1;
+        }
+
+        if (srcAlpha == 0.0f) return;
+
+        d[alpha_pos] = PixelWrapper<channels_type, _impl>::roundFloatToUint(d[alpha_pos] * (1.0f - srcAlpha));
+    }
+};
+
+/**
+ * An optimized version of KoCompositeOpErase for the use in 8 byte
+ * colorspaces with 16-bit channels and alpha channel placed at the
+ * last position: C1_C2_C3_A.
+ */
+template<typename _impl>
+class KoOptimizedCompositeOpEraseU64 : public KoCompositeOp
+{
+public:
+    KoOptimizedCompositeOpEraseU64(const KoColorSpace* cs)
+        : KoCompositeOp(cs, COMPOSITE_ERASE, KoCompositeOp::categoryMix()) {}
+
+    using KoCompositeOp::composite;
+
+    void composite(const KoCompositeOp::ParameterInfo& params) const override
+    {
+        if(params.maskRowStart) {
+            KoStreamedMath<_impl>::template genericComposite64<true, false, EraseCompositor128<quint16> >(params);
+        } else {
+            KoStreamedMath<_impl>::template genericComposite64<false, false, EraseCompositor128<quint16> >(params);
+        }
+    }
+};
+
+#endif // KOOPTIMIZEDCOMPOSITEOPERASE128_H
@@ -7,6 +7,23 @@
 #include "KoOptimizedCompositeOpFactoryPerArch.h"
 #include "KoOptimizedCompositeOpFactory.h"
 
+#include <KoCompositeOpRegistry.h>
+
+namespace {
+bool hasOptimizedGenericSCOp(const QString &id)
+{
+    return id == COMPOSITE_MULT ||
+        id == COMPOSITE_SCREEN ||
+        id == COMPOSITE_OVERLAY ||
+        id == COMPOSITE_DARKEN ||
+        id == COMPOSITE_LIGHTEN ||
+        id == COMPOSITE_ADD ||
+        id == COMPOSITE_LINEAR_DODGE ||
+        id == COMPOSITE_SUBTRACT ||
+        id == COMPOSITE_DIFF;
+}
+}
+
 KoCompositeOp* KoOptimizedCompositeOpFactory::createAlphaDarkenOpHard32(const KoColorSpace *cs)
 {
     return createOptimizedClass<
@@ -78,3 +95,31 @@ KoCompositeOp* KoOptimizedCompositeOpFactory::createCopyOpU64(const KoColorSpace
 {
     return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopyU64> >(cs);
 }
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createBehindOpU64(const KoColorSpace *cs)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpBehindU64> >(cs);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createEraseOpU64(const KoColorSpace *cs)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpEraseU64> >(cs);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericSCOp32(const KoColorSpace *cs, const QString &id, const QString &category)
+{
+    if (!hasOptimizedGenericSCOp(id)) return nullptr;
+    return createOptimizedClass<KoOptimizedCompositeOpGenericSCFactoryPerArch<quint8> >(cs, id, category);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericSCOpU64(const KoColorSpace *cs, const QString &id, const QString &category)
+{
+    if (!hasOptimizedGenericSCOp(id)) return nullptr;
+    return createOptimizedClass<KoOptimizedCompositeOpGenericSCFactoryPerArch<quint16> >(cs, id, category);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericSCOp128(const KoColorSpace *cs, const QString &id, const QString &category)
+{
+    if (!hasOptimizedGenericSCOp(id)) return nullptr;
+    return createOptimizedClass<KoOptimizedCompositeOpGenericSCFactoryPerArch<float> >(cs, id, category);
+}
@@ -11,6 +11,7 @@
 
 class KoCompositeOp;
 class KoColorSpace;
+class QString;
 
 /**
  * The creation of the optimized composite ops is moved into a separate
@@ -39,6 +40,18 @@ public:
     static KoCompositeOp* createCopyOp32(const KoColorSpace *cs);
     static KoCompositeOp* createAlphaDarkenOpHardU64(const KoColorSpace *cs);
     static KoCompositeOp* createAlphaDarkenOpCreamyU64(const KoColorSpace *cs);
+    static KoCompositeOp* createBehindOpU64(const KoColorSpace *cs);
+    static KoCompositeOp* createEraseOpU64(const KoColorSpace *cs);
+
+    /**
+     * Create an optimized version of a separable blend mode \p id for
+     * RGBA colorspaces with 8-bit, 16-bit or 32-bit float channels. The
+     * functions return null if there is no optimized version of the blend
+     * mode or the vector instructions are not available on the CPU.
+     */
+    static KoCompositeOp* createGenericSCOp32(const KoColorSpace *cs, const QString &id, const QString &category);
+    static KoCompositeOp* createGenericSCOpU64(const KoColorSpace *cs, const QString &id, const QString &category);
+    static KoCompositeOp* createGenericSCOp128(const KoColorSpace *cs, const QString &id, const QString &category);
 };
 
 #endif /* KOOPTIMIZEDCOMPOSITEOPFACTORY_H */
@@ -13,6 +13,9 @@
 #include "KoOptimizedCompositeOpOver32.h"
 #include "KoOptimizedCompositeOpOver128.h"
 #include "KoOptimizedCompositeOpCopy128.h"
+#include "KoOptimizedCompositeOpBehind128.h"
+#include "KoOptimizedCompositeOpErase128.h"
+#include "KoOptimizedCompositeOpGenericSC.h"
 
 #include <KoCompositeOpRegistry.h>
 
@@ -124,4 +127,78 @@ KoCompositeOp *KoOptimizedCompositeOpFactoryPerArch<
     return new KoOptimizedCompositeOpAlphaDarkenCreamyU64<xsimd::current_arch>(param);
 }
 
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpBehindU64>::create<
+    xsimd::current_arch>(const KoColorSpace *param)
+{
+    return new KoOptimizedCompositeOpBehindU64<xsimd::current_arch>(param);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpEraseU64>::create<
+    xsimd::current_arch>(const KoColorSpace *param)
+{
+    return new KoOptimizedCompositeOpEraseU64<xsimd::current_arch>(param);
+}
+
+namespace {
+template<typename channels_type>
+KoCompositeOp *createGenericSCOp(const KoColorSpace *cs, const QString &id, const QString &category)
+{
+    using namespace KoOptimizedBlendFunctions;
+    using _impl = xsimd::current_arch;
+
+    if (id == COMPOSITE_MULT) {
+        return new KoOptimizedCompositeOpGenericSC<channels_type, Multiply, _impl>(cs, id, category);
+    } else if (id == COMPOSITE_SCREEN) {
+        return new KoOptimizedCompositeOpGenericSC<channels_type, Screen, _impl>(cs, id, category);
+    } else if (id == COMPOSITE_OVERLAY) {
+        return new KoOptimizedCompositeOpGenericSC<channels_type, Overlay, _impl>(cs, id, category);
+    } else if (id == COMPOSITE_DARKEN) {
+        return new KoOptimizedCompositeOpGenericSC<channels_type, Darken, _impl>(cs, id, category);
+    } else if (id == COMPOSITE_LIGHTEN) {
+        return new KoOptimizedCompositeOpGenericSC<channels_type, Lighten, _impl>(cs, id, category);
+    } else if (id == COMPOSITE_ADD || id == COMPOSITE_LINEAR_DODGE) {
+        return new KoOptimizedCompositeOpGenericSC<channels_type, Addition, _impl>(cs, id, category);
+    } else if (id == COMPOSITE_SUBTRACT) {
+        return new KoOptimizedCompositeOpGenericSC<channels_type, Subtract, _impl>(cs, id, category);
+    } else if (id == COMPOSITE_DIFF) {
+        return new KoOptimizedCompositeOpGenericSC<channels_type, Difference, _impl>(cs, id, category);
+    }
+
+    return nullptr;
+}
+} // namespace
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericSCFactoryPerArch<quint8>::create<
+    xsimd::current_arch>(const KoColorSpace *param, const QString &id, const QString &category)
+{
+    return createGenericSCOp<quint8>(param, id, category);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericSCFactoryPerArch<quint16>::create<
+    xsimd::current_arch>(const KoColorSpace *param, const QString &id, const QString &category)
+{
+    return createGenericSCOp<quint16>(param, id, category);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericSCFactoryPerArch<float>::create<
+    xsimd::current_arch>(const KoColorSpace *param, const QString &id, const QString &category)
+{
+    return createGenericSCOp<float>(param, id, category);
+}
+
 #endif // XSIMD_UNIVERSAL_BUILD_PASS
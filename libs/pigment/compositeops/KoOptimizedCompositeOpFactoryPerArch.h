@@ -12,6 +12,7 @@
 
 class KoCompositeOp;
 class KoColorSpace;
+class QString;
 
 template<typename _impl>
 class KoOptimizedCompositeOpAlphaDarkenCreamy32;
@@ -49,10 +50,28 @@ class KoOptimizedCompositeOpCopyU64;
 template<typename _impl>
 class KoOptimizedCompositeOpCopy32;
 
+template<typename _impl>
+class KoOptimizedCompositeOpBehindU64;
+
+template<typename _impl>
+class KoOptimizedCompositeOpEraseU64;
+
 template<template<typename I> class CompositeOp>
 struct KoOptimizedCompositeOpFactoryPerArch {
     template<typename _impl>
     static KoCompositeOp *create(const KoColorSpace *);
 };
 
+/**
+ * Creates an optimized version of a separable blend mode \p id
+ * (see KoOptimizedCompositeOpGenericSC.h) for an RGBA colorspace
+ * with \p channels_type channels. Returns null if the blend mode
+ * has no optimized version.
+ */
+template<typename channels_type>
+struct KoOptimizedCompositeOpGenericSCFactoryPerArch {
+    template<typename _impl>
+    static KoCompositeOp *create(const KoColorSpace *, const QString &id, const QString &category);
+};
+
 #endif /* KOOPTIMIZEDCOMPOSITEOPFACTORYPERARCH_H */
@@ -12,6 +12,9 @@
 #include "KoAlphaDarkenParamsWrapper.h"
 #include "KoCompositeOpOver.h"
 #include "KoCompositeOpCopy2.h"
+#include "KoCompositeOpBehind.h"
+#include "KoCompositeOpErase.h"
+#include "KoColorSpaceBlendingPolicy.h"
 
 template<>
 template<>
@@ -121,3 +124,52 @@ KoCompositeOp *KoOptimizedCompositeOpFactoryPerArch<
     return new KoCompositeOpAlphaDarken<KoBgrU16Traits, KoAlphaDarkenParamsWrapperCreamy>(param);
 }
 
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpBehindU64>::create<
+    xsimd::generic>(const KoColorSpace *param)
+{
+    return new KoCompositeOpBehind<KoBgrU16Traits, KoAdditiveBlendingPolicy<KoBgrU16Traits>>(param);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpEraseU64>::create<
+    xsimd::generic>(const KoColorSpace *param)
+{
+    return new KoCompositeOpErase<KoBgrU16Traits>(param);
+}
+
+/**
+ * The scalar builds use the generic implementation of the blend
+ * modes from KoCompositeOps.h
+ */
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericSCFactoryPerArch<quint8>::create<
+    xsimd::generic>(const KoColorSpace *, const QString &, const QString &)
+{
+    return nullptr;
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericSCFactoryPerArch<quint16>::create<
+    xsimd::generic>(const KoColorSpace *, const QString &, const QString &)
+{
+    return nullptr;
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericSCFactoryPerArch<float>::create<
+    xsimd::generic>(const KoColorSpace *, const QString &, const QString &)
+{
+    return nullptr;
+}
@@ -0,0 +1,391 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPGENERICSC_H
+#define KOOPTIMIZEDCOMPOSITEOPGENERICSC_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "KoCompositeOpBase.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoStreamedMath.h"
+
+/**
+ * Vectorized versions of the most popular separable blend functions
+ * from KoCompositeOpFunctions.h. All the functions work on channel
+ * values normalized into [0, 1] range (float channels may go out of
+ * this range), so the same code is used for U8, U16 and F32 pixels.
+ *
+ * The math follows KoCompositeOpGenericSC exactly, but the integer
+ * color spaces are calculated in floating point, so the result may
+ * differ from the scalar op by one in the least significant bit.
+ */
+namespace KoOptimizedBlendFunctions
+{
+
+ALWAYS_INLINE float min(float a, float b) { return std::min(a, b); }
+ALWAYS_INLINE float max(float a, float b) { return std::max(a, b); }
+ALWAYS_INLINE float abs(float a) { return std::abs(a); }
+ALWAYS_INLINE float select(bool cond, float a, float b) { return cond ? a : b; }
+
+template<typename A>
+ALWAYS_INLINE xsimd::batch<float, A> min(const xsimd::batch<float, A> &a, const xsimd::batch<float, A> &b)
+{
+    return xsimd::min(a, b);
+}
+
+template<typename A>
+ALWAYS_INLINE xsimd::batch<float, A> max(const xsimd::batch<float, A> &a, const xsimd::batch<float, A> &b)
+{
+    return xsimd::max(a, b);
+}
+
+template<typename A>
+ALWAYS_INLINE xsimd::batch<float, A> abs(const xsimd::batch<float, A> &a)
+{
+    return xsimd::abs(a);
+}
+
+template<typename A>
+ALWAYS_INLINE xsimd::batch<float, A> select(const xsimd::batch_bool<float, A> &cond, const xsimd::batch<float, A> &a, const xsimd::batch<float, A> &b)
+{
+    return xsimd::select(cond, a, b);
+}
+
+/**
+ * Every blend function has \c clampSourceToSDR flag, which follows
+ * the clamping policy of the corresponding scalar functor (see
+ * KoCompositeOpGenericFunctorBase.h) and the \c blend() method.
+ * The \c isInteger template parameter tells if the result should
+ * be clamped to the range of an integer channel.
+ */
+
+// cfMultiply
+struct Multiply {
+    static constexpr bool clampSourceToSDR = false;
+
+    template<bool isInteger, typename T>
+    static ALWAYS_INLINE T blend(const T &src, const T &dst)
+    {
+        return src * dst;
+    }
+};
+
+// cfScreen
+struct Screen {
+    static constexpr bool clampSourceToSDR = false;
+
+    template<bool isInteger, typename T>
+    static ALWAYS_INLINE T blend(const T &src, const T &dst)
+    {
+        return src + dst - src * dst;
+    }
+};
+
+// CFOverlay, that is CFHardLight with swapped arguments
+struct Overlay {
+    static constexpr bool clampSourceToSDR = true;
+
+    template<bool isInteger, typename T>
+    static ALWAYS_INLINE T blend(const T &src, const T &dst)
+    {
+        const T dst2 = dst + dst;
+        const T one(1.0f);
+
+        return select(dst > T(0.5f),
+                      (dst2 - one) + src - (dst2 - one) * src,
+                      dst2 * src);
+    }
+};
+
+// cfDarkenOnly
+struct Darken {
+    static constexpr bool clampSourceToSDR = false;
+
+    template<bool isInteger, typename T>
+    static ALWAYS_INLINE T blend(const T &src, const T &dst)
+    {
+        return min(src, dst);
+    }
+};
+
+// cfLightenOnly
+struct Lighten {
+    static constexpr bool clampSourceToSDR = false;
+
+    template<bool isInteger, typename T>
+    static ALWAYS_INLINE T blend(const T &src, const T &dst)
+    {
+        return max(src, dst);
+    }
+};
+
+// cfAddition
+struct Addition {
+    static constexpr bool clampSourceToSDR = false;
+
+    template<bool isInteger, typename T>
+    static ALWAYS_INLINE T blend(const T &src, const T &dst)
+    {
+        return isInteger ? min(src + dst, T(1.0f)) : src + dst;
+    }
+};
+
+// cfSubtract
+struct Subtract {
+    static constexpr bool clampSourceToSDR = false;
+
+    template<bool isInteger, typename T>
+    static ALWAYS_INLINE T blend(const T &src, const T &dst)
+    {
+        return isInteger ? max(dst - src, T(0.0f)) : dst - src;
+    }
+};
+
+// cfDifference
+struct Difference {
+    static constexpr bool clampSourceToSDR = false;
+
+    template<bool isInteger, typename T>
+    static ALWAYS_INLINE T blend(const T &src, const T &dst)
+    {
+        return abs(src - dst);
+    }
+};
+
+} // namespace KoOptimizedBlendFunctions
+
+template<typename channels_type, class BlendFunction, bool alphaLocked, bool allChannelsFlag>
+struct GenericSCCompositor {
+    struct ParamsWrapper {
+        ParamsWrapper(const KoCompositeOp::ParameterInfo& params)
+            : channelFlags(params.channelFlags)
+        {
+        }
+        const QBitArray &channelFlags;
+    };
+
+    static constexpr bool isInteger = std::numeric_limits<channels_type>::is_integer;
+
+    template<typename T>
+    static ALWAYS_INLINE T clampSource(const T &value)
+    {
+        using namespace KoOptimizedBlendFunctions;
+
+        // integer channels never leave SDR range
+        return !isInteger && BlendFunction::clampSourceToSDR ?
+            min(max(value, T(0.0f)), T(1.0f)) : value;
+    }
+
+    // \see docs in AlphaDarkenCompositor32
+    template<bool haveMask, bool src_aligned, typename _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        Q_UNUSED(oparams);
+
+        using float_v = typename KoStreamedMath<_impl>::float_v;
+        using float_m = typename float_v::batch_bool_type;
+
+        float_v src_alpha;
+        float_v dst_alpha;
+
+        float_v src_c1;
+        float_v src_c2;
+        float_v src_c3;
+
+        PixelWrapper<channels_type, _impl> dataWrapper;
+        dataWrapper.read(src, src_c1, src_c2, src_c3, src_alpha);
+
+        src_alpha *= float_v(opacity);
+
+        if (haveMask) {
+            const float_v uint8MaxRec1(1.0f / 255.0f);
+            const float_v mask_vec = KoStreamedMath<_impl>::fetch_mask_8(mask);
+            src_alpha *= mask_vec * uint8MaxRec1;
+        }
+
+        const float_v zeroValue(0.0f);
+        const float_v oneValue(1.0f);
+
+        // The source cannot change the colors in the destination,
+        // since its fully transparent
+        if (xsimd::all(src_alpha == zeroValue)) {
+            return;
+        }
+
+        float_v dst_c1;
+        float_v dst_c2;
+        float_v dst_c3;
+
+        dataWrapper.read(dst, dst_c1, dst_c2, dst_c3, dst_alpha);
+
+        /**
+         * The pixels with transparent source are kept unchanged. The new
+         * alpha can be null only for such pixels, so guard the division
+         * for them only.
+         */
+        const float_m transparent_src = src_alpha == zeroValue;
+
+        const float_v new_alpha = src_alpha + dst_alpha - src_alpha * dst_alpha;
+        const float_v new_alpha_rec = oneValue / xsimd::select(transparent_src, oneValue, new_alpha);
+
+        // see Arithmetic::blend()
+        const float_v src_weight = (oneValue - dst_alpha) * src_alpha * new_alpha_rec;
+        const float_v dst_weight = (oneValue - src_alpha) * dst_alpha * new_alpha_rec;
+        const float_v blend_weight = src_alpha * dst_alpha * new_alpha_rec;
+
+        const float unitValue = KoColorSpaceMathsTraits<channels_type>::unitValue;
+        const float_v unitValueVec(unitValue);
+        const float_v unitValueRecVec(1.0f / unitValue);
+
+        auto composeChannel = [&] (const float_v &src_c, const float_v &dst_c) {
+            float_v s = src_c;
+            float_v d = dst_c;
+
+            if (isInteger) {
+                s *= unitValueRecVec;
+                d *= unitValueRecVec;
+            }
+
+            s = clampSource(s);
+
+            float_v result =
+                dst_weight * d + src_weight * s +
+                blend_weight * BlendFunction::template blend<isInteger>(s, d);
+
+            if (isInteger) {
+                result *= unitValueVec;
+            }
+
+            return xsimd::select(transparent_src, dst_c, result);
+        };
+
+        dst_c1 = composeChannel(src_c1, dst_c1);
+        dst_c2 = composeChannel(src_c2, dst_c2);
+        dst_c3 = composeChannel(src_c3, dst_c3);
+
+        dataWrapper.write(dst, dst_c1, dst_c2, dst_c3, xsimd::select(transparent_src, dst_alpha, new_alpha));
+    }
+
+    template<bool haveMask, typename _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src,
+                                                      quint8 *dst,
+                                                      const quint8 *mask,
+                                                      float opacity,
+                                                      const ParamsWrapper &oparams)
+    {
+        const qint32 alpha_pos = 3;
+
+        const auto *s = reinterpret_cast<const channels_type*>(src);
+        auto *d = reinterpret_cast<channels_type*>(dst);
+
+        float srcAlpha = s[alpha_pos];
+        PixelWrapper<channels_type, _impl>::normalizeAlpha(srcAlpha);
+        srcAlpha *= opacity;
+
+        if (haveMask) {
+            const float uint8Rec1 = 1.0f / 255.0f;
+            srcAlpha *= float(*mask) * uint8Rec1;
+        }
+
+        float dstAlpha = d[alpha_pos];
+        PixelWrapper<channels_type, _impl>::normalizeAlpha(dstAlpha);
+
+        // see KoCompositeOpBase::genericComposite()
+        if (!allChannelsFlag && dstAlpha == 0.0f) {
+            KoStreamedMathFunctions::clearPixel<4 * sizeof(channels_type)>(dst);
+        }
+
+        if (srcAlpha == 0.0f) return;
+        if (alphaLocked && dstAlpha == 0.0f) return;
+
+        const float unitValue = KoColorSpaceMathsTraits<channels_type>::unitValue;
+        const float unitValueRec = 1.0f / unitValue;
+
+        const float newAlpha = alphaLocked ? dstAlpha : srcAlpha + dstAlpha - srcAlpha * dstAlpha;
+        const float newAlphaRec = 1.0f / newAlpha;
+
+        // the same weights as in the vector version, see Arithmetic::blend()
+        const float srcWeight = (1.0f - dstAlpha) * srcAlpha * newAlphaRec;
+        const float dstWeight = (1.0f - srcAlpha) * dstAlpha * newAlphaRec;
+        const float blendWeight = srcAlpha * dstAlpha * newAlphaRec;
+
+        for (int i = 0; i < 3; i++) {
+            if (!allChannelsFlag && !oparams.channelFlags.at(i)) continue;
+
+            const float srcValue = clampSource(float(s[i]) * unitValueRec);
+            const float dstValue = float(d[i]) * unitValueRec;
+            const float blended = BlendFunction::template blend<isInteger>(srcValue, dstValue);
+
+            const float result = alphaLocked ?
+                dstValue + (blended - dstValue) * srcAlpha :
+                dstWeight * dstValue + srcWeight * srcValue + blendWeight * blended;
+
+            d[i] = PixelWrapper<channels_type, _impl>::roundFloatToUint(result * unitValue);
+        }
+
+        if (!alphaLocked) {
+            float dstAlphaNative = newAlpha;
+            PixelWrapper<channels_type, _impl>::denormalizeAlpha(dstAlphaNative);
+            d[alpha_pos] = PixelWrapper<channels_type, _impl>::roundFloatToUint(dstAlphaNative);
+        }
+    }
+};
+
+/**
+ * An optimized version of KoCompositeOpGenericSC for the use in RGBA
+ * colorspaces with 8-bit, 16-bit and 32-bit float channels and the
+ * alpha channel placed at the last position: C1_C2_C3_A.
+ */
+template<typename channels_type, class BlendFunction, typename _impl>
+class KoOptimizedCompositeOpGenericSC : public KoCompositeOp
+{
+    static const int pixelSize = 4 * sizeof(channels_type);
+
+public:
+    KoOptimizedCompositeOpGenericSC(const KoColorSpace* cs, const QString &id, const QString &category)
+        : KoCompositeOp(cs, id, category) {}
+
+    using KoCompositeOp::composite;
+
+    void composite(const KoCompositeOp::ParameterInfo& params) const override
+    {
+        if(params.maskRowStart) {
+            composite<true>(params);
+        } else {
+            composite<false>(params);
+        }
+    }
+
+    template <bool haveMask>
+    inline void composite(const KoCompositeOp::ParameterInfo& params) const {
+        if (params.channelFlags.isEmpty() ||
+            params.channelFlags == QBitArray(4, true)) {
+
+            KoStreamedMath<_impl>::template genericComposite<haveMask, false, GenericSCCompositor<channels_type, BlendFunction, false, true>, pixelSize>(params);
+        } else {
+            const bool allChannelsFlag =
+                params.channelFlags.at(0) &&
+                params.channelFlags.at(1) &&
+                params.channelFlags.at(2);
+
+            const bool alphaLocked =
+                !params.channelFlags.at(3);
+
+            if (allChannelsFlag && alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite_novector<haveMask, false, GenericSCCompositor<channels_type, BlendFunction, true, true>, pixelSize>(params);
+            } else if (!allChannelsFlag && !alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite_novector<haveMask, false, GenericSCCompositor<channels_type, BlendFunction, false, false>, pixelSize>(params);
+            } else /*if (!allChannelsFlag && alphaLocked) */{
+                KoStreamedMath<_impl>::template genericComposite_novector<haveMask, false, GenericSCCompositor<channels_type, BlendFunction, true, false>, pixelSize>(params);
+            }
+        }
+    }
+};
+
+#endif // KOOPTIMIZEDCOMPOSITEOPGENERICSC_H
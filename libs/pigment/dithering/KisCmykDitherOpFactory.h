@@ -216,12 +216,18 @@ private:
     }
 };
 
+template<typename srcCSTraits, typename dstCSTraits, DitherType dType> inline KisDitherOp *createCmykDitherOp(const KoID &srcDepth, const KoID &dstDepth)
+{
+    KisDitherOp *op = KisOptimizedDitherOpFactory::create(srcDepth, dstDepth, srcCSTraits::channels_nb, srcCSTraits::alpha_pos, true, dType);
+    return op ? op : new KisCmykDitherOpImpl<srcCSTraits, dstCSTraits, dType>(srcDepth, dstDepth);
+}
+
 template<typename srcCSTraits, typename dstCSTraits> inline void addCmykDitherOpsByDepth(KoColorSpace *cs, const KoID &dstDepth)
 {
     const KoID &srcDepth {cs->colorDepthId()};
     cs->addDitherOp(new KisCmykDitherOpImpl<srcCSTraits, dstCSTraits, DITHER_NONE>(srcDepth, dstDepth));
-    cs->addDitherOp(new KisCmykDitherOpImpl<srcCSTraits, dstCSTraits, DITHER_BAYER>(srcDepth, dstDepth));
-    cs->addDitherOp(new KisCmykDitherOpImpl<srcCSTraits, dstCSTraits, DITHER_BLUE_NOISE>(srcDepth, dstDepth));
+    cs->addDitherOp(createCmykDitherOp<srcCSTraits, dstCSTraits, DITHER_BAYER>(srcDepth, dstDepth));
+    cs->addDitherOp(createCmykDitherOp<srcCSTraits, dstCSTraits, DITHER_BLUE_NOISE>(srcDepth, dstDepth));
 }
 
 template<class srcCSTraits> inline void addStandardDitherOps(KoColorSpace *cs)
@@ -13,6 +13,9 @@
 #include <KoColorModelStandardIds.h>
 #include <KoColorProfile.h>
 #include <KoColorSpaceRegistry.h>
+#include <KoColorSpaceMaths.h>
+#include <KoColorTransferFunctions.h>
+#include <KoOptimizedRgbPixelConverterFactory.h>
 #include <testpigment.h>
 
 #include <QRandomGenerator>
@@ -501,5 +504,113 @@ void TestColorConversionSystem::testCmykBitnessConversion()
 
 }
 
+void TestColorConversionSystem::testOptimizedRgbConversions()
+{
+    KoColorSpaceRegistry *registry = KoColorSpaceRegistry::instance();
+
+    const KoColorSpace *srgb8 =
+        registry->colorSpace(RGBAColorModelID.id(), Integer8BitsColorDepthID.id(), registry->p709SRGBProfile());
+    const KoColorSpace *srgb16 =
+        registry->colorSpace(RGBAColorModelID.id(), Integer16BitsColorDepthID.id(), registry->p709SRGBProfile());
+    const KoColorSpace *linear32 =
+        registry->colorSpace(RGBAColorModelID.id(), Float32BitsColorDepthID.id(), registry->p709G10Profile());
+    const KoColorSpace *rec2020linear32 =
+        registry->colorSpace(RGBAColorModelID.id(), Float32BitsColorDepthID.id(), registry->p2020G10Profile());
+    const KoColorSpace *rec2020pq16 =
+        registry->colorSpace(RGBAColorModelID.id(), Integer16BitsColorDepthID.id(), registry->p2020PQProfile());
+    const KoColorSpace *rec2020pq32 =
+        registry->colorSpace(RGBAColorModelID.id(), Float32BitsColorDepthID.id(), registry->p2020PQProfile());
+
+    KoOptimizedRgbPixelConverterBase::CurvePolicy curvePolicy;
+
+    QVERIFY(KoOptimizedRgbPixelConverterFactory::canConvertDirectly(srgb8, srgb16, &curvePolicy));
+    QCOMPARE(curvePolicy, KoOptimizedRgbPixelConverterBase::KeepTheSame);
+
+    QVERIFY(KoOptimizedRgbPixelConverterFactory::canConvertDirectly(srgb8, linear32, &curvePolicy));
+    QCOMPARE(curvePolicy, KoOptimizedRgbPixelConverterBase::RemoveSrgbCurve);
+
+    QVERIFY(KoOptimizedRgbPixelConverterFactory::canConvertDirectly(linear32, srgb8, &curvePolicy));
+    QCOMPARE(curvePolicy, KoOptimizedRgbPixelConverterBase::ApplySrgbCurve);
+
+    // different primaries need a real color management
+    QVERIFY(!KoOptimizedRgbPixelConverterFactory::canConvertDirectly(linear32, rec2020linear32, &curvePolicy));
+
+    // PQ color spaces have their own conversion links
+    QVERIFY(!KoOptimizedRgbPixelConverterFactory::canConvertDirectly(rec2020pq16, rec2020pq32, &curvePolicy));
+
+    // an odd number of pixels to check both, vector and scalar code paths
+    const int numPixels = 67;
+
+    QByteArray srcBuf(numPixels * srgb8->pixelSize(), '\0');
+    for (int i = 0; i < srcBuf.size(); i++) {
+        srcBuf[i] = static_cast<char>((i * 37) % 256);
+    }
+
+    QByteArray dst16Buf(numPixels * srgb16->pixelSize(), '\0');
+    QByteArray dst32Buf(numPixels * linear32->pixelSize(), '\0');
+    QByteArray roundTripBuf(numPixels * srgb8->pixelSize(), '\0');
+
+    srgb8->convertPixelsTo((quint8*)srcBuf.data(), (quint8*)dst16Buf.data(), srgb16, numPixels,
+                           KoColorConversionTransformation::internalRenderingIntent(),
+                           KoColorConversionTransformation::internalConversionFlags());
+
+    srgb8->convertPixelsTo((quint8*)srcBuf.data(), (quint8*)dst32Buf.data(), linear32, numPixels,
+                           KoColorConversionTransformation::internalRenderingIntent(),
+                           KoColorConversionTransformation::internalConversionFlags());
+
+    linear32->convertPixelsTo((quint8*)dst32Buf.data(), (quint8*)roundTripBuf.data(), srgb8, numPixels,
+                              KoColorConversionTransformation::internalRenderingIntent(),
+                              KoColorConversionTransformation::internalConversionFlags());
+
+    const quint8 *src = reinterpret_cast<const quint8*>(srcBuf.constData());
+    const quint16 *dst16 = reinterpret_cast<const quint16*>(dst16Buf.constData());
+    const float *dst32 = reinterpret_cast<const float*>(dst32Buf.constData());
+
+    for (int i = 0; i < numPixels; i++) {
+        for (int ch = 0; ch < 4; ch++) {
+            QCOMPARE(dst16[ch], KoColorSpaceMaths<quint8, quint16>::scaleToA(src[ch]));
+        }
+
+        // BGRA -> RGBA
+        QVERIFY(qAbs(dst32[0] - removeSrgbCurve(src[2] / 255.0f)) < 1e-5);
+        QVERIFY(qAbs(dst32[1] - removeSrgbCurve(src[1] / 255.0f)) < 1e-5);
+        QVERIFY(qAbs(dst32[2] - removeSrgbCurve(src[0] / 255.0f)) < 1e-5);
+        QVERIFY(qAbs(dst32[3] - src[3] / 255.0f) < 1e-5);
+
+        src += 4;
+        dst16 += 4;
+        dst32 += 4;
+    }
+
+    QCOMPARE(roundTripBuf, srcBuf);
+}
+
+void TestColorConversionSystem::benchmarkSrgbToLinearConversion()
+{
+    KoColorSpaceRegistry *registry = KoColorSpaceRegistry::instance();
+
+    const KoColorSpace *srgb8 =
+        registry->colorSpace(RGBAColorModelID.id(), Integer8BitsColorDepthID.id(), registry->p709SRGBProfile());
+    const KoColorSpace *linear32 =
+        registry->colorSpace(RGBAColorModelID.id(), Float32BitsColorDepthID.id(), registry->p709G10Profile());
+
+    const int numPixels = 1024 * 4096;
+    QByteArray srcBuf(numPixels * srgb8->pixelSize(), '\0');
+    QByteArray dstBuf(numPixels * linear32->pixelSize(), '\0');
+
+    QRandomGenerator rng{};
+    for (int i = 0; i < srcBuf.size(); i++) {
+        srcBuf[i] = static_cast<char>(rng.bounded(256));
+    }
+
+    QBENCHMARK {
+        srgb8->convertPixelsTo((quint8*)srcBuf.data(),
+                               (quint8*)dstBuf.data(),
+                               linear32,
+                               numPixels,
+                               KoColorConversionTransformation::IntentPerceptual,
+                               KoColorConversionTransformation::Empty);
+    }
+}
 
 KISTEST_MAIN(TestColorConversionSystem)
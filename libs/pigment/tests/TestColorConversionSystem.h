@@ -40,6 +40,9 @@ private Q_SLOTS:
 
     void testCmykBitnessConversion();
 
+    void testOptimizedRgbConversions();
+    void benchmarkSrgbToLinearConversion();
+
 private:
     std::vector<KoColorConversionSystem::NodeKey> calcPath(const std::vector<KoColorConversionSystem::NodeKey> &expectedPath);
 
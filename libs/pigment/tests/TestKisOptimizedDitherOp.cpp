@@ -0,0 +1,221 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestKisOptimizedDitherOp.h"
+
+#include <simpletest.h>
+
+#include <QPoint>
+#include <QRandomGenerator>
+#include <QScopedPointer>
+#include <QVector>
+
+#include <type_traits>
+
+#include "../KoColorSpaceTraits.h"
+#include "../KoCmykColorSpaceTraits.h"
+#include "../KoCmykColorSpaceMaths.h"
+#include "../KisDitherOpImpl.h"
+#include "../KisOptimizedDitherOpFactory.h"
+#include "../dithering/KisCmykDitherOpFactory.h"
+
+namespace {
+
+template<typename T>
+KoID depthId();
+
+template<>
+KoID depthId<quint8>()
+{
+    return Integer8BitsColorDepthID;
+}
+
+template<>
+KoID depthId<quint16>()
+{
+    return Integer16BitsColorDepthID;
+}
+
+template<>
+KoID depthId<float>()
+{
+    return Float32BitsColorDepthID;
+}
+
+template<typename T>
+T randomValue(QRandomGenerator &rng, bool isCmykColor)
+{
+    Q_UNUSED(isCmykColor);
+    return T(rng.bounded(quint32(KoColorSpaceMathsTraits<T>::unitValue) + 1));
+}
+
+template<>
+float randomValue<float>(QRandomGenerator &rng, bool isCmykColor)
+{
+    if (isCmykColor) {
+        // CMYK color channels are truncated, so the source
+        // should stay in [0, unitValueCMYK] range
+        return rng.generateDouble() * KoCmykColorSpaceMathsTraits<float>::unitValueCMYK;
+    }
+
+    // the values out of [0, 1] range check the clamping
+    return -0.25 + 1.5 * rng.generateDouble();
+}
+
+template<class Traits, bool isCmyk>
+void fillRandomPixels(QVector<quint8> &buffer, QRandomGenerator &rng)
+{
+    using channels_type = typename Traits::channels_type;
+
+    channels_type *ptr = reinterpret_cast<channels_type*>(buffer.data());
+    const int numValues = buffer.size() / sizeof(channels_type);
+
+    for (int i = 0; i < numValues; i++) {
+        const bool isAlpha = i % Traits::channels_nb == Traits::alpha_pos;
+        ptr[i] = randomValue<channels_type>(rng, isCmyk && !isAlpha);
+    }
+}
+
+/**
+ * Compares the optimized op with KisDitherOpImpl (or KisCmykDitherOpImpl)
+ *
+ * The vector code scales the integer sources with a multiplication instead
+ * of the lookup table and rounds the halves up, so some values may differ
+ * by one. Any error in the factors table would make a much bigger fraction
+ * of the values differ.
+ */
+template<class SrcTraits, class DstTraits, bool isCmyk, DitherType dType>
+void testDitherOp()
+{
+    using src_channels_type = typename SrcTraits::channels_type;
+    using dst_channels_type = typename DstTraits::channels_type;
+
+    using ReferenceOp = typename std::conditional<isCmyk,
+        KisCmykDitherOpImpl<SrcTraits, DstTraits, dType>,
+        KisDitherOpImpl<SrcTraits, DstTraits, dType>>::type;
+
+    const KoID srcDepth = depthId<src_channels_type>();
+    const KoID dstDepth = depthId<dst_channels_type>();
+
+    QScopedPointer<KisDitherOp> opAct(
+        KisOptimizedDitherOpFactory::create(srcDepth, dstDepth,
+                                            SrcTraits::channels_nb, SrcTraits::alpha_pos,
+                                            isCmyk, dType));
+    QVERIFY(opAct);
+
+    const ReferenceOp opExp(srcDepth, dstDepth);
+
+    QRandomGenerator rng(1);
+
+    // the widths that are not a multiple of the vector size
+    // and the ones wider than the period of the factors table
+    const QVector<int> widths = {1, 3, 7, 13, 64, 65, 150};
+    const QVector<QPoint> origins = {QPoint(0, 0), QPoint(5, 3), QPoint(61, 127)};
+    const int rows = 4;
+
+    // the rows are padded to check that the strides are respected
+    const int padding = 3;
+
+    int numValues = 0;
+    int numInexact = 0;
+
+    Q_FOREACH (int columns, widths) {
+        Q_FOREACH (const QPoint &origin, origins) {
+            const int srcRowStride = (columns + padding) * SrcTraits::pixelSize;
+            const int dstRowStride = (columns + padding) * DstTraits::pixelSize;
+
+            QVector<quint8> src(srcRowStride * rows);
+            fillRandomPixels<SrcTraits, isCmyk>(src, rng);
+
+            QVector<quint8> dstAct(dstRowStride * rows, 0);
+            QVector<quint8> dstExp(dstRowStride * rows, 0);
+
+            opAct->dither(src.constData(), srcRowStride, dstAct.data(), dstRowStride,
+                          origin.x(), origin.y(), columns, rows);
+            opExp.dither(src.constData(), srcRowStride, dstExp.data(), dstRowStride,
+                         origin.x(), origin.y(), columns, rows);
+
+            const QString testName =
+                QString("src: %1 dst: %2 type: %3 columns: %4 origin: %5,%6")
+                    .arg(srcDepth.id(), dstDepth.id())
+                    .arg(dType)
+                    .arg(columns)
+                    .arg(origin.x())
+                    .arg(origin.y());
+
+            for (int row = 0; row < rows; row++) {
+                const dst_channels_type *act =
+                    reinterpret_cast<const dst_channels_type*>(dstAct.constData() + row * dstRowStride);
+                const dst_channels_type *exp =
+                    reinterpret_cast<const dst_channels_type*>(dstExp.constData() + row * dstRowStride);
+
+                const int rowValues = columns * DstTraits::channels_nb;
+                const int rowStrideValues = (columns + padding) * DstTraits::channels_nb;
+
+                for (int i = 0; i < rowValues; i++) {
+                    const int diff = qAbs(int(act[i]) - int(exp[i]));
+
+                    QVERIFY2(diff <= 1,
+                             qPrintable(QString("%1 row: %2 value: %3 act: %4 exp: %5")
+                                        .arg(testName).arg(row).arg(i)
+                                        .arg(act[i]).arg(exp[i])));
+
+                    if (diff) {
+                        numInexact++;
+                    }
+                }
+
+                for (int i = rowValues; i < rowStrideValues; i++) {
+                    QVERIFY2(act[i] == 0,
+                             qPrintable(QString("%1 row: %2 padding is overwritten")
+                                        .arg(testName).arg(row)));
+                }
+
+                numValues += rowValues;
+            }
+        }
+    }
+
+    QVERIFY2(numInexact * 100 <= numValues,
+             qPrintable(QString("src: %1 dst: %2 type: %3 inexact values: %4 of %5")
+                        .arg(srcDepth.id(), dstDepth.id())
+                        .arg(dType)
+                        .arg(numInexact)
+                        .arg(numValues)));
+}
+
+template<template<typename> class Traits, bool isCmyk, DitherType dType>
+void testAllDepths()
+{
+    testDitherOp<Traits<quint8>, Traits<quint8>, isCmyk, dType>();
+    testDitherOp<Traits<quint8>, Traits<quint16>, isCmyk, dType>();
+    testDitherOp<Traits<quint16>, Traits<quint8>, isCmyk, dType>();
+    testDitherOp<Traits<quint16>, Traits<quint16>, isCmyk, dType>();
+    testDitherOp<Traits<float>, Traits<quint8>, isCmyk, dType>();
+    testDitherOp<Traits<float>, Traits<quint16>, isCmyk, dType>();
+}
+
+}
+
+void TestKisOptimizedDitherOp::testRgba()
+{
+    testAllDepths<KoBgrTraits, false, DITHER_BAYER>();
+    testAllDepths<KoBgrTraits, false, DITHER_BLUE_NOISE>();
+}
+
+void TestKisOptimizedDitherOp::testGrayA()
+{
+    testAllDepths<KoGrayTraits, false, DITHER_BAYER>();
+    testAllDepths<KoGrayTraits, false, DITHER_BLUE_NOISE>();
+}
+
+void TestKisOptimizedDitherOp::testCmyka()
+{
+    testAllDepths<KoCmykTraits, true, DITHER_BAYER>();
+    testAllDepths<KoCmykTraits, true, DITHER_BLUE_NOISE>();
+}
+
+SIMPLE_TEST_MAIN(TestKisOptimizedDitherOp)
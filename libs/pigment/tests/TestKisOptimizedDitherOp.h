@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TESTKISOPTIMIZEDDITHEROP_H
+#define TESTKISOPTIMIZEDDITHEROP_H
+
+#include <QObject>
+
+class TestKisOptimizedDitherOp : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testRgba();
+    void testGrayA();
+    void testCmyka();
+};
+
+#endif // TESTKISOPTIMIZEDDITHEROP_H
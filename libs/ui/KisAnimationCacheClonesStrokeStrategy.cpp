@@ -0,0 +1,102 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisAnimationCacheClonesStrokeStrategy.h"
+
+#include <QApplication>
+
+#include "kis_image.h"
+#include "kis_image_animation_interface.h"
+#include "kis_assert.h"
+
+#include "KisRunnableStrokeJobUtils.h"
+#include "KisRunnableStrokeJobsInterface.h"
+
+
+struct KisAnimationCacheClonesStrokeStrategy::Private
+{
+    KisImageWSP image;
+    QVector<KisImageSP> clones;
+    bool imageCopied = false;
+
+    static void updateClone(KisImageSP &clone, KisImageSP source) {
+        if (clone) {
+            clone->copyFromImage(*source, true);
+        } else {
+            clone = source->clone(true);
+        }
+
+        /**
+         * The clones are created in the stroke worker threads, which
+         * have no event loop, so all the QObjects of the clone must be
+         * moved to the GUI thread (KisImage and KisNode do that on
+         * construction). Otherwise queued signals to them would be lost.
+         */
+        KIS_SAFE_ASSERT_RECOVER_NOOP(clone->thread() == qApp->thread());
+        KIS_SAFE_ASSERT_RECOVER_NOOP(clone->animationInterface()->thread() == qApp->thread());
+    }
+};
+
+KisAnimationCacheClonesStrokeStrategy::KisAnimationCacheClonesStrokeStrategy(KisImageSP image, const QVector<KisImageSP> &clones)
+    : KisIdleTaskStrokeStrategy(QLatin1String("animation-cache-clones-stroke"), kundo2_i18n("Clone Image for Animation Cache")),
+      m_d(new Private)
+{
+    qRegisterMetaType<QVector<KisImageSP>>("QVector<KisImageSP>");
+
+    // the populator waits for the result even if the stroke is never started
+    setNeedsExplicitCancel(true);
+
+    m_d->image = image;
+    m_d->clones = clones;
+
+    // the jobs write into the elements of the vector concurrently
+    m_d->clones.detach();
+}
+
+KisAnimationCacheClonesStrokeStrategy::~KisAnimationCacheClonesStrokeStrategy()
+{
+}
+
+void KisAnimationCacheClonesStrokeStrategy::initStrokeCallback()
+{
+    KisIdleTaskStrokeStrategy::initStrokeCallback();
+
+    KisImageSP image = m_d->image;
+    if (!image || m_d->clones.isEmpty()) return;
+
+    /**
+     * The init job is exclusive, so the image cannot be modified
+     * while it is being copied. The first clone is not accessible
+     * to the user, so the rest of the clones can be copied from it
+     * concurrently.
+     */
+    Private::updateClone(m_d->clones[0], image);
+    m_d->imageCopied = true;
+
+    using KritaUtils::addJobConcurrent;
+
+    QVector<KisRunnableStrokeJobData*> jobs;
+    KisImageSP firstClone = m_d->clones.first();
+
+    for (int i = 1; i < m_d->clones.size(); i++) {
+        addJobConcurrent(jobs, [this, i, firstClone] () {
+            Private::updateClone(m_d->clones[i], firstClone);
+        });
+    }
+
+    runnableJobsInterface()->addRunnableJobs(jobs);
+}
+
+void KisAnimationCacheClonesStrokeStrategy::finishStrokeCallback()
+{
+    KisIdleTaskStrokeStrategy::finishStrokeCallback();
+
+    Q_EMIT sigClonesUpdated(m_d->clones, m_d->imageCopied);
+}
+
+void KisAnimationCacheClonesStrokeStrategy::cancelStrokeCallback()
+{
+    Q_EMIT sigClonesUpdated(m_d->clones, false);
+}
@@ -0,0 +1,49 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISANIMATIONCACHECLONESSTROKESTRATEGY_H
+#define KISANIMATIONCACHECLONESSTROKESTRATEGY_H
+
+#include "KisIdleTaskStrokeStrategy.h"
+
+#include <QVector>
+#include <QScopedPointer>
+
+
+/**
+ * An idle task that prepares the exact clones of the image used
+ * by KisAnimationCachePopulator to render the frames in parallel.
+ *
+ * The existing clones passed to the strategy are refreshed in place,
+ * the null ones are replaced with new clones. Only the first clone is
+ * copied from the image itself (in an exclusive job), the others are
+ * copied from the first clone concurrently.
+ *
+ * The result is reported with sigClonesUpdated(). If the stroke is
+ * cancelled (e.g. by the user starting a brush stroke), the clones
+ * are reported as incomplete and should not be used for rendering.
+ */
+class KRITAUI_EXPORT KisAnimationCacheClonesStrokeStrategy : public KisIdleTaskStrokeStrategy
+{
+    Q_OBJECT
+public:
+    KisAnimationCacheClonesStrokeStrategy(KisImageSP image, const QVector<KisImageSP> &clones);
+    ~KisAnimationCacheClonesStrokeStrategy() override;
+
+    void cancelStrokeCallback() override;
+
+Q_SIGNALS:
+    void sigClonesUpdated(const QVector<KisImageSP> &clones, bool isComplete);
+
+private:
+    void initStrokeCallback() override;
+    void finishStrokeCallback() override;
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISANIMATIONCACHECLONESSTROKESTRATEGY_H
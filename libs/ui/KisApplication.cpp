@@ -108,6 +108,7 @@
 #include "kis_file_layer.h"
 #include "kis_group_layer.h"
 #include "kis_node_commands_adapter.h"
+#include "kis_update_time_monitor.h"
 #include "KisSynchronizedConnection.h"
 #include <QThreadStorage>
 #include <KisWindowsPackageUtils.h>
@@ -408,6 +409,15 @@ bool KisApplication::start(const KisApplicationArguments &args)
 {
     KisConfig cfg(false);
 
+    /**
+     * Start tracing only after the single-instance check, otherwise
+     * an instance that just forwards its arguments to the running one
+     * would truncate the trace file of the latter
+     */
+    if (!args.traceUpdatesFileName().isEmpty()) {
+        KisUpdateTimeMonitor::instance()->startTracing(args.traceUpdatesFileName());
+    }
+
 #if defined(Q_OS_WIN)
 #ifdef ENV32BIT
 
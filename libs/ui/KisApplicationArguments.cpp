@@ -40,6 +40,7 @@ struct Q_DECL_HIDDEN KisApplicationArguments::Private
     bool canvasOnly {false};
     bool noSplash {false};
     bool fullScreen {false};
+    QString traceUpdatesFileName;
 
     bool newImage {false};
     QString colorModel {"RGBA"};
@@ -97,6 +98,11 @@ KisApplicationArguments::KisApplicationArguments(const QApplication &app)
     parser.addOption(QCommandLineOption(QStringList() << QLatin1String("export-filename"), i18n("Filename for export"), QLatin1String("filename")));
     parser.addOption(QCommandLineOption(QStringList() << QLatin1String("file-layer"), i18n("File layer to be added to existing or new file"), QLatin1String("file-layer")));
     parser.addOption(QCommandLineOption(QStringList() << QLatin1String("resource-location"), i18n("A location that overrides the configured location for Krita's resources"), QLatin1String("file-layer")));
+    {
+        QCommandLineOption opt(QStringList() << QLatin1String("trace-updates"), i18n("Record the timings of the image updates and save them as a Chrome trace into the given file on exit"), QLatin1String("filename"));
+        opt.setFlags(QCommandLineOption::HiddenFromHelp);
+        parser.addOption(opt);
+    }
     parser.addPositionalArgument(QLatin1String("[file(s)]"), i18n("File(s) or URL(s) to open"));
 
     QStringList filteredArgs;
@@ -193,6 +199,11 @@ KisApplicationArguments::KisApplicationArguments(const QApplication &app)
     KoResourcePaths::s_overrideAppDataLocation = parser.value("resource-location");
 
     const QDir currentDir = QDir::current();
+
+    if (parser.isSet("trace-updates")) {
+        d->traceUpdatesFileName = currentDir.absoluteFilePath(parser.value("trace-updates"));
+    }
+
     Q_FOREACH (const QString &filename, parser.positionalArguments()) {
         d->filenames << currentDir.absoluteFilePath(filename);
     }
@@ -213,6 +224,7 @@ KisApplicationArguments::KisApplicationArguments(const KisApplicationArguments &
     d->session = rhs.session();
     d->noSplash = rhs.noSplash();
     d->fullScreen = rhs.fullScreen();
+    d->traceUpdatesFileName = rhs.traceUpdatesFileName();
 
 }
 
@@ -230,6 +242,7 @@ void KisApplicationArguments::operator=(const KisApplicationArguments &rhs)
     d->session = rhs.session();
     d->noSplash = rhs.noSplash();
     d->fullScreen = rhs.fullScreen();
+    d->traceUpdatesFileName = rhs.traceUpdatesFileName();
 }
 
 QByteArray KisApplicationArguments::serialize()
@@ -365,6 +378,11 @@ bool KisApplicationArguments::fullScreen() const
     return d->fullScreen;
 }
 
+QString KisApplicationArguments::traceUpdatesFileName() const
+{
+    return d->traceUpdatesFileName;
+}
+
 bool KisApplicationArguments::doNewImage() const
 {
     return d->newImage;
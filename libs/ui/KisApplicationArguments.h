@@ -41,6 +41,7 @@ public:
     bool canvasOnly() const;
     bool noSplash() const;
     bool fullScreen() const;
+    QString traceUpdatesFileName() const;
     bool doNewImage() const;
     KisDocument *createDocumentFromArguments() const;
 
@@ -0,0 +1,143 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisFilterLodPrerenderStrokeStrategy.h"
+
+#include "kis_image.h"
+#include "kis_paint_device.h"
+#include "kis_layer_utils.h"
+#include "kis_pointer_utils.h"
+#include "kis_config.h"
+#include "krita_utils.h"
+#include "krita_container_utils.h"
+
+#include "KisRunnableStrokeJobUtils.h"
+#include "KisRunnableStrokeJobsInterface.h"
+
+
+struct KisFilterLodPrerenderStrokeStrategy::Private
+{
+    KisImageWSP image;
+    QVector<int> levels;
+};
+
+KisFilterLodPrerenderStrokeStrategy::KisFilterLodPrerenderStrokeStrategy(KisImageSP image)
+    : KisIdleTaskStrokeStrategy(QLatin1String("filter-lod-prerender-stroke"), kundo2_i18n("Pre-render filters for Instant Preview")),
+      m_d(new Private)
+{
+    m_d->image = image;
+
+    const KisLodPreferences lodPreferences = image->lodPreferences();
+
+    if (lodPreferences.lodSupported()) {
+        KisConfig cfg(true);
+        m_d->levels = levelsToPrerender(lodPreferences.desiredLevelOfDetail(),
+                                        cfg.numMipmapLevels());
+    }
+}
+
+KisFilterLodPrerenderStrokeStrategy::~KisFilterLodPrerenderStrokeStrategy()
+{
+}
+
+QVector<int> KisFilterLodPrerenderStrokeStrategy::levelsToPrerender(int currentLevelOfDetail, int maxLevelOfDetail)
+{
+    QVector<int> levels;
+
+    if (currentLevelOfDetail + 1 <= maxLevelOfDetail) {
+        levels << currentLevelOfDetail + 1;
+    }
+
+    if (currentLevelOfDetail - 1 >= 1) {
+        levels << currentLevelOfDetail - 1;
+    }
+
+    return levels;
+}
+
+KisPaintDeviceList KisFilterLodPrerenderStrokeStrategy::devicesToPrerender(KisNodeSP root)
+{
+    KisPaintDeviceList devices;
+
+    KisLayerUtils::recursiveApplyNodes(root, [&devices] (KisNodeSP node) {
+        if (node->isFakeNode()) return;
+
+        if (node->inherits("KisAdjustmentLayer")) {
+            devices << node->getLodCapableDevices();
+        } else if (node->inherits("KisFilterMask") && node->parent()) {
+            /**
+             * The result of the mask is stored in the
+             * projection of its parent layer
+             */
+            devices << node->parent()->getLodCapableDevices();
+        }
+    });
+
+    KritaUtils::makeContainerUnique(devices);
+
+    return devices;
+}
+
+void KisFilterLodPrerenderStrokeStrategy::initStrokeCallback()
+{
+    KisIdleTaskStrokeStrategy::initStrokeCallback();
+
+    using KritaUtils::addJobConcurrent;
+    using KritaUtils::addJobSequential;
+    using KritaUtils::splitRegionIntoPatches;
+    using KritaUtils::optimalPatchSize;
+
+    KisImageSP image = m_d->image;
+    if (!image || m_d->levels.isEmpty()) return;
+
+    const KisPaintDeviceList devices = devicesToPrerender(image->root());
+    if (devices.isEmpty()) return;
+
+    using Plane = std::pair<KisPaintDeviceSP, QSharedPointer<KisPaintDevice::LodDataStruct>>;
+    QSharedPointer<QVector<Plane>> planes(new QVector<Plane>());
+
+    /**
+     * The updates are not blocked while the planes are generated, so
+     * the user doesn't wait for the idle task. If an update modifies
+     * a projection in the meantime, the sequence number of its cache
+     * changes, and stashLodDataStruct() drops the plane generated from
+     * the possibly half-written data.
+     *
+     * The planes stashed by the previous runs stay valid while the Lod0
+     * data of their devices is unchanged, so only the devices modified
+     * since then are pre-rendered again.
+     */
+    Q_FOREACH (int lod, m_d->levels) {
+        Q_FOREACH (KisPaintDeviceSP device, devices) {
+            if (device->hasUpToDateLodPlane(lod)) continue;
+
+            planes->append(std::make_pair(device, toQShared(device->createLodDataStruct(lod))));
+        }
+    }
+
+    if (planes->isEmpty()) return;
+
+    QVector<KisRunnableStrokeJobData*> jobs;
+
+    for (int i = 0; i < planes->size(); i++) {
+        KisPaintDeviceSP device = (*planes)[i].first;
+        const QVector<QRect> rects = splitRegionIntoPatches(device->regionForLodSyncing(), optimalPatchSize());
+
+        Q_FOREACH (const QRect &rc, rects) {
+            addJobConcurrent(jobs, [planes, i, rc] () {
+                const Plane &plane = (*planes)[i];
+                plane.first->updateLodDataStruct(plane.second.data(), rc);
+            });
+        }
+    }
+
+    addJobSequential(jobs, [planes] () {
+        Q_FOREACH (const Plane &plane, *planes) {
+            plane.first->stashLodDataStruct(plane.second.data());
+        }
+    });
+
+    runnableJobsInterface()->addRunnableJobs(jobs);
+}
@@ -0,0 +1,66 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISFILTERLODPRERENDERSTROKESTRATEGY_H
+#define KISFILTERLODPRERENDERSTROKESTRATEGY_H
+
+#include "KisIdleTaskStrokeStrategy.h"
+
+#include <QScopedPointer>
+
+
+/**
+ * An idle task that speculatively pre-renders the Lod planes of the
+ * adjustment layers and the layers with filter masks for the levels of
+ * detail next to the one currently shown on the canvas, i.e. the levels
+ * the user will switch to by zooming in or out a bit.
+ *
+ * The projections of such nodes are regenerated from scratch on every
+ * switch of the level of detail, because their active Lod planes may
+ * diverge from Lod0. The pre-rendered planes are generated from Lod0
+ * and kept in the Lod pyramids of the devices (see
+ * KisPaintDevice::stashLodDataStruct()), so the sync stroke can reuse
+ * them while the image stays unchanged. The planes are keyed on the
+ * sequence number of the Lod0 data, so the devices that have not been
+ * changed since the previous run are skipped.
+ *
+ * Like any other idle task, the stroke is cancelled as soon as the user
+ * starts any other action. The planes are stashed only after all of them
+ * are fully generated, so a cancelled run leaves no partial data behind.
+ * The updates are not blocked during the generation, the planes made
+ * outdated by them are dropped instead.
+ *
+ * The stashed planes are subject to the bounds of the Lod pyramid, i.e.
+ * they replace the least recently used levels and are not kept at all
+ * when the tiles take too much memory.
+ */
+class KRITAUI_EXPORT KisFilterLodPrerenderStrokeStrategy : public KisIdleTaskStrokeStrategy
+{
+public:
+    KisFilterLodPrerenderStrokeStrategy(KisImageSP image);
+    ~KisFilterLodPrerenderStrokeStrategy() override;
+
+    /**
+     * The levels of detail that should be pre-rendered when the canvas
+     * shows \p currentLevelOfDetail level and the maximum level is
+     * \p maxLevelOfDetail
+     */
+    static QVector<int> levelsToPrerender(int currentLevelOfDetail, int maxLevelOfDetail);
+
+    /**
+     * The devices of the filter-based nodes of \p root, i.e. the
+     * adjustment layers and the parents of the filter masks
+     */
+    static KisPaintDeviceList devicesToPrerender(KisNodeSP root);
+
+private:
+    void initStrokeCallback() override;
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISFILTERLODPRERENDERSTROKESTRATEGY_H
@@ -0,0 +1,111 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisTileDeduplicationStrokeStrategy.h"
+
+#include "kis_image.h"
+#include "kis_paint_device.h"
+#include "kis_paint_device_frames_interface.h"
+#include "kis_datamanager.h"
+#include "kis_layer_utils.h"
+#include "kis_memory_statistics_server.h"
+#include "tiles3/KisTileDataDeduplicator.h"
+#include "tiles3/kis_tile_data_store.h"
+
+#include "KisRunnableStrokeJobUtils.h"
+#include "KisRunnableStrokeJobsInterface.h"
+
+
+struct KisTileDeduplicationStrokeStrategy::Private
+{
+    KisNodeSP root;
+    KisTileDataDeduplicator deduplicator;
+};
+
+KisTileDeduplicationStrokeStrategy::KisTileDeduplicationStrokeStrategy(KisImageSP image)
+    : KisIdleTaskStrokeStrategy(QLatin1String("tile-deduplication-stroke"), kundo2_i18n("Deduplicate image tiles")),
+      m_d(new Private)
+{
+    m_d->root = image->root();
+}
+
+KisTileDeduplicationStrokeStrategy::~KisTileDeduplicationStrokeStrategy()
+{
+}
+
+void KisTileDeduplicationStrokeStrategy::initStrokeCallback()
+{
+    KisIdleTaskStrokeStrategy::initStrokeCallback();
+
+    using KisLayerUtils::recursiveApplyNodes;
+    using KritaUtils::addJobConcurrent;
+    using KritaUtils::addJobSequential;
+    using KritaUtils::addJobSequentialExclusive;
+
+    /**
+     * Projections are not deduplicated: they are regenerated
+     * by the updates all the time, so merging their tiles would
+     * just cause extra COW in the update jobs.
+     */
+    QVector<KisDataManagerSP> dataManagers;
+
+    recursiveApplyNodes(m_d->root, [&dataManagers] (KisNodeSP node) {
+        if (node->isFakeNode()) return;
+
+        KisPaintDeviceSP device = node->paintDevice();
+        if (!device) return;
+
+        KisPaintDeviceFramesInterface *frames =
+            device->keyframeChannel() ? device->framesInterface() : 0;
+
+        if (frames) {
+            Q_FOREACH (int frameId, frames->frames()) {
+                dataManagers << frames->frameDataManager(frameId);
+            }
+        } else {
+            dataManagers << device->dataManager();
+        }
+    });
+
+    QVector<KisRunnableStrokeJobData*> jobs;
+
+    /**
+     * Hashing only reads the tiles, so it can be done
+     * in parallel with anything else. The number of tiles
+     * hashed per run is limited to keep the idle task short
+     * after loading of a big image, the rest of them will
+     * be hashed by the next runs.
+     */
+    const int maxHashedTilesPerDevice = 4096;
+
+    Q_FOREACH (KisDataManagerSP dm, dataManagers) {
+        addJobConcurrent(jobs, [dm, maxHashedTilesPerDevice] () {
+            KisTileDataDeduplicator::updateContentHashes(dm.data(), maxHashedTilesPerDevice);
+        });
+    }
+
+    /**
+     * Merging replaces the tile data of the devices, so no update
+     * should be copying the tiles from them at the same time
+     */
+    Q_FOREACH (KisDataManagerSP dm, dataManagers) {
+        addJobSequentialExclusive(jobs, [this, dm] () {
+            const qint64 releasedBefore = m_d->deduplicator.releasedMemory();
+            m_d->deduplicator.processDataManager(dm.data());
+
+            KisTileDataStore::instance()->registerDeduplicatedMemory(
+                m_d->deduplicator.releasedMemory() - releasedBefore);
+        });
+    }
+
+    addJobSequential(jobs, [this] () {
+        if (!m_d->deduplicator.numMergedTiles()) return;
+
+        QMetaObject::invokeMethod(KisMemoryStatisticsServer::instance(),
+                                  "notifyImageChanged", Qt::QueuedConnection);
+    });
+
+    runnableJobsInterface()->addRunnableJobs(jobs);
+}
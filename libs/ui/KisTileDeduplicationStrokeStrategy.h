@@ -0,0 +1,39 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISTILEDEDUPLICATIONSTROKESTRATEGY_H
+#define KISTILEDEDUPLICATIONSTROKESTRATEGY_H
+
+#include "KisIdleTaskStrokeStrategy.h"
+
+#include <QVector>
+#include <QScopedPointer>
+
+
+/**
+ * An idle task that merges byte-identical tiles of all the layers
+ * and raster keyframes of the image into shared COW tile data, see
+ * KisTileDataDeduplicator. Uniform tiles are switched to the tile
+ * data shared by all the tiles of the same color. The released
+ * memory is reported via KisMemoryStatisticsServer.
+ *
+ * Only the tiles changed since the previous run are rehashed, so
+ * the task is cheap when the image is edited locally.
+ */
+class KRITAUI_EXPORT KisTileDeduplicationStrokeStrategy : public KisIdleTaskStrokeStrategy
+{
+public:
+    KisTileDeduplicationStrokeStrategy(KisImageSP image);
+    ~KisTileDeduplicationStrokeStrategy() override;
+
+private:
+    void initStrokeCallback() override;
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISTILEDEDUPLICATIONSTROKESTRATEGY_H
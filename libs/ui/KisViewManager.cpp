@@ -121,6 +121,9 @@
 #include "imagesize/imagesize.h"
 #include <KoToolDocker.h>
 #include <KisIdleTasksManager.h>
+#include <KisTileDeduplicationStrokeStrategy.h>
+#include <KisFilterLodPrerenderStrokeStrategy.h>
+#include <kis_image_config.h>
 #include <KisImageBarrierLock.h>
 #include <KisTextPropertiesManager.h>
 #include <kis_selection.h>
@@ -231,6 +234,8 @@ public:
     KisMirrorManager mirrorManager;
     KisInputManager inputManager;
     KisIdleTasksManager idleTasksManager;
+    KisIdleTasksManager::TaskGuard tileDeduplicationTaskGuard;
+    KisIdleTasksManager::TaskGuard filterLodPrerenderTaskGuard;
     KisTextPropertiesManager textPropertyManager;
 
     KisSignalAutoConnectionsStore viewConnections;
@@ -344,6 +349,20 @@ KisViewManager::KisViewManager(QWidget *parent, KisKActionCollection *_actionCol
     d->canvasResourceProvider.setColorHistory(cfg.readKoColors("LastColorHistory"));
     d->textPropertyManager.setCanvasResourceProvider(&d->canvasResourceProvider);
 
+    if (KisImageConfig(true).enableTileDeduplication()) {
+        d->tileDeduplicationTaskGuard =
+            d->idleTasksManager.addIdleTaskWithGuard([] (KisImageSP image) {
+                return new KisTileDeduplicationStrokeStrategy(image);
+            });
+    }
+
+    if (KisImageConfig(true).prerenderFilterLodPlanes()) {
+        d->filterLodPrerenderTaskGuard =
+            d->idleTasksManager.addIdleTaskWithGuard([] (KisImageSP image) {
+                return new KisFilterLodPrerenderStrokeStrategy(image);
+            });
+    }
+
     // Initialize the old imagesize plugin
     new ImageSize(this);
 }
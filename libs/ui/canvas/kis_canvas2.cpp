@@ -181,6 +181,12 @@ public:
     QRect regionOfInterest;
     qreal regionOfInterestMargin = 0.25;
 
+    /**
+     * The image the visible rect of the canvas was last reported to,
+     * so that the rect could be withdrawn when the canvas is gone
+     */
+    KisImageWSP viewportImage;
+
     QRect renderingLimit;
     int isBatchUpdateActive = 0;
 
@@ -325,6 +331,11 @@ void KisCanvas2::initializeFpsDecoration()
 
 KisCanvas2::~KisCanvas2()
 {
+    KisImageSP viewportImage = m_d->viewportImage;
+    if (viewportImage) {
+        viewportImage->setCanvasViewportRect(this, QRect());
+    }
+
     delete m_d;
 }
 
@@ -1107,6 +1118,25 @@ void KisCanvas2::slotUpdateRegionOfInterest()
     if (m_d->regionOfInterest != oldRegionOfInterest) {
         Q_EMIT sigRegionOfInterestChanged(m_d->regionOfInterest);
     }
+
+    /**
+     * Let the update scheduler process the updates
+     * of the visible area first
+     */
+    KisImageSP image = this->image();
+    KisImageSP oldViewportImage = m_d->viewportImage;
+
+    if (oldViewportImage && oldViewportImage != image) {
+        oldViewportImage->setCanvasViewportRect(this, QRect());
+    }
+
+    if (image) {
+        const QRect visibleRect =
+            m_d->coordinatesConverter->widgetRectInImagePixels().toAlignedRect() & imageRect;
+
+        image->setCanvasViewportRect(this, visibleRect);
+        m_d->viewportImage = image;
+    }
 }
 
 void KisCanvas2::slotReferenceImagesChanged()
@@ -55,7 +55,13 @@ QList<int> calcDirtyFramesList(KisAnimationFrameCacheSP cache, const KisTimeSpan
 
 int KisAsyncAnimationCacheRenderDialog::calcFirstDirtyFrame(KisAnimationFrameCacheSP cache, const KisTimeSpan &playbackRange, const KisTimeSpan &skipRange)
 {
-    int result = -1;
+    const QList<int> frames = calcFirstDirtyFrames(cache, playbackRange, skipRange, 1);
+    return !frames.isEmpty() ? frames.first() : -1;
+}
+
+QList<int> KisAsyncAnimationCacheRenderDialog::calcFirstDirtyFrames(KisAnimationFrameCacheSP cache, const KisTimeSpan &playbackRange, const KisTimeSpan &skipRange, int maxFrames)
+{
+    QList<int> result;
 
     KisImageSP image = cache->image();
     if (!image) return result;
@@ -78,8 +84,21 @@ int KisAsyncAnimationCacheRenderDialog::calcFirstDirtyFrame(KisAnimationFrameCac
             }
 
             if (cache->frameStatus(frame) != KisAnimationFrameCache::Cached) {
-                result = frame;
-                break;
+                result.append(frame);
+                if (result.size() >= maxFrames) break;
+
+                /**
+                 * The frames identical to this one will be glued to it
+                 * when it is cached, don't render them separately
+                 */
+                const KisTimeSpan stillFrameRange =
+                    KisTimeSpan::calculateIdenticalFramesRecursive(image->root(), frame);
+
+                if (!stillFrameRange.isValid() || stillFrameRange.isInfinite()) {
+                    break;
+                }
+
+                frame = qMax(frame, stillFrameRange.end());
             }
         }
     }
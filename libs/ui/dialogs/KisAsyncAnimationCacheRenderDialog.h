@@ -19,6 +19,13 @@ public:
 
     static int calcFirstDirtyFrame(KisAnimationFrameCacheSP cache, const KisTimeSpan &playbackRange, const KisTimeSpan &skipRange);
 
+    /**
+     * Returns up to \p maxFrames first uncached frames of \p playbackRange
+     * that lie outside \p skipRange. The frames identical to an already
+     * listed one are not listed.
+     */
+    static QList<int> calcFirstDirtyFrames(KisAnimationFrameCacheSP cache, const KisTimeSpan &playbackRange, const KisTimeSpan &skipRange, int maxFrames);
+
 protected:
     QList<int> calcDirtyFrames() const override;
     KisAsyncAnimationRendererBase* createRenderer(KisImageSP image) override;
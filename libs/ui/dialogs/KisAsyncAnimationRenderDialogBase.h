@@ -102,6 +102,13 @@ public:
      */
     bool batchMode() const;
 
+    /**
+     * @brief the number of clones of \p image that can be created without
+     *        exceeding the memory limit set by the user. The estimation is
+     *        based on the size of the projections of the image.
+     */
+    static int calculateNumberMemoryAllowedClones(KisImageSP image);
+
 private Q_SLOTS:
     void slotFrameCompleted(int frame);
     void slotFrameCancelled(int frame, KisAsyncAnimationRendererBase::CancelReason cancelReason);
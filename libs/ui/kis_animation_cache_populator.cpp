@@ -12,7 +12,11 @@
 #include <QMutex>
 #include <QStack>
 
+#include <memory>
+#include <vector>
+
 #include "kis_config.h"
+#include "kis_image_config.h"
 #include "kis_config_notifier.h"
 #include "KisPart.h"
 #include "KisDocument.h"
@@ -31,6 +35,7 @@
 
 #include <KisLockFrameGenerationLock.h>
 #include "KisAsyncAnimationCacheRenderer.h"
+#include "KisAnimationCacheClonesStrokeStrategy.h"
 #include "dialogs/KisAsyncAnimationCacheRenderDialog.h"
 
 
@@ -53,6 +58,39 @@ struct KisAnimationCachePopulator::Private
     KisAsyncAnimationCacheRenderer regenerator;
     bool calculateAnimationCacheInBackground = true;
 
+    /**
+     * The image holds only one current time, so the frames are rendered
+     * in parallel on the clones of the image, the same way the frames
+     * are rendered on export (see KisAsyncAnimationRenderDialogBase).
+     *
+     * The clones are prepared lazily by an idle stroke on the source
+     * image (see KisAnimationCacheClonesStrokeStrategy). When the source
+     * image changes, the clones are marked stale and refreshed in place
+     * before the next batch that needs them, so the images and the
+     * renderers are reused across the edits.
+     */
+    struct CloneWorker {
+        std::unique_ptr<KisAsyncAnimationCacheRenderer> renderer;
+        KisImageSP image;
+    };
+
+    std::vector<CloneWorker> cloneWorkers;
+    KisImageWSP clonesSourceImage;
+    KisSignalAutoConnectionsStore clonesSourceConnections;
+    bool clonesAreStale = false;
+    bool clonesUpdateInProgress = false;
+    int clonesGeneration = 0;
+
+    /**
+     * The released workers are destroyed only when their images
+     * finish all the jobs, because the renderers are called directly
+     * from the worker threads of the images.
+     */
+    std::vector<CloneWorker> releasedCloneWorkers;
+
+    int numFramesInProgress = 0;
+    bool batchCancelled = false;
+
     enum State {
         NotWaitingForAnything,
         WaitingForIdle,
@@ -103,7 +141,11 @@ struct KisAnimationCachePopulator::Private
                 if (result == RequestPostponed) {
                     enterState(WaitingForIdle);
                 } else if (result == RequestRejected) {
-                    enterState(NotWaitingForAnything);
+                    // everything is cached, release the memory
+                    dropCloneWorkers();
+
+                    // keep polling until the released clones are destroyed
+                    enterState(releasedCloneWorkers.empty() ? NotWaitingForAnything : WaitingForIdle);
                 }
 
                 return;
@@ -242,23 +284,40 @@ struct KisAnimationCachePopulator::Private
 
         KisTimeSpan currentRange = animation->documentPlaybackRange();
 
-        const int frame = priorityFrame >= 0 ? priorityFrame : KisAsyncAnimationCacheRenderDialog::calcFirstDirtyFrame(cache, currentRange, skipRange);
+        const QList<int> frames = priorityFrame >= 0 ?
+            QList<int>({priorityFrame}) :
+            KisAsyncAnimationCacheRenderDialog::calcFirstDirtyFrames(cache, currentRange, skipRange, maxNumWorkers(image));
 
-        if (frame >= 0) {
-            return regenerate(cache, frame);
+        if (!frames.isEmpty()) {
+            return regenerate(cache, frames);
         }
 
         return RequestRejected;
     }
 
-    RegenerationRequestResult regenerate(KisAnimationFrameCacheSP cache, int frame)
+    int maxNumWorkers(KisImageSP image) const
+    {
+        KisImageConfig cfg(true);
+
+        const int numAllowedWorkers = 1 + KisAsyncAnimationRenderDialogBase::calculateNumberMemoryAllowedClones(image);
+        return qMax(1, qMin(cfg.frameRenderingClones(), numAllowedWorkers));
+    }
+
+    RegenerationRequestResult regenerate(KisAnimationFrameCacheSP cache, const QList<int> &frames)
     {
+        KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(!frames.isEmpty(), RequestRejected);
+
         if (state == WaitingForFrame) {
             // Already busy, deny request
             return RequestRejected;
         }
 
-        KisLockFrameGenerationLock lock(cache->image()->animationInterface(), std::try_to_lock);
+        KisImageSP image = cache->image();
+
+        const bool clonesAreReady =
+            prepareCloneWorkers(image, qMin(frames.size(), maxNumWorkers(image)) - 1);
+
+        KisLockFrameGenerationLock lock(image->animationInterface(), std::try_to_lock);
 
         if (!lock.owns_lock()) {
             return RequestPostponed;
@@ -271,15 +330,231 @@ struct KisAnimationCachePopulator::Private
          */
         enterState(WaitingForFrame);
 
+        // the first frame is rendered on the source image
+        numFramesInProgress = 1;
+        batchCancelled = false;
+
+        std::vector<std::pair<CloneWorker*, KisLockFrameGenerationLock>> startedWorkers;
+
+        if (clonesAreReady) {
+            for (CloneWorker &worker : cloneWorkers) {
+                if (int(startedWorkers.size()) >= frames.size() - 1) break;
+
+                KisLockFrameGenerationLock cloneLock(worker.image->animationInterface(), std::try_to_lock);
+
+                // the clone may still be finishing a cancelled frame
+                if (!cloneLock.owns_lock()) continue;
+
+                startedWorkers.emplace_back(&worker, std::move(cloneLock));
+            }
+        }
+
+        if (!startedWorkers.empty()) {
+            KisImageConfig cfg(true);
+            const int numThreadsPerImage =
+                qMax(1, cfg.maxNumberOfThreads() / int(startedWorkers.size() + 1));
+
+            /**
+             * The limit of the source image is not touched: changing it
+             * waits for the jobs of the image, and the limit belongs to
+             * the user. The clones are private and idle here, so they
+             * just take their share of the threads.
+             */
+            for (auto &pair : startedWorkers) {
+                setWorkingThreadsLimit(pair.first->image, numThreadsPerImage);
+            }
+        }
+
+        int nextFrame = 1;
+
+        for (auto &pair : startedWorkers) {
+            CloneWorker &worker = *pair.first;
+            numFramesInProgress++;
+
+            worker.renderer->setFrameCache(cache);
+            worker.renderer->startFrameRegeneration(worker.image, frames[nextFrame++], KisAsyncAnimationRendererBase::Cancellable, std::move(pair.second));
+        }
+
         regenerator.setFrameCache(cache);
 
         // if we ever decide to add ROI to background cache
         // regeneration, it should be added here :)
-        regenerator.startFrameRegeneration(cache->image(), frame, KisAsyncAnimationRendererBase::Cancellable, std::move(lock));
+        regenerator.startFrameRegeneration(image, frames.first(), KisAsyncAnimationRendererBase::Cancellable, std::move(lock));
 
         return RequestSuccessful;
     }
 
+    static void setWorkingThreadsLimit(KisImageSP image, int value)
+    {
+        // changing the limit waits for the running jobs of the image
+        if (image->workingThreadsLimit() != value) {
+            image->setWorkingThreadsLimit(value);
+        }
+    }
+
+    /**
+     * Returns true if \p numClones clones of \p image are ready for
+     * rendering. Otherwise starts preparing them in the background,
+     * so they could be used by one of the next batches.
+     */
+    bool prepareCloneWorkers(KisImageSP image, int numClones)
+    {
+        releaseIdleCloneWorkers();
+
+        if (numClones <= 0 || clonesUpdateInProgress) return false;
+
+        if (KisImageSP(clonesSourceImage) != image) {
+            clonesSourceConnections.clear();
+            clonesSourceImage = image;
+            clonesSourceConnections.addConnection(
+                image->animationInterface(), SIGNAL(sigFramesChanged(KisTimeSpan,QRect)),
+                q, SLOT(slotCloneSourceChanged()));
+            clonesAreStale = true;
+        }
+
+        const int numExistingClones = int(cloneWorkers.size());
+        if (!clonesAreStale && numExistingClones >= numClones) return true;
+
+        QVector<KisImageSP> clones;
+
+        if (clonesAreStale) {
+            // the clones are refreshed in place, so they should not be busy
+            for (CloneWorker &worker : cloneWorkers) {
+                if (!worker.image->isIdle()) return false;
+            }
+
+            for (CloneWorker &worker : cloneWorkers) {
+                clones << worker.image;
+            }
+        }
+
+        for (int i = numExistingClones; i < numClones; i++) {
+            clones << KisImageSP();
+        }
+
+        const int generation = ++clonesGeneration;
+
+        KisAnimationCacheClonesStrokeStrategy *strategy =
+            new KisAnimationCacheClonesStrokeStrategy(image, clones);
+
+        QObject::connect(strategy, &KisAnimationCacheClonesStrokeStrategy::sigClonesUpdated, q,
+                         [this, generation] (const QVector<KisImageSP> &clones, bool isComplete) {
+                             clonesUpdated(generation, clones, isComplete);
+                         });
+
+        KisStrokeId strokeId = image->startStroke(strategy);
+        image->endStroke(strokeId);
+
+        clonesUpdateInProgress = true;
+
+        /**
+         * The changes of the image made after the clones are copied
+         * will mark them stale again
+         */
+        clonesAreStale = false;
+
+        return false;
+    }
+
+    void clonesUpdated(int generation, const QVector<KisImageSP> &clones, bool isComplete)
+    {
+        // the clones have been dropped while being updated
+        if (generation != clonesGeneration) return;
+
+        clonesUpdateInProgress = false;
+
+        Q_FOREACH (KisImageSP clone, clones) {
+            if (!clone) continue;
+
+            auto it = std::find_if(cloneWorkers.begin(), cloneWorkers.end(),
+                                   [clone] (const CloneWorker &worker) {
+                                       return worker.image == clone;
+                                   });
+            if (it != cloneWorkers.end()) continue;
+
+            CloneWorker worker;
+            worker.image = clone;
+            worker.renderer.reset(new KisAsyncAnimationCacheRenderer());
+
+            QObject::connect(worker.renderer.get(), SIGNAL(sigFrameCancelled(int, KisAsyncAnimationRendererBase::CancelReason)),
+                             q, SLOT(slotRegeneratorFrameCancelled()));
+            QObject::connect(worker.renderer.get(), SIGNAL(sigFrameCompleted(int)),
+                             q, SLOT(slotRegeneratorFrameReady()));
+
+            cloneWorkers.push_back(std::move(worker));
+        }
+
+        if (!isComplete) {
+            clonesAreStale = true;
+        }
+    }
+
+    void cancelActiveCloneWorkers()
+    {
+        for (CloneWorker &worker : cloneWorkers) {
+            if (worker.renderer->isActive()) {
+                worker.renderer->cancelCurrentFrameRendering(KisAsyncAnimationRendererBase::UserCancelled);
+            }
+        }
+    }
+
+    void releaseIdleCloneWorkers()
+    {
+        releasedCloneWorkers.erase(
+            std::remove_if(releasedCloneWorkers.begin(), releasedCloneWorkers.end(),
+                           [] (CloneWorker &worker) {
+                               return worker.image->isIdle();
+                           }),
+            releasedCloneWorkers.end());
+    }
+
+    void dropCloneWorkers()
+    {
+        cancelActiveCloneWorkers();
+
+        for (CloneWorker &worker : cloneWorkers) {
+            worker.image->requestStrokeCancellation();
+            releasedCloneWorkers.push_back(std::move(worker));
+        }
+
+        cloneWorkers.clear();
+        clonesSourceConnections.clear();
+        clonesSourceImage = nullptr;
+        clonesAreStale = false;
+
+        // the results of a running update will be ignored
+        clonesUpdateInProgress = false;
+        clonesGeneration++;
+
+        releaseIdleCloneWorkers();
+    }
+
+    void frameProcessed(bool isCancelled)
+    {
+        KIS_ASSERT_RECOVER_RETURN(state == WaitingForFrame);
+        KIS_SAFE_ASSERT_RECOVER_NOOP(numFramesInProgress > 0);
+
+        numFramesInProgress--;
+
+        if (isCancelled && !batchCancelled) {
+            batchCancelled = true;
+
+            // the cancelled frames are reported synchronously
+            if (regenerator.isActive()) {
+                regenerator.cancelCurrentFrameRendering(KisAsyncAnimationRendererBase::UserCancelled);
+            }
+            cancelActiveCloneWorkers();
+        }
+
+        if (numFramesInProgress <= 0 && state == WaitingForFrame) {
+            if (batchCancelled) {
+                enterState(NotWaitingForAnything);
+            } else {
+                enterState(BetweenFrames);
+            }
+        }
+    }
+
     QString debugStateToString(State newState) {
         QString str = "<unknown>";
 
@@ -349,11 +624,21 @@ KisAnimationCachePopulator::KisAnimationCachePopulator(KisPart *part)
 KisAnimationCachePopulator::~KisAnimationCachePopulator()
 {
     m_d->priorityFrames.clear();
+    m_d->dropCloneWorkers();
+
+    /**
+     * The populator is destroyed on shutdown only, so it is
+     * fine to wait for the images to stop calling the renderers
+     */
+    for (Private::CloneWorker &worker : m_d->releasedCloneWorkers) {
+        worker.image->waitForDone();
+    }
+    m_d->releasedCloneWorkers.clear();
 }
 
 bool KisAnimationCachePopulator::regenerate(KisAnimationFrameCacheSP cache, int frame)
 {
-    return m_d->regenerate(cache, frame);
+    return m_d->regenerate(cache, {frame});
 }
 
 void KisAnimationCachePopulator::requestRegenerationWithPriorityFrame(KisImageSP image, int frameIndex)
@@ -384,13 +669,19 @@ void KisAnimationCachePopulator::slotRequestRegeneration()
 
 void KisAnimationCachePopulator::slotRegeneratorFrameCancelled()
 {
-    KIS_ASSERT_RECOVER_RETURN(m_d->state == Private::WaitingForFrame);
-    m_d->enterState(Private::NotWaitingForAnything);
+    m_d->frameProcessed(true);
 }
 
 void KisAnimationCachePopulator::slotRegeneratorFrameReady()
 {
-    m_d->enterState(Private::BetweenFrames);
+    m_d->frameProcessed(false);
+}
+
+void KisAnimationCachePopulator::slotCloneSourceChanged()
+{
+    // the frames rendered on the clones would be outdated
+    m_d->clonesAreStale = true;
+    m_d->cancelActiveCloneWorkers();
 }
 
 void KisAnimationCachePopulator::slotConfigChanged()
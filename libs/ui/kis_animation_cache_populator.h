@@ -36,6 +36,7 @@ private Q_SLOTS:
 
     void slotRegeneratorFrameCancelled();
     void slotRegeneratorFrameReady();
+    void slotCloneSourceChanged();
 
     void slotConfigChanged();
 
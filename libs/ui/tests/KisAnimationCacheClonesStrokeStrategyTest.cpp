@@ -0,0 +1,177 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisAnimationCacheClonesStrokeStrategyTest.h"
+
+#include <simpletest.h>
+#include <testutil.h>
+
+#include "KisAnimationCacheClonesStrokeStrategy.h"
+#include "kis_image.h"
+#include "kis_keyframe_channel.h"
+#include "kis_layer_utils.h"
+#include "kis_paint_layer.h"
+#include "kis_simple_stroke_strategy.h"
+#include "kistest.h"
+
+#include "kundo2command.h"
+
+namespace {
+
+struct UpdateResult
+{
+    QVector<KisImageSP> clones;
+    bool isComplete = false;
+    int numCalls = 0;
+};
+
+KisAnimationCacheClonesStrokeStrategy* createStrategy(KisImageSP image,
+                                                      const QVector<KisImageSP> &clones,
+                                                      UpdateResult *result)
+{
+    KisAnimationCacheClonesStrokeStrategy *strategy =
+        new KisAnimationCacheClonesStrokeStrategy(image, clones);
+
+    // the signal is delivered directly in the context of the stroke
+    QObject::connect(strategy, &KisAnimationCacheClonesStrokeStrategy::sigClonesUpdated,
+                     [result] (const QVector<KisImageSP> &clones, bool isComplete) {
+                         result->clones = clones;
+                         result->isComplete = isComplete;
+                         result->numCalls++;
+                     });
+
+    return strategy;
+}
+
+void runStrategy(KisImageSP image, const QVector<KisImageSP> &clones, UpdateResult *result)
+{
+    KisStrokeId id = image->startStroke(createStrategy(image, clones, result));
+    image->endStroke(id);
+    image->waitForDone();
+}
+
+QVector<QUuid> nodeUuids(KisImageSP image)
+{
+    QVector<QUuid> uuids;
+    KisLayerUtils::recursiveApplyNodes(image->root(),
+                                       [&uuids] (KisNodeSP node) {
+                                           uuids << node->uuid();
+                                       });
+    return uuids;
+}
+
+void verifyClone(KisImageSP clone, KisImageSP source)
+{
+    QVERIFY(clone);
+    QVERIFY(clone != source);
+    QCOMPARE(clone->bounds(), source->bounds());
+    QCOMPARE(nodeUuids(clone), nodeUuids(source));
+
+    KisNodeSP layer = clone->root()->firstChild();
+    QVERIFY(layer);
+
+    KisNodeSP sourceLayer = source->root()->firstChild();
+
+    KisKeyframeChannel *channel = layer->getKeyframeChannel(KisKeyframeChannel::Raster.id());
+    QVERIFY(channel);
+    QCOMPARE(channel->keyframeCount(),
+             sourceLayer->getKeyframeChannel(KisKeyframeChannel::Raster.id())->keyframeCount());
+
+    QPoint pt;
+    QVERIFY(TestUtil::comparePaintDevices(pt, layer->paintDevice(), sourceLayer->paintDevice()));
+}
+
+}
+
+void KisAnimationCacheClonesStrokeStrategyTest::testCreateClones()
+{
+    TestUtil::MaskParent p;
+    KUndo2Command parentCommand;
+
+    KisKeyframeChannel *channel = p.layer->getKeyframeChannel(KisKeyframeChannel::Raster.id(), true);
+    channel->addKeyframe(10, &parentCommand);
+
+    p.layer->paintDevice()->fill(QRect(10, 10, 100, 100), KoColor(Qt::red, p.image->colorSpace()));
+
+    UpdateResult result;
+    runStrategy(p.image, QVector<KisImageSP>(3), &result);
+
+    QCOMPARE(result.numCalls, 1);
+    QVERIFY(result.isComplete);
+    QCOMPARE(result.clones.size(), 3);
+
+    Q_FOREACH (KisImageSP clone, result.clones) {
+        verifyClone(clone, p.image);
+    }
+
+    QVERIFY(result.clones[0] != result.clones[1]);
+    QVERIFY(result.clones[1] != result.clones[2]);
+}
+
+void KisAnimationCacheClonesStrokeStrategyTest::testRefreshClones()
+{
+    TestUtil::MaskParent p;
+    KUndo2Command parentCommand;
+
+    KisKeyframeChannel *channel = p.layer->getKeyframeChannel(KisKeyframeChannel::Raster.id(), true);
+    channel->addKeyframe(10, &parentCommand);
+
+    UpdateResult result;
+    runStrategy(p.image, QVector<KisImageSP>(2), &result);
+    QVERIFY(result.isComplete);
+
+    const QVector<KisImageSP> clones = result.clones;
+
+    // change the source image after the clones have been created
+    p.layer->paintDevice()->fill(QRect(10, 10, 100, 100), KoColor(Qt::red, p.image->colorSpace()));
+    KisPaintLayerSP layer2 = new KisPaintLayer(p.image, "paint2", OPACITY_OPAQUE_U8);
+    p.image->addNode(layer2);
+    p.image->waitForDone();
+
+    // the existing clones are refreshed in place, the null one is created
+    QVector<KisImageSP> requestedClones = clones;
+    requestedClones << KisImageSP();
+
+    runStrategy(p.image, requestedClones, &result);
+
+    QCOMPARE(result.numCalls, 2);
+    QVERIFY(result.isComplete);
+    QCOMPARE(result.clones.size(), 3);
+    QCOMPARE(result.clones[0].data(), clones[0].data());
+    QCOMPARE(result.clones[1].data(), clones[1].data());
+
+    Q_FOREACH (KisImageSP clone, result.clones) {
+        verifyClone(clone, p.image);
+    }
+}
+
+void KisAnimationCacheClonesStrokeStrategyTest::testCancelUpdate()
+{
+    TestUtil::MaskParent p;
+    KUndo2Command parentCommand;
+
+    KisKeyframeChannel *channel = p.layer->getKeyframeChannel(KisKeyframeChannel::Raster.id(), true);
+    channel->addKeyframe(10, &parentCommand);
+
+    UpdateResult result;
+
+    // keep the stroke in the queue until a user stroke is started
+    p.image->barrierLock();
+
+    KisStrokeId id = p.image->startStroke(createStrategy(p.image, QVector<KisImageSP>(2), &result));
+    p.image->endStroke(id);
+
+    id = p.image->startStroke(new KisSimpleStrokeStrategy(QLatin1String("user-stroke")));
+    p.image->endStroke(id);
+
+    p.image->unlock();
+    p.image->waitForDone();
+
+    QCOMPARE(result.numCalls, 1);
+    QVERIFY(!result.isComplete);
+}
+
+KISTEST_MAIN(KisAnimationCacheClonesStrokeStrategyTest)
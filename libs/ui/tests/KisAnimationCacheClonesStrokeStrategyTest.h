@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISANIMATIONCACHECLONESSTROKESTRATEGYTEST_H
+#define KISANIMATIONCACHECLONESSTROKESTRATEGYTEST_H
+
+#include <simpletest.h>
+
+class KisAnimationCacheClonesStrokeStrategyTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testCreateClones();
+    void testRefreshClones();
+    void testCancelUpdate();
+};
+
+#endif // KISANIMATIONCACHECLONESSTROKESTRATEGYTEST_H
@@ -115,6 +115,12 @@ void FreehandStrokeStrategy::init(Flags flags)
 
     enableJob(KisSimpleStrokeStrategy::JOB_DOSTROKE);
 
+    /**
+     * With high-frequency tablets the dabs are tiny, so let the queue
+     * execute a few of them in a row without rescheduling
+     */
+    setSupportsJobBatching(true);
+
     if (m_d->needsAsynchronousUpdates) {
         /**
          * In case the paintop uses asynchronous updates, we should set priority to it,